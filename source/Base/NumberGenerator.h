@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "Definitions.h"
 
 class NumberGenerator
@@ -28,7 +30,7 @@ private:
 
 	int _index = 0;
 	vector<uint32_t> _arrayOfRandomNumbers;
-	uint64_t _runningNumber = 0;
+	std::atomic<uint64_t> _runningNumber{0};  //ids are also requested by conversions on background threads
 	uint64_t _threadId = 0;
 };
 
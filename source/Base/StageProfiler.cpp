@@ -0,0 +1,84 @@
+#include "StageProfiler.h"
+
+#include <algorithm>
+#include <fstream>
+
+StageProfiler::StageProfiler(int windowSize)
+    : _windowSize(windowSize)
+{}
+
+void StageProfiler::beginTimestep()
+{
+    std::fill(_currentDurations.begin(), _currentDurations.end(), -1.0);
+}
+
+void StageProfiler::endTimestep()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto index = _numTimesteps % _windowSize;
+    if (index < toInt(_durations.size())) {
+        _durations[index] = _currentDurations;
+    } else {
+        _durations.emplace_back(_currentDurations);
+    }
+    ++_numTimesteps;
+}
+
+vector<StageStatistics> StageProfiler::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    vector<StageStatistics> result;
+    for (int stageIndex = 0; stageIndex < toInt(_stageNames.size()); ++stageIndex) {
+        vector<double> samples;
+        for (auto const& durations : _durations) {
+            if (stageIndex < toInt(durations.size()) && durations[stageIndex] >= 0) {
+                samples.emplace_back(durations[stageIndex]);
+            }
+        }
+
+        StageStatistics statistics;
+        statistics.name = _stageNames[stageIndex];
+        statistics.numSamples = toInt(samples.size());
+        if (!samples.empty()) {
+            double sum = 0;
+            for (auto const& sample : samples) {
+                sum += sample;
+                statistics.maxTime = std::max(statistics.maxTime, sample);
+            }
+            statistics.meanTime = sum / samples.size();
+
+            auto p95Index = std::min(samples.size() - 1, samples.size() * 95 / 100);
+            std::nth_element(samples.begin(), samples.begin() + p95Index, samples.end());
+            statistics.p95Time = samples[p95Index];
+        }
+        result.emplace_back(statistics);
+    }
+    return result;
+}
+
+bool StageProfiler::saveStatisticsToCsv(vector<StageStatistics> const& statistics, string const& filename)
+{
+    std::ofstream stream(filename, std::ios::trunc);
+    if (!stream) {
+        return false;
+    }
+    stream << "stage,samples,mean [ms],p95 [ms],max [ms]" << std::endl;
+    for (auto const& stage : statistics) {
+        stream << stage.name << "," << stage.numSamples << "," << stage.meanTime << "," << stage.p95Time << ","
+               << stage.maxTime << std::endl;
+    }
+    return stream.good();
+}
+
+void StageProfiler::addDuration(string const& stageName, double duration)
+{
+    auto findResult = std::find(_stageNames.begin(), _stageNames.end(), stageName);
+    auto stageIndex = toInt(findResult - _stageNames.begin());
+    if (findResult == _stageNames.end()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stageNames.emplace_back(stageName);
+        _currentDurations.resize(_stageNames.size(), -1.0);
+    }
+    _currentDurations[stageIndex] = duration;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+#include "Definitions.h"
+
+struct StageStatistics
+{
+    string name;
+    int numSamples = 0;
+
+    //in milliseconds
+    double meanTime = 0.0;
+    double p95Time = 0.0;
+    double maxTime = 0.0;
+};
+
+//measures the wall time of each stage of a time step over a rolling window of time steps
+class StageProfiler
+{
+public:
+    BASE_EXPORT StageProfiler(int windowSize = 1000);
+
+    BASE_EXPORT void beginTimestep();
+    BASE_EXPORT void endTimestep();
+
+    template <typename Func>
+    void measure(string const& stageName, Func const& func)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        func();
+        auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+        addDuration(stageName, duration.count());
+    }
+
+    BASE_EXPORT vector<StageStatistics> getStatistics() const;
+
+    //writes one line per stage, returns false if the file cannot be written
+    BASE_EXPORT static bool saveStatisticsToCsv(vector<StageStatistics> const& statistics, string const& filename);
+
+private:
+    BASE_EXPORT void addDuration(string const& stageName, double duration);
+
+    int _windowSize;
+
+    //written by the simulation thread only
+    vector<double> _currentDurations;  //negative values denote stages which have not been executed
+
+    mutable std::mutex _mutex;
+    vector<string> _stageNames;
+    vector<vector<double>> _durations;  //ring buffer of _currentDurations
+    int _numTimesteps = 0;
+};
@@ -0,0 +1,58 @@
+#include "TaskPool.h"
+
+TaskPool& TaskPool::getInstance()
+{
+    static TaskPool instance;
+    return instance;
+}
+
+int TaskPool::getNumThreads() const
+{
+    return static_cast<int>(_workers.size());
+}
+
+TaskPool::TaskPool()
+{
+    auto numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(&TaskPool::run, this);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::unique_lock<std::mutex> uniqueLock(_mutex);
+        _isShutdown = true;
+    }
+    _condition.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void TaskPool::addTask(std::function<void()> const& task)
+{
+    {
+        std::unique_lock<std::mutex> uniqueLock(_mutex);
+        _tasks.emplace_back(task);
+    }
+    _condition.notify_one();
+}
+
+void TaskPool::run()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> uniqueLock(_mutex);
+            _condition.wait(uniqueLock, [this] { return _isShutdown || !_tasks.empty(); });
+            if (_tasks.empty()) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
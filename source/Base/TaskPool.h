@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Definitions.h"
+
+//process-wide pool of worker threads for host-side data processing (conversion, compression, ...)
+//the workers are created once => callers do not pay for thread creation on each request
+class TaskPool
+{
+public:
+    BASE_EXPORT static TaskPool& getInstance();
+
+    TaskPool(TaskPool const&) = delete;
+    void operator=(TaskPool const&) = delete;
+
+    BASE_EXPORT int getNumThreads() const;
+
+    //results and exceptions are passed through the future
+    template <typename Func>
+    auto add(Func const& function) -> std::future<decltype(function())>
+    {
+        using Result = decltype(function());
+        auto task = std::make_shared<std::packaged_task<Result()>>(function);
+        auto result = task->get_future();
+        addTask([task] { (*task)(); });
+        return result;
+    }
+
+    //splits [0, numElements) into contiguous ranges and calls func(startIndex, endIndex) for each of them
+    //the calling thread processes ranges as well => it may also be used from within a task without deadlocking
+    template <typename Func>
+    void executeInParallel(int numElements, int minElementsPerRange, Func const& func)
+    {
+        auto numRanges = std::min(getNumThreads(), numElements / std::max(1, minElementsPerRange));
+        if (numRanges <= 1) {
+            func(0, numElements);
+            return;
+        }
+
+        struct SharedState
+        {
+            std::atomic<int> nextRange{0};
+            std::mutex mutex;
+            std::condition_variable condition;
+            int numFinishedRanges = 0;
+            std::exception_ptr exception;
+        };
+        auto state = std::make_shared<SharedState>();
+        auto processRanges = [state, numRanges, numElements, &func] {
+            for (auto range = state->nextRange++; range < numRanges; range = state->nextRange++) {
+                auto startIndex = static_cast<int>(static_cast<int64_t>(numElements) * range / numRanges);
+                auto endIndex = static_cast<int>(static_cast<int64_t>(numElements) * (range + 1) / numRanges);
+                std::exception_ptr exception;
+                try {
+                    func(startIndex, endIndex);
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (exception && !state->exception) {
+                        state->exception = exception;
+                    }
+                    ++state->numFinishedRanges;
+                }
+                state->condition.notify_all();
+            }
+        };
+        //helpers which arrive after all ranges have been claimed return immediately and do not touch func
+        for (int i = 1; i < numRanges; ++i) {
+            addTask(processRanges);
+        }
+        processRanges();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->condition.wait(lock, [&] { return state->numFinishedRanges == numRanges; });
+        if (state->exception) {
+            std::rethrow_exception(state->exception);
+        }
+    }
+
+private:
+    TaskPool();
+    ~TaskPool();
+
+    BASE_EXPORT void addTask(std::function<void()> const& task);
+    void run();
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::function<void()>> _tasks;
+    bool _isShutdown = false;
+    std::vector<std::thread> _workers;
+};
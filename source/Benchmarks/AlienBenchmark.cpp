@@ -0,0 +1,498 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include "Base/BaseServices.h"
+#include "Base/NumberGenerator.h"
+#include "EngineImpl/SimulationController.h"
+#include "EngineInterface/ChangeDescriptions.h"
+#include "EngineInterface/Descriptions.h"
+#include "EngineInterface/Parser.h"
+#include "EngineInterface/Serializer.h"
+
+//runs reproducible scenarios on the complete engine and writes the measurements as JSON
+namespace
+{
+    struct Arguments
+    {
+        int timesteps = 1000;
+        int warmupTimesteps = 100;
+        string outputFilename = "benchmark.json";
+        boost::optional<string> examplesDirectory;
+        ComputeBackend backend = ComputeBackend::Cuda;
+    };
+
+    struct Scenario
+    {
+        string name;
+        Settings settings;
+        SymbolMap symbolMap;
+        DataDescription data;
+    };
+
+    struct ScenarioResult
+    {
+        string name;
+        int numCells = 0;
+        int numParticles = 0;
+        int numTokens = 0;
+
+        double tps = 0;
+
+        //in milliseconds
+        double meanStepTime = 0;
+        double p50StepTime = 0;
+        double p95StepTime = 0;
+        double p99StepTime = 0;
+        double maxStepTime = 0;
+        double getSimulationDataTime = 0;
+        double setSimulationDataTime = 0;
+
+        uint64_t peakMemory = 0;  //in bytes, process-wide
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: alien-bench [options]" << std::endl
+                  << "  -t <time steps>  measured time steps per scenario (default: 1000)" << std::endl
+                  << "  -w <time steps>  warm-up time steps per scenario (default: 100)" << std::endl
+                  << "  -o <file>        JSON output file (default: benchmark.json)" << std::endl
+                  << "  -e <directory>   additionally run all *.settings.json found in <directory>" << std::endl
+                  << "  --cpu            use the CPU backend instead of CUDA" << std::endl;
+    }
+
+    boost::optional<Arguments> parseArguments(int argc, char** argv)
+    {
+        Arguments result;
+        for (int i = 1; i < argc; ++i) {
+            string argument = argv[i];
+            if (argument == "--cpu") {
+                result.backend = ComputeBackend::Cpu;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                return boost::none;
+            }
+            string value = argv[++i];
+            if (argument == "-t") {
+                result.timesteps = std::stoi(value);
+            } else if (argument == "-w") {
+                result.warmupTimesteps = std::stoi(value);
+            } else if (argument == "-o") {
+                result.outputFilename = value;
+            } else if (argument == "-e") {
+                result.examplesDirectory = value;
+            } else {
+                return boost::none;
+            }
+        }
+        if (result.timesteps <= 0 || result.warmupTimesteps < 0) {
+            return boost::none;
+        }
+        return result;
+    }
+
+    uint64_t getPeakMemory()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return 0;
+        }
+        return counters.PeakWorkingSetSize;
+#else
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return usage.ru_maxrss;
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    Settings createSettings(int worldSizeX, int worldSizeY)
+    {
+        Settings result;
+        result.generalSettings.worldSizeX = worldSizeX;
+        result.generalSettings.worldSizeY = worldSizeY;
+        return result;
+    }
+
+    CellDescription createCell(RealVector2D const& pos, int maxConnections, int branchNumber = 0)
+    {
+        return CellDescription()
+            .setId(NumberGenerator::getInstance().getId())
+            .setPos(pos)
+            .setVel({0, 0})
+            .setEnergy(100)
+            .setMaxConnections(maxConnections)
+            .setFlagTokenBlocked(false)
+            .setTokenBranchNumber(branchNumber)
+            .setMetadata(CellMetadata())
+            .setTokenUsages(0);
+    }
+
+    ClusterDescription createRectangularCluster(RealVector2D const& pos, int sizeX, int sizeY)
+    {
+        ClusterDescription result;
+        result.setId(NumberGenerator::getInstance().getId());
+        for (int y = 0; y < sizeY; ++y) {
+            for (int x = 0; x < sizeX; ++x) {
+                result.addCell(createCell({pos.x + toFloat(x), pos.y + toFloat(y)}, 4));
+            }
+        }
+        std::unordered_map<uint64_t, int> cache;
+        for (int y = 0; y < sizeY; ++y) {
+            for (int x = 0; x < sizeX; ++x) {
+                auto const& cell = result.cells[x + y * sizeX];
+                if (x > 0) {
+                    result.addConnection(cell.id, result.cells[x - 1 + y * sizeX].id, cache);
+                }
+                if (y > 0) {
+                    result.addConnection(cell.id, result.cells[x + (y - 1) * sizeX].id, cache);
+                }
+            }
+        }
+        return result;
+    }
+
+    //tokens circulate since the branch numbers increase along the ring
+    ClusterDescription
+    createTokenRing(RealVector2D const& center, int numCells, int maxBranchNumber, int tokenMemorySize)
+    {
+        ClusterDescription result;
+        result.setId(NumberGenerator::getInstance().getId());
+        auto radius = toFloat(numCells) / (2.0f * 3.14159265f);
+        for (int i = 0; i < numCells; ++i) {
+            auto angle = 2.0f * 3.14159265f * toFloat(i) / toFloat(numCells);
+            auto cell = createCell(
+                {center.x + radius * std::cos(angle), center.y + radius * std::sin(angle)}, 2, i % maxBranchNumber);
+            cell.addToken(TokenDescription().setEnergy(60).setData(std::string(tokenMemorySize, 0)));
+            result.addCell(cell);
+        }
+        std::unordered_map<uint64_t, int> cache;
+        for (int i = 0; i < numCells; ++i) {
+            result.addConnection(result.cells[i].id, result.cells[(i + 1) % numCells].id, cache);
+        }
+        return result;
+    }
+
+    ParticleDescription createParticle(RealVector2D const& pos, RealVector2D const& vel)
+    {
+        return ParticleDescription()
+            .setId(NumberGenerator::getInstance().getId())
+            .setPos(pos)
+            .setVel(vel)
+            .setEnergy(10)
+            .setMetadata(ParticleMetadata());
+    }
+
+    void addParticles(DataDescription& data, IntVector2D const& worldSize, int numParticles, std::mt19937& randomEngine)
+    {
+        std::uniform_real_distribution<float> posX(0, toFloat(worldSize.x));
+        std::uniform_real_distribution<float> posY(0, toFloat(worldSize.y));
+        std::uniform_real_distribution<float> vel(-0.5f, 0.5f);
+        for (int i = 0; i < numParticles; ++i) {
+            data.addParticle(createParticle({posX(randomEngine), posY(randomEngine)}, {vel(randomEngine), vel(randomEngine)}));
+        }
+    }
+
+    void addRectangularClusters(
+        DataDescription& data,
+        IntVector2D const& worldSize,
+        int numClusters,
+        int clusterSize,
+        std::mt19937& randomEngine)
+    {
+        std::uniform_real_distribution<float> posX(0, toFloat(worldSize.x - clusterSize));
+        std::uniform_real_distribution<float> posY(0, toFloat(worldSize.y - clusterSize));
+        for (int i = 0; i < numClusters; ++i) {
+            data.addCluster(createRectangularCluster({posX(randomEngine), posY(randomEngine)}, clusterSize, clusterSize));
+        }
+    }
+
+    Scenario createParticleGasScenario()
+    {
+        std::mt19937 randomEngine(1);
+        Scenario result;
+        result.name = "energy particle gas";
+        result.settings = createSettings(1000, 1000);
+        addParticles(result.data, {1000, 1000}, 200000, randomEngine);
+        return result;
+    }
+
+    Scenario createDenseClustersScenario()
+    {
+        std::mt19937 randomEngine(2);
+        Scenario result;
+        result.name = "dense clusters";
+        result.settings = createSettings(1000, 1000);
+        addRectangularClusters(result.data, {1000, 1000}, 3000, 10, randomEngine);
+        return result;
+    }
+
+    Scenario createTokenColoniesScenario()
+    {
+        std::mt19937 randomEngine(3);
+        Scenario result;
+        result.name = "token colonies";
+        result.settings = createSettings(1000, 1000);
+
+        auto const& parameters = result.settings.simulationParameters;
+        std::uniform_real_distribution<float> pos(50, 950);
+        for (int colony = 0; colony < 100; ++colony) {
+            RealVector2D colonyCenter{pos(randomEngine), pos(randomEngine)};
+            for (int i = 0; i < 20; ++i) {
+                RealVector2D offset{toFloat(i % 5) * 8 - 16, toFloat(i / 5) * 8 - 12};
+                result.data.addCluster(createTokenRing(
+                    colonyCenter + offset, 12, parameters.cellMaxTokenBranchNumber, parameters.tokenMemorySize));
+            }
+        }
+        return result;
+    }
+
+    Scenario createSpotsAndFlowFieldScenario()
+    {
+        std::mt19937 randomEngine(4);
+        Scenario result;
+        result.name = "spots and flow field";
+        result.settings = createSettings(1000, 1000);
+
+        auto& spots = result.settings.simulationParametersSpots;
+        spots.numSpots = 2;
+        spots.spots[0].posX = 300;
+        spots.spots[0].posY = 500;
+        spots.spots[0].coreRadius = 150;
+        spots.spots[0].values.friction = 0.01f;
+        spots.spots[1].posX = 700;
+        spots.spots[1].posY = 500;
+        spots.spots[1].coreRadius = 150;
+        spots.spots[1].values.radiationFactor = 0.002f;
+
+        auto& flowField = result.settings.flowFieldSettings;
+        flowField.active = true;
+        flowField.numCenters = 2;
+        flowField.centers[0].posX = 300;
+        flowField.centers[0].posY = 500;
+        flowField.centers[0].radius = 300;
+        flowField.centers[1].posX = 700;
+        flowField.centers[1].posY = 500;
+        flowField.centers[1].radius = 300;
+        flowField.centers[1].orientation = Orientation::CounterClockwise;
+
+        addRectangularClusters(result.data, {1000, 1000}, 1000, 8, randomEngine);
+        addParticles(result.data, {1000, 1000}, 50000, randomEngine);
+        return result;
+    }
+
+    //example simulations without a .sim file only provide settings => a mixed content is generated
+    vector<Scenario> loadExampleScenarios(string const& directory)
+    {
+        vector<Scenario> result;
+        string const settingsEnding = ".settings.json";
+        for (auto const& entry : std::filesystem::recursive_directory_iterator(directory)) {
+            auto filename = entry.path().string();
+            if (filename.size() <= settingsEnding.size()
+                || filename.compare(filename.size() - settingsEnding.size(), settingsEnding.size(), settingsEnding) != 0) {
+                continue;
+            }
+            auto simFilename = filename.substr(0, filename.size() - settingsEnding.size()) + ".sim";
+
+            Scenario scenario;
+            scenario.name = entry.path().filename().string();
+            scenario.name.resize(scenario.name.size() - settingsEnding.size());
+            if (std::filesystem::exists(simFilename)) {
+                Serializer serializer = boost::make_shared<_Serializer>();
+                DeserializedSimulation sim;
+                if (!serializer->deserializeSimulationFromFile(simFilename, sim)) {
+                    throw std::runtime_error("Simulation " + simFilename + " could not be read.");
+                }
+                scenario.settings = sim.settings;
+                scenario.symbolMap = sim.symbolMap;
+                scenario.data = sim.content;
+            } else {
+                boost::property_tree::ptree tree;
+                boost::property_tree::read_json(filename, tree);
+                scenario.settings = Parser::decodeTimestepAndSettings(tree).second;
+
+                std::mt19937 randomEngine(5);
+                IntVector2D worldSize{
+                    scenario.settings.generalSettings.worldSizeX, scenario.settings.generalSettings.worldSizeY};
+                addRectangularClusters(scenario.data, worldSize, 500, 5, randomEngine);
+                addParticles(scenario.data, worldSize, 20000, randomEngine);
+            }
+            result.emplace_back(scenario);
+        }
+        std::sort(result.begin(), result.end(), [](auto const& left, auto const& right) { return left.name < right.name; });
+        return result;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point const& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    double getPercentile(vector<double> const& sortedValues, double percentile)
+    {
+        auto index = std::min(sortedValues.size() - 1, static_cast<size_t>(percentile * sortedValues.size()));
+        return sortedValues[index];
+    }
+
+    ScenarioResult runScenario(SimulationController const& simController, Scenario const& scenario, Arguments const& arguments)
+    {
+        ScenarioResult result;
+        result.name = scenario.name;
+        result.numParticles = toInt(scenario.data.particles.size());
+        for (auto const& cluster : scenario.data.clusters) {
+            result.numCells += toInt(cluster.cells.size());
+            for (auto const& cell : cluster.cells) {
+                result.numTokens += toInt(cell.tokens.size());
+            }
+        }
+
+        simController->newSimulation(0, scenario.settings, scenario.symbolMap, arguments.backend);
+        simController->setSimulationData(scenario.data);
+
+        for (int i = 0; i < arguments.warmupTimesteps; ++i) {
+            simController->calcSingleTimestep();
+        }
+
+        vector<double> stepTimes;
+        stepTimes.reserve(arguments.timesteps);
+        auto startTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < arguments.timesteps; ++i) {
+            auto stepStartTime = std::chrono::steady_clock::now();
+            simController->calcSingleTimestep();
+            stepTimes.emplace_back(millisecondsSince(stepStartTime));
+        }
+        auto totalTime = millisecondsSince(startTime);
+
+        result.tps = totalTime > 0 ? arguments.timesteps * 1000.0 / totalTime : 0;
+        std::sort(stepTimes.begin(), stepTimes.end());
+        double sum = 0;
+        for (auto const& stepTime : stepTimes) {
+            sum += stepTime;
+        }
+        result.meanStepTime = sum / stepTimes.size();
+        result.p50StepTime = getPercentile(stepTimes, 0.5);
+        result.p95StepTime = getPercentile(stepTimes, 0.95);
+        result.p99StepTime = getPercentile(stepTimes, 0.99);
+        result.maxStepTime = stepTimes.back();
+
+        //round trip of the whole world
+        auto worldSize = simController->getWorldSize();
+        startTime = std::chrono::steady_clock::now();
+        auto data = simController->getSimulationData({-1000, -1000}, {worldSize.x + 1000, worldSize.y + 1000});
+        result.getSimulationDataTime = millisecondsSince(startTime);
+
+        simController->clear();
+        startTime = std::chrono::steady_clock::now();
+        simController->setSimulationData(data);
+        result.setSimulationDataTime = millisecondsSince(startTime);
+
+        simController->closeSimulation();
+
+        result.peakMemory = getPeakMemory();
+        return result;
+    }
+
+    string escapeJson(string const& value)
+    {
+        string result;
+        for (auto const& c : value) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    }
+
+    void writeResults(std::ostream& stream, Arguments const& arguments, vector<ScenarioResult> const& results)
+    {
+        stream << "{" << std::endl;
+        stream << "    \"backend\": \"" << (ComputeBackend::Cuda == arguments.backend ? "cuda" : "cpu") << "\"," << std::endl;
+        stream << "    \"timesteps\": " << arguments.timesteps << "," << std::endl;
+        stream << "    \"warmupTimesteps\": " << arguments.warmupTimesteps << "," << std::endl;
+        stream << "    \"scenarios\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            auto const& result = results[i];
+            stream << (i > 0 ? "," : "") << std::endl;
+            stream << "        {" << std::endl;
+            stream << "            \"name\": \"" << escapeJson(result.name) << "\"," << std::endl;
+            stream << "            \"cells\": " << result.numCells << "," << std::endl;
+            stream << "            \"particles\": " << result.numParticles << "," << std::endl;
+            stream << "            \"tokens\": " << result.numTokens << "," << std::endl;
+            stream << "            \"tps\": " << result.tps << "," << std::endl;
+            stream << "            \"stepTimeMs\": {\"mean\": " << result.meanStepTime << ", \"p50\": " << result.p50StepTime
+                   << ", \"p95\": " << result.p95StepTime << ", \"p99\": " << result.p99StepTime
+                   << ", \"max\": " << result.maxStepTime << "}," << std::endl;
+            stream << "            \"getSimulationDataMs\": " << result.getSimulationDataTime << "," << std::endl;
+            stream << "            \"setSimulationDataMs\": " << result.setSimulationDataTime << "," << std::endl;
+            stream << "            \"peakMemoryBytes\": " << result.peakMemory << std::endl;
+            stream << "        }";
+        }
+        stream << std::endl << "    ]" << std::endl << "}" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto arguments = parseArguments(argc, argv);
+    if (!arguments) {
+        printUsage();
+        return 1;
+    }
+
+    BaseServices baseServices;
+    try {
+        vector<Scenario> scenarios = {
+            createParticleGasScenario(),
+            createDenseClustersScenario(),
+            createTokenColoniesScenario(),
+            createSpotsAndFlowFieldScenario()};
+        if (arguments->examplesDirectory) {
+            auto exampleScenarios = loadExampleScenarios(*arguments->examplesDirectory);
+            scenarios.insert(scenarios.end(), exampleScenarios.begin(), exampleScenarios.end());
+        }
+
+        auto simController = boost::make_shared<_SimulationController>();
+        if (ComputeBackend::Cuda == arguments->backend) {
+            simController->initCuda();
+        }
+
+        vector<ScenarioResult> results;
+        for (auto const& scenario : scenarios) {
+            std::cout << scenario.name << ": " << std::flush;
+            auto result = runScenario(simController, scenario, *arguments);
+            std::cout << result.tps << " TPS, p95 " << result.p95StepTime << " ms" << std::endl;
+            results.emplace_back(result);
+        }
+
+        std::ofstream stream(arguments->outputFilename, std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("File " + arguments->outputFilename + " could not be created.");
+        }
+        writeResults(stream, *arguments, results);
+    } catch (std::exception const& e) {
+        std::cerr << "The following exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
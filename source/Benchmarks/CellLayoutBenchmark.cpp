@@ -0,0 +1,168 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Base/BaseServices.h"
+#include "EngineCpu/Cell.h"
+#include "EngineCpu/CpuSimulation.h"
+#include "EngineCpu/Math.h"
+#include "EngineCpu/ThreadPool.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineInterface/Settings.h"
+
+//compares the memory traffic of the physics passes for the hot/cold split cell layout with the former layout where
+//all cell data was stored inline
+namespace
+{
+    using namespace Cpu;
+
+    struct InlineCell : Cpu::Cell
+    {
+        Cpu::CellColdData coldData;
+    };
+
+    template <typename CellType>
+    void initLattice(std::vector<CellType>& cells, int latticeSize)
+    {
+        for (int y = 0; y < latticeSize; ++y) {
+            for (int x = 0; x < latticeSize; ++x) {
+                auto& cell = cells[x + y * latticeSize];
+                cell.absPos = {toFloat(x), toFloat(y)};
+                cell.vel = {0, 0};
+                cell.temp1 = {0, 0};
+                cell.energy = 100.0f;
+                cell.locked = 0;
+                cell.numConnections = 0;
+                if (x > 0) {
+                    cell.connections[cell.numConnections++] = {&cells[x - 1 + y * latticeSize], 1.0f, 0};
+                }
+                if (x < latticeSize - 1) {
+                    cell.connections[cell.numConnections++] = {&cells[x + 1 + y * latticeSize], 1.0f, 0};
+                }
+                if (y > 0) {
+                    cell.connections[cell.numConnections++] = {&cells[x + (y - 1) * latticeSize], 1.0f, 0};
+                }
+                if (y < latticeSize - 1) {
+                    cell.connections[cell.numConnections++] = {&cells[x + (y + 1) * latticeSize], 1.0f, 0};
+                }
+            }
+        }
+    }
+
+    //mimics calcForces and calcPositions: both passes only access hot fields
+    template <typename CellType>
+    double measurePhysicsPasses(ThreadPool& threadPool, std::vector<CellType>& cells, int numSteps)
+    {
+        auto numCells = static_cast<int>(cells.size());
+        auto startTime = std::chrono::steady_clock::now();
+        for (int step = 0; step < numSteps; ++step) {
+            threadPool.execute([&](ThreadContext const& context) {
+                auto partition = context.calcPartition(numCells);
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    auto& cell = cells[index];
+                    float2 force{0, 0};
+                    for (int i = 0; i < cell.numConnections; ++i) {
+                        auto const& connection = cell.connections[i];
+                        auto displacement = connection.cell->absPos - cell.absPos;
+                        auto distance = Math::length(displacement);
+                        if (distance > 0) {
+                            force = force + displacement * ((distance - connection.distance) * 0.1f / distance);
+                        }
+                    }
+                    cell.temp1 = force;
+                }
+            });
+            threadPool.execute([&](ThreadContext const& context) {
+                auto partition = context.calcPartition(numCells);
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    auto& cell = cells[index];
+                    cell.vel = cell.vel + cell.temp1;
+                    cell.absPos = cell.absPos + cell.vel;
+                }
+            });
+        }
+        auto duration = std::chrono::steady_clock::now() - startTime;
+        return std::chrono::duration<double, std::milli>(duration).count() / numSteps;
+    }
+
+    double measureSimulationSteps(int latticeSize, int numSteps)
+    {
+        auto numCells = latticeSize * latticeSize;
+
+        Settings settings;
+        settings.generalSettings.worldSizeX = latticeSize * 2;
+        settings.generalSettings.worldSizeY = latticeSize * 2;
+
+        std::vector<CellAccessTO> cellTOs(numCells);
+        for (int y = 0; y < latticeSize; ++y) {
+            for (int x = 0; x < latticeSize; ++x) {
+                auto& cellTO = cellTOs[x + y * latticeSize];
+                cellTO = CellAccessTO();
+                cellTO.pos = {toFloat(x) + toFloat(latticeSize) / 2, toFloat(y) + toFloat(latticeSize) / 2};
+                cellTO.energy = 100.0f;
+                cellTO.maxConnections = 4;
+                if (x < latticeSize - 1) {
+                    cellTO.connections[cellTO.numConnections++] = {x + 1 + y * latticeSize, 1.0f, 0};
+                }
+                if (x > 0) {
+                    cellTO.connections[cellTO.numConnections++] = {x - 1 + y * latticeSize, 1.0f, 180.0f};
+                }
+            }
+        }
+        int numParticles = 0;
+        int numTokens = 0;
+        int numStrings = 0;
+        int numStringBytes = 0;
+        DataAccessTO dataTO;
+        dataTO.numCells = &numCells;
+        dataTO.cells = cellTOs.data();
+        dataTO.numParticles = &numParticles;
+        dataTO.numTokens = &numTokens;
+        dataTO.numStrings = &numStrings;
+        dataTO.numStringBytes = &numStringBytes;
+
+        _CpuSimulation simulation(0, settings, GpuSettings(), EngineSettings());
+        simulation.resizeArraysIfNecessary({numCells, 0, 0});
+        simulation.setSimulationData(dataTO);
+
+        auto startTime = std::chrono::steady_clock::now();
+        for (int step = 0; step < numSteps; ++step) {
+            simulation.calcTimestep();
+        }
+        auto duration = std::chrono::steady_clock::now() - startTime;
+        return std::chrono::duration<double, std::milli>(duration).count() / numSteps;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BaseServices baseServices;
+
+    int latticeSize = argc > 1 ? std::stoi(argv[1]) : 1000;
+    int numSteps = argc > 2 ? std::stoi(argv[2]) : 100;
+    auto numCells = latticeSize * latticeSize;
+
+    Cpu::ThreadPool threadPool;
+
+    std::vector<InlineCell> inlineCells(numCells);
+    initLattice(inlineCells, latticeSize);
+    auto inlineDuration = measurePhysicsPasses(threadPool, inlineCells, numSteps);
+
+    std::vector<Cpu::Cell> hotCells(numCells);
+    initLattice(hotCells, latticeSize);
+    auto hotDuration = measurePhysicsPasses(threadPool, hotCells, numSteps);
+
+    auto inlineBytes = static_cast<double>(sizeof(InlineCell)) * numCells * 2;
+    auto hotBytes = static_cast<double>(sizeof(Cpu::Cell)) * numCells * 2;
+    std::cout << numCells << " cells, " << numSteps << " steps, " << threadPool.getNumThreads() << " threads"
+              << std::endl;
+    std::cout << "inline layout:   " << sizeof(InlineCell) << " bytes/cell, " << inlineBytes / (1024 * 1024)
+              << " MB/step, " << inlineDuration << " ms/step" << std::endl;
+    std::cout << "hot/cold layout: " << sizeof(Cpu::Cell) << " bytes/cell, " << hotBytes / (1024 * 1024)
+              << " MB/step, " << hotDuration << " ms/step" << std::endl;
+
+    std::cout << "complete CPU time step: " << measureSimulationSteps(latticeSize, numSteps) << " ms/step"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "EngineCpu/Array.h"
+#include "EngineCpu/Cell.h"
+#include "EngineCpu/Map.h"
+#include "EngineCpu/ThreadPool.h"
+
+//compares the exact cell list of CellMap with the former map which stored at most two cells per grid unit
+namespace
+{
+    using namespace Cpu;
+
+    class TwoSlotCellMap : public MapInfo
+    {
+    public:
+        void init(int2 const& size)
+        {
+            MapInfo::init(size);
+            _map.assign(size.x * size.y * 2, nullptr);
+        }
+
+        void set(Cpu::Cell* cell)
+        {
+            int2 posInt = {floorInt(cell->absPos.x), floorInt(cell->absPos.y)};
+            mapPosCorrection(posInt);
+            auto mapEntry = (posInt.x + posInt.y * _size.x) * 2;
+            auto old = atomicCAS(&_map[mapEntry], static_cast<Cpu::Cell*>(nullptr), cell);
+            if (old != nullptr) {
+                atomicExch(&_map[mapEntry + 1], cell);
+            }
+        }
+
+        template <typename Func>
+        void executeForEachInNeighborhood(float2 const& pos, Func const& func) const
+        {
+            int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    int2 scanPos{posInt.x + dx, posInt.y + dy};
+                    mapPosCorrection(scanPos);
+                    auto mapEntry = (scanPos.x + scanPos.y * _size.x) * 2;
+                    if (auto cell = _map[mapEntry]) {
+                        func(cell);
+                        if (auto cell2 = _map[mapEntry + 1]) {
+                            func(cell2);
+                        }
+                    }
+                }
+            }
+        }
+
+        void cleanup(Cpu::Cell* cell)
+        {
+            int2 posInt = {floorInt(cell->absPos.x), floorInt(cell->absPos.y)};
+            mapPosCorrection(posInt);
+            auto mapEntry = (posInt.x + posInt.y * _size.x) * 2;
+            _map[mapEntry] = nullptr;
+            _map[mapEntry + 1] = nullptr;
+        }
+
+    private:
+        std::vector<Cpu::Cell*> _map;
+    };
+
+    struct Result
+    {
+        double buildTime = 0;
+        double queryTime = 0;
+        uint64_t numNeighbors = 0;
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point const& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    template <typename Map>
+    uint64_t countNeighbors(ThreadPool& threadPool, Map const& map, Array<Cpu::Cell*>& cellPointers)
+    {
+        std::atomic<uint64_t> result{0};
+        threadPool.execute([&](ThreadContext const& context) {
+            uint64_t numNeighbors = 0;
+            auto partition = context.calcPartition(cellPointers.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& cell = cellPointers.at(index);
+                map.executeForEachInNeighborhood(cell->absPos, [&](Cpu::Cell* otherCell) {
+                    if (otherCell != cell && map.mapDistance(cell->absPos, otherCell->absPos) < 1.0f) {
+                        ++numNeighbors;
+                    }
+                });
+            }
+            result.fetch_add(numNeighbors);
+        });
+        return result.load();
+    }
+
+    Result measureTwoSlotMap(ThreadPool& threadPool, int2 const& worldSize, Array<Cpu::Cell*>& cellPointers, int numSteps)
+    {
+        TwoSlotCellMap map;
+        map.init(worldSize);
+
+        Result result;
+        for (int step = 0; step < numSteps; ++step) {
+            auto startTime = std::chrono::steady_clock::now();
+            threadPool.execute([&](ThreadContext const& context) {
+                auto partition = context.calcPartition(cellPointers.getNumEntries());
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    map.set(cellPointers.at(index));
+                }
+            });
+            result.buildTime += millisecondsSince(startTime);
+
+            startTime = std::chrono::steady_clock::now();
+            result.numNeighbors = countNeighbors(threadPool, map, cellPointers);
+            result.queryTime += millisecondsSince(startTime);
+
+            threadPool.execute([&](ThreadContext const& context) {
+                auto partition = context.calcPartition(cellPointers.getNumEntries());
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    map.cleanup(cellPointers.at(index));
+                }
+            });
+        }
+        result.buildTime /= numSteps;
+        result.queryTime /= numSteps;
+        return result;
+    }
+
+    Result measureCellList(ThreadPool& threadPool, int2 const& worldSize, Array<Cpu::Cell*>& cellPointers, int numSteps)
+    {
+        CellMap map;
+        map.init(worldSize);
+        map.resize(cellPointers.getSize());
+
+        Result result;
+        for (int step = 0; step < numSteps; ++step) {
+            map.reset();
+
+            auto startTime = std::chrono::steady_clock::now();
+            map.build(threadPool, cellPointers);
+            result.buildTime += millisecondsSince(startTime);
+
+            startTime = std::chrono::steady_clock::now();
+            result.numNeighbors = countNeighbors(threadPool, map, cellPointers);
+            result.queryTime += millisecondsSince(startTime);
+
+            threadPool.execute([&](ThreadContext const& context) { map.cleanup(context); });
+        }
+        result.buildTime /= numSteps;
+        result.queryTime /= numSteps;
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int worldSize = argc > 1 ? std::stoi(argv[1]) : 500;
+    int numSteps = argc > 2 ? std::stoi(argv[2]) : 3;
+
+    Cpu::ThreadPool threadPool;
+    std::mt19937 randomEngine(0);
+    std::uniform_real_distribution<float> distribution(0, static_cast<float>(worldSize));
+
+    std::cout << "world size " << worldSize << "x" << worldSize << ", " << threadPool.getNumThreads() << " threads"
+              << std::endl;
+    for (float density : {0.5f, 1.0f, 2.0f, 4.0f, 8.0f}) {
+        auto numCells = static_cast<int>(density * worldSize * worldSize);
+
+        std::vector<Cpu::Cell> cells(numCells);
+        Array<Cpu::Cell*> cellPointers;
+        cellPointers.resize(numCells);
+        auto pointers = cellPointers.getNewSubarray(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            cells[i].absPos = {distribution(randomEngine), distribution(randomEngine)};
+            pointers[i] = &cells[i];
+        }
+
+        auto twoSlotResult = measureTwoSlotMap(threadPool, {worldSize, worldSize}, cellPointers, numSteps);
+        auto cellListResult = measureCellList(threadPool, {worldSize, worldSize}, cellPointers, numSteps);
+
+        auto lostNeighbors = cellListResult.numNeighbors > 0
+            ? 100.0 * (cellListResult.numNeighbors - twoSlotResult.numNeighbors) / cellListResult.numNeighbors
+            : 0.0;
+        std::cout << "density " << density << " cells/unit^2 (" << numCells << " cells)" << std::endl;
+        std::cout << "  two-slot map: build " << twoSlotResult.buildTime << " ms, query " << twoSlotResult.queryTime
+                  << " ms, " << twoSlotResult.numNeighbors << " neighbors (" << lostNeighbors << "% lost)"
+                  << std::endl;
+        std::cout << "  cell list:    build " << cellListResult.buildTime << " ms, query " << cellListResult.queryTime
+                  << " ms, " << cellListResult.numNeighbors << " neighbors" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Base/BaseServices.h"
+#include "Base/NumberGenerator.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineImpl/DataConverter.h"
+#include "EngineInterface/Descriptions.h"
+
+//compares the union-find based cluster reconstruction of DataConverter with the former breadth-first search which
+//used hash sets for the visited and remaining cells, the resulting clusters are compared as sets of cells
+namespace
+{
+    class LegacyClusterConverter
+    {
+    public:
+        DataDescription convert(DataAccessTO const& dataTO) const
+        {
+            DataDescription result;
+            std::vector<ClusterDescription> clusters;
+            std::unordered_set<int> freeCellIndices;
+            for (int i = 0; i < *dataTO.numCells; ++i) {
+                freeCellIndices.insert(i);
+            }
+            std::unordered_map<int, int> cellTOIndexToCellDescIndex;
+            std::unordered_map<int, int> cellTOIndexToClusterDescIndex;
+            int clusterDescIndex = 0;
+            while (!freeCellIndices.empty()) {
+                std::unordered_map<int, int> clusterCellIndices;
+                clusters.emplace_back(
+                    scanCluster(dataTO, *freeCellIndices.begin(), freeCellIndices, clusterCellIndices));
+                cellTOIndexToCellDescIndex.insert(clusterCellIndices.begin(), clusterCellIndices.end());
+                for (auto const& [cellTOIndex, cellDescIndex] : clusterCellIndices) {
+                    cellTOIndexToClusterDescIndex.emplace(cellTOIndex, clusterDescIndex);
+                }
+                ++clusterDescIndex;
+            }
+            result.addClusters(clusters);
+            return result;
+        }
+
+    private:
+        ClusterDescription scanCluster(
+            DataAccessTO const& dataTO,
+            int startCellIndex,
+            std::unordered_set<int>& freeCellIndices,
+            std::unordered_map<int, int>& cellTOIndexToCellDescIndex) const
+        {
+            std::unordered_set<int> currentCellIndices{startCellIndex};
+            std::unordered_set<int> scannedCellIndices = currentCellIndices;
+            std::vector<CellDescription> cells;
+            std::unordered_set<int> nextCellIndices;
+            int cellDescIndex = 0;
+            do {
+                for (auto const& currentCellIndex : currentCellIndices) {
+                    cells.emplace_back(createCellDescription(dataTO, currentCellIndex));
+                    cellTOIndexToCellDescIndex.emplace(currentCellIndex, cellDescIndex);
+                    auto const& cellTO = dataTO.cells[currentCellIndex];
+                    for (int i = 0; i < cellTO.numConnections; ++i) {
+                        auto connectionTO = cellTO.connections[i];
+                        if (scannedCellIndices.find(connectionTO.cellIndex) == scannedCellIndices.end()) {
+                            nextCellIndices.insert(connectionTO.cellIndex);
+                            scannedCellIndices.insert(connectionTO.cellIndex);
+                        }
+                    }
+                    ++cellDescIndex;
+                }
+                currentCellIndices = nextCellIndices;
+                nextCellIndices.clear();
+            } while (!currentCellIndices.empty());
+
+            for (auto const& element : scannedCellIndices) {
+                freeCellIndices.erase(element);
+            }
+            ClusterDescription result;
+            result.id = NumberGenerator::getInstance().getId();
+            result.addCells(cells);
+            return result;
+        }
+
+        CellDescription createCellDescription(DataAccessTO const& dataTO, int cellIndex) const
+        {
+            CellDescription result;
+            auto const& cellTO = dataTO.cells[cellIndex];
+            result.id = cellTO.id;
+            result.pos = RealVector2D(cellTO.pos.x, cellTO.pos.y);
+            result.vel = RealVector2D(cellTO.vel.x, cellTO.vel.y);
+            result.energy = cellTO.energy;
+            result.maxConnections = cellTO.maxConnections;
+            std::vector<ConnectionDescription> connections;
+            for (int i = 0; i < cellTO.numConnections; ++i) {
+                auto const& connectionTO = cellTO.connections[i];
+                ConnectionDescription connection;
+                connection.cellId = dataTO.cells[connectionTO.cellIndex].id;
+                connection.distance = connectionTO.distance;
+                connection.angleFromPrevious = connectionTO.angleFromPrevious;
+                connections.emplace_back(connection);
+            }
+            result.connections = connections;
+            result.tokenBlocked = cellTO.tokenBlocked;
+            result.tokenBranchNumber = cellTO.branchNumber;
+            result.metadata = CellMetadata().setColor(cellTO.metadata.color);
+            result.cellFeature = CellFeatureDescription()
+                                     .setType(static_cast<Enums::CellFunction::Type>(cellTO.cellFunctionType))
+                                     .setConstData(std::string(cellTO.staticData, cellTO.numStaticBytes))
+                                     .setVolatileData(std::string(cellTO.mutableData, cellTO.numMutableBytes));
+            result.tokenUsages = cellTO.tokenUsages;
+            return result;
+        }
+    };
+
+    //clusters of random size consisting of a chain with additional random bonds, the cells are stored in random order
+    std::vector<CellAccessTO> createCells(int numCells, std::mt19937& randomEngine)
+    {
+        std::vector<int> cellTOIndices(numCells);
+        std::iota(cellTOIndices.begin(), cellTOIndices.end(), 0);
+        std::shuffle(cellTOIndices.begin(), cellTOIndices.end(), randomEngine);
+
+        std::vector<CellAccessTO> result(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            result[i] = CellAccessTO();
+            result[i].id = i + 1;
+            result[i].pos = {static_cast<float>(i % 1000), static_cast<float>(i / 1000)};
+            result[i].energy = 100.0f;
+            result[i].maxConnections = MAX_CELL_BONDS;
+        }
+        auto connect = [&](int index1, int index2) {
+            auto& cell1 = result[index1];
+            auto& cell2 = result[index2];
+            if (cell1.numConnections < MAX_CELL_BONDS && cell2.numConnections < MAX_CELL_BONDS) {
+                cell1.connections[cell1.numConnections++] = {index2, 1.0f, 0};
+                cell2.connections[cell2.numConnections++] = {index1, 1.0f, 0};
+            }
+        };
+        std::uniform_int_distribution<int> clusterSizeDistribution(1, 64);
+        for (int clusterStart = 0; clusterStart < numCells;) {
+            auto clusterEnd = std::min(clusterStart + clusterSizeDistribution(randomEngine), numCells);
+            std::uniform_int_distribution<int> cellDistribution(clusterStart, clusterEnd - 1);
+            for (int i = clusterStart + 1; i < clusterEnd; ++i) {
+                connect(cellTOIndices[i - 1], cellTOIndices[i]);
+            }
+            for (int i = 0; i < (clusterEnd - clusterStart) / 4; ++i) {
+                auto index1 = cellDistribution(randomEngine);
+                auto index2 = cellDistribution(randomEngine);
+                if (std::abs(index1 - index2) > 1) {
+                    connect(cellTOIndices[index1], cellTOIndices[index2]);
+                }
+            }
+            clusterStart = clusterEnd;
+        }
+        return result;
+    }
+
+    //the order of the clusters and of the cells within a cluster depends on the scan and is therefore not compared
+    using ClusterSet = std::set<std::set<uint64_t>>;
+    using ConnectionSet = std::set<std::pair<uint64_t, uint64_t>>;
+
+    ClusterSet calcClusterSet(DataDescription const& data, ConnectionSet& connections)
+    {
+        ClusterSet result;
+        for (auto const& cluster : data.clusters) {
+            std::set<uint64_t> cellIds;
+            for (auto const& cell : cluster.cells) {
+                cellIds.insert(cell.id);
+                for (auto const& connection : cell.connections) {
+                    connections.emplace(cell.id, connection.cellId);
+                }
+            }
+            result.insert(cellIds);
+        }
+        return result;
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point const& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BaseServices baseServices;
+
+    int maxNumCells = argc > 1 ? std::stoi(argv[1]) : 2000000;
+
+    std::mt19937 randomEngine(0);
+    for (int numCells = 250000; numCells <= maxNumCells; numCells *= 2) {
+        auto cells = createCells(numCells, randomEngine);
+        int numParticles = 0;
+        int numTokens = 0;
+        int numStrings = 0;
+        int numStringBytes = 0;
+        DataAccessTO dataTO;
+        dataTO.numCells = &numCells;
+        dataTO.cells = cells.data();
+        dataTO.numParticles = &numParticles;
+        dataTO.numTokens = &numTokens;
+        dataTO.numStrings = &numStrings;
+        dataTO.numStringBytes = &numStringBytes;
+
+        auto startTime = std::chrono::steady_clock::now();
+        auto legacyData = LegacyClusterConverter().convert(dataTO);
+        auto legacyTime = millisecondsSince(startTime);
+
+        startTime = std::chrono::steady_clock::now();
+        auto data = DataConverter(SimulationParameters(), GpuSettings()).convertAccessTOtoDataDescription(dataTO);
+        auto time = millisecondsSince(startTime);
+
+        ConnectionSet legacyConnections;
+        ConnectionSet connections;
+        auto identical = calcClusterSet(legacyData, legacyConnections) == calcClusterSet(data, connections)
+            && legacyConnections == connections;
+
+        std::cout << numCells << " cells, " << data.clusters.size() << " clusters: breadth-first search "
+                  << legacyTime << " ms, union-find " << time << " ms, speedup " << legacyTime / time
+                  << (identical ? ", identical clusters" : ", DIFFERENT clusters") << std::endl;
+    }
+    return 0;
+}
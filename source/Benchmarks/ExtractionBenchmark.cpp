@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Base/BaseServices.h"
+#include "EngineCpu/CpuSimulation.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineInterface/Settings.h"
+
+//measures the latency of viewport extraction depending on the viewport area at fixed world size
+namespace
+{
+    struct AccessBuffers
+    {
+        std::vector<CellAccessTO> cells;
+        std::vector<ParticleAccessTO> particles;
+        std::vector<TokenAccessTO> tokens;
+        std::vector<StringAccessTO> strings;
+        std::vector<char> stringBytes;
+        int numCells = 0;
+        int numParticles = 0;
+        int numTokens = 0;
+        int numStrings = 0;
+        int numStringBytes = 0;
+
+        DataAccessTO getAccessTO()
+        {
+            DataAccessTO result;
+            result.numCells = &numCells;
+            result.cells = cells.data();
+            result.numParticles = &numParticles;
+            result.particles = particles.data();
+            result.numTokens = &numTokens;
+            result.tokens = tokens.data();
+            result.numStrings = &numStrings;
+            result.strings = strings.data();
+            result.numStringBytes = &numStringBytes;
+            result.stringBytes = stringBytes.data();
+            return result;
+        }
+    };
+
+    double millisecondsSince(std::chrono::steady_clock::time_point const& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BaseServices baseServices;
+
+    int worldSize = argc > 1 ? std::stoi(argv[1]) : 2000;
+    int numEntities = argc > 2 ? std::stoi(argv[2]) : 1000000;
+    int numRepetitions = argc > 3 ? std::stoi(argv[3]) : 10;
+
+    std::mt19937 randomEngine(0);
+    std::uniform_real_distribution<float> distribution(0, static_cast<float>(worldSize));
+
+    AccessBuffers inputBuffers;
+    inputBuffers.cells.resize(numEntities);
+    inputBuffers.particles.resize(numEntities);
+    for (auto& cellTO : inputBuffers.cells) {
+        cellTO = CellAccessTO();
+        cellTO.pos = {distribution(randomEngine), distribution(randomEngine)};
+        cellTO.energy = 100.0f;
+    }
+    for (auto& particleTO : inputBuffers.particles) {
+        particleTO = ParticleAccessTO();
+        particleTO.pos = {distribution(randomEngine), distribution(randomEngine)};
+        particleTO.energy = 10.0f;
+    }
+    inputBuffers.numCells = numEntities;
+    inputBuffers.numParticles = numEntities;
+
+    Settings settings;
+    settings.generalSettings.worldSizeX = worldSize;
+    settings.generalSettings.worldSizeY = worldSize;
+    _CpuSimulation simulation(0, settings, GpuSettings(), EngineSettings());
+    simulation.resizeArraysIfNecessary({numEntities, numEntities, 0});
+    simulation.setSimulationData(inputBuffers.getAccessTO());
+    simulation.calcTimestep();
+
+    //particles may fuse to cells during the time step
+    AccessBuffers buffers;
+    buffers.cells.resize(numEntities * 2);
+    buffers.particles.resize(numEntities * 2);
+
+    std::vector<OverlayElementAccessTO> overlayElements(numEntities * 2);
+    int numOverlayElements = 0;
+    OverlayAccessTO overlayTO;
+    overlayTO.numElements = &numOverlayElements;
+    overlayTO.elements = overlayElements.data();
+    overlayTO.maxElements = static_cast<int>(overlayElements.size());
+
+    double buildTime = 0;
+    for (auto const& statistics : simulation.getStageStatistics()) {
+        if (statistics.name == "buildTileIndices") {
+            buildTime = statistics.meanTime;
+        }
+    }
+    std::cout << "world size " << worldSize << "x" << worldSize << ", " << numEntities << " cells, " << numEntities
+              << " particles, tile index build " << buildTime << " ms" << std::endl;
+
+    for (int viewportSize = 32; viewportSize < worldSize * 2; viewportSize *= 2) {
+        viewportSize = std::min(viewportSize, worldSize);
+        int2 rectUpperLeft{(worldSize - viewportSize) / 2, (worldSize - viewportSize) / 2};
+        int2 rectLowerRight{rectUpperLeft.x + viewportSize, rectUpperLeft.y + viewportSize};
+
+        double dataTime = 0;
+        double overlayTime = 0;
+        for (int i = 0; i < numRepetitions; ++i) {
+            auto startTime = std::chrono::steady_clock::now();
+            simulation.getSimulationData(rectUpperLeft, rectLowerRight, buffers.getAccessTO());
+            dataTime += millisecondsSince(startTime);
+
+            startTime = std::chrono::steady_clock::now();
+            simulation.getOverlayData(rectUpperLeft, rectLowerRight, overlayTO);
+            overlayTime += millisecondsSince(startTime);
+        }
+        simulation.getSimulationData(rectUpperLeft, rectLowerRight, buffers.getAccessTO());
+
+        auto areaFraction = 100.0 * viewportSize * viewportSize / (static_cast<double>(worldSize) * worldSize);
+        std::cout << "viewport " << viewportSize << "x" << viewportSize << " (" << areaFraction << "% of world): "
+                  << buffers.numCells << " cells, " << buffers.numParticles << " particles, data "
+                  << dataTime / numRepetitions << " ms, overlay " << overlayTime / numRepetitions << " ms"
+                  << std::endl;
+        if (viewportSize == worldSize) {
+            break;
+        }
+    }
+    return 0;
+}
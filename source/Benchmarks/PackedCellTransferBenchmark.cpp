@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cuda_runtime.h>
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineGpuKernels/CellAccessTOPacking.cuh"
+
+//compares the bytes copied per round trip of the cells with fixed size records and with packed records of variable
+//length, the copies between host and device are only measured if a CUDA device is present
+namespace
+{
+    //mostly bonded cells, only a part of them has a cell function with static or mutable data
+    std::vector<CellAccessTO> createCells(int numCells, std::mt19937& randomEngine)
+    {
+        std::uniform_int_distribution<int> connectionDistribution(0, MAX_CELL_BONDS / 2);
+        std::uniform_int_distribution<int> percentDistribution(0, 99);
+        std::uniform_int_distribution<int> staticBytesDistribution(1, MAX_CELL_STATIC_BYTES);
+        std::uniform_int_distribution<int> mutableBytesDistribution(1, MAX_CELL_MUTABLE_BYTES);
+        std::uniform_int_distribution<int> byteDistribution(0, 255);
+        std::uniform_int_distribution<int> cellDistribution(0, numCells - 1);
+
+        std::vector<CellAccessTO> result(numCells);
+        for (int i = 0; i < numCells; ++i) {
+            auto& cellTO = result[i];
+            cellTO = CellAccessTO();
+            cellTO.id = i + 1;
+            cellTO.pos = {static_cast<float>(i % 1000), static_cast<float>(i / 1000)};
+            cellTO.energy = 100.0f;
+            cellTO.maxConnections = MAX_CELL_BONDS;
+            cellTO.numConnections = connectionDistribution(randomEngine);
+            for (int j = 0; j < cellTO.numConnections; ++j) {
+                cellTO.connections[j] = {cellDistribution(randomEngine), 1.0f, 120.0f};
+            }
+            if (percentDistribution(randomEngine) < 20) {
+                cellTO.cellFunctionType = 1;
+                cellTO.numStaticBytes = static_cast<unsigned char>(staticBytesDistribution(randomEngine));
+                cellTO.numMutableBytes = static_cast<unsigned char>(mutableBytesDistribution(randomEngine));
+                for (int j = 0; j < cellTO.numStaticBytes; ++j) {
+                    cellTO.staticData[j] = static_cast<char>(byteDistribution(randomEngine));
+                }
+                for (int j = 0; j < cellTO.numMutableBytes; ++j) {
+                    cellTO.mutableData[j] = static_cast<char>(byteDistribution(randomEngine));
+                }
+            }
+        }
+        return result;
+    }
+
+    bool isEqual(CellAccessTO const& cellTO, CellAccessTO const& otherTO)
+    {
+        if (cellTO.id != otherTO.id || cellTO.pos.x != otherTO.pos.x || cellTO.pos.y != otherTO.pos.y
+            || cellTO.vel.x != otherTO.vel.x || cellTO.vel.y != otherTO.vel.y || cellTO.energy != otherTO.energy
+            || cellTO.maxConnections != otherTO.maxConnections || cellTO.numConnections != otherTO.numConnections
+            || cellTO.branchNumber != otherTO.branchNumber || cellTO.tokenBlocked != otherTO.tokenBlocked
+            || cellTO.cellFunctionType != otherTO.cellFunctionType || cellTO.numStaticBytes != otherTO.numStaticBytes
+            || cellTO.numMutableBytes != otherTO.numMutableBytes || cellTO.tokenUsages != otherTO.tokenUsages
+            || cellTO.metadata.color != otherTO.metadata.color
+            || cellTO.metadata.nameStringIndex != otherTO.metadata.nameStringIndex
+            || cellTO.metadata.descriptionStringIndex != otherTO.metadata.descriptionStringIndex
+            || cellTO.metadata.sourceCodeStringIndex != otherTO.metadata.sourceCodeStringIndex) {
+            return false;
+        }
+        for (int i = 0; i < cellTO.numConnections; ++i) {
+            auto const& connection = cellTO.connections[i];
+            auto const& otherConnection = otherTO.connections[i];
+            if (connection.cellIndex != otherConnection.cellIndex || connection.distance != otherConnection.distance
+                || connection.angleFromPrevious != otherConnection.angleFromPrevious) {
+                return false;
+            }
+        }
+        return 0 == memcmp(cellTO.staticData, otherTO.staticData, cellTO.numStaticBytes)
+            && 0 == memcmp(cellTO.mutableData, otherTO.mutableData, cellTO.numMutableBytes);
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point const& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    //host to device and back
+    double measureDeviceRoundTrip(void* hostBuffer, void* deviceBuffer, size_t numBytes)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        cudaMemcpy(deviceBuffer, hostBuffer, numBytes, cudaMemcpyHostToDevice);
+        cudaMemcpy(hostBuffer, deviceBuffer, numBytes, cudaMemcpyDeviceToHost);
+        return millisecondsSince(startTime);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int maxNumCells = argc > 1 ? std::stoi(argv[1]) : 2000000;
+
+    int numDevices = 0;
+    auto hasDevice = cudaSuccess == cudaGetDeviceCount(&numDevices) && numDevices > 0;
+
+    std::mt19937 randomEngine(0);
+    for (int numCells = 250000; numCells <= maxNumCells; numCells *= 2) {
+        auto cells = createCells(numCells, randomEngine);
+
+        std::vector<unsigned long long int> offsets(numCells);
+        std::vector<CellAccessTO> unpackedCells(numCells);
+
+        auto startTime = std::chrono::steady_clock::now();
+        auto numPackedBytes = calcPackedCellOffsets_host(cells.data(), numCells, offsets.data());
+        std::vector<char> bytes(numPackedBytes);
+        packCells_host(cells.data(), numCells, offsets.data(), bytes.data());
+        auto packDuration = millisecondsSince(startTime);
+
+        startTime = std::chrono::steady_clock::now();
+        unpackCells_host(bytes.data(), offsets.data(), numCells, unpackedCells.data());
+        auto unpackDuration = millisecondsSince(startTime);
+
+        for (int i = 0; i < numCells; ++i) {
+            if (!isEqual(cells[i], unpackedCells[i])) {
+                std::cerr << "round trip mismatch at cell " << i << std::endl;
+                return 1;
+            }
+        }
+
+        auto fixedBytes = 2 * sizeof(CellAccessTO) * static_cast<size_t>(numCells);
+        auto packedBytes = 2 * (static_cast<size_t>(numPackedBytes) + sizeof(unsigned long long int) * numCells);
+        std::cout << numCells << " cells: " << fixedBytes / (1024 * 1024) << " MB fixed vs "
+                  << packedBytes / (1024 * 1024) << " MB packed per round trip ("
+                  << 100.0 * static_cast<double>(packedBytes) / static_cast<double>(fixedBytes)
+                  << "%), pack " << packDuration << " ms, unpack " << unpackDuration << " ms";
+
+        if (hasDevice) {
+            void* deviceBuffer;
+            cudaMalloc(&deviceBuffer, sizeof(CellAccessTO) * numCells);
+            auto fixedDuration = measureDeviceRoundTrip(cells.data(), deviceBuffer, fixedBytes / 2);
+            auto packedDuration = measureDeviceRoundTrip(bytes.data(), deviceBuffer, numPackedBytes)
+                + measureDeviceRoundTrip(offsets.data(), deviceBuffer, sizeof(unsigned long long int) * numCells);
+            cudaFree(deviceBuffer);
+            std::cout << ", device copies " << fixedDuration << " ms fixed vs " << packedDuration << " ms packed";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
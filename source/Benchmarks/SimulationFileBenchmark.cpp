@@ -0,0 +1,159 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Base/BaseServices.h"
+#include "EngineInterface/Descriptions.h"
+#include "EngineInterface/Serializer.h"
+
+//compares save time, load time and file size of the former format with the chunked format with and without block
+//compression, a simulation file can be passed as argument, otherwise a world is generated
+namespace
+{
+    auto const NumClustersPerChunk = 1000;
+
+    //clusters of bonded cells with cell functions, programs and tokens in a world with energy particles
+    DataDescription createWorld(int numCells, std::mt19937& randomEngine)
+    {
+        std::uniform_real_distribution<float> posDistribution(0, 2000.0f);
+        std::normal_distribution<float> velDistribution(0, 0.1f);
+        std::uniform_real_distribution<float> energyDistribution(50.0f, 150.0f);
+        std::uniform_int_distribution<int> clusterSizeDistribution(1, 40);
+        std::uniform_int_distribution<int> percentDistribution(0, 99);
+        std::uniform_int_distribution<int> cellFunctionDistribution(0, Enums::CellFunction::_COUNTER - 1);
+        std::uniform_int_distribution<int> byteDistribution(0, 255);
+
+        DataDescription result;
+        uint64_t id = 1;
+        for (int cellIndex = 0; cellIndex < numCells;) {
+            auto clusterSize = std::min(clusterSizeDistribution(randomEngine), numCells - cellIndex);
+            RealVector2D clusterPos{posDistribution(randomEngine), posDistribution(randomEngine)};
+            RealVector2D clusterVel{velDistribution(randomEngine), velDistribution(randomEngine)};
+            ClusterDescription cluster;
+            for (int i = 0; i < clusterSize; ++i) {
+                CellDescription cell;
+                cell.setId(id)
+                    .setPos({clusterPos.x + toFloat(i), clusterPos.y + velDistribution(randomEngine)})
+                    .setVel(clusterVel)
+                    .setEnergy(energyDistribution(randomEngine))
+                    .setMaxConnections(4)
+                    .setTokenBranchNumber(i % 6);
+                if (i > 0) {
+                    cell.connections.emplace_back(ConnectionDescription{id - 1, 1.0f, 0});
+                }
+                if (i < clusterSize - 1) {
+                    cell.connections.emplace_back(ConnectionDescription{id + 1, 1.0f, 180.0f});
+                }
+                auto cellFunction = static_cast<Enums::CellFunction::Type>(cellFunctionDistribution(randomEngine));
+                std::string staticData;
+                if (Enums::CellFunction::COMPUTER == cellFunction) {
+                    for (int j = 0; j < 48; ++j) {
+                        staticData.push_back(static_cast<char>(byteDistribution(randomEngine)));
+                    }
+                }
+                cell.cellFeature = CellFeatureDescription()
+                                       .setType(cellFunction)
+                                       .setConstData(staticData)
+                                       .setVolatileData(std::string(8, 0));
+                if (percentDistribution(randomEngine) < 5) {
+                    cell.addToken(TokenDescription().setEnergy(60.0f).setData(std::string(256, 0)));
+                }
+                cluster.addCell(cell);
+                ++id;
+            }
+            result.addCluster(cluster);
+            cellIndex += clusterSize;
+        }
+        for (int i = 0; i < numCells / 4; ++i) {
+            result.addParticle(ParticleDescription()
+                                   .setId(id++)
+                                   .setPos({posDistribution(randomEngine), posDistribution(randomEngine)})
+                                   .setVel({velDistribution(randomEngine), velDistribution(randomEngine)})
+                                   .setEnergy(energyDistribution(randomEngine)));
+        }
+        return result;
+    }
+
+    void exportInChunks(DataDescription const& data, DataChunkSink const& sink)
+    {
+        for (size_t clusterIndex = 0; clusterIndex < data.clusters.size(); clusterIndex += NumClustersPerChunk) {
+            DataDescription chunk;
+            auto clusterEndIndex = std::min(clusterIndex + NumClustersPerChunk, data.clusters.size());
+            chunk.clusters.assign(data.clusters.begin() + clusterIndex, data.clusters.begin() + clusterEndIndex);
+            sink(chunk);
+        }
+        DataDescription particleChunk;
+        particleChunk.particles = data.particles;
+        sink(particleChunk);
+    }
+
+    double millisecondsSince(std::chrono::steady_clock::time_point const& startTime)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    void printResult(
+        std::string const& format,
+        std::string const& filename,
+        double saveDuration,
+        double loadDuration,
+        int numLoadedCells)
+    {
+        std::cout << format << ": " << std::filesystem::file_size(filename) / (1024 * 1024) << " MB, save "
+                  << saveDuration << " ms, load " << loadDuration << " ms, " << numLoadedCells << " cells"
+                  << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BaseServices baseServices;
+
+    DeserializedSimulation sim;
+    Serializer serializer = boost::make_shared<_Serializer>();
+    if (argc > 1) {
+        if (!serializer->deserializeSimulationFromFile(argv[1], sim)) {
+            std::cerr << "Simulation " << argv[1] << " could not be read." << std::endl;
+            return 1;
+        }
+    } else {
+        std::mt19937 randomEngine(0);
+        sim.content = createWorld(2000000, randomEngine);
+    }
+    auto directory = std::filesystem::temp_directory_path();
+    auto countCells = [](int& numCells) {
+        return [&numCells](DataDescription const& chunk) {
+            for (auto const& cluster : chunk.clusters) {
+                numCells += toInt(cluster.cells.size());
+            }
+        };
+    };
+
+    {
+        auto filename = (directory / "alien_benchmark_former.sim").string();
+        auto startTime = std::chrono::steady_clock::now();
+        serializer->serializeSimulationToFile(filename, sim);
+        auto saveDuration = millisecondsSince(startTime);
+
+        int numCells = 0;
+        startTime = std::chrono::steady_clock::now();
+        serializer->deserializeDataChunksFromFile(filename, countCells(numCells));
+        printResult("former format", filename, saveDuration, millisecondsSince(startTime), numCells);
+    }
+    for (auto compress : {false, true}) {
+        auto filename = (directory / "alien_benchmark_chunked.sim").string();
+        auto startTime = std::chrono::steady_clock::now();
+        serializer->serializeSimulationToChunkedFile(
+            filename, sim, [&](DataChunkSink const& sink) { exportInChunks(sim.content, sink); }, compress);
+        auto saveDuration = millisecondsSince(startTime);
+
+        int numCells = 0;
+        startTime = std::chrono::steady_clock::now();
+        serializer->deserializeDataChunksFromFile(filename, countCells(numCells));
+        auto format = compress ? "chunked, compressed" : "chunked";
+        printResult(format, filename, saveDuration, millisecondsSince(startTime), numCells);
+    }
+    return 0;
+}
@@ -0,0 +1,276 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "Base/BaseServices.h"
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
+#include "EngineImpl/SimulationController.h"
+#include "EngineInterface/Serializer.h"
+#include "EngineInterface/ChangeDescriptions.h"
+#include "EngineInterface/RecordingFile.h"
+
+namespace
+{
+    //bounds the host memory for the world data while writing checkpoints
+    auto const ExportTileSize = 500;
+
+    auto const SnapshotFileExtension = ".snapshot";
+    auto const RecordingFileExtension = ".recording";
+
+    struct Arguments
+    {
+        string inputFilename;
+        uint64_t timesteps = 0;
+        uint64_t statisticsInterval = 1000;
+        uint64_t checkpointInterval = 0;  //0 = no checkpoints
+        int recordingInterval = 0;        //0 = no recording
+        boost::optional<uint64_t> recordedTimestep;  //of a recording as input, none = last one
+        bool exportRecording = false;
+        string outputPrefix = "alien";
+        ComputeBackend backend = ComputeBackend::Cuda;
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: alien-cli -i <simulation file> -t <time steps> [options]" << std::endl
+                  << "  -s <interval>  write statistics every <interval> time steps (default: 1000)" << std::endl
+                  << "  -c <interval>  write a checkpoint every <interval> time steps (default: none)" << std::endl
+                  << "  -o <prefix>    prefix of the output files (default: alien)" << std::endl
+                  << "  -r <interval>  record every <interval> time steps into <prefix>.recording" << std::endl
+                  << "  -a <step>      start from the state at time step <step> if the input is a recording"
+                  << " (default: last)" << std::endl
+                  << "  -e             export the states of the input recording from -a on as <prefix>_<time step>.sim"
+                  << std::endl
+                  << "  --cpu          use the CPU backend instead of CUDA" << std::endl;
+    }
+
+    boost::optional<Arguments> parseArguments(int argc, char** argv)
+    {
+        Arguments result;
+        for (int i = 1; i < argc; ++i) {
+            string argument = argv[i];
+            if (argument == "--cpu") {
+                result.backend = ComputeBackend::Cpu;
+                continue;
+            }
+            if (argument == "-e") {
+                result.exportRecording = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                return boost::none;
+            }
+            string value = argv[++i];
+            if (argument == "-i") {
+                result.inputFilename = value;
+            } else if (argument == "-t") {
+                result.timesteps = std::stoull(value);
+            } else if (argument == "-s") {
+                result.statisticsInterval = std::stoull(value);
+            } else if (argument == "-c") {
+                result.checkpointInterval = std::stoull(value);
+            } else if (argument == "-o") {
+                result.outputPrefix = value;
+            } else if (argument == "-r") {
+                result.recordingInterval = std::stoi(value);
+            } else if (argument == "-a") {
+                result.recordedTimestep = std::stoull(value);
+            } else {
+                return boost::none;
+            }
+        }
+        if (result.inputFilename.empty() || result.statisticsInterval == 0 || result.recordingInterval < 0) {
+            return boost::none;
+        }
+        if (result.timesteps == 0 && !result.exportRecording) {
+            return boost::none;
+        }
+        return result;
+    }
+
+    class ConsoleLogger : public LoggingCallBack
+    {
+    public:
+        ConsoleLogger()
+        {
+            auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+            loggingService->registerCallBack(this);
+        }
+
+        ~ConsoleLogger()
+        {
+            auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+            loggingService->unregisterCallBack(this);
+        }
+
+        void newLogMessage(Priority priority, std::string const& message) override
+        {
+            if (Priority::Important == priority) {
+                std::cerr << message << std::endl;
+            }
+        }
+    };
+
+    void writeStatisticsHeader(std::ostream& stream)
+    {
+        stream << "time step,cells,particles,tokens,internal energy,created cells,successful attacks,failed "
+                  "attacks,muscle activities,tps"
+               << std::endl;
+    }
+
+    void writeStatistics(std::ostream& stream, OverallStatistics const& statistics, double tps)
+    {
+        stream << statistics.timeStep << "," << statistics.numCells << "," << statistics.numParticles << ","
+               << statistics.numTokens << "," << statistics.totalInternalEnergy << "," << statistics.numCreatedCells
+               << "," << statistics.numSuccessfulAttacks << "," << statistics.numFailedAttacks << ","
+               << statistics.numMuscleActivities << "," << tps << std::endl;
+    }
+
+    void writeCheckpoint(SimulationController const& simController, string const& filename)
+    {
+        DeserializedSimulation sim;
+        sim.timestep = simController->getCurrentTimestep();
+        sim.settings = simController->getSettings();
+        sim.symbolMap = simController->getSymbolMap();
+
+        Serializer serializer = boost::make_shared<_Serializer>();
+        auto exportChunks = [&](DataChunkSink const& sink) {
+            simController->exportSimulationData(ExportTileSize, sink);
+        };
+        if (!serializer->serializeSimulationToChunkedFile(filename, sim, exportChunks)) {
+            throw std::runtime_error("Checkpoint " + filename + " could not be written.");
+        }
+    }
+
+    //writes the recorded states as simulation files without simulating, e.g. for rendering them elsewhere
+    void exportRecordedStates(Arguments const& arguments, DeserializedSimulation const& deserializedData)
+    {
+        _RecordingReader reader(arguments.inputFilename);
+        Serializer serializer = boost::make_shared<_Serializer>();
+        for (auto const& timestep : reader.getTimesteps()) {
+            if (arguments.recordedTimestep && timestep < *arguments.recordedTimestep) {
+                continue;
+            }
+            DeserializedSimulation sim = deserializedData;
+            sim.timestep = reader.seek(timestep);
+            sim.content = reader.getData();
+            auto filename = arguments.outputPrefix + "_" + std::to_string(timestep) + ".sim";
+            if (!serializer->serializeSimulationToFile(filename, sim)) {
+                throw std::runtime_error("Simulation " + filename + " could not be written.");
+            }
+            std::cout << "exported time step " << timestep << std::endl;
+        }
+    }
+}
+
+//runs a simulation without any window or rendering, e.g. for batch jobs on headless servers
+int main(int argc, char** argv)
+{
+    auto arguments = parseArguments(argc, argv);
+    if (!arguments) {
+        printUsage();
+        return 1;
+    }
+
+    BaseServices baseServices;
+    ConsoleLogger logger;
+
+    SimulationController simController;
+    try {
+        Serializer serializer = boost::make_shared<_Serializer>();
+        DeserializedSimulation deserializedData;
+        if (!serializer->deserializeSettingsFromFile(arguments->inputFilename, deserializedData)) {
+            throw std::runtime_error("Simulation " + arguments->inputFilename + " could not be read.");
+        }
+        auto inputExtension = std::filesystem::path(arguments->inputFilename).extension();
+        if (arguments->exportRecording) {
+            if (inputExtension != RecordingFileExtension) {
+                throw std::runtime_error("Only recordings can be exported.");
+            }
+            exportRecordedStates(*arguments, deserializedData);
+            return 0;
+        }
+
+        simController = boost::make_shared<_SimulationController>();
+        if (ComputeBackend::Cuda == arguments->backend) {
+            simController->initCuda();
+        }
+
+        //the processing steps are measured separately for the stage statistics from the first time step on
+        auto engineSettings = simController->getEngineSettings();
+        engineSettings.STAGE_PROFILING = true;
+        simController->setEngineSettings_async(engineSettings);
+        simController->newSimulation(
+            deserializedData.timestep, deserializedData.settings, deserializedData.symbolMap, arguments->backend);
+        if (inputExtension == SnapshotFileExtension) {
+            simController->loadSnapshot(arguments->inputFilename);
+        } else if (inputExtension == RecordingFileExtension) {
+            _RecordingReader reader(arguments->inputFilename);
+            auto timesteps = reader.getTimesteps();
+            simController->setCurrentTimestep(reader.seek(arguments->recordedTimestep.value_or(timesteps.back())));
+            simController->setSimulationData(reader.getData());
+        } else {
+            auto addChunk = [&](DataDescription const& chunk) { simController->addSimulationData(chunk); };
+            auto reserve = [&](uint64_t numCells, uint64_t numParticles) {
+                simController->reserveSimulationData(toInt(numCells), toInt(numParticles));
+            };
+            if (!serializer->deserializeDataChunksFromFile(arguments->inputFilename, addChunk, reserve)) {
+                throw std::runtime_error("Simulation " + arguments->inputFilename + " could not be read.");
+            }
+        }
+
+        std::ofstream statisticsStream(arguments->outputPrefix + "_statistics.csv", std::ios::trunc);
+        if (!statisticsStream) {
+            throw std::runtime_error("Statistics file could not be created.");
+        }
+        writeStatisticsHeader(statisticsStream);
+
+        if (arguments->recordingInterval > 0) {
+            auto recordingFilename = arguments->outputPrefix + RecordingFileExtension;
+            DeserializedSimulation sim;
+            sim.timestep = simController->getCurrentTimestep();
+            sim.settings = simController->getSettings();
+            sim.symbolMap = simController->getSymbolMap();
+            if (!serializer->serializeSettingsToFile(recordingFilename, sim)) {
+                throw std::runtime_error("Recording " + recordingFilename + " could not be created.");
+            }
+            simController->startRecording(recordingFilename, arguments->recordingInterval);
+        }
+
+        auto intervalStartTime = std::chrono::steady_clock::now();
+        for (uint64_t step = 1; step <= arguments->timesteps; ++step) {
+            simController->calcSingleTimestep();
+
+            if (step % arguments->statisticsInterval == 0 || step == arguments->timesteps) {
+                auto now = std::chrono::steady_clock::now();
+                auto intervalDuration = std::chrono::duration<double>(now - intervalStartTime).count();
+                auto intervalSteps = (step - 1) % arguments->statisticsInterval + 1;
+                auto tps = intervalDuration > 0 ? intervalSteps / intervalDuration : 0.0;
+                intervalStartTime = now;
+
+                writeStatistics(statisticsStream, simController->getStatistics(), tps);
+                std::cout << "time step " << simController->getCurrentTimestep() << ", " << tps << " TPS" << std::endl;
+            }
+            if (arguments->checkpointInterval > 0 && step % arguments->checkpointInterval == 0) {
+                writeCheckpoint(
+                    simController,
+                    arguments->outputPrefix + "_" + std::to_string(simController->getCurrentTimestep()) + ".sim");
+            }
+        }
+        if (simController->isRecording()) {
+            simController->stopRecording();
+        }
+        writeCheckpoint(simController, arguments->outputPrefix + "_final.sim");
+        simController->saveStageStatisticsToCsv(arguments->outputPrefix + "_stages.csv");
+
+        simController->closeSimulation();
+    } catch (std::exception const& e) {
+        auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+        auto message = std::string("The following exception occurred: ") + e.what();
+        loggingService->logMessage(Priority::Important, message);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,668 @@
+#pragma once
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Base.h"
+#include "CleanupKernels.h"
+#include "EntityFactory.h"
+#include "Map.h"
+#include "SimulationData.h"
+#include "ThreadPool.h"
+
+namespace Cpu
+{
+    //connections refer to indices in the cell array and have to be resolved afterwards
+    inline void copyCellToAccessTO(
+        Cell const& cell,
+        CellAccessTO& cellTO,
+        Cell const* firstCell,
+        StringTable& strings,
+        DataAccessTO const& accessTO)
+    {
+        cellTO.id = cell.id;
+        cellTO.pos = cell.absPos;
+        cellTO.vel = cell.vel;
+        cellTO.energy = cell.energy;
+        cellTO.maxConnections = cell.maxConnections;
+        cellTO.numConnections = cell.numConnections;
+        cellTO.branchNumber = cell.branchNumber;
+        cellTO.tokenBlocked = cell.tokenBlocked;
+        cellTO.cellFunctionType = cell.cellFunctionType;
+        cellTO.numStaticBytes = cell.cold->numStaticBytes;
+        cellTO.tokenUsages = cell.cold->tokenUsages;
+        cellTO.metadata.color = cell.cold->metadata.color;
+        cellTO.metadata.nameStringIndex = strings.getAccessIndex(cell.cold->metadata.nameId, accessTO);
+        cellTO.metadata.descriptionStringIndex = strings.getAccessIndex(cell.cold->metadata.descriptionId, accessTO);
+        cellTO.metadata.sourceCodeStringIndex = strings.getAccessIndex(cell.cold->metadata.sourceCodeId, accessTO);
+        for (int i = 0; i < cell.numConnections; ++i) {
+            auto connectingCell = cell.connections[i].cell;
+            cellTO.connections[i].cellIndex = static_cast<int>(connectingCell - firstCell);
+            cellTO.connections[i].distance = cell.connections[i].distance;
+            cellTO.connections[i].angleFromPrevious = cell.connections[i].angleFromPrevious;
+        }
+        for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
+            cellTO.staticData[i] = cell.cold->staticData[i];
+        }
+        cellTO.numMutableBytes = cell.cold->numMutableBytes;
+        for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
+            cellTO.mutableData[i] = cell.cold->mutableData[i];
+        }
+    }
+
+    //tags cell with cellTO index and tags cellTO connections with cell index
+    //only the cells in the tiles intersecting the rectangle are visited => tags of the other cells remain stale
+    inline void getCellAccessDataWithoutConnections(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        SimulationData& data,
+        DataAccessTO const& accessTO,
+        ThreadContext const& context)
+    {
+        auto const firstCell = data.entities.cells.getArray();
+
+        data.cellTiles.executeForEachInRect(rectUpperLeft, rectLowerRight, context, [&](Cell* cell) {
+            auto pos = cell->absPos;
+            data.cellMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                return;
+            }
+            auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
+            auto& cellTO = accessTO.cells[cellTOIndex];
+
+            copyCellToAccessTO(*cell, cellTO, firstCell, data.strings, accessTO);
+            cell->tag = cellTOIndex;
+        });
+    }
+
+    //returns the cellTO index of a cell or -1 if the cell has not been copied (its tag may be stale)
+    inline int getCellTOIndex(Cell const& cell, DataAccessTO const& accessTO)
+    {
+        auto const cellTOIndex = cell.tag;
+        if (cellTOIndex < 0 || cellTOIndex >= *accessTO.numCells || accessTO.cells[cellTOIndex].id != cell.id) {
+            return -1;
+        }
+        return cellTOIndex;
+    }
+
+    inline void resolveConnections(SimulationData& data, DataAccessTO const& accessTO, ThreadContext const& context)
+    {
+        auto const partition = context.calcPartition(*accessTO.numCells);
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cellTO = accessTO.cells[index];
+
+            for (int i = 0; i < cellTO.numConnections; ++i) {
+                auto const cellIndex = cellTO.connections[i].cellIndex;
+                cellTO.connections[i].cellIndex = getCellTOIndex(data.entities.cells.at(cellIndex), accessTO);
+            }
+        }
+    }
+
+    //copies the cells connected to the copied cells until the clusters are complete
+    //runs sequentially since the number of copied cells grows during the traversal
+    inline void completeClusterAccessData(SimulationData& data, DataAccessTO const& accessTO)
+    {
+        auto const firstCell = data.entities.cells.getArray();
+
+        for (int index = 0; index < *accessTO.numCells; ++index) {
+            auto const& cellTO = accessTO.cells[index];
+            for (int i = 0; i < cellTO.numConnections; ++i) {
+                auto& connectedCell = data.entities.cells.at(cellTO.connections[i].cellIndex);
+                if (-1 != getCellTOIndex(connectedCell, accessTO)) {
+                    continue;
+                }
+                auto connectedCellTOIndex = (*accessTO.numCells)++;
+                auto& connectedCellTO = accessTO.cells[connectedCellTOIndex];
+                copyCellToAccessTO(connectedCell, connectedCellTO, firstCell, data.strings, accessTO);
+                connectedCell.tag = connectedCellTOIndex;
+            }
+        }
+    }
+
+    inline void getCellOverlayData(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        SimulationData& data,
+        OverlayAccessTO const& overlayTO,
+        ThreadContext const& context)
+    {
+        data.cellTiles.executeForEachInRect(rectUpperLeft, rectLowerRight, context, [&](Cell* cell) {
+            auto pos = cell->absPos;
+            data.cellMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                return;
+            }
+            auto elementIndex = atomicAdd(overlayTO.numElements, 1);
+            if (elementIndex >= overlayTO.maxElements) {
+                return;
+            }
+            auto& element = overlayTO.elements[elementIndex];
+
+            element.pos = cell->absPos;
+            element.cellFunctionType = cell->cellFunctionType;
+        });
+    }
+
+    inline void getTokenAccessData(SimulationData& data, DataAccessTO const& accessTO, ThreadContext const& context)
+    {
+        auto& tokens = data.entities.tokenPointers;
+
+        auto partition = context.calcPartition(tokens.getNumEntries());
+        for (auto tokenIndex = partition.startIndex; tokenIndex <= partition.endIndex; ++tokenIndex) {
+            auto token = tokens.at(tokenIndex);
+            auto const cellTOIndex = getCellTOIndex(*token->cell, accessTO);
+            if (-1 == cellTOIndex) {
+                continue;
+            }
+
+            auto tokenTOIndex = atomicAdd(accessTO.numTokens, 1);
+            auto& tokenTO = accessTO.tokens[tokenTOIndex];
+
+            tokenTO.energy = token->energy;
+            for (int i = 0; i < data.constants.parameters.tokenMemorySize; ++i) {
+                tokenTO.memory[i] = token->memory[i];
+            }
+            tokenTO.cellIndex = cellTOIndex;
+        }
+    }
+
+    inline void getParticleAccessData(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        SimulationData& data,
+        DataAccessTO const& access,
+        ThreadContext const& context)
+    {
+        data.particleTiles.executeForEachInRect(rectUpperLeft, rectLowerRight, context, [&](Particle* particle) {
+            auto pos = particle->absPos;
+            data.particleMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                return;
+            }
+            int particleAccessIndex = atomicAdd(access.numParticles, 1);
+            ParticleAccessTO& particleAccess = access.particles[particleAccessIndex];
+
+            particleAccess.id = particle->id;
+            particleAccess.pos = particle->absPos;
+            particleAccess.vel = particle->vel;
+            particleAccess.energy = particle->energy;
+        });
+    }
+
+    //copies the cells changed after sinceVersion
+    //tags cells with cellTO index, changed cells outside the rectangle are logged as removed
+    inline void getChangedCellAccessData(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        uint64_t sinceVersion,
+        SimulationData& data,
+        DataAccessTO const& accessTO,
+        ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+        auto const firstCell = data.entities.cells.getArray();
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            cell->tag = -1;
+            if (cell->generation <= sinceVersion) {
+                continue;
+            }
+
+            auto pos = cell->absPos;
+            data.cellMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                data.logRemovedCell(cell->id);
+                continue;
+            }
+            auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
+            copyCellToAccessTO(*cell, accessTO.cells[cellTOIndex], firstCell, data.strings, accessTO);
+            cell->tag = cellTOIndex;
+        }
+    }
+
+    //unchanged cells connected to changed cells are appended such that connections can be resolved,
+    //their own connections are omitted
+    inline void getConnectedCellAccessData(
+        SimulationData& data,
+        DataAccessTO const& accessTO,
+        int numChangedCells,
+        ThreadContext const& context)
+    {
+        auto const partition = context.calcPartition(numChangedCells);
+        auto const firstCell = data.entities.cells.getArray();
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cellTO = accessTO.cells[index];
+            for (int i = 0; i < cellTO.numConnections; ++i) {
+                auto& connectedCell = data.entities.cells.at(cellTO.connections[i].cellIndex);
+                if (-1 != atomicCAS(&connectedCell.tag, -1, -2)) {
+                    continue;
+                }
+                auto connectedCellTOIndex = atomicAdd(accessTO.numCells, 1);
+                auto& connectedCellTO = accessTO.cells[connectedCellTOIndex];
+                copyCellToAccessTO(connectedCell, connectedCellTO, firstCell, data.strings, accessTO);
+                connectedCellTO.numConnections = 0;
+                connectedCell.tag = connectedCellTOIndex;
+            }
+        }
+    }
+
+    inline void getChangedTokenAccessData(
+        SimulationData& data,
+        DataAccessTO const& accessTO,
+        int numChangedCells,
+        ThreadContext const& context)
+    {
+        auto& tokens = data.entities.tokenPointers;
+        auto const partition = context.calcPartition(tokens.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& token = tokens.at(index);
+            auto const cellTOIndex = token->cell->tag;
+            if (cellTOIndex < 0 || cellTOIndex >= numChangedCells) {
+                continue;
+            }
+            auto tokenTOIndex = atomicAdd(accessTO.numTokens, 1);
+            auto& tokenTO = accessTO.tokens[tokenTOIndex];
+
+            tokenTO.energy = token->energy;
+            for (int i = 0; i < data.constants.parameters.tokenMemorySize; ++i) {
+                tokenTO.memory[i] = token->memory[i];
+            }
+            tokenTO.cellIndex = cellTOIndex;
+        }
+    }
+
+    inline void getChangedParticleAccessData(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        uint64_t sinceVersion,
+        SimulationData& data,
+        DataAccessTO const& accessTO,
+        ThreadContext const& context)
+    {
+        auto& particles = data.entities.particlePointers;
+        auto const partition = context.calcPartition(particles.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& particle = *particles.at(index);
+            if (particle.generation <= sinceVersion) {
+                continue;
+            }
+
+            auto pos = particle.absPos;
+            data.particleMap.mapPosCorrection(pos);
+            if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+                data.logRemovedParticle(particle.id);
+                continue;
+            }
+            auto particleTOIndex = atomicAdd(accessTO.numParticles, 1);
+            auto& particleTO = accessTO.particles[particleTOIndex];
+
+            particleTO.id = particle.id;
+            particleTO.pos = particle.absPos;
+            particleTO.vel = particle.vel;
+            particleTO.energy = particle.energy;
+            particleTO.metadata.color = particle.metadata.color;
+        }
+    }
+
+    //row-major tiles for exporting the world in chunks
+    //each cluster belongs to the first tile containing one of its cells
+    struct ExportTiles
+    {
+        int tileSize;
+        int2 numTiles;
+        int* ownerTiles;  //tile of the cluster of each cell in the order of the cell pointers
+
+        int getTile(float2 pos, MapInfo const& map) const
+        {
+            map.mapPosCorrection(pos);
+            auto x = std::min(floorInt(pos.x) / tileSize, numTiles.x - 1);
+            auto y = std::min(floorInt(pos.y) / tileSize, numTiles.y - 1);
+            return x + y * numTiles.x;
+        }
+    };
+
+    //the tag of each cell is its tile, the tags are then reduced to the minimum within each cluster
+    inline void
+    tagCellsWithExportTiles(ExportTiles const& exportTiles, SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            cell->tag = exportTiles.getTile(cell->absPos, data.cellMap);
+        }
+    }
+
+    inline void rolloutMinTagToCellClusters(SimulationData& data, int* change, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            auto tag = atomicRead(&cell->tag);
+            for (int i = 0; i < cell->numConnections; ++i) {
+                if (atomicMin(&cell->connections[i].cell->tag, tag) > tag) {
+                    atomicExch(change, 1);
+                }
+            }
+        }
+    }
+
+    //prerequisite: owner tiles have been determined by getExportTileCounters and the cells have not changed since then
+    inline void getExportTileCellAccessDataWithoutConnections(
+        ExportTiles const& exportTiles,
+        int tile,
+        SimulationData& data,
+        DataAccessTO const& accessTO,
+        ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+        auto const firstCell = data.entities.cells.getArray();
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            if (exportTiles.ownerTiles[index] != tile) {
+                cell->tag = -1;
+                continue;
+            }
+            auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
+            copyCellToAccessTO(*cell, accessTO.cells[cellTOIndex], firstCell, data.strings, accessTO);
+            cell->tag = cellTOIndex;
+        }
+    }
+
+    inline void getExportTileParticleAccessData(
+        ExportTiles const& exportTiles,
+        int tile,
+        SimulationData& data,
+        DataAccessTO const& access,
+        ThreadContext const& context)
+    {
+        int2 rectUpperLeft{
+            (tile % exportTiles.numTiles.x) * exportTiles.tileSize,
+            (tile / exportTiles.numTiles.x) * exportTiles.tileSize};
+        int2 rectLowerRight{rectUpperLeft.x + exportTiles.tileSize, rectUpperLeft.y + exportTiles.tileSize};
+        data.particleTiles.executeForEachInRect(rectUpperLeft, rectLowerRight, context, [&](Particle* particle) {
+            if (exportTiles.getTile(particle->absPos, data.particleMap) != tile) {
+                return;
+            }
+            int particleAccessIndex = atomicAdd(access.numParticles, 1);
+            ParticleAccessTO& particleAccess = access.particles[particleAccessIndex];
+
+            particleAccess.id = particle->id;
+            particleAccess.pos = particle->absPos;
+            particleAccess.vel = particle->vel;
+            particleAccess.energy = particle->energy;
+        });
+    }
+
+    inline void createDataFromTO(
+        SimulationData& data,
+        DataAccessTO const& simulationTO,
+        Particle* particleTargetArray,
+        Cell* cellTargetArray,
+        CellColdData* cellColdDataTargetArray,
+        Token* tokenTargetArray,
+        std::vector<int> const& stringIds,
+        ThreadContext const& context)
+    {
+        EntityFactory factory;
+        factory.init(&data);
+
+        auto particlePartition = context.calcPartition(*simulationTO.numParticles);
+        for (int index = particlePartition.startIndex; index <= particlePartition.endIndex; ++index) {
+            factory.createParticleFromTO(index, simulationTO.particles[index], particleTargetArray);
+        }
+
+        auto cellPartition = context.calcPartition(*simulationTO.numCells);
+        for (int index = cellPartition.startIndex; index <= cellPartition.endIndex; ++index) {
+            factory.createCellFromTO(
+                index, simulationTO.cells[index], cellTargetArray, cellColdDataTargetArray, stringIds);
+        }
+
+        auto tokenPartition = context.calcPartition(*simulationTO.numTokens);
+        for (int index = tokenPartition.startIndex; index <= tokenPartition.endIndex; ++index) {
+            factory.createTokenFromTO(index, simulationTO.tokens[index], cellTargetArray, tokenTargetArray);
+        }
+    }
+
+    inline void adaptNumberGenerator(NumberGenerator& numberGen, DataAccessTO const& accessTO, ThreadContext const& context)
+    {
+        {
+            auto const partition = context.calcPartition(*accessTO.numCells);
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& cell = accessTO.cells[index];
+                numberGen.adaptMaxId(cell.id);
+            }
+        }
+        {
+            auto const partition = context.calcPartition(*accessTO.numParticles);
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& particle = accessTO.particles[index];
+                numberGen.adaptMaxId(particle.id);
+            }
+        }
+    }
+
+    /************************************************************************/
+    /* Main                                                                 */
+    /************************************************************************/
+    inline void getSimulationAccessData(
+        ThreadPool& threadPool,
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        SimulationData& data,
+        DataAccessTO const& access)
+    {
+        *access.numCells = 0;
+        *access.numParticles = 0;
+        *access.numTokens = 0;
+        *access.numStrings = 0;
+        *access.numStringBytes = 0;
+        data.strings.prepareForAccess();
+
+        threadPool.execute([&](ThreadContext const& context) {
+            getCellAccessDataWithoutConnections(rectUpperLeft, rectLowerRight, data, access, context);
+        });
+        threadPool.execute([&](ThreadContext const& context) { resolveConnections(data, access, context); });
+        threadPool.execute([&](ThreadContext const& context) {
+            getTokenAccessData(data, access, context);
+            getParticleAccessData(rectUpperLeft, rectLowerRight, data, access, context);
+        });
+    }
+
+    //clusters with at least one cell in the rectangle are copied completely
+    inline void getSimulationClusterAccessData(
+        ThreadPool& threadPool,
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        SimulationData& data,
+        DataAccessTO const& access)
+    {
+        *access.numCells = 0;
+        *access.numParticles = 0;
+        *access.numTokens = 0;
+        *access.numStrings = 0;
+        *access.numStringBytes = 0;
+        data.strings.prepareForAccess();
+
+        threadPool.execute([&](ThreadContext const& context) {
+            getCellAccessDataWithoutConnections(rectUpperLeft, rectLowerRight, data, access, context);
+        });
+        completeClusterAccessData(data, access);
+        threadPool.execute([&](ThreadContext const& context) { resolveConnections(data, access, context); });
+        threadPool.execute([&](ThreadContext const& context) {
+            getTokenAccessData(data, access, context);
+            getParticleAccessData(rectUpperLeft, rectLowerRight, data, access, context);
+        });
+    }
+
+    //returns the sizes of the access data per tile, the string sizes are upper bounds
+    //the tile of the cluster of each cell is kept as owner tile for the extraction of the single tiles
+    inline std::vector<int> getExportTileCounters(
+        ThreadPool& threadPool,
+        ExportTiles const& exportTiles,
+        SimulationData& data)
+    {
+        threadPool.execute(
+            [&](ThreadContext const& context) { tagCellsWithExportTiles(exportTiles, data, context); });
+        int change;
+        do {
+            change = 0;
+            threadPool.execute(
+                [&](ThreadContext const& context) { rolloutMinTagToCellClusters(data, &change, context); });
+        } while (1 == change);
+
+        //counted sequentially in the order of ArraySizes
+        std::vector<int> result(exportTiles.numTiles.x * exportTiles.numTiles.y * 5, 0);
+        auto& cells = data.entities.cellPointers;
+        for (int index = 0; index < cells.getNumEntries(); ++index) {
+            auto const& cell = cells.at(index);
+            exportTiles.ownerTiles[index] = cell->tag;
+            auto counters = &result[cell->tag * 5];
+            ++counters[0];
+            auto const& metadata = cell->cold->metadata;
+            for (auto stringId : {metadata.nameId, metadata.descriptionId, metadata.sourceCodeId}) {
+                if (0 != stringId) {
+                    ++counters[3];
+                    counters[4] += data.strings.getNumBytes(stringId);
+                }
+            }
+        }
+        auto& particles = data.entities.particlePointers;
+        for (int index = 0; index < particles.getNumEntries(); ++index) {
+            ++result[exportTiles.getTile(particles.at(index)->absPos, data.particleMap) * 5 + 1];
+        }
+        auto& tokens = data.entities.tokenPointers;
+        for (int index = 0; index < tokens.getNumEntries(); ++index) {
+            ++result[tokens.at(index)->cell->tag * 5 + 2];
+        }
+        return result;
+    }
+
+    //the clusters belonging to the tile are copied completely, particles only if they lie in the tile
+    inline void getExportTileAccessData(
+        ThreadPool& threadPool,
+        ExportTiles const& exportTiles,
+        int tile,
+        SimulationData& data,
+        DataAccessTO const& access)
+    {
+        *access.numCells = 0;
+        *access.numParticles = 0;
+        *access.numTokens = 0;
+        *access.numStrings = 0;
+        *access.numStringBytes = 0;
+        data.strings.prepareForAccess();
+
+        threadPool.execute([&](ThreadContext const& context) {
+            getExportTileCellAccessDataWithoutConnections(exportTiles, tile, data, access, context);
+        });
+        threadPool.execute([&](ThreadContext const& context) { resolveConnections(data, access, context); });
+        threadPool.execute([&](ThreadContext const& context) {
+            getTokenAccessData(data, access, context);
+            getExportTileParticleAccessData(exportTiles, tile, data, access, context);
+        });
+    }
+
+    //copies the entities which have been changed after sinceVersion
+    //returns the number of changed cells, the remaining cells in the access data are only referenced by connections
+    inline int getSimulationDeltaAccessData(
+        ThreadPool& threadPool,
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        uint64_t sinceVersion,
+        SimulationData& data,
+        DataAccessTO const& access)
+    {
+        *access.numCells = 0;
+        *access.numParticles = 0;
+        *access.numTokens = 0;
+        *access.numStrings = 0;
+        *access.numStringBytes = 0;
+        data.strings.prepareForAccess();
+
+        threadPool.execute([&](ThreadContext const& context) {
+            getChangedCellAccessData(rectUpperLeft, rectLowerRight, sinceVersion, data, access, context);
+            getChangedParticleAccessData(rectUpperLeft, rectLowerRight, sinceVersion, data, access, context);
+        });
+        auto const numChangedCells = *access.numCells;
+        threadPool.execute(
+            [&](ThreadContext const& context) { getConnectedCellAccessData(data, access, numChangedCells, context); });
+        threadPool.execute([&](ThreadContext const& context) {
+            resolveConnections(data, access, context);
+            getChangedTokenAccessData(data, access, numChangedCells, context);
+        });
+        return numChangedCells;
+    }
+
+    inline void getSimulationOverlayData(
+        ThreadPool& threadPool,
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        SimulationData& data,
+        OverlayAccessTO const& overlayTO)
+    {
+        *overlayTO.numElements = 0;
+        threadPool.execute([&](ThreadContext const& context) {
+            getCellOverlayData(rectUpperLeft, rectLowerRight, data, overlayTO, context);
+        });
+    }
+
+    inline void clearData(SimulationData& data)
+    {
+        data.entities.cellPointers.reset();
+        data.entities.tokenPointers.reset();
+        data.entities.particlePointers.reset();
+        data.entities.cells.reset();
+        data.entities.cellColdData.reset();
+        data.entities.tokens.reset();
+        data.entities.particles.reset();
+        data.strings.reset();
+    }
+
+    inline void addSimulationAccessData(ThreadPool& threadPool, SimulationData& data, DataAccessTO const& access)
+    {
+        threadPool.execute(
+            [&](ThreadContext const& context) { adaptNumberGenerator(data.numberGen, access, context); });
+
+        auto particleTargetArray = data.entities.particles.getNewSubarray(*access.numParticles);
+        auto cellTargetArray = data.entities.cells.getNewSubarray(*access.numCells);
+        auto cellColdDataTargetArray = data.entities.cellColdData.getNewSubarray(*access.numCells);
+        auto tokenTargetArray = data.entities.tokens.getNewSubarray(*access.numTokens);
+
+        //strings are interned before the cells referring to them are created in parallel
+        std::vector<int> stringIds(*access.numStrings);
+        for (int i = 0; i < *access.numStrings; ++i) {
+            auto const& stringTO = access.strings[i];
+            stringIds[i] = data.strings.intern(&access.stringBytes[stringTO.byteIndex], stringTO.numBytes);
+        }
+        threadPool.execute([&](ThreadContext const& context) {
+            createDataFromTO(
+                data,
+                access,
+                particleTargetArray,
+                cellTargetArray,
+                cellColdDataTargetArray,
+                tokenTargetArray,
+                stringIds,
+                context);
+        });
+
+        cleanupAfterDataManipulation(threadPool, data);
+    }
+
+    inline void setSimulationAccessData(ThreadPool& threadPool, SimulationData& data, DataAccessTO const& access)
+    {
+        clearData(data);
+        addSimulationAccessData(threadPool, data, access);
+    }
+}
@@ -0,0 +1,503 @@
+#pragma once
+
+#include <atomic>
+
+#include "EngineInterface/ShallowUpdateSelectionData.h"
+#include "EngineGpuKernels/Definitions.cuh"
+
+#include "Base.h"
+#include "CellConnectionProcessor.h"
+#include "CellProcessor.h"
+#include "Map.h"
+#include "Math.h"
+#include "SelectionResult.h"
+#include "SimulationData.h"
+#include "ThreadPool.h"
+
+namespace Cpu
+{
+    inline void applyForceToCells(ApplyForceData const& applyData, SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const cellBlock = context.calcPartition(cells.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = cells.at(index);
+            auto const& pos = cell->absPos;
+            auto distanceToSegment =
+                Math::calcDistanceToLineSegment(applyData.startPos, applyData.endPos, pos, applyData.radius);
+            if (distanceToSegment < applyData.radius) {
+                auto weightedForce = applyData.force;
+                cell->vel = cell->vel + weightedForce;
+                data.markChanged(cell);
+            }
+        }
+    }
+
+    inline void
+    applyForceToParticles(ApplyForceData const& applyData, SimulationData& data, ThreadContext const& context)
+    {
+        auto& particles = data.entities.particlePointers;
+        auto const particleBlock = context.calcPartition(particles.getNumEntries());
+
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = particles.at(index);
+            auto const& pos = particle->absPos;
+            auto distanceToSegment =
+                Math::calcDistanceToLineSegment(applyData.startPos, applyData.endPos, pos, applyData.radius);
+            if (distanceToSegment < applyData.radius) {
+                auto weightedForce = applyData.force;
+                particle->vel = particle->vel + weightedForce;
+                data.markChanged(particle);
+            }
+        }
+    }
+
+    inline void
+    existSelection(SwitchSelectionData const& switchData, SimulationData& data, int* result, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if (1 == cell->selected && data.cellMap.mapDistance(switchData.pos, cell->absPos) < switchData.radius) {
+                atomicExch(result, 1);
+            }
+        }
+
+        auto const particleBlock = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = data.entities.particlePointers.at(index);
+            if (1 == particle->selected
+                && data.cellMap.mapDistance(switchData.pos, particle->absPos) < switchData.radius) {
+                atomicExch(result, 1);
+            }
+        }
+    }
+
+    inline void setSelection(float2 const& pos, float radius, SimulationData& data, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if (data.cellMap.mapDistance(pos, cell->absPos) < radius) {
+                cell->selected = 1;
+            } else {
+                cell->selected = 0;
+            }
+        }
+
+        auto const particleBlock = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = data.entities.particlePointers.at(index);
+            if (data.particleMap.mapDistance(pos, particle->absPos) < radius) {
+                particle->selected = 1;
+            } else {
+                particle->selected = 0;
+            }
+        }
+    }
+
+    inline void setSelection(SetSelectionData const& selectionData, SimulationData& data, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if (isContainedInRect(selectionData.startPos, selectionData.endPos, cell->absPos)) {
+                cell->selected = 1;
+            } else {
+                cell->selected = 0;
+            }
+        }
+
+        auto const particleBlock = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = data.entities.particlePointers.at(index);
+            if (isContainedInRect(selectionData.startPos, selectionData.endPos, particle->absPos)) {
+                particle->selected = 1;
+            } else {
+                particle->selected = 0;
+            }
+        }
+    }
+
+    inline void rolloutSelection(SimulationData& data, int* result, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+
+            if (0 != cell->selected) {
+                auto currentCell = cell;
+                for (int i = 0; i < 10; ++i) {
+                    bool found = false;
+                    for (int j = 0; j < currentCell->numConnections; ++j) {
+                        auto candidateCell = currentCell->connections[j].cell;
+                        if (0 == atomicRead(&candidateCell->selected)) {
+                            currentCell = candidateCell;
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (!found) {
+                        break;
+                    }
+
+                    atomicExch(&currentCell->selected, 2);
+                    atomicExch(result, 1);
+                }
+            }
+        }
+    }
+
+    inline void
+    updatePosAndVelForSelection(ShallowUpdateSelectionData const& updateData, SimulationData& data, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if ((0 != cell->selected && updateData.considerClusters)
+                || (1 == cell->selected && !updateData.considerClusters)) {
+                cell->absPos = cell->absPos + float2{updateData.posDeltaX, updateData.posDeltaY};
+                cell->vel = cell->vel + float2{updateData.velDeltaX, updateData.velDeltaY};
+                data.markChanged(cell);
+            }
+        }
+
+        auto const particleBlock = context.calcPartition(data.entities.particlePointers.getNumEntries());
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = data.entities.particlePointers.at(index);
+            if (0 != particle->selected) {
+                particle->absPos = particle->absPos + float2{updateData.posDeltaX, updateData.posDeltaY};
+                particle->vel = particle->vel + float2{updateData.velDeltaX, updateData.velDeltaY};
+                data.markChanged(particle);
+            }
+        }
+    }
+
+    inline void removeSelection(SimulationData& data, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            cell->selected = 0;
+        }
+
+        auto const particleBlock = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = data.entities.particlePointers.at(index);
+            particle->selected = 0;
+        }
+    }
+
+    inline void removeClusterSelection(SimulationData& data, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if (2 == cell->selected) {
+                cell->selected = 0;
+            }
+        }
+    }
+
+    inline void getSelectionShallowData(SimulationData& data, SelectionResult& result, ThreadContext const& context)
+    {
+        auto const cellBlock = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if (0 != cell->selected) {
+                result.collectCell(cell);
+            }
+        }
+
+        auto const particleBlock = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
+            auto const& particle = data.entities.particlePointers.at(index);
+            if (0 != particle->selected) {
+                result.collectParticle(particle);
+            }
+        }
+    }
+
+    inline void disconnectSelection(SimulationData& data, int* result, ThreadContext const& context)
+    {
+        auto const partition = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cell = data.entities.cellPointers.at(index);
+            if (1 == cell->selected) {
+                for (int i = 0; i < cell->numConnections; ++i) {
+                    auto const& connectedCell = cell->connections[i].cell;
+
+                    if (1 != connectedCell->selected
+                        && data.cellMap.mapDistance(cell->absPos, connectedCell->absPos)
+                            > data.constants.parameters.cellMaxBindingDistance) {
+                        CellConnectionProcessor::scheduleDelConnection(data, cell, connectedCell);
+                        atomicExch(result, 1);
+                    }
+                }
+            }
+        }
+    }
+
+    inline void connectSelection(SimulationData& data, int* result, ThreadContext const& context)
+    {
+        auto const partition = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+        Cell* otherCells[18];
+        int numOtherCells;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = data.entities.cellPointers.at(index);
+            if (1 != cell->selected) {
+                continue;
+            }
+            data.cellMap.get(
+                otherCells, 18, numOtherCells, cell->absPos, data.constants.parameters.cellMaxCollisionDistance);
+            for (int i = 0; i < numOtherCells; ++i) {
+                Cell* otherCell = otherCells[i];
+
+                if (!otherCell || otherCell == cell) {
+                    continue;
+                }
+
+                if (1 == otherCell->selected) {
+                    continue;
+                }
+
+                bool alreadyConnected = false;
+                for (int j = 0; j < cell->numConnections; ++j) {
+                    auto const& connectedCell = cell->connections[j].cell;
+                    if (connectedCell == otherCell) {
+                        alreadyConnected = true;
+                        break;
+                    }
+                }
+                if (alreadyConnected) {
+                    continue;
+                }
+
+                if (cell->numConnections < cell->maxConnections && otherCell->numConnections < otherCell->maxConnections) {
+                    CellConnectionProcessor::scheduleAddConnections(data, cell, otherCell, false);
+                    atomicExch(result, 1);
+                }
+            }
+        }
+    }
+
+    inline void calcAccumulatedCenter(
+        ShallowUpdateSelectionData const& updateData,
+        SimulationData& data,
+        float2* center,
+        int* numEntities,
+        ThreadContext const& context)
+    {
+        {
+            auto const partition = context.calcPartition(data.entities.cellPointers.getNumEntries());
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& cell = data.entities.cellPointers.at(index);
+                if ((updateData.considerClusters && cell->selected != 0)
+                    || (!updateData.considerClusters && cell->selected == 1)) {
+                    atomicAdd(&center->x, cell->absPos.x);
+                    atomicAdd(&center->y, cell->absPos.y);
+                    atomicAdd(numEntities, 1);
+                }
+            }
+        }
+        {
+            auto const partition = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& particle = data.entities.particlePointers.at(index);
+                if (particle->selected != 0) {
+                    atomicAdd(&center->x, particle->absPos.x);
+                    atomicAdd(&center->y, particle->absPos.y);
+                    atomicAdd(numEntities, 1);
+                }
+            }
+        }
+    }
+
+    inline void updateAngleAndAngularVelForSelection(
+        ShallowUpdateSelectionData const& updateData,
+        SimulationData& data,
+        float2 const& center,
+        ThreadContext const& context)
+    {
+        Math::Matrix rotationMatrix;
+        Math::rotationMatrix(updateData.angleDelta, rotationMatrix);
+
+        {
+            auto const partition = context.calcPartition(data.entities.cellPointers.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& cell = data.entities.cellPointers.at(index);
+                if ((updateData.considerClusters && cell->selected != 0)
+                    || (!updateData.considerClusters && cell->selected == 1)) {
+                    auto relPos = cell->absPos - center;
+                    data.cellMap.mapDisplacementCorrection(relPos);
+                    data.markChanged(cell);
+
+                    if (updateData.angleDelta != 0) {
+                        cell->absPos = Math::applyMatrix(relPos, rotationMatrix) + center;
+                        data.cellMap.mapPosCorrection(cell->absPos);
+                    }
+
+                    if (updateData.angularVelDelta != 0) {
+                        auto velDelta = relPos;
+                        Math::rotateQuarterClockwise(velDelta);
+                        velDelta = velDelta * updateData.angularVelDelta * DEG_TO_RAD;
+                        cell->vel = cell->vel + velDelta;
+                    }
+                }
+            }
+        }
+
+        {
+            auto const partition = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& particle = data.entities.particlePointers.at(index);
+                if (particle->selected != 0) {
+                    auto relPos = particle->absPos - center;
+                    data.cellMap.mapDisplacementCorrection(relPos);
+                    particle->absPos = Math::applyMatrix(relPos, rotationMatrix) + center;
+                    data.cellMap.mapPosCorrection(particle->absPos);
+                    data.markChanged(particle);
+                }
+            }
+        }
+    }
+
+    /************************************************************************/
+    /* Main                                                                 */
+    /************************************************************************/
+
+    inline void applyForce(ThreadPool& threadPool, ApplyForceData const& applyData, SimulationData& data)
+    {
+        threadPool.execute([&](ThreadContext const& context) {
+            applyForceToCells(applyData, data, context);
+            applyForceToParticles(applyData, data, context);
+        });
+    }
+
+    namespace Action
+    {
+        inline void rolloutSelection(ThreadPool& threadPool, SimulationData& data)
+        {
+            int result;
+            do {
+                result = 0;
+                threadPool.execute([&](ThreadContext const& context) { Cpu::rolloutSelection(data, &result, context); });
+            } while (1 == result);
+        }
+    }
+
+    inline void switchSelection(ThreadPool& threadPool, SwitchSelectionData const& switchData, SimulationData& data)
+    {
+        int result = 0;
+        threadPool.execute([&](ThreadContext const& context) { existSelection(switchData, data, &result, context); });
+        if (0 == result) {
+            threadPool.execute(
+                [&](ThreadContext const& context) { setSelection(switchData.pos, switchData.radius, data, context); });
+            Action::rolloutSelection(threadPool, data);
+        }
+    }
+
+    inline void setSelection(ThreadPool& threadPool, SetSelectionData const& setData, SimulationData& data)
+    {
+        threadPool.execute([&](ThreadContext const& context) { setSelection(setData, data, context); });
+        Action::rolloutSelection(threadPool, data);
+    }
+
+    inline SelectionShallowData
+    getSelectionShallowData(ThreadPool& threadPool, SimulationData& data, SelectionResult& selectionResult)
+    {
+        selectionResult.reset();
+        threadPool.execute(
+            [&](ThreadContext const& context) { getSelectionShallowData(data, selectionResult, context); });
+        selectionResult.finalize();
+        return selectionResult.getSelectionShallowData();
+    }
+
+    inline void
+    shallowUpdateSelection(ThreadPool& threadPool, ShallowUpdateSelectionData const& updateData, SimulationData& data)
+    {
+        int result;
+
+        bool reconnectionRequired = !updateData.considerClusters
+            && (updateData.posDeltaX != 0 || updateData.posDeltaY != 0 || updateData.angleDelta != 0);
+
+        //disconnect selection in case of reconnection
+        if (reconnectionRequired) {
+            int counter = 10;
+            do {
+                result = 0;
+                data.prepareForSimulation();
+                threadPool.execute([&](ThreadContext const& context) { disconnectSelection(data, &result, context); });
+                auto numOperations = data.numOperations.load();
+                threadPool.execute([&](ThreadContext const& context) {
+                    CellConnectionProcessor::processConnectionsOperations(data, context, numOperations);
+                });
+            } while (1 == result && --counter > 0);  //due to locking not all affecting connections may be removed at first => repeat
+        }
+
+        if (updateData.posDeltaX != 0 || updateData.posDeltaY != 0 || updateData.velDeltaX != 0
+            || updateData.velDeltaY != 0) {
+            threadPool.execute(
+                [&](ThreadContext const& context) { updatePosAndVelForSelection(updateData, data, context); });
+        }
+        if (updateData.angleDelta != 0 || updateData.angularVelDelta != 0) {
+            float2 center{0, 0};
+            int numEntities = 0;
+            threadPool.execute([&](ThreadContext const& context) {
+                calcAccumulatedCenter(updateData, data, &center, &numEntities, context);
+            });
+            if (numEntities != 0) {
+                center = center / toFloat(numEntities);
+            }
+            threadPool.execute([&](ThreadContext const& context) {
+                updateAngleAndAngularVelForSelection(updateData, data, center, context);
+            });
+        }
+
+        //connect selection in case of reconnection
+        if (reconnectionRequired) {
+
+            int counter = 10;
+            do {
+                result = 0;
+                data.prepareForSimulation();
+
+                data.cellMap.build(threadPool, data.entities.cellPointers);
+                threadPool.execute([&](ThreadContext const& context) { connectSelection(data, &result, context); });
+                auto numOperations = data.numOperations.load();
+                threadPool.execute([&](ThreadContext const& context) {
+                    CellConnectionProcessor::processConnectionsOperations(data, context, numOperations);
+                });
+
+                threadPool.execute([&](ThreadContext const& context) { data.cellMap.cleanup(context); });
+            } while (1 == result && --counter > 0);  //due to locking not all necessary connections may be established at first => repeat
+
+            //update selection
+            threadPool.execute([&](ThreadContext const& context) { removeClusterSelection(data, context); });
+            Action::rolloutSelection(threadPool, data);
+        }
+    }
+
+    inline void removeSelection(ThreadPool& threadPool, SimulationData& data)
+    {
+        threadPool.execute([&](ThreadContext const& context) { removeSelection(data, context); });
+    }
+}
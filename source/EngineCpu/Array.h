@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Base/Exceptions.h"
+
+#include "Base.h"
+#include "VirtualMemory.h"
+
+namespace Const
+{
+    //bounds for the reserved address ranges of the entity arrays which are derived from the world size
+    constexpr uint64_t MaxEntitiesPerArea = 4;
+    constexpr uint64_t MinReservedEntities = 1ull << 22;
+}
+
+namespace Cpu
+{
+    //entries live in a reserved address range which is backed by physical memory page by page
+    //=> growing the array appends pages and existing entries never move as long as the array has a maximum size,
+    //arrays without maximum size are relocated when they outgrow their reserved range
+    template <class T>
+    class Array
+    {
+        static_assert(std::is_trivial<T>::value, "entries are placed in raw memory without construction");
+
+    public:
+        T* getArray() const { return reinterpret_cast<T*>(_memory.getData()); }
+
+        int getSize() const { return _size; }
+
+        int getNumEntries() const { return _numEntries.load(std::memory_order_relaxed); }
+        void setNumEntries(int value) { _numEntries.store(value); }
+
+        void swapContent(Array& other)
+        {
+            auto numEntries = getNumEntries();
+            setNumEntries(other.getNumEntries());
+            other.setNumEntries(numEntries);
+            _memory.swap(other._memory);
+            std::swap(_size, other._size);
+            std::swap(_maxSize, other._maxSize);
+        }
+
+        void reset() { _numEntries.store(0); }
+
+        T* getNewSubarray(int size)
+        {
+            int oldIndex = _numEntries.fetch_add(size);
+            if (oldIndex + size - 1 >= _size) {
+                _numEntries.fetch_sub(size);
+                throw BugReportException("Not enough fixed memory!");
+            }
+            return &getArray()[oldIndex];
+        }
+
+        T* getNewElement()
+        {
+            int oldIndex = _numEntries.fetch_add(1);
+            if (oldIndex >= _size) {
+                _numEntries.fetch_sub(1);
+                throw BugReportException("Not enough fixed memory!");
+            }
+            return &getArray()[oldIndex];
+        }
+
+        //returns nullptr instead of throwing if the array is full
+        T* tryGetNewElement()
+        {
+            int oldIndex = _numEntries.fetch_add(1);
+            if (oldIndex >= _size) {
+                _numEntries.fetch_sub(1);
+                return nullptr;
+            }
+            return &getArray()[oldIndex];
+        }
+
+        T& at(int index) { return getArray()[index]; }
+        T const& at(int index) const { return getArray()[index]; }
+
+        int decNumEntriesAndReturnOrigSize() { return _numEntries.fetch_sub(1); }
+
+        bool shouldResize(int arraySizeInc, float fillLevelFactor) const
+        {
+            return getNumEntries() + arraySizeInc > getSize() * fillLevelFactor;
+        }
+
+        //determines the reserved address range, must be called before the first resize
+        void setMaxSize(int value) { _maxSize = value; }
+
+        //content is preserved, the array never shrinks
+        void resize(int newSize)
+        {
+            if (_maxSize > 0) {
+                newSize = std::min(newSize, _maxSize);
+            }
+            if (newSize <= _size) {
+                return;
+            }
+            _memory.commit(sizeof(T) * newSize, sizeof(T) * std::max(newSize, _maxSize));
+            _size = newSize;
+        }
+
+    private:
+        VirtualMemory _memory;
+        int _size = 0;
+        int _maxSize = 0;
+        std::atomic<int> _numEntries{0};
+    };
+
+    class DynamicMemory
+    {
+    public:
+        void resize(uint64_t size)
+        {
+            _data.reset(new unsigned char[size]);
+            _size = size;
+        }
+
+        template <typename T>
+        T* getArray(int numElements)
+        {
+            if (0 == numElements) {
+                return nullptr;
+            }
+            int newBytesToOccupy = numElements * sizeof(T);
+            newBytesToOccupy = newBytesToOccupy + 16 - (newBytesToOccupy % 16);
+            int oldIndex = _bytesOccupied.fetch_add(newBytesToOccupy);
+            if (static_cast<uint64_t>(oldIndex + newBytesToOccupy) > _size) {
+                _bytesOccupied.fetch_sub(newBytesToOccupy);
+                throw BugReportException("Not enough dynamic memory!");
+            }
+            return reinterpret_cast<T*>(&_data[oldIndex]);
+        }
+
+        int getNumBytes() const { return _bytesOccupied.load(); }
+
+        void reset() { _bytesOccupied.store(0); }
+
+        void swapContent(DynamicMemory& other)
+        {
+            auto bytesOccupied = getNumBytes();
+            _bytesOccupied.store(other.getNumBytes());
+            other._bytesOccupied.store(bytesOccupied);
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+        }
+
+    private:
+        std::unique_ptr<unsigned char[]> _data;
+        uint64_t _size = 0;
+        std::atomic<int> _bytesOccupied{0};
+    };
+}
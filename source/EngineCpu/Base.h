@@ -0,0 +1,346 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "EngineGpuKernels/VectorTypes.h"
+
+namespace Cpu
+{
+    inline float toFloat(int value) { return static_cast<float>(value); }
+
+    inline int toInt(float value) { return static_cast<int>(value); }
+
+    inline uint64_t toUInt64(float value) { return static_cast<uint64_t>(value); }
+
+    struct PartitionData
+    {
+        int startIndex;
+        int endIndex;
+
+        int numElements() const { return endIndex - startIndex + 1; }
+    };
+
+    inline PartitionData calcPartition(int numEntities, int division, int numDivisions)
+    {
+        PartitionData result;
+        int entitiesByDivisions = numEntities / numDivisions;
+        int remainder = numEntities % numDivisions;
+
+        int length = division < remainder ? entitiesByDivisions + 1 : entitiesByDivisions;
+        result.startIndex = division < remainder
+            ? (entitiesByDivisions + 1) * division
+            : (entitiesByDivisions + 1) * remainder + entitiesByDivisions * (division - remainder);
+        result.endIndex = result.startIndex + length - 1;
+        return result;
+    }
+
+    //counterpart of the CUDA launch configuration: a kernel function is executed once by every worker thread
+    struct ThreadContext
+    {
+        int threadIndex;
+        int numThreads;
+
+        PartitionData calcPartition(int numEntities) const
+        {
+            return Cpu::calcPartition(numEntities, threadIndex, numThreads);
+        }
+    };
+
+    inline int2 toInt2(float2 const& p) { return {static_cast<int>(p.x), static_cast<int>(p.y)}; }
+
+    inline float2 toFloat2(int2 const& p) { return {static_cast<float>(p.x), static_cast<float>(p.y)}; }
+
+    inline int floorInt(float v)
+    {
+        int result = static_cast<int>(v);
+        if (result > v) {
+            --result;
+        }
+        return result;
+    }
+
+    inline bool isContainedInRect(int2 const& rectUpperLeft, int2 const& rectLowerRight, float2 const& pos)
+    {
+        return pos.x >= rectUpperLeft.x && pos.x <= rectLowerRight.x && pos.y >= rectUpperLeft.y
+            && pos.y <= rectLowerRight.y;
+    }
+
+    inline bool isContainedInRect(float2 const& rectUpperLeft, float2 const& rectLowerRight, float2 const& pos)
+    {
+        return pos.x >= rectUpperLeft.x && pos.x <= rectLowerRight.x && pos.y >= rectUpperLeft.y
+            && pos.y <= rectLowerRight.y;
+    }
+
+    inline bool
+    isContainedInRect(int2 const& rectUpperLeft, int2 const& rectLowerRight, int2 const& pos, int boundary = 0)
+    {
+        return pos.x >= rectUpperLeft.x + boundary && pos.x <= rectLowerRight.x - boundary
+            && pos.y >= rectUpperLeft.y + boundary && pos.y <= rectLowerRight.y - boundary;
+    }
+
+    /************************************************************************/
+    /* Atomics                                                              */
+    /************************************************************************/
+    //the entity structs are shared between plain and atomic accesses like in the CUDA kernels,
+    //hence std::atomic is laid over the existing fields
+    template <typename T>
+    inline std::atomic<T>& asAtomic(T& value)
+    {
+        static_assert(sizeof(std::atomic<T>) == sizeof(T), "std::atomic<T> must have the same size as T");
+        static_assert(alignof(std::atomic<T>) == alignof(T), "std::atomic<T> must have the same alignment as T");
+        return *reinterpret_cast<std::atomic<T>*>(&value);
+    }
+
+    inline int atomicAdd(int* address, int value) { return asAtomic(*address).fetch_add(value); }
+
+    inline unsigned int atomicAdd(unsigned int* address, unsigned int value)
+    {
+        return asAtomic(*address).fetch_add(value);
+    }
+
+    inline uint64_t atomicAdd(uint64_t* address, uint64_t value) { return asAtomic(*address).fetch_add(value); }
+
+    inline float atomicAdd(float* address, float value)
+    {
+        auto& atomicValue = asAtomic(*address);
+        auto expected = atomicValue.load(std::memory_order_relaxed);
+        while (!atomicValue.compare_exchange_weak(expected, expected + value)) {
+        }
+        return expected;
+    }
+
+    inline int atomicSub(int* address, int value) { return asAtomic(*address).fetch_sub(value); }
+
+    inline int atomicExch(int* address, int value) { return asAtomic(*address).exchange(value); }
+
+    template <typename T>
+    inline T* atomicExch(T** address, T* value)
+    {
+        return asAtomic(*address).exchange(value);
+    }
+
+    template <typename T>
+    inline T* atomicCAS(T** address, T* compare, T* value)
+    {
+        asAtomic(*address).compare_exchange_strong(compare, value);
+        return compare;
+    }
+
+    inline int atomicCAS(int* address, int compare, int value)
+    {
+        asAtomic(*address).compare_exchange_strong(compare, value);
+        return compare;
+    }
+
+    inline int atomicMin(int* address, int value)
+    {
+        auto& atomicValue = asAtomic(*address);
+        auto expected = atomicValue.load(std::memory_order_relaxed);
+        while (expected > value && !atomicValue.compare_exchange_weak(expected, value)) {
+        }
+        return expected;
+    }
+
+    inline int atomicMax(int* address, int value)
+    {
+        auto& atomicValue = asAtomic(*address);
+        auto expected = atomicValue.load(std::memory_order_relaxed);
+        while (expected < value && !atomicValue.compare_exchange_weak(expected, value)) {
+        }
+        return expected;
+    }
+
+    inline uint64_t atomicMax(uint64_t* address, uint64_t value)
+    {
+        auto& atomicValue = asAtomic(*address);
+        auto expected = atomicValue.load(std::memory_order_relaxed);
+        while (expected < value && !atomicValue.compare_exchange_weak(expected, value)) {
+        }
+        return expected;
+    }
+
+    template <typename T>
+    inline T atomicRead(T* const& address)
+    {
+        return asAtomic(*address).load();
+    }
+
+    /************************************************************************/
+    /* Locks                                                                */
+    /************************************************************************/
+    class SystemLock
+    {
+    public:
+        void init() { lock = 0; }
+
+        void getLock()
+        {
+            while (1 == atomicExch(&lock, 1)) {
+            }
+        }
+
+        bool tryLock() { return 0 == atomicExch(&lock, 1); }
+
+        void releaseLock() { atomicExch(&lock, 0); }
+
+    private:
+        int lock;  //0 = unlocked, 1 = locked
+    };
+
+    class SystemDoubleLock
+    {
+    public:
+        void init(int* lock1, int* lock2)
+        {
+            if (lock1 <= lock2) {
+                _lock1 = lock1;
+                _lock2 = lock2;
+            } else {
+                _lock1 = lock2;
+                _lock2 = lock1;
+            }
+        }
+
+        bool tryLock()
+        {
+            _lockState1 = atomicExch(_lock1, 1);
+            _lockState2 = atomicExch(_lock2, 1);
+            if (0 != _lockState1 || 0 != _lockState2) {
+                releaseLock();
+                return false;
+            }
+            return true;
+        }
+
+        void getLock()
+        {
+            while (!tryLock()) {
+            };
+        }
+
+        bool isLocked() { return _lockState1 == 0 && _lockState2 == 0; }
+
+        void releaseLock()
+        {
+            if (0 == _lockState1) {
+                atomicExch(_lock1, 0);
+            }
+            if (0 == _lockState2) {
+                atomicExch(_lock2, 0);
+            }
+        }
+
+    private:
+        int* _lock1;
+        int* _lock2;
+        int _lockState1;
+        int _lockState2;
+    };
+
+    /************************************************************************/
+    /* Number generator                                                     */
+    /************************************************************************/
+    //Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): maps a 128 bit counter and a
+    //64 bit key bijectively to 128 random bits without any state
+    namespace Philox
+    {
+        inline void mulHiLo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+        {
+            auto product = static_cast<uint64_t>(a) * b;
+            hi = static_cast<uint32_t>(product >> 32);
+            lo = static_cast<uint32_t>(product);
+        }
+
+        inline uint32_t generate(uint32_t counter[4], uint32_t key[2])
+        {
+            uint32_t const M0 = 0xD2511F53;
+            uint32_t const M1 = 0xCD9E8D57;
+            uint32_t const W0 = 0x9E3779B9;
+            uint32_t const W1 = 0xBB67AE85;
+
+            uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+            uint32_t k0 = key[0], k1 = key[1];
+            for (int round = 0; round < 10; ++round) {
+                uint32_t hi0, lo0, hi1, lo1;
+                mulHiLo(M0, c0, hi0, lo0);
+                mulHiLo(M1, c2, hi1, lo1);
+                c0 = hi1 ^ c1 ^ k0;
+                c1 = lo1;
+                c2 = hi0 ^ c3 ^ k1;
+                c3 = lo0;
+                k0 += W0;
+                k1 += W1;
+            }
+            return c0;
+        }
+    }
+
+    //each random number is a function of (seed, time step, entity id, number of previous draws for that entity in the
+    //time step) => runs are reproducible for a fixed seed independent of the thread which processes an entity
+    class NumberGenerator
+    {
+    public:
+        static int const MaxRandomNumber = 0x7fffffff;
+
+        void init() { _currentId.store(1); }
+
+        void prepareForTimestep(uint32_t seed, uint64_t timestep)
+        {
+            _seed = seed;
+            _timestep = timestep;
+        }
+
+        //the draw index of an entity is reset at the beginning of each time step
+        template <typename Entity>
+        int random(Entity* entity, int maxVal)
+        {
+            int number = getRandomNumber(entity);
+            return number % (maxVal + 1);
+        }
+
+        template <typename Entity>
+        float random(Entity* entity, float maxVal)
+        {
+            int number = getRandomNumber(entity);
+            return maxVal * static_cast<float>(number) / MaxRandomNumber;
+        }
+
+        template <typename Entity>
+        float random(Entity* entity)
+        {
+            int number = getRandomNumber(entity);
+            return static_cast<float>(number) / MaxRandomNumber;
+        }
+
+        uint64_t createNewId_kernel() { return _currentId.fetch_add(1); }
+
+        void adaptMaxId(uint64_t id)
+        {
+            auto expected = _currentId.load(std::memory_order_relaxed);
+            while (expected < id + 1 && !_currentId.compare_exchange_weak(expected, id + 1)) {
+            }
+        }
+
+    private:
+        template <typename Entity>
+        int getRandomNumber(Entity* entity)
+        {
+            auto drawIndex = atomicAdd(&entity->numRandomDraws, 1u);
+            uint32_t counter[4] = {
+                drawIndex,
+                static_cast<uint32_t>(entity->id),
+                static_cast<uint32_t>(entity->id >> 32),
+                static_cast<uint32_t>(_timestep)};
+            uint32_t key[2] = {_seed, static_cast<uint32_t>(_timestep >> 32)};
+            return static_cast<int>(Philox::generate(counter, key) & MaxRandomNumber);
+        }
+
+        uint32_t _seed = 0;
+        uint64_t _timestep = 0;
+
+        std::atomic<uint64_t> _currentId{1};
+    };
+}
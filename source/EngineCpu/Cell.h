@@ -0,0 +1,87 @@
+#pragma once
+
+#include "EngineInterface/ElementaryTypes.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Base.h"
+
+namespace Cpu
+{
+    struct Cell;
+
+    struct CellMetadata
+    {
+        unsigned char color;
+
+        //ids in the string table of the simulation data, 0 = empty string
+        int nameId;
+        int descriptionId;
+        int sourceCodeId;
+    };
+
+    struct CellConnection
+    {
+        Cell* cell;
+        float distance;
+        float angleFromPrevious;
+    };
+
+    //data which is only accessed by cell functions, token processing and data access
+    //it is stored in a separate array such that the physics passes do not need to stream it
+    struct CellColdData
+    {
+        unsigned char numStaticBytes;
+        char staticData[MAX_CELL_STATIC_BYTES];
+        unsigned char numMutableBytes;
+        char mutableData[MAX_CELL_MUTABLE_BYTES];
+        int tokenUsages;
+        CellMetadata metadata;
+    };
+
+    //the hot fields remain an array of structs since the kernels address cells through Cell* handles
+    struct Cell
+    {
+        uint64_t id;
+        float2 absPos;
+        float2 vel;
+
+        int branchNumber;
+        bool tokenBlocked;
+        int maxConnections;
+        int numConnections;
+        CellConnection connections[MAX_CELL_BONDS];
+        float energy;
+        int cellFunctionType;
+        CellColdData* cold;
+
+        //editing data
+        int selected;  //0 = no, 1 = selected, 2 = indirectly selected
+
+        //change tracking for delta extraction
+        uint64_t generation;  //data version at the last change
+
+        //temporary data
+        int locked;  //0 = unlocked, 1 = locked
+        int tag;
+        uint32_t numRandomDraws;  //draw index for the number generator in the current time step
+        float2 temp1;
+        float2 temp2;
+        float2 temp3;
+
+        void getLock()
+        {
+            while (1 == atomicExch(&locked, 1)) {
+            }
+        }
+
+        bool tryLock() { return 0 == atomicExch(&locked, 1); }
+
+        void releaseLock() { atomicExch(&locked, 0); }
+
+        Enums::CellFunction::Type getCellFunctionType() const
+        {
+            return static_cast<Enums::CellFunction::Type>(
+                static_cast<unsigned int>(cellFunctionType) % Enums::CellFunction::_COUNTER);
+        }
+    };
+}
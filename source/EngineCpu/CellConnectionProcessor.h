@@ -0,0 +1,396 @@
+#pragma once
+
+#include "Base.h"
+#include "EntityFactory.h"
+#include "SimulationData.h"
+#include "SpotCalculator.h"
+
+namespace Cpu
+{
+    class CellConnectionProcessor
+    {
+    public:
+        static void scheduleAddConnections(SimulationData& data, Cell* cell1, Cell* cell2, bool addTokens);
+        static void scheduleDelConnections(SimulationData& data, Cell* cell);
+        static void scheduleDelConnection(SimulationData& data, Cell* cell1, Cell* cell2);
+        static void scheduleDelCell(SimulationData& data, Cell* cell, int cellIndex);
+        static void scheduleDelCellAndConnections(SimulationData& data, Cell* cell, int cellIndex);
+
+        //numOperations is passed from outside since operations may be scheduled during processing
+        static void
+        processConnectionsOperations(SimulationData& data, ThreadContext const& context, int numOperations);
+        static void processDelCellOperations(SimulationData& data, ThreadContext const& context, int numOperations);
+
+        static void addConnections(
+            SimulationData& data,
+            Cell* cell1,
+            Cell* cell2,
+            float desiredAngleOnCell1,
+            float desiredAngleOnCell2,
+            float desiredDistance,
+            int angleAlignment = 0);
+        static void delConnections(SimulationData& data, Cell* cell1, Cell* cell2);
+
+    private:
+        static Operation* getNewOperation(SimulationData& data);
+
+        static void addConnectionsIntern(SimulationData& data, Cell* cell1, Cell* cell2, bool addTokens);
+        static void addConnectionIntern(
+            SimulationData& data,
+            Cell* cell1,
+            Cell* cell2,
+            float2 const& posDelta,
+            float desiredDistance,
+            float desiredAngleOnCell1 = 0,
+            int angleAlignment = 0);
+
+        static void delConnectionsIntern(SimulationData& data, Cell* cell);
+        static void delConnectionIntern(SimulationData& data, Cell* cell1, Cell* cell2);
+        static void delConnectionOneWay(SimulationData& data, Cell* cell1, Cell* cell2);
+
+        static void delCell(SimulationData& data, Cell* cell, int cellIndex);
+    };
+
+    /************************************************************************/
+    /* Implementation                                                       */
+    /************************************************************************/
+    inline Operation* CellConnectionProcessor::getNewOperation(SimulationData& data)
+    {
+        auto index = data.numOperations.fetch_add(1);
+        if (index < data.getMaxOperations()) {
+            return &data.operations[index];
+        }
+        data.numOperations.fetch_sub(1);
+        return nullptr;
+    }
+
+    inline void
+    CellConnectionProcessor::scheduleAddConnections(SimulationData& data, Cell* cell1, Cell* cell2, bool addTokens)
+    {
+        if (auto operation = getNewOperation(data)) {
+            operation->type = Operation::Type::AddConnections;
+            operation->data.addConnectionOperation.cell = cell1;
+            operation->data.addConnectionOperation.otherCell = cell2;
+            operation->data.addConnectionOperation.addTokens = addTokens;
+        }
+    }
+
+    inline void CellConnectionProcessor::scheduleDelConnections(SimulationData& data, Cell* cell)
+    {
+        if (auto operation = getNewOperation(data)) {
+            operation->type = Operation::Type::DelConnections;
+            operation->data.delConnectionsOperation.cell = cell;
+        }
+    }
+
+    inline void CellConnectionProcessor::scheduleDelConnection(SimulationData& data, Cell* cell1, Cell* cell2)
+    {
+        if (auto operation = getNewOperation(data)) {
+            operation->type = Operation::Type::DelConnection;
+            operation->data.delConnectionOperation.cell1 = cell1;
+            operation->data.delConnectionOperation.cell2 = cell2;
+        }
+    }
+
+    inline void CellConnectionProcessor::scheduleDelCell(SimulationData& data, Cell* cell, int cellIndex)
+    {
+        if (auto operation = getNewOperation(data)) {
+            operation->type = Operation::Type::DelCell;
+            operation->data.delCellOperation.cell = cell;
+            operation->data.delCellOperation.cellIndex = cellIndex;
+        }
+    }
+
+    inline void CellConnectionProcessor::scheduleDelCellAndConnections(SimulationData& data, Cell* cell, int cellIndex)
+    {
+        if (auto operation = getNewOperation(data)) {
+            operation->type = Operation::Type::DelCellAndConnections;
+            operation->data.delCellAndConnectionOperation.cell = cell;
+            operation->data.delCellAndConnectionOperation.cellIndex = cellIndex;
+        }
+    }
+
+    inline void CellConnectionProcessor::processConnectionsOperations(
+        SimulationData& data,
+        ThreadContext const& context,
+        int numOperations)
+    {
+        auto partition = context.calcPartition(numOperations);
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& operation = data.operations[index];
+            if (Operation::Type::DelConnection == operation.type) {
+                delConnectionIntern(
+                    data, operation.data.delConnectionOperation.cell1, operation.data.delConnectionOperation.cell2);
+            }
+            if (Operation::Type::DelConnections == operation.type) {
+                delConnectionsIntern(data, operation.data.delConnectionsOperation.cell);
+            }
+            if (Operation::Type::DelCellAndConnections == operation.type) {
+                delConnectionsIntern(data, operation.data.delConnectionsOperation.cell);
+                scheduleDelCell(
+                    data,
+                    operation.data.delCellAndConnectionOperation.cell,
+                    operation.data.delCellAndConnectionOperation.cellIndex);
+            }
+            if (Operation::Type::AddConnections == operation.type) {
+                addConnectionsIntern(
+                    data,
+                    operation.data.addConnectionOperation.cell,
+                    operation.data.addConnectionOperation.otherCell,
+                    operation.data.addConnectionOperation.addTokens);
+            }
+        }
+    }
+
+    inline void
+    CellConnectionProcessor::processDelCellOperations(SimulationData& data, ThreadContext const& context, int numOperations)
+    {
+        auto partition = context.calcPartition(numOperations);
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& operation = data.operations[index];
+            if (Operation::Type::DelCell == operation.type) {
+                delCell(data, operation.data.delCellOperation.cell, operation.data.delCellOperation.cellIndex);
+            }
+        }
+    }
+
+    inline void CellConnectionProcessor::addConnections(
+        SimulationData& data,
+        Cell* cell1,
+        Cell* cell2,
+        float desiredAngleOnCell1,
+        float desiredAngleOnCell2,
+        float desiredDistance,
+        int angleAlignment)
+    {
+        auto posDelta = cell2->absPos - cell1->absPos;
+        data.cellMap.mapDisplacementCorrection(posDelta);
+        addConnectionIntern(data, cell1, cell2, posDelta, desiredDistance, desiredAngleOnCell1, angleAlignment);
+        addConnectionIntern(data, cell2, cell1, posDelta * (-1), desiredDistance, desiredAngleOnCell2, angleAlignment);
+    }
+
+    inline void CellConnectionProcessor::delConnections(SimulationData& data, Cell* cell1, Cell* cell2)
+    {
+        delConnectionOneWay(data, cell1, cell2);
+        delConnectionOneWay(data, cell2, cell1);
+    }
+
+    inline void
+    CellConnectionProcessor::addConnectionsIntern(SimulationData& data, Cell* cell1, Cell* cell2, bool addTokens)
+    {
+        SystemDoubleLock lock;
+        lock.init(&cell1->locked, &cell2->locked);
+        if (lock.tryLock()) {
+
+            bool alreadyConnected = false;
+            for (int i = 0; i < cell1->numConnections; ++i) {
+                if (cell1->connections[i].cell == cell2) {
+                    alreadyConnected = true;
+                    break;
+                }
+            }
+
+            if (!alreadyConnected && cell1->numConnections < cell1->maxConnections
+                && cell2->numConnections < cell2->maxConnections) {
+                auto posDelta = cell2->absPos - cell1->absPos;
+                data.cellMap.mapDisplacementCorrection(posDelta);
+                addConnectionIntern(data, cell1, cell2, posDelta, Math::length(posDelta));
+                addConnectionIntern(data, cell2, cell1, posDelta * (-1), Math::length(posDelta));
+
+                if (addTokens) {
+                    EntityFactory factory;
+                    factory.init(&data);
+
+                    auto cellMinEnergy =
+                        SpotCalculator::calc(&SimulationParametersSpotValues::cellMinEnergy, data, cell1->absPos);
+                    auto newTokenEnergy = data.constants.parameters.tokenMinEnergy * 1.5f;
+                    if (cell1->energy > cellMinEnergy + newTokenEnergy) {
+                        auto token = factory.createToken(cell1, cell2);
+                        token->energy = newTokenEnergy;
+                        cell1->energy -= newTokenEnergy;
+                        data.markChanged(cell1);
+                    }
+                    if (cell2->energy > cellMinEnergy + newTokenEnergy) {
+                        auto token = factory.createToken(cell2, cell1);
+                        token->energy = newTokenEnergy;
+                        cell2->energy -= newTokenEnergy;
+                        data.markChanged(cell2);
+                    }
+                }
+            }
+
+            lock.releaseLock();
+        }
+    }
+
+    inline void CellConnectionProcessor::addConnectionIntern(
+        SimulationData& data,
+        Cell* cell1,
+        Cell* cell2,
+        float2 const& posDelta,
+        float desiredDistance,
+        float desiredAngleOnCell1,
+        int angleAlignment)
+    {
+        auto newAngle = Math::angleOfVector(posDelta);
+        data.markChanged(cell1);
+
+        if (0 == cell1->numConnections) {
+            cell1->numConnections++;
+            cell1->connections[0].cell = cell2;
+            cell1->connections[0].distance = desiredDistance;
+            cell1->connections[0].angleFromPrevious = 360.0f;
+            return;
+        }
+        if (1 == cell1->numConnections) {
+            cell1->numConnections++;
+            cell1->connections[1].cell = cell2;
+            cell1->connections[1].distance = desiredDistance;
+
+            auto connectedCellDelta = cell1->connections[0].cell->absPos - cell1->absPos;
+            data.cellMap.mapDisplacementCorrection(connectedCellDelta);
+            auto prevAngle = Math::angleOfVector(connectedCellDelta);
+            auto angleDiff = newAngle - prevAngle;
+            if (0 != desiredAngleOnCell1) {
+                angleDiff = desiredAngleOnCell1;
+            }
+            angleDiff = Math::alignAngle(angleDiff, angleAlignment % 7);
+            if (angleDiff >= 0) {
+                cell1->connections[1].angleFromPrevious = angleDiff;
+                cell1->connections[0].angleFromPrevious = 360.0f - angleDiff;
+            } else {
+                cell1->connections[1].angleFromPrevious = 360.0f + angleDiff;
+                cell1->connections[0].angleFromPrevious = -angleDiff;
+            }
+            return;
+        }
+
+        auto lastConnectedCellDelta = cell1->connections[0].cell->absPos - cell1->absPos;
+        data.cellMap.mapDisplacementCorrection(lastConnectedCellDelta);
+        float angle = Math::angleOfVector(lastConnectedCellDelta);
+
+        int i = 1;
+        while (true) {
+            auto nextAngle = angle + cell1->connections[i].angleFromPrevious;
+
+            if ((angle < newAngle && newAngle <= nextAngle)
+                || (angle < (newAngle + 360.0f) && (newAngle + 360.0f) <= nextAngle)) {
+                break;
+            }
+
+            ++i;
+            if (i == cell1->numConnections) {
+                i = 0;
+            }
+            angle = nextAngle;
+            if (angle > 360.0f) {
+                angle -= 360.0f;
+            }
+        }
+
+        CellConnection newConnection;
+        newConnection.cell = cell2;
+        newConnection.distance = desiredDistance;
+
+        auto angleDiff1 = newAngle - angle;
+        if (angleDiff1 < 0) {
+            angleDiff1 += 360.0f;
+        }
+        auto angleDiff2 = cell1->connections[i].angleFromPrevious;
+        if (angleDiff1 > angleDiff2) {
+            angleDiff1 = angleDiff2;
+        }
+
+        auto factor = (angleDiff2 != 0) ? angleDiff1 / angleDiff2 : 0.5f;
+        if (0 == desiredAngleOnCell1) {
+            newConnection.angleFromPrevious = angleDiff2 * factor;
+        } else {
+            if (desiredAngleOnCell1 > angleDiff2) {
+                desiredAngleOnCell1 = angleDiff2;
+            }
+            newConnection.angleFromPrevious = desiredAngleOnCell1;
+        }
+        newConnection.angleFromPrevious = Math::alignAngle(newConnection.angleFromPrevious, angleAlignment % 7);
+
+        for (int j = cell1->numConnections; j > i; --j) {
+            cell1->connections[j] = cell1->connections[j - 1];
+        }
+        cell1->connections[i] = newConnection;
+        ++cell1->numConnections;
+
+        cell1->connections[(++i) % cell1->numConnections].angleFromPrevious =
+            angleDiff2 - newConnection.angleFromPrevious;
+    }
+
+    inline void CellConnectionProcessor::delConnectionsIntern(SimulationData& data, Cell* cell)
+    {
+        if (cell->tryLock()) {
+            for (int i = cell->numConnections - 1; i >= 0; --i) {
+                auto connectedCell = cell->connections[i].cell;
+                if (connectedCell->tryLock()) {
+
+                    delConnectionOneWay(data, cell, connectedCell);
+                    delConnectionOneWay(data, connectedCell, cell);
+
+                    connectedCell->releaseLock();
+                }
+            }
+            cell->releaseLock();
+        }
+    }
+
+    inline void CellConnectionProcessor::delConnectionIntern(SimulationData& data, Cell* cell1, Cell* cell2)
+    {
+        if (cell1->tryLock()) {
+            if (cell2->tryLock()) {
+                delConnectionOneWay(data, cell1, cell2);
+                delConnectionOneWay(data, cell2, cell1);
+                cell2->releaseLock();
+            }
+            cell1->releaseLock();
+        }
+    }
+
+    inline void CellConnectionProcessor::delConnectionOneWay(SimulationData& data, Cell* cell1, Cell* cell2)
+    {
+        for (int i = 0; i < cell1->numConnections; ++i) {
+            if (cell1->connections[i].cell == cell2) {
+                float angleToAdd = cell1->connections[i].angleFromPrevious;
+                for (int j = i; j < cell1->numConnections - 1; ++j) {
+                    cell1->connections[j] = cell1->connections[j + 1];
+                }
+
+                if (i < cell1->numConnections - 1) {
+                    cell1->connections[i].angleFromPrevious += angleToAdd;
+                } else {
+                    cell1->connections[0].angleFromPrevious += angleToAdd;
+                }
+
+                --cell1->numConnections;
+                data.markChanged(cell1);
+                return;
+            }
+        }
+    }
+
+    inline void CellConnectionProcessor::delCell(SimulationData& data, Cell* cell, int cellIndex)
+    {
+        if (cell->tryLock()) {
+
+            if (0 == cell->numConnections && cell->energy != 0) {
+                EntityFactory factory;
+                factory.init(&data);
+                factory.createParticle(cell->energy, cell->absPos, cell->vel, {cell->cold->metadata.color});
+                cell->energy = 0;
+
+                data.entities.cellPointers.at(cellIndex) = nullptr;
+                data.logRemovedCell(cell->id);
+                data.strings.removeReferences(cell->cold->metadata);
+            }
+
+            cell->releaseLock();
+        }
+    }
+}
@@ -0,0 +1,372 @@
+#pragma once
+
+#include "Base.h"
+#include "CellConnectionProcessor.h"
+#include "EntityFactory.h"
+#include "Map.h"
+#include "SpotCalculator.h"
+
+namespace Cpu
+{
+    class CellProcessor
+    {
+    public:
+        void init(SimulationData& data, ThreadContext const& context);
+        void clearTag(SimulationData& data, ThreadContext const& context);
+        void collisions(SimulationData& data, ThreadContext const& context);  //prerequisite: clearTag
+        void applyAndCheckForces(SimulationData& data, ThreadContext const& context);  //prerequisite: tag from collisions
+        void calcForces(SimulationData& data, ThreadContext const& context);
+        void calcPositionsAndCheckBindings(SimulationData& data, ThreadContext const& context);
+        void calcVelocities(SimulationData& data, ThreadContext const& context, int numCellPointers);
+        void calcAveragedVelocities(SimulationData& data, ThreadContext const& context);
+        void applyAveragedVelocities(SimulationData& data, ThreadContext const& context);
+        void radiation(SimulationData& data, ThreadContext const& context);
+        void decay(SimulationData& data, ThreadContext const& context);
+    };
+
+    /************************************************************************/
+    /* Implementation                                                       */
+    /************************************************************************/
+
+    inline void CellProcessor::init(SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            cell->temp1 = {0, 0};
+            cell->numRandomDraws = 0;
+        }
+    }
+
+    inline void CellProcessor::clearTag(SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            cell->tag = 0;
+        }
+    }
+
+    inline void CellProcessor::collisions(SimulationData& data, ThreadContext const& context)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            data.cellMap.executeForEachInNeighborhood(cell->absPos, [&](Cell* otherCell) {
+                if (otherCell == cell) {
+                    return;
+                }
+
+                auto posDelta = cell->absPos - otherCell->absPos;
+                data.cellMap.mapDisplacementCorrection(posDelta);
+
+                auto distance = Math::length(posDelta);
+                if (distance >= parameters.cellMaxCollisionDistance) {
+                    return;
+                }
+
+                if (distance < parameters.cellMinDistance && cell->numConnections > 1) {
+                    CellConnectionProcessor::scheduleDelConnections(data, cell);
+                }
+
+                bool alreadyConnected = false;
+                for (int i = 0; i < cell->numConnections; ++i) {
+                    auto const& connectedCell = cell->connections[i].cell;
+                    if (connectedCell == otherCell) {
+                        alreadyConnected = true;
+                        break;
+                    }
+                }
+
+                if (!alreadyConnected) {
+                    auto velDelta = cell->vel - otherCell->vel;
+                    auto isApproaching = Math::dot(posDelta, velDelta) < 0;
+
+                    if (Math::length(cell->vel) > 0.5f && isApproaching) {
+                        auto distanceSquared = distance * distance + 0.25f;
+                        auto force1 = posDelta * Math::dot(velDelta, posDelta) / (-2 * distanceSquared);
+                        auto force2 = posDelta * Math::dot(velDelta, posDelta) / (2 * distanceSquared);
+                        atomicAdd(&cell->temp1.x, force1.x);
+                        atomicAdd(&cell->temp1.y, force1.y);
+                        atomicAdd(&otherCell->temp1.x, force2.x);
+                        atomicAdd(&otherCell->temp1.y, force2.y);
+                    } else {
+                        auto force = Math::normalized(posDelta)
+                            * (parameters.cellMaxCollisionDistance - Math::length(posDelta))
+                            * parameters.cellRepulsionStrength;
+                        atomicAdd(&cell->temp1.x, force.x);
+                        atomicAdd(&cell->temp1.y, force.y);
+                        atomicAdd(&otherCell->temp1.x, -force.x);
+                        atomicAdd(&otherCell->temp1.y, -force.y);
+                    }
+
+                    if (cell->numConnections < cell->maxConnections
+                        && otherCell->numConnections < otherCell->maxConnections
+                        && Math::length(velDelta)
+                            >= SpotCalculator::calc(&SimulationParametersSpotValues::cellFusionVelocity, data, cell->absPos)
+                        && isApproaching && cell->energy <= parameters.spotValues.cellMaxBindingEnergy
+                        && otherCell->energy <= parameters.spotValues.cellMaxBindingEnergy) {
+                        CellConnectionProcessor::scheduleAddConnections(data, cell, otherCell, true);
+                    }
+                }
+            });
+        }
+    }
+
+    inline void CellProcessor::applyAndCheckForces(SimulationData& data, ThreadContext const& context)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            auto force = cell->temp1;
+            if (Math::length(force) > SpotCalculator::calc(&SimulationParametersSpotValues::cellMaxForce, data, cell->absPos)) {
+                if (data.numberGen.random(cell) < parameters.cellMaxForceDecayProb) {
+                    CellConnectionProcessor::scheduleDelCellAndConnections(data, cell, index);
+                }
+            }
+
+            auto origVel = cell->vel;
+            cell->vel = cell->vel + force;
+            if (Math::length(cell->vel) > parameters.cellMaxVel) {
+                cell->vel = Math::normalized(cell->vel) * parameters.cellMaxVel;
+            }
+            if (cell->vel != origVel) {
+                data.markChanged(cell);
+            }
+            cell->temp1 = {0, 0};
+        }
+    }
+
+    inline void CellProcessor::calcForces(SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            if (0 == cell->numConnections) {
+                continue;
+            }
+            float2 force{0, 0};
+            float2 prevDisplacement = cell->connections[cell->numConnections - 1].cell->absPos - cell->absPos;
+            data.cellMap.mapDisplacementCorrection(prevDisplacement);
+            auto cellBindingForce =
+                SpotCalculator::calc(&SimulationParametersSpotValues::cellBindingForce, data, cell->absPos);
+            for (int i = 0; i < cell->numConnections; ++i) {
+                auto connectingCell = cell->connections[i].cell;
+
+                auto displacement = connectingCell->absPos - cell->absPos;
+                data.cellMap.mapDisplacementCorrection(displacement);
+
+                auto actualDistance = Math::length(displacement);
+                auto bondDistance = cell->connections[i].distance;
+                auto deviation = actualDistance - bondDistance;
+                force = force + Math::normalized(displacement) * deviation / 2 * cellBindingForce;
+
+                if (cell->numConnections > 1) {
+                    auto angle = Math::angleOfVector(displacement);
+                    auto prevAngle = Math::angleOfVector(prevDisplacement);
+                    auto actualAngleFromPrevious = Math::subtractAngle(angle, prevAngle);
+                    auto referenceAngleFromPrevious = cell->connections[i].angleFromPrevious;
+
+                    auto angleDeviation =
+                        std::abs(referenceAngleFromPrevious - actualAngleFromPrevious) / 2000 * cellBindingForce;
+
+                    auto force1 = Math::normalized(displacement) * angleDeviation;
+                    Math::rotateQuarterClockwise(force1);
+
+                    auto force2 = Math::normalized(prevDisplacement) * angleDeviation;
+                    Math::rotateQuarterCounterClockwise(force2);
+
+                    if (referenceAngleFromPrevious < actualAngleFromPrevious) {
+                        force1 = force1 * (-1);
+                        force2 = force2 * (-1);
+                    }
+                    atomicAdd(&connectingCell->temp1.x, force1.x);
+                    atomicAdd(&connectingCell->temp1.y, force1.y);
+                    if (i > 0) {
+                        atomicAdd(&cell->connections[i - 1].cell->temp1.x, force2.x);
+                        atomicAdd(&cell->connections[i - 1].cell->temp1.y, force2.y);
+                    } else {
+                        auto lastIndex = cell->numConnections - 1;
+                        atomicAdd(&cell->connections[lastIndex].cell->temp1.x, force2.x);
+                        atomicAdd(&cell->connections[lastIndex].cell->temp1.y, force2.y);
+                    }
+                    force = force - (force1 + force2);
+                }
+
+                prevDisplacement = displacement;
+            }
+            atomicAdd(&cell->temp1.x, force.x);
+            atomicAdd(&cell->temp1.y, force.y);
+        }
+    }
+
+    inline void CellProcessor::calcPositionsAndCheckBindings(SimulationData& data, ThreadContext const& context)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            auto origPos = cell->absPos;
+            cell->absPos = cell->absPos + cell->vel * parameters.timestepSize
+                + cell->temp1 * parameters.timestepSize * parameters.timestepSize / 2;
+            data.cellMap.mapPosCorrection(cell->absPos);
+            if (cell->absPos != origPos) {
+                data.markChanged(cell);
+            }
+            cell->temp2 = cell->temp1;  //forces
+            cell->temp1 = {0, 0};
+
+            bool scheduleForDestruction = false;
+            for (int i = 0; i < cell->numConnections; ++i) {
+                auto connectingCell = cell->connections[i].cell;
+
+                auto displacement = connectingCell->absPos - cell->absPos;
+                data.cellMap.mapDisplacementCorrection(displacement);
+                auto actualDistance = Math::length(displacement);
+                if (actualDistance > parameters.cellMaxBindingDistance) {
+                    scheduleForDestruction = true;
+                }
+            }
+            if (scheduleForDestruction) {
+                CellConnectionProcessor::scheduleDelConnections(data, cell);
+            }
+        }
+    }
+
+    inline void CellProcessor::calcVelocities(SimulationData& data, ThreadContext const& context, int numCellPointers)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(numCellPointers);
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            auto acceleration = (cell->temp1 + cell->temp2) / 2;
+            if (acceleration != float2{0, 0}) {
+                cell->vel = cell->vel + acceleration * data.constants.parameters.timestepSize;
+                data.markChanged(cell);
+            }
+        }
+    }
+
+    inline void CellProcessor::calcAveragedVelocities(SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        constexpr float preserveVelocityFactor = 0.8f;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            auto averagedVel = cell->vel * (1.0f - preserveVelocityFactor);
+            for (int index = 0; index < cell->numConnections; ++index) {
+                auto connectingCell = cell->connections[index].cell;
+                averagedVel = averagedVel + connectingCell->vel * (1.0f - preserveVelocityFactor);
+            }
+            cell->temp1 = cell->vel * preserveVelocityFactor + averagedVel / toFloat(cell->numConnections + 1);
+        }
+    }
+
+    inline void CellProcessor::applyAveragedVelocities(SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            auto friction = SpotCalculator::calc(&SimulationParametersSpotValues::friction, data, cell->absPos);
+            auto origVel = cell->vel;
+            cell->vel = cell->temp1 * (1.0f - friction);
+            if (cell->vel != origVel) {
+                data.markChanged(cell);
+            }
+        }
+    }
+
+    inline void CellProcessor::radiation(SimulationData& data, ThreadContext const& context)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            if (data.numberGen.random(cell) < parameters.radiationProb) {
+                auto radiationFactor =
+                    SpotCalculator::calc(&SimulationParametersSpotValues::radiationFactor, data, cell->absPos);
+                if (radiationFactor > 0) {
+
+                    auto& pos = cell->absPos;
+                    float2 particleVel = (cell->vel * parameters.radiationVelocityMultiplier)
+                        + float2{
+                            (data.numberGen.random(cell) - 0.5f) * parameters.radiationVelocityPerturbation,
+                            (data.numberGen.random(cell) - 0.5f) * parameters.radiationVelocityPerturbation};
+                    float2 particlePos = pos + Math::normalized(particleVel) * 1.5f;
+                    data.cellMap.mapPosCorrection(particlePos);
+
+                    auto cellEnergy = cell->energy;
+                    particlePos = particlePos - particleVel;  //because particle will still be moved in current time step
+                    float radiationEnergy = powf(cellEnergy, parameters.radiationExponent) * radiationFactor;
+                    radiationEnergy = radiationEnergy / parameters.radiationProb;
+                    radiationEnergy = 2 * radiationEnergy * data.numberGen.random(cell);
+                    if (cellEnergy > 1) {
+                        if (radiationEnergy > cellEnergy - 1) {
+                            radiationEnergy = cellEnergy - 1;
+                        }
+                        cell->energy -= radiationEnergy;
+                        data.markChanged(cell);
+
+                        EntityFactory factory;
+                        factory.init(&data);
+                        factory.createParticle(radiationEnergy, particlePos, particleVel, {cell->cold->metadata.color});
+                    }
+                }
+            }
+        }
+    }
+
+    inline void CellProcessor::decay(SimulationData& data, ThreadContext const& context)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto& cells = data.entities.cellPointers;
+        auto const partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+
+            bool destroyDueToTokenUsage = false;
+            if (cell->cold->tokenUsages > parameters.cellMinTokenUsages) {
+                if (data.numberGen.random(cell) < parameters.cellTokenUsageDecayProb) {
+                    destroyDueToTokenUsage = true;
+                }
+            }
+
+            auto cellMinEnergy = SpotCalculator::calc(&SimulationParametersSpotValues::cellMinEnergy, data, cell->absPos);
+            auto cellMaxBindingEnergy =
+                SpotCalculator::calc(&SimulationParametersSpotValues::cellMaxBindingEnergy, data, cell->absPos);
+            if (cell->energy < cellMinEnergy || destroyDueToTokenUsage) {
+                CellConnectionProcessor::scheduleDelCellAndConnections(data, cell, index);
+            } else if (cell->energy > cellMaxBindingEnergy) {
+                CellConnectionProcessor::scheduleDelConnections(data, cell);
+            }
+        }
+    }
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "Array.h"
+#include "SimulationData.h"
+#include "ThreadPool.h"
+
+namespace Cpu
+{
+    template <typename Entity>
+    void cleanupEntities(Array<Entity>& entityArray, Array<Entity>& newEntityArray, ThreadContext const& context)
+    {
+        auto partition = context.calcPartition(entityArray.getNumEntries());
+
+        int numEntities = 0;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            if (entityArray.at(index) != nullptr) {
+                ++numEntities;
+            }
+        }
+        if (0 == numEntities) {
+            return;
+        }
+
+        auto newEntities = newEntityArray.getNewSubarray(numEntities);
+        int newIndex = 0;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& entity = entityArray.at(index);
+            if (entity != nullptr) {
+                newEntities[newIndex++] = entity;
+            }
+        }
+    }
+
+    inline void cleanupParticles(Array<Particle*>& particlePointers, Array<Particle>& particles, ThreadContext const& context)
+    {
+        //assumes that particlePointers are already cleaned up
+        auto pointerBlock = context.calcPartition(particlePointers.getNumEntries());
+
+        int numParticlesToCopy = pointerBlock.numElements();
+        if (numParticlesToCopy > 0) {
+            auto newParticles = particles.getNewSubarray(numParticlesToCopy);
+
+            int newParticleIndex = 0;
+            for (int index = pointerBlock.startIndex; index <= pointerBlock.endIndex; ++index) {
+                auto& particlePointer = particlePointers.at(index);
+                auto& newParticle = newParticles[newParticleIndex];
+                newParticle = *particlePointer;
+                particlePointer = &newParticle;
+
+                ++newParticleIndex;
+            }
+        }
+    }
+
+    inline void cleanupCellsStep1(
+        Array<Cell*>& cellPointers,
+        Array<Cell>& cells,
+        Array<CellColdData>& cellColdData,
+        ThreadContext const& context)
+    {
+        //assumes that cellPointers are already cleaned up
+        auto pointerBlock = context.calcPartition(cellPointers.getNumEntries());
+
+        int numCellsToCopy = pointerBlock.numElements();
+        if (numCellsToCopy > 0) {
+            auto newCells = cells.getNewSubarray(numCellsToCopy);
+            auto newCellColdData = cellColdData.getNewSubarray(numCellsToCopy);
+
+            int newCellIndex = 0;
+            for (int index = pointerBlock.startIndex; index <= pointerBlock.endIndex; ++index) {
+                auto& cellPointer = cellPointers.at(index);
+                auto& newCell = newCells[newCellIndex];
+                newCell = *cellPointer;
+                newCellColdData[newCellIndex] = *cellPointer->cold;
+                newCell.cold = &newCellColdData[newCellIndex];
+
+                cellPointer->tag = static_cast<int>(&newCell - cells.getArray());  //save index of new cell in old cell
+                cellPointer = &newCell;
+
+                ++newCellIndex;
+            }
+        }
+    }
+
+    inline void cleanupCellsStep2(Array<Token*>& tokenPointers, Array<Cell>& cells, ThreadContext const& context)
+    {
+        {
+            auto partition = context.calcPartition(cells.getNumEntries());
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto& cell = cells.at(index);
+                for (int i = 0; i < cell.numConnections; ++i) {
+                    auto& connectedCell = cell.connections[i].cell;
+                    cell.connections[i].cell = &cells.at(connectedCell->tag);
+                }
+            }
+        }
+        {
+            auto partition = context.calcPartition(tokenPointers.getNumEntries());
+
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                if (auto& token = tokenPointers.at(index)) {
+                    token->cell = &cells.at(token->cell->tag);
+                    token->sourceCell = &cells.at(token->sourceCell->tag);
+                }
+            }
+        }
+    }
+
+    inline void cleanupTokens(Array<Token*>& tokenPointers, Array<Token>& newToken, ThreadContext const& context)
+    {
+        auto partition = context.calcPartition(tokenPointers.getNumEntries());
+
+        if (partition.numElements() > 0) {
+            Token* newEntities = newToken.getNewSubarray(partition.numElements());
+
+            int targetIndex = 0;
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto& token = tokenPointers.at(index);
+                newEntities[targetIndex] = *token;
+                token = &newEntities[targetIndex];
+                ++targetIndex;
+            }
+        }
+    }
+
+    /************************************************************************/
+    /* Main                                                                 */
+    /************************************************************************/
+
+    namespace Cleanup
+    {
+        template <typename Entity>
+        void cleanupPointers(ThreadPool& threadPool, Array<Entity*>& pointers, Array<Entity*>& pointersForCleanup)
+        {
+            pointersForCleanup.reset();
+            threadPool.execute(
+                [&](ThreadContext const& context) { cleanupEntities<Entity*>(pointers, pointersForCleanup, context); });
+        }
+
+        inline void cleanupAllPointers(ThreadPool& threadPool, Entities& entities, Entities& entitiesForCleanup)
+        {
+            cleanupPointers(threadPool, entities.particlePointers, entitiesForCleanup.particlePointers);
+            cleanupPointers(threadPool, entities.cellPointers, entitiesForCleanup.cellPointers);
+            cleanupPointers(threadPool, entities.tokenPointers, entitiesForCleanup.tokenPointers);
+        }
+
+        inline void copyParticles(ThreadPool& threadPool, Array<Particle*>& particlePointers, Array<Particle>& particles)
+        {
+            particles.reset();
+            threadPool.execute(
+                [&](ThreadContext const& context) { cleanupParticles(particlePointers, particles, context); });
+        }
+
+        inline void copyCells(
+            ThreadPool& threadPool,
+            Array<Cell*>& cellPointers,
+            Array<Token*>& tokenPointers,
+            Array<Cell>& cells,
+            Array<CellColdData>& cellColdData)
+        {
+            cells.reset();
+            cellColdData.reset();
+            threadPool.execute(
+                [&](ThreadContext const& context) { cleanupCellsStep1(cellPointers, cells, cellColdData, context); });
+            threadPool.execute([&](ThreadContext const& context) { cleanupCellsStep2(tokenPointers, cells, context); });
+        }
+
+        inline void copyTokens(ThreadPool& threadPool, Array<Token*>& tokenPointers, Array<Token>& tokens)
+        {
+            tokens.reset();
+            threadPool.execute([&](ThreadContext const& context) { cleanupTokens(tokenPointers, tokens, context); });
+        }
+
+        inline void swapPointers(Entities& entities, Entities& entitiesForCleanup)
+        {
+            entities.particlePointers.swapContent(entitiesForCleanup.particlePointers);
+            entities.cellPointers.swapContent(entitiesForCleanup.cellPointers);
+            entities.tokenPointers.swapContent(entitiesForCleanup.tokenPointers);
+        }
+    }
+
+    inline void cleanupAfterSimulation(ThreadPool& threadPool, SimulationData& data)
+    {
+        threadPool.execute([&](ThreadContext const& context) {
+            data.cellMap.cleanup(context);
+            data.particleMap.cleanup(context);
+        });
+
+        Cleanup::cleanupAllPointers(threadPool, data.entities, data.entitiesForCleanup);
+        Cleanup::swapPointers(data.entities, data.entitiesForCleanup);
+
+        auto& entities = data.entities;
+        auto& entitiesForCleanup = data.entitiesForCleanup;
+        auto fillLevelFactor = data.constants.engineSettings.ARRAY_FILL_LEVEL_FACTOR;
+        if (entities.particles.getNumEntries() > entities.particles.getSize() * fillLevelFactor) {
+            Cleanup::copyParticles(threadPool, entities.particlePointers, entitiesForCleanup.particles);
+            entities.particles.swapContent(entitiesForCleanup.particles);
+        }
+
+        if (entities.cells.getNumEntries() > entities.cells.getSize() * fillLevelFactor
+            || entities.cellColdData.getNumEntries() > entities.cellColdData.getSize() * fillLevelFactor) {
+            Cleanup::copyCells(
+                threadPool,
+                entities.cellPointers,
+                entities.tokenPointers,
+                entitiesForCleanup.cells,
+                entitiesForCleanup.cellColdData);
+            entities.cells.swapContent(entitiesForCleanup.cells);
+            entities.cellColdData.swapContent(entitiesForCleanup.cellColdData);
+        }
+
+        if (entities.tokens.getNumEntries() > entities.tokens.getSize() * fillLevelFactor) {
+            Cleanup::copyTokens(threadPool, entities.tokenPointers, entitiesForCleanup.tokens);
+            entities.tokens.swapContent(entitiesForCleanup.tokens);
+        }
+
+        data.strings.collectGarbage();
+    }
+
+    inline void cleanupAfterDataManipulation(ThreadPool& threadPool, SimulationData& data)
+    {
+        auto& entities = data.entities;
+        auto& entitiesForCleanup = data.entitiesForCleanup;
+
+        Cleanup::cleanupAllPointers(threadPool, entities, entitiesForCleanup);
+        Cleanup::swapPointers(entities, entitiesForCleanup);
+
+        Cleanup::copyParticles(threadPool, entities.particlePointers, entitiesForCleanup.particles);
+        entities.particles.swapContent(entitiesForCleanup.particles);
+
+        Cleanup::copyCells(
+            threadPool,
+            entities.cellPointers,
+            entities.tokenPointers,
+            entitiesForCleanup.cells,
+            entitiesForCleanup.cellColdData);
+        entities.cells.swapContent(entitiesForCleanup.cells);
+        entities.cellColdData.swapContent(entitiesForCleanup.cellColdData);
+
+        Cleanup::copyTokens(threadPool, entities.tokenPointers, entitiesForCleanup.tokens);
+        entities.tokens.swapContent(entitiesForCleanup.tokens);
+
+        data.strings.collectGarbage();
+    }
+}
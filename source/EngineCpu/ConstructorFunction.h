@@ -0,0 +1,541 @@
+#pragma once
+
+#include <algorithm>
+
+#include "EngineInterface/ElementaryTypes.h"
+
+#include "CellConnectionProcessor.h"
+#include "EntityFactory.h"
+#include "Math.h"
+#include "QuantityConverter.h"
+#include "SimulationResult.h"
+
+namespace Cpu
+{
+    class ConstructorFunction
+    {
+    public:
+        static void processing(Token* token, SimulationData& data, SimulationResult& result);
+
+    private:
+        struct ConstructionData
+        {
+            Enums::ConstrIn::Type constrIn;
+            bool isConstructToken;
+            bool isDuplicateTokenMemory;
+            bool isFinishConstruction;
+            bool isSeparateConstruction;
+            int angleAlignment;
+            bool uniformDist;
+            char angle;
+            char distance;
+            char maxConnections;
+            char branchNumber;
+            char metaData;
+            char cellFunctionType;
+        };
+        static void readConstructionData(Token* token, SimulationParameters const& parameters, ConstructionData& data);
+
+        static Cell* getFirstCellOfConstructionSite(Token* token);
+        static void startNewConstruction(
+            Token* token,
+            SimulationData& data,
+            SimulationResult& result,
+            ConstructionData& constructionData);
+        static void continueConstruction(
+            Token* token,
+            SimulationData& data,
+            SimulationResult& result,
+            ConstructionData const& constructionData,
+            Cell* firstConstructedCell);
+
+        static void constructCell(
+            SimulationData& data,
+            Token* token,
+            float2 const& posOfNewCell,
+            float const energyOfNewCell,
+            ConstructionData const& constructionData,
+            Cell*& result);
+
+        enum class AdaptMaxConnections
+        {
+            No,
+            Yes
+        };
+        static AdaptMaxConnections
+        isAdaptMaxConnections(ConstructionData const& data, SimulationParameters const& parameters);
+
+        static int getMaxConnections(ConstructionData const& data, SimulationParameters const& parameters);
+
+        static bool isConnectable(
+            int numConnections,
+            int maxConnections,
+            AdaptMaxConnections adaptMaxConnections,
+            SimulationParameters const& parameters);
+
+        struct AnglesForNewConnection
+        {
+            float angleFromPreviousConnection;
+            float angleForCell;
+        };
+        static AnglesForNewConnection calcAnglesForNewConnection(SimulationData& data, Cell* cell, float angleDeviation);
+
+        struct EnergyForNewEntities
+        {
+            bool energyAvailable;
+            float cell;
+            float token;
+        };
+        static EnergyForNewEntities
+        adaptEnergies(Token* token, ConstructionData const& data, SimulationParameters const& parameters);
+
+        static Token* constructToken(
+            SimulationData& data,
+            Cell* cell,
+            Token* token,
+            Cell* sourceCell,
+            float energy,
+            bool duplicateMemory);
+    };
+
+    /************************************************************************/
+    /* Implementation                                                       */
+    /************************************************************************/
+    inline void ConstructorFunction::processing(Token* token, SimulationData& data, SimulationResult& result)
+    {
+        ConstructionData constructionData;
+        readConstructionData(token, data.constants.parameters, constructionData);
+
+        if (Enums::ConstrIn::DO_NOTHING == constructionData.constrIn) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::SUCCESS;
+            return;
+        }
+
+        Cell* firstCellOfConstructionSite = getFirstCellOfConstructionSite(token);
+
+        if (firstCellOfConstructionSite) {
+            if (!firstCellOfConstructionSite->tryLock()) {
+                token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_LOCK;
+                return;
+            }
+
+            continueConstruction(token, data, result, constructionData, firstCellOfConstructionSite);
+            firstCellOfConstructionSite->releaseLock();
+        } else {
+            startNewConstruction(token, data, result, constructionData);
+        }
+    }
+
+    inline void ConstructorFunction::readConstructionData(
+        Token* token,
+        SimulationParameters const& parameters,
+        ConstructionData& data)
+    {
+        auto const& memory = token->memory;
+        data.constrIn = static_cast<Enums::ConstrIn::Type>(
+            static_cast<unsigned char>(token->memory[Enums::Constr::INPUT]) % Enums::ConstrIn::_COUNTER);
+
+        auto option = static_cast<Enums::ConstrInOption::Type>(
+            static_cast<unsigned char>(token->memory[Enums::Constr::IN_OPTION]) % Enums::ConstrInOption::_COUNTER);
+
+        data.isConstructToken = Enums::ConstrInOption::CREATE_EMPTY_TOKEN == option
+            || Enums::ConstrInOption::CREATE_DUP_TOKEN == option
+            || Enums::ConstrInOption::FINISH_WITH_EMPTY_TOKEN_SEP == option
+            || Enums::ConstrInOption::FINISH_WITH_DUP_TOKEN_SEP == option;
+        data.isDuplicateTokenMemory = (Enums::ConstrInOption::CREATE_DUP_TOKEN == option
+                                       || Enums::ConstrInOption::FINISH_WITH_DUP_TOKEN_SEP == option)
+            && !parameters.cellFunctionConstructorOffspringTokenSuppressMemoryCopy;
+        data.isFinishConstruction = Enums::ConstrInOption::FINISH_NO_SEP == option
+            || Enums::ConstrInOption::FINISH_WITH_SEP == option
+            || Enums::ConstrInOption::FINISH_WITH_EMPTY_TOKEN_SEP == option
+            || Enums::ConstrInOption::FINISH_WITH_DUP_TOKEN_SEP == option;
+        data.isSeparateConstruction = Enums::ConstrInOption::FINISH_WITH_SEP == option
+            || Enums::ConstrInOption::FINISH_WITH_EMPTY_TOKEN_SEP == option
+            || Enums::ConstrInOption::FINISH_WITH_DUP_TOKEN_SEP == option;
+
+        data.angleAlignment = static_cast<unsigned char>(memory[Enums::Constr::IN_ANGLE_ALIGNMENT]);
+
+        data.uniformDist = static_cast<Enums::ConstrInUniformDist::Type>(
+                               static_cast<unsigned char>(token->memory[Enums::Constr::IN_UNIFORM_DIST])
+                               % Enums::ConstrInUniformDist::_COUNTER)
+            == Enums::ConstrInUniformDist::YES;
+
+        data.angle = memory[Enums::Constr::INOUT_ANGLE];
+        data.distance = memory[Enums::Constr::IN_DIST];
+        data.maxConnections = memory[Enums::Constr::IN_CELL_MAX_CONNECTIONS];
+        data.branchNumber = memory[Enums::Constr::IN_CELL_BRANCH_NO];
+        data.metaData = memory[Enums::Constr::IN_CELL_METADATA];
+        data.cellFunctionType = memory[Enums::Constr::IN_CELL_FUNCTION];
+    }
+
+    inline Cell* ConstructorFunction::getFirstCellOfConstructionSite(Token* token)
+    {
+        Cell* result = nullptr;
+        auto const& cell = token->cell;
+        for (int i = 0; i < cell->numConnections; ++i) {
+            auto const& connectingCell = cell->connections[i].cell;
+            if (connectingCell->tokenBlocked) {
+                result = connectingCell;
+            }
+        }
+        return result;
+    }
+
+    inline void ConstructorFunction::startNewConstruction(
+        Token* token,
+        SimulationData& data,
+        SimulationResult& result,
+        ConstructionData& constructionData)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto const& cell = token->cell;
+        auto const adaptMaxConnections = isAdaptMaxConnections(constructionData, parameters);
+
+        if (!isConnectable(cell->numConnections, cell->maxConnections, adaptMaxConnections, parameters)) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_CONNECTION;
+            return;
+        }
+
+        auto const anglesForNewConnection =
+            calcAnglesForNewConnection(data, cell, QuantityConverter::convertDataToAngle(constructionData.angle));
+
+        auto const relPosOfNewCellDelta = Math::unitVectorOfAngle(anglesForNewConnection.angleForCell)
+            * parameters.cellFunctionConstructorOffspringCellDistance;
+        float2 posOfNewCell = cell->absPos + relPosOfNewCellDelta;
+
+        constructionData.isConstructToken = false;  //not supported
+        auto energyForNewEntities = adaptEnergies(token, constructionData, parameters);
+
+        if (!energyForNewEntities.energyAvailable) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_NO_ENERGY;
+            return;
+        }
+
+        Cell* newCell;
+        constructCell(data, token, posOfNewCell, energyForNewEntities.cell, constructionData, newCell);
+
+        if (!newCell->tryLock()) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_LOCK;
+            return;
+        }
+
+        if (!constructionData.isFinishConstruction || !constructionData.isSeparateConstruction) {
+            CellConnectionProcessor::addConnections(
+                data,
+                cell,
+                newCell,
+                anglesForNewConnection.angleFromPreviousConnection,
+                0,
+                parameters.cellFunctionConstructorOffspringCellDistance);
+        }
+        if (constructionData.isFinishConstruction) {
+            newCell->tokenBlocked = false;
+        }
+        if (AdaptMaxConnections::Yes == adaptMaxConnections) {
+            cell->maxConnections = cell->numConnections;
+            newCell->maxConnections = newCell->numConnections;
+        }
+
+        newCell->releaseLock();
+
+        token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::SUCCESS;
+        token->memory[Enums::Constr::INOUT_ANGLE] = 0;
+        result.incCreatedCell();
+    }
+
+    inline void ConstructorFunction::continueConstruction(
+        Token* token,
+        SimulationData& data,
+        SimulationResult& result,
+        ConstructionData const& constructionData,
+        Cell* firstConstructedCell)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto cell = token->cell;
+        auto posDelta = firstConstructedCell->absPos - cell->absPos;
+        data.cellMap.mapDisplacementCorrection(posDelta);
+
+        auto desiredDistance = QuantityConverter::convertDataToDistance(constructionData.distance);
+        posDelta = Math::normalized(posDelta) * (parameters.cellFunctionConstructorOffspringCellDistance - desiredDistance);
+
+        if (Math::length(posDelta) <= parameters.cellMinDistance
+            || parameters.cellFunctionConstructorOffspringCellDistance - desiredDistance < 0) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_DIST;
+            return;
+        }
+        auto adaptMaxConnections = isAdaptMaxConnections(constructionData, parameters);
+        if (AdaptMaxConnections::No == adaptMaxConnections && 1 == constructionData.maxConnections) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_CONNECTION;
+            return;
+        }
+
+        auto energyForNewEntities = adaptEnergies(token, constructionData, parameters);
+        if (!energyForNewEntities.energyAvailable) {
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_NO_ENERGY;
+            return;
+        }
+
+        Cell* newCell;
+        auto posOfNewCell = cell->absPos + posDelta;
+        constructCell(data, token, posOfNewCell, energyForNewEntities.cell, constructionData, newCell);
+        firstConstructedCell->tokenBlocked = false;
+
+        if (!newCell->tryLock()) {
+            cell->energy +=
+                energyForNewEntities.token;  //token could not be constructed anymore => transfer energy back to cell
+            token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::ERROR_LOCK;
+            return;
+        }
+
+        if (constructionData.isConstructToken) {
+            constructToken(data, newCell, token, cell, energyForNewEntities.token, constructionData.isDuplicateTokenMemory);
+        }
+
+        float angleFromPreviousForCell = 0;
+        for (int i = 0; i < cell->numConnections; ++i) {
+            if (cell->connections[i].cell == firstConstructedCell) {
+                angleFromPreviousForCell = cell->connections[i].angleFromPrevious;
+                break;
+            }
+        }
+
+        float angleFromPreviousForFirstConstructedCell = 0;
+        for (int i = 0; i < firstConstructedCell->numConnections; ++i) {
+            if (firstConstructedCell->connections[i].cell == cell) {
+                angleFromPreviousForFirstConstructedCell = firstConstructedCell->connections[i].angleFromPrevious;
+                break;
+            }
+        }
+        CellConnectionProcessor::delConnections(data, cell, firstConstructedCell);
+        if (!constructionData.isFinishConstruction || !constructionData.isSeparateConstruction) {
+            CellConnectionProcessor::addConnections(
+                data,
+                cell,
+                newCell,
+                angleFromPreviousForCell,
+                0,
+                parameters.cellFunctionConstructorOffspringCellDistance);
+        }
+        auto angleFromPreviousForNewCell = QuantityConverter::convertDataToAngle(constructionData.angle) + 180.0f;
+        CellConnectionProcessor::addConnections(
+            data,
+            newCell,
+            firstConstructedCell,
+            angleFromPreviousForNewCell,
+            angleFromPreviousForFirstConstructedCell,
+            desiredDistance);
+
+        if (constructionData.isFinishConstruction) {
+            newCell->tokenBlocked = false;
+        }
+
+        Math::normalize(posDelta);
+        Math::rotateQuarterClockwise(posDelta);
+        Cell* otherCells[18];
+        int numOtherCells;
+        data.cellMap.get(
+            otherCells, 18, numOtherCells, posOfNewCell, parameters.cellFunctionConstructorOffspringCellDistance);
+        for (int i = 0; i < numOtherCells; ++i) {
+            Cell* otherCell = otherCells[i];
+            if (otherCell == firstConstructedCell) {
+                continue;
+            }
+            if (otherCell == cell) {
+                continue;
+            }
+
+            bool connected = false;
+            for (int j = 0; j < cell->numConnections; ++j) {
+                auto const& connectedCell = cell->connections[j].cell;
+                if (connectedCell == otherCell) {
+                    connected = true;
+                    break;
+                }
+            }
+            if (connected) {
+                continue;
+            }
+
+            auto otherPosDelta = otherCell->absPos - newCell->absPos;
+            data.cellMap.mapDisplacementCorrection(otherPosDelta);
+            Math::normalize(otherPosDelta);
+            if (Math::dot(posDelta, otherPosDelta) < 0.1) {
+                continue;
+            }
+            if (otherCell->tryLock()) {
+                if (isConnectable(newCell->numConnections, newCell->maxConnections, adaptMaxConnections, parameters)
+                    && isConnectable(
+                        otherCell->numConnections, otherCell->maxConnections, adaptMaxConnections, parameters)) {
+
+                    auto distance = constructionData.uniformDist ? desiredDistance : Math::length(otherPosDelta);
+                    CellConnectionProcessor::addConnections(
+                        data, newCell, otherCell, 0, 0, distance, constructionData.angleAlignment);
+                }
+                otherCell->releaseLock();
+            }
+        }
+
+        if (AdaptMaxConnections::Yes == adaptMaxConnections) {
+            cell->maxConnections = cell->numConnections;
+            newCell->maxConnections = newCell->numConnections;
+        }
+
+        newCell->releaseLock();
+
+        token->memory[Enums::Constr::OUTPUT] = Enums::ConstrOut::SUCCESS;
+        result.incCreatedCell();
+    }
+
+    inline void ConstructorFunction::constructCell(
+        SimulationData& data,
+        Token* token,
+        float2 const& posOfNewCell,
+        float const energyOfNewCell,
+        ConstructionData const& constructionData,
+        Cell*& result)
+    {
+        auto const& parameters = data.constants.parameters;
+        EntityFactory factory;
+        factory.init(&data);
+        result = factory.createCell();
+        result->energy = energyOfNewCell;
+        result->absPos = posOfNewCell;
+        data.cellMap.mapPosCorrection(result->absPos);
+        result->maxConnections = getMaxConnections(constructionData, parameters);
+        result->numConnections = 0;
+        result->branchNumber =
+            static_cast<unsigned char>(constructionData.branchNumber) % parameters.cellMaxTokenBranchNumber;
+        result->tokenBlocked = true;
+        result->cellFunctionType = constructionData.cellFunctionType;
+        result->cold->numStaticBytes = static_cast<unsigned char>(token->memory[Enums::Constr::IN_CELL_FUNCTION_DATA])
+            % (MAX_CELL_STATIC_BYTES + 1);
+        auto offset = result->cold->numStaticBytes + 1;
+        result->cold->numMutableBytes =
+            static_cast<unsigned char>(
+                token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset) % MAX_TOKEN_MEM_SIZE])
+            % (MAX_CELL_MUTABLE_BYTES + 1);
+        result->cold->metadata.color = constructionData.metaData;
+
+        for (int i = 0; i < result->cold->numStaticBytes; ++i) {
+            result->cold->staticData[i] = token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + i + 1) % MAX_TOKEN_MEM_SIZE];
+        }
+        for (int i = 0; i < result->cold->numMutableBytes; ++i) {
+            result->cold->mutableData[i] =
+                token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset + i + 1) % MAX_TOKEN_MEM_SIZE];
+        }
+    }
+
+    inline auto
+    ConstructorFunction::isAdaptMaxConnections(ConstructionData const& data, SimulationParameters const& parameters)
+        -> AdaptMaxConnections
+    {
+        return 0 == getMaxConnections(data, parameters) ? AdaptMaxConnections::Yes : AdaptMaxConnections::No;
+    }
+
+    inline int
+    ConstructorFunction::getMaxConnections(ConstructionData const& data, SimulationParameters const& parameters)
+    {
+        return static_cast<unsigned char>(data.maxConnections) % (parameters.cellMaxBonds + 1);
+    }
+
+    inline bool ConstructorFunction::isConnectable(
+        int numConnections,
+        int maxConnections,
+        AdaptMaxConnections adaptMaxConnections,
+        SimulationParameters const& parameters)
+    {
+        if (AdaptMaxConnections::Yes == adaptMaxConnections) {
+            if (numConnections >= parameters.cellMaxBonds) {
+                return false;
+            }
+        }
+        if (AdaptMaxConnections::No == adaptMaxConnections) {
+            if (numConnections >= maxConnections) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline auto
+    ConstructorFunction::calcAnglesForNewConnection(SimulationData& data, Cell* cell, float angleDeviation)
+        -> AnglesForNewConnection
+    {
+        if (0 == cell->numConnections) {
+            return AnglesForNewConnection{0, 0};
+        }
+        auto displacement = cell->connections[0].cell->absPos - cell->absPos;
+        data.cellMap.mapDisplacementCorrection(displacement);
+        auto angle = Math::angleOfVector(displacement);
+        int index = 0;
+        float largestAngleGap = 0;
+        float angleOfLargestAngleGap = 0;
+        auto numConnections = cell->numConnections;
+        for (int i = 1; i <= numConnections; ++i) {
+            auto angleDiff = cell->connections[i % numConnections].angleFromPrevious;
+            if (angleDiff > largestAngleGap) {
+                largestAngleGap = angleDiff;
+                index = i % numConnections;
+                angleOfLargestAngleGap = angle;
+            }
+            angle += angleDiff;
+        }
+        auto angleFromPreviousConnection = cell->connections[index].angleFromPrevious / 2 + angleDeviation;
+        if (angleFromPreviousConnection > 360.0f) {
+            angleFromPreviousConnection -= 360;
+        }
+
+        angleFromPreviousConnection =
+            std::max(std::min(angleFromPreviousConnection, cell->connections[index].angleFromPrevious), 0.0f);
+
+        return AnglesForNewConnection{angleFromPreviousConnection, angleOfLargestAngleGap + angleFromPreviousConnection};
+    }
+
+    inline auto ConstructorFunction::adaptEnergies(
+        Token* token,
+        ConstructionData const& data,
+        SimulationParameters const& parameters) -> EnergyForNewEntities
+    {
+        auto const& cell = token->cell;
+
+        EnergyForNewEntities result;
+        result.energyAvailable = true;
+        result.cell = parameters.cellFunctionConstructorOffspringCellEnergy;
+        result.token = data.isConstructToken ? parameters.cellFunctionConstructorOffspringTokenEnergy : 0.0f;
+
+        if (token->energy <= result.cell + result.token + parameters.tokenMinEnergy) {
+            result.energyAvailable = false;
+            return result;
+        }
+
+        token->energy -= (result.cell + result.token);
+        if (data.isConstructToken) {
+            auto const averageEnergy = (cell->energy + result.cell) / 2;
+            cell->energy = averageEnergy;
+            result.cell = averageEnergy;
+        }
+
+        return result;
+    }
+
+    inline Token* ConstructorFunction::constructToken(
+        SimulationData& data,
+        Cell* cell,
+        Token* token,
+        Cell* sourceCell,
+        float energy,
+        bool duplicateMemory)
+    {
+        EntityFactory factory;
+        factory.init(&data);
+
+        Token* result;
+        if (duplicateMemory) {
+            result = factory.duplicateToken(cell, token);
+        } else {
+            result = factory.createToken(cell, sourceCell);
+        }
+        result->energy = energy;
+        return result;
+    }
+}
@@ -0,0 +1,490 @@
+#include "CpuSimulation.h"
+
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "AccessKernels.h"
+#include "ActionKernels.h"
+#include "CleanupKernels.h"
+#include "FlowFieldKernel.h"
+#include "MonitorKernels.h"
+#include "RenderingKernels.h"
+#include "ReorderKernels.h"
+#include "SelectionResult.h"
+#include "SimulationData.h"
+#include "SimulationKernels.h"
+#include "SimulationResult.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    size_t const MaxRemovedIdHistory = 1 << 22;
+
+    //versions are unique among all simulations such that a version of a previous simulation yields complete data
+    std::atomic<uint64_t> LastDataVersion{0};
+
+    uint64_t createDataVersion()
+    {
+        return ++LastDataVersion;
+    }
+}
+
+_CpuSimulation::_CpuSimulation(
+    uint64_t timestep,
+    Settings const& settings,
+    GpuSettings const& gpuSettings,
+    EngineSettings const& engineSettings)
+    : _threadPool(std::make_unique<Cpu::ThreadPool>())
+    , _simulationData(std::make_unique<Cpu::SimulationData>())
+    , _simulationResult(std::make_unique<Cpu::SimulationResult>())
+    , _selectionResult(std::make_unique<Cpu::SelectionResult>())
+    , _dataVersion(createDataVersion())
+    , _oldestDeltaVersion(_dataVersion)
+{
+    setSimulationParameters(settings.simulationParameters);
+    setSimulationParametersSpots(settings.simulationParametersSpots);
+    setGpuConstants(gpuSettings);
+    setEngineSettings(engineSettings);
+    setFlowFieldSettings(settings.flowFieldSettings);
+
+    auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+    loggingService->logMessage(
+        Priority::Important,
+        "initialize simulation on " + std::to_string(_threadPool->getNumThreads()) + " CPU threads");
+
+    _currentTimestep.store(timestep);
+
+    int2 worldSize{settings.generalSettings.worldSizeX, settings.generalSettings.worldSizeY};
+    _simulationData->init(worldSize);
+    _simulationData->dataVersion = _dataVersion;
+
+    //default array sizes for empty simulation (will be resized later if not sufficient)
+    resizeArrays({100000, 100000, 10000});
+}
+
+_CpuSimulation::~_CpuSimulation()
+{
+    auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+    loggingService->logMessage(Priority::Important, "close simulation");
+}
+
+void* _CpuSimulation::registerImageResource(GLuint image)
+{
+    //there is no interop resource on the host => the texture name itself serves as resource handle
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(image));
+}
+
+void _CpuSimulation::calcTimestep()
+{
+    auto& data = *_simulationData;
+    auto& result = *_simulationResult;
+    auto& threadPool = *_threadPool;
+    auto& profiler = _stageProfiler;
+
+    profiler.beginTimestep();
+    data.numberGen.prepareForTimestep(static_cast<uint32_t>(_engineSettings.RANDOM_SEED), _currentTimestep.load());
+    data.prepareForSimulation();
+    result.resetStatistics();
+
+    if (data.constants.flowFieldSettings.active) {
+        profiler.measure("applyFlowFieldSettings", [&] {
+            threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::applyFlowFieldSettings(data, context); });
+        });
+    }
+
+    //the number of entries has to be determined before each step since it may be changed during the step
+    profiler.measure("buildCellMap", [&] { data.cellMap.build(threadPool, data.entities.cellPointers); });
+    profiler.measure("processingStep1", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep1(data, context); });
+    });
+    profiler.measure("processingStep2", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep2(data, context); });
+    });
+    profiler.measure("processingStep3", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep3(data, context); });
+    });
+    profiler.measure("processingStep4", [&] {
+        auto numTokenPointers = data.entities.tokenPointers.getNumEntries();
+        threadPool.execute(
+            [&](Cpu::ThreadContext const& context) { Cpu::processingStep4(data, context, numTokenPointers); });
+    });
+    profiler.measure("processingStep5", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep5(data, context); });
+    });
+    profiler.measure("processingStep6", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep6(data, context, result); });
+    });
+    profiler.measure("processingStep7", [&] {
+        auto numCellPointers = data.entities.cellPointers.getNumEntries();
+        threadPool.execute(
+            [&](Cpu::ThreadContext const& context) { Cpu::processingStep7(data, context, numCellPointers); });
+    });
+    profiler.measure("processingStep8", [&] {
+        auto numTokenPointers = data.entities.tokenPointers.getNumEntries();
+        threadPool.execute([&](Cpu::ThreadContext const& context) {
+            Cpu::processingStep8(data, context, result, numTokenPointers);
+        });
+    });
+    profiler.measure("processingStep9", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep9(data, context); });
+    });
+    profiler.measure("processingStep10", [&] {
+        threadPool.execute([&](Cpu::ThreadContext const& context) { Cpu::processingStep10(data, context); });
+    });
+    profiler.measure("processingStep11", [&] {
+        auto numOperations = data.numOperations.load();
+        threadPool.execute(
+            [&](Cpu::ThreadContext const& context) { Cpu::processingStep11(data, context, numOperations); });
+    });
+    profiler.measure("processingStep12", [&] {
+        auto numParticlePointers = data.entities.particlePointers.getNumEntries();
+        auto numOperations = data.numOperations.load();
+        threadPool.execute([&](Cpu::ThreadContext const& context) {
+            Cpu::processingStep12(data, context, numParticlePointers, numOperations);
+        });
+    });
+
+    profiler.measure("cleanupAfterSimulation", [&] { Cpu::cleanupAfterSimulation(threadPool, data); });
+    profiler.measure("reorderEntities", [&] { automaticReorderEntities(); });
+
+    result.setArrayResizeNeeded(data.shouldResize());
+
+    profiler.measure("automaticResizeArrays", [&] { automaticResizeArrays(); });
+    profiler.measure("buildTileIndices", [&] { data.buildTileIndices(threadPool); });
+    profiler.endTimestep();
+    ++_currentTimestep;
+}
+
+void _CpuSimulation::drawVectorGraphics(
+    float2 const& rectUpperLeft,
+    float2 const& rectLowerRight,
+    void* imageResource,
+    int2 const& imageSize,
+    double zoom)
+{
+    auto image = static_cast<GLuint>(reinterpret_cast<uintptr_t>(imageResource));
+
+    _imageData.resize(static_cast<size_t>(imageSize.x) * imageSize.y);
+    Cpu::drawImage(
+        *_threadPool,
+        rectUpperLeft,
+        rectLowerRight,
+        imageSize,
+        static_cast<float>(zoom),
+        *_simulationData,
+        _imageData.data());
+
+    glBindTexture(GL_TEXTURE_2D, image);
+    glTexSubImage2D(
+        GL_TEXTURE_2D, 0, 0, 0, imageSize.x, imageSize.y, GL_RGBA, GL_UNSIGNED_SHORT, _imageData.data());
+}
+
+void _CpuSimulation::getSimulationData(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    DataAccessTO const& dataTO)
+{
+    updateTileIndicesIfNecessary();
+    Cpu::getSimulationAccessData(*_threadPool, rectUpperLeft, rectLowerRight, *_simulationData, dataTO);
+}
+
+void _CpuSimulation::getClusterData(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    DataAccessTO const& dataTO)
+{
+    updateTileIndicesIfNecessary();
+    Cpu::getSimulationClusterAccessData(*_threadPool, rectUpperLeft, rectLowerRight, *_simulationData, dataTO);
+}
+
+auto _CpuSimulation::getExportTileSizes(int tileSize) -> std::vector<ArraySizes>
+{
+    _exportOwnerTiles.resize(_simulationData->entities.cellPointers.getNumEntries());
+    auto exportTiles = createExportTiles(tileSize);
+    auto tileCounters = Cpu::getExportTileCounters(*_threadPool, exportTiles, *_simulationData);
+
+    std::vector<ArraySizes> result(exportTiles.numTiles.x * exportTiles.numTiles.y);
+    for (int tile = 0; tile < static_cast<int>(result.size()); ++tile) {
+        auto counters = &tileCounters[tile * 5];
+        result[tile] = {counters[0], counters[1], counters[2], counters[3], counters[4]};
+    }
+    return result;
+}
+
+void _CpuSimulation::getExportTileData(int tileSize, int tile, DataAccessTO const& dataTO)
+{
+    updateTileIndicesIfNecessary();
+    Cpu::getExportTileAccessData(*_threadPool, createExportTiles(tileSize), tile, *_simulationData, dataTO);
+}
+
+void _CpuSimulation::getOverlayData(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    OverlayAccessTO const& overlayTO)
+{
+    updateTileIndicesIfNecessary();
+    Cpu::getSimulationOverlayData(*_threadPool, rectUpperLeft, rectLowerRight, *_simulationData, overlayTO);
+}
+
+auto _CpuSimulation::getSimulationDataDelta(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    uint64_t sinceVersion,
+    DataAccessTO const& dataTO) -> DataDelta
+{
+    auto& data = *_simulationData;
+    //entities changed from now on are stamped with the version of the next delta
+    auto const version = _dataVersion;
+    takeOverRemovedIds(version);
+    _dataVersion = createDataVersion();
+    data.dataVersion = _dataVersion;
+
+    DataDelta result;
+    result.version = version;
+    result.complete = 0 == sinceVersion || sinceVersion < _oldestDeltaVersion;
+    if (result.complete) {
+        sinceVersion = 0;
+    } else {
+        for (auto it = _removedCellIds.rbegin(); it != _removedCellIds.rend() && it->first > sinceVersion; ++it) {
+            result.removedCellIds.emplace_back(it->second);
+        }
+        for (auto it = _removedParticleIds.rbegin(); it != _removedParticleIds.rend() && it->first > sinceVersion;
+             ++it) {
+            result.removedParticleIds.emplace_back(it->second);
+        }
+    }
+
+    result.numChangedCells =
+        Cpu::getSimulationDeltaAccessData(*_threadPool, rectUpperLeft, rectLowerRight, sinceVersion, data, dataTO);
+
+    //the removal logs now contain the changed entities outside the rectangle
+    if (!result.complete) {
+        auto const& cellIds = data.removedCellIds;
+        auto const& particleIds = data.removedParticleIds;
+        result.removedCellIds.insert(
+            result.removedCellIds.end(), cellIds.getArray(), cellIds.getArray() + cellIds.getNumEntries());
+        result.removedParticleIds.insert(
+            result.removedParticleIds.end(),
+            particleIds.getArray(),
+            particleIds.getArray() + particleIds.getNumEntries());
+    }
+    data.removedCellIds.reset();
+    data.removedParticleIds.reset();
+    return result;
+}
+
+void _CpuSimulation::setSimulationData(DataAccessTO const& dataTO)
+{
+    Cpu::setSimulationAccessData(*_threadPool, *_simulationData, dataTO);
+    _simulationData->invalidateTileIndices();
+    invalidateDataDeltas();
+}
+
+void _CpuSimulation::addSimulationData(DataAccessTO const& dataTO)
+{
+    Cpu::addSimulationAccessData(*_threadPool, *_simulationData, dataTO);
+    _simulationData->invalidateTileIndices();
+    invalidateDataDeltas();
+}
+
+void _CpuSimulation::applyForce(ApplyForceData const& applyData)
+{
+    Cpu::applyForce(*_threadPool, applyData, *_simulationData);
+}
+
+void _CpuSimulation::switchSelection(SwitchSelectionData const& switchData)
+{
+    Cpu::switchSelection(*_threadPool, switchData, *_simulationData);
+}
+
+void _CpuSimulation::setSelection(SetSelectionData const& selectionData)
+{
+    Cpu::setSelection(*_threadPool, selectionData, *_simulationData);
+}
+
+SelectionShallowData _CpuSimulation::getSelectionShallowData()
+{
+    return Cpu::getSelectionShallowData(*_threadPool, *_simulationData, *_selectionResult);
+}
+
+void _CpuSimulation::shallowUpdateSelection(ShallowUpdateSelectionData const& shallowUpdateData)
+{
+    Cpu::shallowUpdateSelection(*_threadPool, shallowUpdateData, *_simulationData);
+    _simulationData->invalidateTileIndices();
+}
+
+void _CpuSimulation::removeSelection()
+{
+    Cpu::removeSelection(*_threadPool, *_simulationData);
+    _simulationData->invalidateTileIndices();
+}
+
+void _CpuSimulation::setGpuConstants(GpuSettings const& gpuConstants)
+{
+    //block and thread counts have no meaning for the host threads
+    _gpuSettings = gpuConstants;
+}
+
+void _CpuSimulation::setEngineSettings(EngineSettings const& engineSettings)
+{
+    _engineSettings = engineSettings;
+    _simulationData->constants.engineSettings = engineSettings;
+}
+
+void _CpuSimulation::setSimulationParameters(SimulationParameters const& parameters)
+{
+    _simulationData->constants.parameters = parameters;
+}
+
+void _CpuSimulation::setSimulationParametersSpots(SimulationParametersSpots const& spots)
+{
+    _simulationData->constants.spots = spots;
+}
+
+void _CpuSimulation::setFlowFieldSettings(FlowFieldSettings const& settings)
+{
+    _simulationData->constants.flowFieldSettings = settings;
+}
+
+auto _CpuSimulation::getArraySizes() const -> ArraySizes
+{
+    return {
+        _simulationData->entities.cells.getSize(),
+        _simulationData->entities.particles.getSize(),
+        _simulationData->entities.tokens.getSize(),
+        _simulationData->strings.getNumStrings(),
+        static_cast<int>(_simulationData->strings.getNumBytes())};
+}
+
+OverallStatistics _CpuSimulation::getMonitorData()
+{
+    OverallStatistics result;
+
+    result.timeStep = getCurrentTimestep();
+    result.numCells = _simulationData->entities.cellPointers.getNumEntries();
+    result.numParticles = _simulationData->entities.particlePointers.getNumEntries();
+    result.numTokens = _simulationData->entities.tokenPointers.getNumEntries();
+    result.totalInternalEnergy = Cpu::getInternalEnergy(*_threadPool, *_simulationData);
+
+    auto processStatistics = _simulationResult->getStatistics();
+    result.numCreatedCells = processStatistics.createdCells;
+    result.numSuccessfulAttacks = processStatistics.sucessfulAttacks;
+    result.numFailedAttacks = processStatistics.failedAttacks;
+    result.numMuscleActivities = processStatistics.muscleActivities;
+    return result;
+}
+
+vector<StageStatistics> _CpuSimulation::getStageStatistics() const
+{
+    return _stageProfiler.getStatistics();
+}
+
+uint64_t _CpuSimulation::getCurrentTimestep() const
+{
+    return _currentTimestep.load();
+}
+
+void _CpuSimulation::setCurrentTimestep(uint64_t timestep)
+{
+    _currentTimestep.store(timestep);
+}
+
+void _CpuSimulation::clear()
+{
+    Cpu::clearData(*_simulationData);
+    _simulationData->invalidateTileIndices();
+    invalidateDataDeltas();
+}
+
+void _CpuSimulation::resizeArraysIfNecessary(ArraySizes const& additionals)
+{
+    if (_simulationData->shouldResize(
+            additionals.cellArraySize, additionals.particleArraySize, additionals.tokenArraySize)) {
+        resizeArrays(additionals);
+    }
+}
+
+void _CpuSimulation::automaticResizeArrays()
+{
+    //make check after every 10th time step
+    if (_currentTimestep.load() % 10 == 0) {
+        if (_simulationResult->isArrayResizeNeeded()) {
+            resizeArrays({0, 0, 0});
+        }
+    }
+}
+
+void _CpuSimulation::automaticReorderEntities()
+{
+    auto const interval = _engineSettings.REORDER_INTERVAL;
+    if (interval > 0 && _currentTimestep.load() % interval == 0) {
+        Cpu::reorderEntities(*_threadPool, *_simulationData, _engineSettings.REORDER_CURVE);
+    }
+}
+
+void _CpuSimulation::updateTileIndicesIfNecessary()
+{
+    //the tile indices are built at the end of each time step and only need an update after data manipulations
+    auto& data = *_simulationData;
+    if (!data.cellTiles.isValid() || !data.particleTiles.isValid()) {
+        data.buildTileIndices(*_threadPool);
+    }
+}
+
+Cpu::ExportTiles _CpuSimulation::createExportTiles(int tileSize)
+{
+    auto const& size = _simulationData->size;
+    return {
+        tileSize, {(size.x + tileSize - 1) / tileSize, (size.y + tileSize - 1) / tileSize}, _exportOwnerTiles.data()};
+}
+
+void _CpuSimulation::takeOverRemovedIds(uint64_t version)
+{
+    auto& data = *_simulationData;
+    if (data.removedIdsOverflow.exchange(false)) {
+        invalidateDataDeltas();
+        return;
+    }
+
+    auto takeOver = [&](Cpu::Array<uint64_t>& ids, std::deque<std::pair<uint64_t, uint64_t>>& history) {
+        for (int i = 0; i < ids.getNumEntries(); ++i) {
+            history.emplace_back(version, ids.at(i));
+        }
+        ids.reset();
+
+        //older deltas cannot be reconstructed once their removals are discarded
+        while (history.size() > MaxRemovedIdHistory) {
+            _oldestDeltaVersion = std::max(_oldestDeltaVersion, history.front().first);
+            history.pop_front();
+        }
+    };
+    takeOver(data.removedCellIds, _removedCellIds);
+    takeOver(data.removedParticleIds, _removedParticleIds);
+}
+
+void _CpuSimulation::invalidateDataDeltas()
+{
+    _oldestDeltaVersion = _dataVersion;
+    _removedCellIds.clear();
+    _removedParticleIds.clear();
+    _simulationData->removedCellIds.reset();
+    _simulationData->removedParticleIds.reset();
+}
+
+void _CpuSimulation::resizeArrays(ArraySizes const& additionals)
+{
+    auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+    loggingService->logMessage(Priority::Important, "resize arrays");
+
+    _simulationData->resizeEntities(
+        additionals.cellArraySize, additionals.particleArraySize, additionals.tokenArraySize);
+    _simulationData->resizeRemainings();
+
+    auto cellArraySize = _simulationData->entities.cells.getSize();
+    auto particleArraySize = _simulationData->entities.particles.getSize();
+    auto tokenArraySize = _simulationData->entities.tokens.getSize();
+    loggingService->logMessage(Priority::Unimportant, "cell array size: " + std::to_string(cellArraySize));
+    loggingService->logMessage(Priority::Unimportant, "particle array size: " + std::to_string(particleArraySize));
+    loggingService->logMessage(Priority::Unimportant, "token array size: " + std::to_string(tokenArraySize));
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "EngineGpuKernels/SimulationBackend.cuh"
+
+#include "Definitions.h"
+#include "DllExport.h"
+
+namespace Cpu
+{
+    struct SimulationData;
+    class SimulationResult;
+    class SelectionResult;
+    class ThreadPool;
+    struct ExportTiles;
+}
+
+//executes the same processing steps as _CudaSimulation on a pool of host threads
+class _CpuSimulation : public _SimulationBackend
+{
+public:
+    ENGINECPU_EXPORT _CpuSimulation(
+        uint64_t timestep,
+        Settings const& settings,
+        GpuSettings const& gpuSettings,
+        EngineSettings const& engineSettings);
+    ENGINECPU_EXPORT ~_CpuSimulation() override;
+
+    ENGINECPU_EXPORT void* registerImageResource(GLuint image) override;
+
+    ENGINECPU_EXPORT void calcTimestep() override;
+
+    ENGINECPU_EXPORT void drawVectorGraphics(
+        float2 const& rectUpperLeft,
+        float2 const& rectLowerRight,
+        void* imageResource,
+        int2 const& imageSize,
+        double zoom) override;
+    ENGINECPU_EXPORT void
+    getSimulationData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO) override;
+    ENGINECPU_EXPORT void
+    getClusterData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO) override;
+    ENGINECPU_EXPORT void
+    getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, OverlayAccessTO const& overlayTO) override;
+    ENGINECPU_EXPORT std::vector<ArraySizes> getExportTileSizes(int tileSize) override;
+    ENGINECPU_EXPORT void getExportTileData(int tileSize, int tile, DataAccessTO const& dataTO) override;
+    ENGINECPU_EXPORT DataDelta getSimulationDataDelta(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        uint64_t sinceVersion,
+        DataAccessTO const& dataTO) override;
+    ENGINECPU_EXPORT void setSimulationData(DataAccessTO const& dataTO) override;
+    ENGINECPU_EXPORT void addSimulationData(DataAccessTO const& dataTO) override;
+
+    ENGINECPU_EXPORT void applyForce(ApplyForceData const& applyData) override;
+    ENGINECPU_EXPORT void switchSelection(SwitchSelectionData const& switchData) override;
+    ENGINECPU_EXPORT void setSelection(SetSelectionData const& selectionData) override;
+    ENGINECPU_EXPORT SelectionShallowData getSelectionShallowData() override;
+    ENGINECPU_EXPORT void shallowUpdateSelection(ShallowUpdateSelectionData const& shallowUpdateData) override;
+    ENGINECPU_EXPORT void removeSelection() override;
+
+    ENGINECPU_EXPORT void setGpuConstants(GpuSettings const& gpuConstants) override;
+    ENGINECPU_EXPORT void setEngineSettings(EngineSettings const& engineSettings) override;
+    ENGINECPU_EXPORT void setSimulationParameters(SimulationParameters const& parameters) override;
+    ENGINECPU_EXPORT void setSimulationParametersSpots(SimulationParametersSpots const& spots) override;
+    ENGINECPU_EXPORT void setFlowFieldSettings(FlowFieldSettings const& settings) override;
+
+    ENGINECPU_EXPORT ArraySizes getArraySizes() const override;
+
+    ENGINECPU_EXPORT OverallStatistics getMonitorData() override;
+    ENGINECPU_EXPORT vector<StageStatistics> getStageStatistics() const override;
+    ENGINECPU_EXPORT uint64_t getCurrentTimestep() const override;
+    ENGINECPU_EXPORT void setCurrentTimestep(uint64_t timestep) override;
+
+    ENGINECPU_EXPORT void clear() override;
+
+    ENGINECPU_EXPORT void resizeArraysIfNecessary(ArraySizes const& additionals) override;
+
+private:
+    void automaticResizeArrays();
+    void automaticReorderEntities();
+    void resizeArrays(ArraySizes const& additionals);
+    void updateTileIndicesIfNecessary();
+    Cpu::ExportTiles createExportTiles(int tileSize);
+    void takeOverRemovedIds(uint64_t version);
+    void invalidateDataDeltas();
+
+    std::atomic<uint64_t> _currentTimestep;
+    GpuSettings _gpuSettings;
+    EngineSettings _engineSettings;
+    StageProfiler _stageProfiler;
+    std::unique_ptr<Cpu::ThreadPool> _threadPool;
+    std::unique_ptr<Cpu::SimulationData> _simulationData;
+    std::unique_ptr<Cpu::SimulationResult> _simulationResult;
+    std::unique_ptr<Cpu::SelectionResult> _selectionResult;
+    std::vector<uint64_t> _imageData;
+    std::vector<int> _exportOwnerTiles;  //tile of the cluster of each cell, determined by getExportTileSizes
+
+    //delta extraction
+    uint64_t _dataVersion;  //of the next delta
+    uint64_t _oldestDeltaVersion;  //deltas for older versions are not available anymore
+    std::deque<std::pair<uint64_t, uint64_t>> _removedCellIds;  //pairs of version and id
+    std::deque<std::pair<uint64_t, uint64_t>> _removedParticleIds;
+};
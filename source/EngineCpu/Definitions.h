@@ -0,0 +1,6 @@
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+
+class _CpuSimulation;
+using CpuSimulation = boost::shared_ptr<_CpuSimulation>;
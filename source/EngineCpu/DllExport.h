@@ -0,0 +1,11 @@
+#pragma once
+
+#if defined(_WIN32) && !defined(ALIEN_STATIC)
+#ifdef ENGINECPU_LIB
+#define ENGINECPU_EXPORT __declspec(dllexport)
+#else
+#define ENGINECPU_EXPORT __declspec(dllimport)
+#endif
+#else
+#define ENGINECPU_EXPORT
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Array.h"
+#include "Cell.h"
+#include "Particle.h"
+#include "Token.h"
+
+namespace Cpu
+{
+    struct Entities
+    {
+        Array<Cell*> cellPointers;
+        Array<Token*> tokenPointers;
+        Array<Particle*> particlePointers;
+
+        Array<Cell> cells;
+        Array<CellColdData> cellColdData;  //entry of cells[i] is referenced by cells[i].cold
+        Array<Token> tokens;
+        Array<Particle> particles;
+
+        //the pointer arrays also hold pointers to entities which are deleted in the current time step
+        void init(int maxEntities)
+        {
+            auto maxPointers = maxEntities * 10;
+            cellPointers.setMaxSize(maxPointers);
+            tokenPointers.setMaxSize(maxPointers);
+            particlePointers.setMaxSize(maxPointers);
+            cells.setMaxSize(maxEntities);
+            cellColdData.setMaxSize(maxEntities);
+            tokens.setMaxSize(maxEntities);
+            particles.setMaxSize(maxEntities);
+        }
+    };
+}
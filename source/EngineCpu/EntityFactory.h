@@ -0,0 +1,252 @@
+#pragma once
+
+#include "EngineInterface/ElementaryTypes.h"
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Base.h"
+#include "Map.h"
+#include "Math.h"
+#include "SimulationData.h"
+
+namespace Cpu
+{
+    class EntityFactory
+    {
+    public:
+        void init(SimulationData* data)
+        {
+            _data = data;
+            _map.init(data->size);
+        }
+
+        Particle* createParticleFromTO(int targetIndex, ParticleAccessTO const& particleTO, Particle* particleTargetArray)
+        {
+            Particle** particlePointer = _data->entities.particlePointers.getNewElement();
+            Particle* particle = particleTargetArray + targetIndex;
+            *particlePointer = particle;
+
+            particle->id = _data->numberGen.createNewId_kernel();
+            particle->absPos = particleTO.pos;
+            _map.mapPosCorrection(particle->absPos);
+            particle->vel = particleTO.vel;
+            particle->energy = particleTO.energy;
+            particle->locked = 0;
+            particle->selected = 0;
+            particle->generation = _data->dataVersion;
+            particle->metadata.color = particleTO.metadata.color;
+            return particle;
+        }
+
+        Cell* createCellFromTO(
+            int targetIndex,
+            CellAccessTO const& cellTO,
+            Cell* cellTargetArray,
+            CellColdData* cellColdDataTargetArray,
+            std::vector<int> const& stringIds)
+        {
+            Cell** cellPointer = _data->entities.cellPointers.getNewElement();
+            Cell* cell = cellTargetArray + targetIndex;
+            *cellPointer = cell;
+            cell->cold = cellColdDataTargetArray + targetIndex;
+
+            cell->id = _data->numberGen.createNewId_kernel();
+            cell->numRandomDraws = 0;
+            cell->absPos = cellTO.pos;
+            _map.mapPosCorrection(cell->absPos);
+            cell->vel = cellTO.vel;
+            cell->branchNumber = cellTO.branchNumber;
+            cell->tokenBlocked = cellTO.tokenBlocked;
+            cell->maxConnections = cellTO.maxConnections;
+            cell->numConnections = cellTO.numConnections;
+            for (int i = 0; i < cell->numConnections; ++i) {
+                auto& connectingCell = cell->connections[i];
+                connectingCell.cell = cellTargetArray + cellTO.connections[i].cellIndex;
+                connectingCell.distance = cellTO.connections[i].distance;
+                connectingCell.angleFromPrevious = cellTO.connections[i].angleFromPrevious;
+            }
+            cell->energy = cellTO.energy;
+            cell->cellFunctionType = cellTO.cellFunctionType;
+
+            switch (cell->cellFunctionType) {
+            case Enums::CellFunction::COMPUTER: {
+                cell->cold->numStaticBytes = cellTO.numStaticBytes;
+                cell->cold->numMutableBytes = _data->constants.parameters.cellFunctionComputerCellMemorySize;
+            } break;
+            case Enums::CellFunction::SENSOR: {
+                cell->cold->numStaticBytes = 0;
+                cell->cold->numMutableBytes = 5;
+            } break;
+            default: {
+                cell->cold->numStaticBytes = 0;
+                cell->cold->numMutableBytes = 0;
+            }
+            }
+            for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
+                cell->cold->staticData[i] = cellTO.staticData[i];
+            }
+            for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
+                cell->cold->mutableData[i] = cellTO.mutableData[i];
+            }
+            cell->cold->tokenUsages = cellTO.tokenUsages;
+            auto& metadata = cell->cold->metadata;
+            metadata.color = cellTO.metadata.color;
+            metadata.nameId = getStringId(cellTO.metadata.nameStringIndex, stringIds);
+            metadata.descriptionId = getStringId(cellTO.metadata.descriptionStringIndex, stringIds);
+            metadata.sourceCodeId = getStringId(cellTO.metadata.sourceCodeStringIndex, stringIds);
+            _data->strings.addReferences(metadata);
+
+            cell->selected = 0;
+            cell->locked = 0;
+            cell->generation = _data->dataVersion;
+            cell->temp3 = {0, 0};
+
+            return cell;
+        }
+
+        Token* createTokenFromTO(
+            int targetIndex,
+            TokenAccessTO const& tokenTO,
+            Cell* cellArray,
+            Token* tokenArray)
+        {
+            Token** tokenPointer = _data->entities.tokenPointers.getNewElement();
+            Token* token = tokenArray + targetIndex;
+            *tokenPointer = token;
+
+            token->energy = tokenTO.energy;
+            for (int i = 0; i < _data->constants.parameters.tokenMemorySize; ++i) {
+                token->memory[i] = tokenTO.memory[i];
+            }
+            token->cell = cellArray + tokenTO.cellIndex;
+            token->sourceCell = token->cell;
+            return token;
+        }
+
+        Particle* createParticle(float energy, float2 const& pos, float2 const& vel, ParticleMetadata const& metadata)
+        {
+            Particle** particlePointer = _data->entities.particlePointers.getNewElement();
+            Particle* particle = _data->entities.particles.getNewElement();
+            *particlePointer = particle;
+            particle->id = _data->numberGen.createNewId_kernel();
+            particle->selected = 0;
+            particle->locked = 0;
+            particle->generation = _data->dataVersion;
+            particle->energy = energy;
+            particle->absPos = pos;
+            particle->vel = vel;
+            particle->metadata = metadata;
+            return particle;
+        }
+
+        Cell* createRandomCell(float energy, float2 const& pos, float2 const& vel)
+        {
+            auto const& parameters = _data->constants.parameters;
+            auto cell = _data->entities.cells.getNewElement();
+            auto cellPointers = _data->entities.cellPointers.getNewElement();
+            *cellPointers = cell;
+            cell->cold = _data->entities.cellColdData.getNewElement();
+
+            cell->id = _data->numberGen.createNewId_kernel();
+            cell->numRandomDraws = 0;
+            cell->absPos = pos;
+            cell->vel = vel;
+            cell->energy = energy;
+            cell->maxConnections = _data->numberGen.random(cell, MAX_CELL_BONDS);
+            cell->branchNumber = _data->numberGen.random(cell, parameters.cellMaxTokenBranchNumber - 1);
+            cell->numConnections = 0;
+            cell->tokenBlocked = false;
+            cell->locked = 0;
+            cell->selected = 0;
+            cell->generation = _data->dataVersion;
+            cell->temp3 = {0, 0};
+            cell->cold->metadata.color = 0;
+            cell->cold->metadata.nameId = 0;
+            cell->cold->metadata.descriptionId = 0;
+            cell->cold->metadata.sourceCodeId = 0;
+            cell->cellFunctionType =
+                _data->numberGen.random(cell, static_cast<int>(Enums::CellFunction::_COUNTER) - 1);
+            switch (cell->cellFunctionType) {
+            case Enums::CellFunction::COMPUTER: {
+                cell->cold->numStaticBytes = parameters.cellFunctionComputerMaxInstructions * 3;
+                cell->cold->numMutableBytes = parameters.cellFunctionComputerCellMemorySize;
+            } break;
+            case Enums::CellFunction::SENSOR: {
+                cell->cold->numStaticBytes = 0;
+                cell->cold->numMutableBytes = 5;
+            } break;
+            default: {
+                cell->cold->numStaticBytes = 0;
+                cell->cold->numMutableBytes = 0;
+            }
+            }
+            for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
+                cell->cold->staticData[i] = _data->numberGen.random(cell, 255);
+            }
+            for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
+                cell->cold->mutableData[i] = _data->numberGen.random(cell, 255);
+            }
+            cell->cold->tokenUsages = 0;
+            return cell;
+        }
+
+        Cell* createCell()
+        {
+            auto result = _data->entities.cells.getNewElement();
+            auto cellPointer = _data->entities.cellPointers.getNewElement();
+            *cellPointer = result;
+            result->cold = _data->entities.cellColdData.getNewElement();
+            result->cold->tokenUsages = 0;
+            result->id = _data->numberGen.createNewId_kernel();
+            result->numRandomDraws = 0;
+            result->selected = 0;
+            result->locked = 0;
+            result->generation = _data->dataVersion;
+            result->temp3 = {0, 0};
+            result->cold->metadata.color = 0;
+            result->cold->metadata.nameId = 0;
+            result->cold->metadata.descriptionId = 0;
+            result->cold->metadata.sourceCodeId = 0;
+            return result;
+        }
+
+        Token* duplicateToken(Cell* targetCell, Token* sourceToken)
+        {
+            Token* token = _data->entities.tokens.getNewElement();
+            Token** tokenPointer = _data->entities.tokenPointers.getNewElement();
+            *tokenPointer = token;
+
+            *token = *sourceToken;
+            token->memory[0] = targetCell->branchNumber;
+            token->sourceCell = token->cell;
+            token->cell = targetCell;
+            _data->markChanged(targetCell);
+            return token;
+        }
+
+        Token* createToken(Cell* cell, Cell* sourceCell)
+        {
+            Token* token = _data->entities.tokens.getNewSubarray(1);
+            Token** tokenPointer = _data->entities.tokenPointers.getNewElement();
+            *tokenPointer = token;
+
+            token->cell = cell;
+            token->sourceCell = sourceCell;
+            token->memory[0] = cell->branchNumber;
+            for (int i = 1; i < MAX_TOKEN_MEM_SIZE; ++i) {
+                token->memory[i] = 0;
+            }
+            _data->markChanged(cell);
+            return token;
+        }
+
+    private:
+        //stringIds maps the string indices of the access data to ids in the string table
+        int getStringId(int stringIndex, std::vector<int> const& stringIds)
+        {
+            return -1 == stringIndex ? 0 : stringIds[stringIndex];
+        }
+
+        MapInfo _map;
+        SimulationData* _data;
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Map.h"
+#include "Math.h"
+#include "SimulationData.h"
+
+namespace Cpu
+{
+    inline float getHeight(float2 const& pos, MapInfo const& mapInfo, FlowFieldSettings const& flowFieldSettings)
+    {
+        float result = 0;
+        for (int i = 0; i < flowFieldSettings.numCenters; ++i) {
+            auto& radialFlow = flowFieldSettings.centers[i];
+            auto dist = mapInfo.mapDistance(pos, float2{radialFlow.posX, radialFlow.posY});
+            if (dist > radialFlow.radius) {
+                dist = radialFlow.radius;
+            }
+            if (Orientation::Clockwise == radialFlow.orientation) {
+                result += sqrtf(dist) * radialFlow.strength;
+            } else {
+                result -= sqrtf(dist) * radialFlow.strength;
+            }
+        }
+        return result;
+    }
+
+    inline float2 calcVelocity(float2 const& pos, MapInfo const& mapInfo, FlowFieldSettings const& flowFieldSettings)
+    {
+        auto baseValue = getHeight(pos, mapInfo, flowFieldSettings);
+        auto downValue = getHeight(pos + float2{0, 1}, mapInfo, flowFieldSettings);
+        auto rightValue = getHeight(pos + float2{1, 0}, mapInfo, flowFieldSettings);
+        float2 result{rightValue - baseValue, downValue - baseValue};
+        Math::rotateQuarterClockwise(result);
+        return result;
+    }
+
+    inline void applyFlowFieldSettings(SimulationData& data, ThreadContext const& context)
+    {
+        auto& cells = data.entities.cellPointers;
+        auto partition = context.calcPartition(cells.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& cell = cells.at(index);
+            auto velInc = calcVelocity(cell->absPos, data.cellMap, data.constants.flowFieldSettings);
+            if (velInc != float2{0, 0}) {
+                cell->vel = cell->vel + velInc;
+                data.markChanged(cell);
+            }
+        }
+    }
+}
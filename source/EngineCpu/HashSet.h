@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "Cell.h"
+
+namespace Cpu
+{
+    template <typename T>
+    struct HashFunctor
+    {};
+
+    template <typename T>
+    struct HashFunctor<T*>
+    {
+        int operator()(T* const& element) const
+        {
+            return std::abs(static_cast<int>(reinterpret_cast<std::uintptr_t>(element)) * 17);
+        }
+    };
+
+    template <>
+    struct HashFunctor<Cell*>
+    {
+        int operator()(Cell* const& cell) const { return std::abs(static_cast<int>(cell->id)); }
+    };
+
+    template <typename T, typename Hash = HashFunctor<T>>
+    class HashSet
+    {
+    public:
+        HashSet(int size, T* data)
+            : _data(data)
+        {
+            reset(size);
+        }
+
+        void reset(int size)
+        {
+            _size = size;
+            for (int i = 0; i < size; ++i) {
+                _data[i] = nullptr;
+            }
+        }
+
+        void insert(T const& element)
+        {
+            int index = _hash(element) % _size;
+            for (int i = 0; i < _size; ++i) {
+                if (nullptr == _data[index]) {
+                    break;
+                }
+                if (_data[index] == element) {
+                    return;
+                }
+                index = (index + 1) % _size;
+            }
+            _data[index] = element;
+        }
+
+        bool contains(T const& element) const
+        {
+            int index = _hash(element) % _size;
+            for (int i = 0; i < _size; ++i, index = (index + 1) % _size) {
+                if (_data[index] == element) {
+                    return true;
+                } else if (nullptr == _data[index]) {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+    private:
+        T* _data;
+        int _size;
+        Hash _hash;
+    };
+}
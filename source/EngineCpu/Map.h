@@ -0,0 +1,276 @@
+#pragma once
+
+#include <vector>
+
+#include "Array.h"
+#include "Base.h"
+#include "Cell.h"
+#include "Math.h"
+#include "Particle.h"
+#include "ThreadPool.h"
+
+namespace Cpu
+{
+    class MapInfo
+    {
+    public:
+        void init(int2 const& size) { _size = size; }
+
+        void mapPosCorrection(int2& pos) const
+        {
+            pos = {((pos.x % _size.x) + _size.x) % _size.x, ((pos.y % _size.y) + _size.y) % _size.y};
+        }
+
+        void mapPosCorrection(float2& pos) const
+        {
+            int2 intPart{floorInt(pos.x), floorInt(pos.y)};
+            float2 fracPart = {pos.x - intPart.x, pos.y - intPart.y};
+            mapPosCorrection(intPart);
+            pos = {static_cast<float>(intPart.x) + fracPart.x, static_cast<float>(intPart.y) + fracPart.y};
+        }
+
+        void mapDisplacementCorrection(float2& disp) const
+        {
+            disp.x = remainderf(disp.x, static_cast<float>(_size.x));
+            disp.y = remainderf(disp.y, static_cast<float>(_size.y));
+        }
+
+        float mapDistance(float2 const& p, float2 const& q) const
+        {
+            float2 d = {p.x - q.x, p.y - q.y};
+            mapDisplacementCorrection(d);
+            return sqrtf(d.x * d.x + d.y * d.y);
+        }
+
+        float2 correctionIncrement(float2 pos1, float2 pos2) const
+        {
+            float2 result{0.0f, 0.0f};
+            if (pos2.x - pos1.x > _size.x / 2) {
+                result.x = static_cast<float>(-_size.x);
+            }
+            if (pos1.x - pos2.x > _size.x / 2) {
+                result.x = static_cast<float>(_size.x);
+            }
+            if (pos2.y - pos1.y > _size.y / 2) {
+                result.y = static_cast<float>(-_size.y);
+            }
+            if (pos1.y - pos2.y > _size.y / 2) {
+                result.y = static_cast<float>(_size.y);
+            }
+            return result;
+        }
+
+        int getMaxRadius() const { return std::min(_size.x, _size.y) / 4; }
+
+    protected:
+        int2 _size;
+    };
+
+    //exact cell list: the cells are sorted into the buckets of a unit grid by a counting sort which is rebuilt in
+    //every time step, thus there is no limit on the number of cells per grid unit
+    class CellMap : public MapInfo
+    {
+    public:
+        void init(int2 const& size)
+        {
+            MapInfo::init(size);
+            _bucketSizes.assign(size.x * size.y, 0);
+            _bucketOffsets.assign(size.x * size.y, 0);
+        }
+
+        void resize(int maxEntries)
+        {
+            _entries.resize(maxEntries);
+            _occupiedBuckets.resize(maxEntries);
+            _cellBuckets.resize(maxEntries);
+        }
+
+        void reset()
+        {
+            _entries.reset();
+            _occupiedBuckets.reset();
+        }
+
+        void build(ThreadPool& threadPool, Array<Cell*>& cellPointers)
+        {
+            if (cellPointers.getNumEntries() > static_cast<int>(_cellBuckets.size())) {
+                throw BugReportException("Cell map is too small!");
+            }
+            threadPool.execute([&](ThreadContext const& context) { countCells(cellPointers, context); });
+            threadPool.execute([&](ThreadContext const& context) { allocateBuckets(context); });
+            threadPool.execute([&](ThreadContext const& context) { fillBuckets(cellPointers, context); });
+        }
+
+        //calls func for each cell in the 3x3 grid units around pos
+        template <typename Func>
+        void executeForEachInNeighborhood(float2 const& pos, Func const& func) const
+        {
+            int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    executeForEachInBucket({posInt.x + dx, posInt.y + dy}, func);
+                }
+            }
+        }
+
+        //calls func for each cell within radius around pos
+        template <typename Func>
+        void executeForEach(float2 const& pos, float radius, Func const& func) const
+        {
+            int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
+            int radiusInt = static_cast<int>(ceilf(radius));
+            for (int dx = -radiusInt; dx <= radiusInt; ++dx) {
+                for (int dy = -radiusInt; dy <= radiusInt; ++dy) {
+                    executeForEachInBucket({posInt.x + dx, posInt.y + dy}, [&](Cell* cell) {
+                        if (mapDistance(cell->absPos, pos) <= radius) {
+                            func(cell);
+                        }
+                    });
+                }
+            }
+        }
+
+        //returns at most arraySize cells within radius around pos
+        void get(Cell* cells[], int arraySize, int& numCells, float2 const& pos, float radius) const
+        {
+            numCells = 0;
+            executeForEach(pos, radius, [&](Cell* cell) {
+                if (numCells < arraySize) {
+                    cells[numCells++] = cell;
+                }
+            });
+        }
+
+        Cell* getFirst(float2 const& pos) const
+        {
+            int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
+            auto bucket = calcBucket(posInt);
+            return _bucketSizes[bucket] > 0 ? _entries.at(_bucketOffsets[bucket]) : nullptr;
+        }
+
+        void cleanup(ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(_occupiedBuckets.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                _bucketSizes[_occupiedBuckets.at(index)] = 0;
+            }
+        }
+
+    private:
+        int calcBucket(int2 pos) const
+        {
+            mapPosCorrection(pos);
+            return pos.x + pos.y * _size.x;
+        }
+
+        template <typename Func>
+        void executeForEachInBucket(int2 const& pos, Func const& func) const
+        {
+            auto bucket = calcBucket(pos);
+            auto offset = _bucketOffsets[bucket];
+            for (int i = 0, size = _bucketSizes[bucket]; i < size; ++i) {
+                func(_entries.at(offset + i));
+            }
+        }
+
+        //pass 1: determine bucket sizes and the rank of each cell within its bucket
+        void countCells(Array<Cell*>& cellPointers, ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(cellPointers.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& cell = cellPointers.at(index);
+                if (!cell) {
+                    _cellBuckets[index] = {-1, 0};
+                    continue;
+                }
+                auto bucket = calcBucket({floorInt(cell->absPos.x), floorInt(cell->absPos.y)});
+                auto rank = atomicAdd(&_bucketSizes[bucket], 1);
+                if (0 == rank) {
+                    *_occupiedBuckets.getNewElement() = bucket;
+                }
+                _cellBuckets[index] = {bucket, rank};
+            }
+        }
+
+        //pass 2: reserve a contiguous range of entries for each occupied bucket
+        void allocateBuckets(ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(_occupiedBuckets.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto bucket = _occupiedBuckets.at(index);
+                auto bucketEntries = _entries.getNewSubarray(_bucketSizes[bucket]);
+                _bucketOffsets[bucket] = static_cast<int>(bucketEntries - _entries.getArray());
+            }
+        }
+
+        //pass 3: scatter the cells into their ranges
+        void fillBuckets(Array<Cell*>& cellPointers, ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(cellPointers.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& bucketAndRank = _cellBuckets[index];
+                if (bucketAndRank.x >= 0) {
+                    _entries.at(_bucketOffsets[bucketAndRank.x] + bucketAndRank.y) = cellPointers.at(index);
+                }
+            }
+        }
+
+        std::vector<int> _bucketSizes;  //zero outside of occupied buckets
+        std::vector<int> _bucketOffsets;  //only valid for occupied buckets
+        std::vector<int2> _cellBuckets;  //bucket and rank for each entry in cellPointers
+        Array<Cell*> _entries;
+        Array<int> _occupiedBuckets;
+    };
+
+    class ParticleMap : public MapInfo
+    {
+    public:
+        void init(int2 const& size)
+        {
+            MapInfo::init(size);
+            _map.assign(size.x * size.y, nullptr);
+        }
+
+        void resize(int maxEntries) { _mapEntries.resize(maxEntries); }
+
+        void reset() { _mapEntries.reset(); }
+
+        void set(int numEntities, Particle** entities)
+        {
+            if (0 == numEntities) {
+                return;
+            }
+
+            auto entrySubarray = _mapEntries.getNewSubarray(numEntities);
+            for (int index = 0; index < numEntities; ++index) {
+                auto const& entity = entities[index];
+                int2 posInt = {floorInt(entity->absPos.x), floorInt(entity->absPos.y)};
+                mapPosCorrection(posInt);
+                auto mapEntry = posInt.x + posInt.y * _size.x;
+                atomicExch(&_map[mapEntry], entity);
+                entrySubarray[index] = mapEntry;
+            }
+        }
+
+        Particle* get(float2 const& pos) const
+        {
+            int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
+            mapPosCorrection(posInt);
+            auto mapEntry = posInt.x + posInt.y * _size.x;
+            return _map[mapEntry];
+        }
+
+        void cleanup(ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(_mapEntries.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& mapEntry = _mapEntries.at(index);
+                _map[mapEntry] = nullptr;
+            }
+        }
+
+    private:
+        std::vector<Particle*> _map;
+        Array<int> _mapEntries;
+    };
+}
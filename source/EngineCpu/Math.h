@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+
+
+#include "EngineGpuKernels/Definitions.cuh"
+#include "EngineGpuKernels/VectorTypes.h"
+
+#include "Base.h"
+
+namespace Cpu
+{
+    constexpr double PI = 3.1415926535897932384626433832795;
+    constexpr double DEG_TO_RAD = PI / 180.0;
+    constexpr double RAD_TO_DEG = 180.0 / PI;
+
+    inline float2 operator+(float2 const& p, float2 const& q) { return {p.x + q.x, p.y + q.y}; }
+
+    inline float2 operator-(float2 const& p, float2 const& q) { return {p.x - q.x, p.y - q.y}; }
+
+    inline float2 operator-(float2 const& p, int2 const& q) { return {p.x - q.x, p.y - q.y}; }
+
+    inline int2 operator-(int2 const& p, int2 const& q) { return {p.x - q.x, p.y - q.y}; }
+
+    inline float2 operator*(float2 const& p, float m) { return {p.x * m, p.y * m}; }
+
+    inline float3 operator*(float3 const& p, float m) { return {p.x * m, p.y * m, p.z * m}; }
+
+    inline float2 operator/(float2 const& p, float m) { return {p.x / m, p.y / m}; }
+
+    inline bool operator==(int2 const& p, int2 const& q) { return p.x == q.x && p.y == q.y; }
+
+    inline bool operator!=(float2 const& p, float2 const& q) { return p.x != q.x || p.y != q.y; }
+
+    class Math
+    {
+    public:
+        using Matrix = float[2][2];
+
+        static void rotationMatrix(float angle, Matrix& rotMatrix)
+        {
+            float sinAngle = sinf(static_cast<float>(angle * DEG_TO_RAD));
+            float cosAngle = cosf(static_cast<float>(angle * DEG_TO_RAD));
+            rotMatrix[0][0] = cosAngle;
+            rotMatrix[0][1] = -sinAngle;
+            rotMatrix[1][0] = sinAngle;
+            rotMatrix[1][1] = cosAngle;
+        }
+
+        static void inverseRotationMatrix(float angle, Matrix& rotMatrix)
+        {
+            float sinAngle = sinf(static_cast<float>(angle * DEG_TO_RAD));
+            float cosAngle = cosf(static_cast<float>(angle * DEG_TO_RAD));
+            rotMatrix[0][0] = cosAngle;
+            rotMatrix[0][1] = sinAngle;
+            rotMatrix[1][0] = -sinAngle;
+            rotMatrix[1][1] = cosAngle;
+        }
+
+        static float2 applyMatrix(float2 const& vec, Matrix const& matrix)
+        {
+            return {vec.x * matrix[0][0] + vec.y * matrix[0][1], vec.x * matrix[1][0] + vec.y * matrix[1][1]};
+        }
+
+        static void angleCorrection(int& angle) { angle = ((angle % 360) + 360) % 360; }
+
+        static void angleCorrection(float& angle)
+        {
+            int intPart = (int)angle;
+            float fracPart = angle - intPart;
+            angleCorrection(intPart);
+            angle = (float)intPart + fracPart;
+        }
+
+        static void rotateQuarterClockwise(float2& v)
+        {
+            float temp = v.x;
+            v.x = -v.y;
+            v.y = temp;
+        }
+
+        static void rotateQuarterCounterClockwise(float2& v)
+        {
+            float temp = v.x;
+            v.x = v.y;
+            v.y = -temp;
+        }
+
+        //0 DEG corresponds to (0,-1)
+        static float angleOfVector(float2 const& v)
+        {
+            if (length(v) < FP_PRECISION) {
+                return 0;
+            }
+
+            auto normalizedVy = -v.y / length(v);
+            normalizedVy = std::max(-1.0f, std::min(1.0f, normalizedVy));
+            float angleSin = static_cast<float>(asinf(normalizedVy) * RAD_TO_DEG);
+            if (v.x >= 0.0f) {
+                return 90.0f - angleSin;
+            } else {
+                return angleSin + 270.0f;
+            }
+        }
+
+        static float2 unitVectorOfAngle(float angle)
+        {
+            angle *= static_cast<float>(DEG_TO_RAD);
+            return {sinf(angle), -cosf(angle)};
+        }
+
+        static void normalize(float2& vec)
+        {
+            float length = sqrtf(vec.x * vec.x + vec.y * vec.y);
+            if (length > FP_PRECISION) {
+                vec = {vec.x / length, vec.y / length};
+            } else {
+                vec = {1.0f, 0.0f};
+            }
+        }
+
+        static float2 normalized(float2 vec)
+        {
+            normalize(vec);
+            return vec;
+        }
+
+        static float dot(float2 const& p, float2 const& q) { return p.x * q.x + p.y * q.y; }
+
+        static float2 crossProdProjected(float3 const& p, float3 const& q)
+        {
+            return {p.y * q.z - p.z * q.y, p.z * q.x - p.x * q.z};
+        }
+
+        static float length(float2 const& v) { return sqrtf(v.x * v.x + v.y * v.y); }
+
+        static float length(int2 const& v) { return sqrtf(static_cast<float>(v.x * v.x + v.y * v.y)); }
+
+        static float lengthSquared(float2 const& v) { return v.x * v.x + v.y * v.y; }
+
+        static float2 rotateClockwise(float2 const& v, float angle)
+        {
+            Matrix rotMatrix;
+            rotationMatrix(angle, rotMatrix);
+            return applyMatrix(v, rotMatrix);
+        }
+
+        static float subtractAngle(float angleMinuend, float angleSubtrahend)
+        {
+            auto angleDiff = angleMinuend - angleSubtrahend;
+            if (angleDiff > 360.0f) {
+                angleDiff -= 360.0f;
+            }
+            if (angleDiff < 0.0f) {
+                angleDiff += 360.0f;
+            }
+            return angleDiff;
+        }
+
+        static float calcDistanceToLineSegment(
+            float2 const& startSegment,
+            float2 const& endSegment,
+            float2 const& pos,
+            int const& boundary = 0)
+        {
+            auto const relPos = pos - startSegment;
+            auto segmentDirection = endSegment - startSegment;
+            if (length(segmentDirection) < FP_PRECISION) {
+                return static_cast<float>(boundary + 1);
+            }
+
+            auto const segmentLength = length(segmentDirection);
+            segmentDirection = segmentDirection / segmentLength;
+            auto normal = segmentDirection;
+            rotateQuarterCounterClockwise(normal);
+            auto const signedDistanceFromLine = dot(relPos, normal);
+            if (std::abs(signedDistanceFromLine) > boundary) {
+                return static_cast<float>(boundary + 1);
+            }
+
+            auto const signedDistanceFromStart = dot(relPos, segmentDirection);
+            if (signedDistanceFromStart < 0 || signedDistanceFromStart > segmentLength) {
+                return static_cast<float>(boundary + 1);
+            }
+
+            return std::abs(signedDistanceFromLine);
+        }
+
+        static float alignAngle(float angle, int alignment)
+        {
+            if (0 == alignment) {
+                return angle;
+            }
+            float unitAngle = 360.0f / alignment;
+            float factor = angle / unitAngle + 0.5f;
+            factor = floorf(factor);
+            return factor * unitAngle;
+        }
+    };
+}
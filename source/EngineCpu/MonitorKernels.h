@@ -0,0 +1,43 @@
+#pragma once
+
+#include <numeric>
+#include <vector>
+
+#include "SimulationData.h"
+#include "ThreadPool.h"
+
+namespace Cpu
+{
+    //counterpart of getEnergyForMonitorData: energy of all cells, particles and tokens
+    //the partial sums of the threads are added in a fixed order such that the result does not depend on the timing
+    inline double getInternalEnergy(ThreadPool& threadPool, SimulationData& data)
+    {
+        std::vector<double> energies(threadPool.getNumThreads(), 0.0);
+        threadPool.execute([&](ThreadContext const& context) {
+            double energy = 0;
+            {
+                auto& cells = data.entities.cellPointers;
+                auto const partition = context.calcPartition(cells.getNumEntries());
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    energy += cells.at(index)->energy;
+                }
+            }
+            {
+                auto& particles = data.entities.particlePointers;
+                auto const partition = context.calcPartition(particles.getNumEntries());
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    energy += particles.at(index)->energy;
+                }
+            }
+            {
+                auto& tokens = data.entities.tokenPointers;
+                auto const partition = context.calcPartition(tokens.getNumEntries());
+                for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                    energy += tokens.at(index)->energy;
+                }
+            }
+            energies[context.threadIndex] = energy;
+        });
+        return std::accumulate(energies.begin(), energies.end(), 0.0);
+    }
+}
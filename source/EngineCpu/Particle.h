@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Base.h"
+
+namespace Cpu
+{
+    struct ParticleMetadata
+    {
+        unsigned char color;
+    };
+
+    struct Particle
+    {
+        uint64_t id;
+        float2 absPos;
+        float2 vel;
+        ParticleMetadata metadata;
+        float energy;
+
+        //editing data
+        int selected;  //0 = no, 1 = selected
+
+        //change tracking for delta extraction
+        uint64_t generation;  //data version at the last change
+
+        //auxiliary data
+        int locked;  //0 = unlocked, 1 = locked
+
+        bool tryLock() { return 0 == atomicExch(&locked, 1); }
+
+        void releaseLock() { atomicExch(&locked, 0); }
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Base.h"
+#include "EntityFactory.h"
+#include "Map.h"
+#include "SpotCalculator.h"
+
+namespace Cpu
+{
+    class ParticleProcessor
+    {
+    public:
+        void updateMap(SimulationData& data, ThreadContext const& context);
+        void movement(SimulationData& data, ThreadContext const& context);
+        void collision(SimulationData& data, ThreadContext const& context);
+        void transformation(SimulationData& data, ThreadContext const& context, int numParticlePointers);
+    };
+
+    /************************************************************************/
+    /* Implementation                                                       */
+    /************************************************************************/
+
+    inline void ParticleProcessor::updateMap(SimulationData& data, ThreadContext const& context)
+    {
+        auto partition = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        Particle** particlePointers = data.entities.particlePointers.getArray() + partition.startIndex;
+        data.particleMap.set(partition.numElements(), particlePointers);
+    }
+
+    inline void ParticleProcessor::movement(SimulationData& data, ThreadContext const& context)
+    {
+        auto partition = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int particleIndex = partition.startIndex; particleIndex <= partition.endIndex; ++particleIndex) {
+            auto& particle = data.entities.particlePointers.at(particleIndex);
+            if (particle->vel != float2{0, 0}) {
+                particle->absPos = particle->absPos + particle->vel;
+                data.particleMap.mapPosCorrection(particle->absPos);
+                data.markChanged(particle);
+            }
+        }
+    }
+
+    inline void ParticleProcessor::collision(SimulationData& data, ThreadContext const& context)
+    {
+        auto partition = context.calcPartition(data.entities.particlePointers.getNumEntries());
+
+        for (int particleIndex = partition.startIndex; particleIndex <= partition.endIndex; ++particleIndex) {
+            auto& particle = data.entities.particlePointers.at(particleIndex);
+            auto otherParticle = data.particleMap.get(particle->absPos);
+            if (otherParticle && otherParticle != particle
+                && Math::lengthSquared(particle->absPos - otherParticle->absPos) < 0.5f) {
+
+                SystemDoubleLock lock;
+                lock.init(&particle->locked, &otherParticle->locked);
+                if (lock.tryLock()) {
+
+                    if (particle->energy > FP_PRECISION && otherParticle->energy > FP_PRECISION) {
+                        auto factor1 = particle->energy / (particle->energy + otherParticle->energy);
+                        otherParticle->vel = particle->vel * factor1 + otherParticle->vel * (1.0f - factor1);
+                        otherParticle->energy += particle->energy;
+                        particle->energy = 0;
+                        data.markChanged(otherParticle);
+                        data.logRemovedParticle(particle->id);
+                        particle = nullptr;
+                    }
+
+                    lock.releaseLock();
+                }
+            } else {
+                if (auto cell = data.cellMap.getFirst(particle->absPos)) {
+                    if (!cell->tryLock()) {
+                        continue;
+                    }
+                    if (particle->tryLock()) {
+
+                        atomicAdd(&cell->energy, particle->energy);
+                        particle->energy = 0;
+                        data.markChanged(cell);
+
+                        particle->releaseLock();
+
+                        data.logRemovedParticle(particle->id);
+                        particle = nullptr;
+                    }
+                    cell->releaseLock();
+                }
+            }
+        }
+    }
+
+    inline void
+    ParticleProcessor::transformation(SimulationData& data, ThreadContext const& context, int numParticlePointers)
+    {
+        auto partition = context.calcPartition(numParticlePointers);
+
+        for (int particleIndex = partition.startIndex; particleIndex <= partition.endIndex; ++particleIndex) {
+            if (auto& particle = data.entities.particlePointers.at(particleIndex)) {
+
+                auto cellMinEnergy =
+                    SpotCalculator::calc(&SimulationParametersSpotValues::cellMinEnergy, data, particle->absPos);
+                if (particle->energy >= cellMinEnergy) {
+                    EntityFactory factory;
+                    factory.init(&data);
+                    auto cell = factory.createRandomCell(particle->energy, particle->absPos, particle->vel);
+                    cell->cold->metadata.color = particle->metadata.color;
+
+                    data.logRemovedParticle(particle->id);
+                    particle = nullptr;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "EngineInterface/ElementaryTypes.h"
+
+#include "SimulationData.h"
+
+namespace Cpu
+{
+    class PropulsionFunction
+    {
+    public:
+        //thrust is currently disabled in the CUDA kernels as well
+        static void processing(Token* token, SimulationData&)
+        {
+            auto& tokenMem = token->memory;
+            tokenMem[Enums::Prop::OUTPUT] = Enums::PropOut::SUCCESS;
+        }
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "EngineInterface/EngineSettings.h"
+
+#include "Array.h"
+#include "CleanupKernels.h"
+#include "SimulationData.h"
+#include "ThreadPool.h"
+
+//sorts cells and particles along a space-filling curve such that entities which are close in space are also close
+//in memory
+namespace Cpu
+{
+    namespace SpaceFillingCurve
+    {
+        int const Order = 16;  //number of bits per coordinate
+
+        inline uint32_t spreadBits(uint32_t value)
+        {
+            value &= 0x0000ffff;
+            value = (value | (value << 8)) & 0x00ff00ff;
+            value = (value | (value << 4)) & 0x0f0f0f0f;
+            value = (value | (value << 2)) & 0x33333333;
+            value = (value | (value << 1)) & 0x55555555;
+            return value;
+        }
+
+        inline uint32_t mortonIndex(uint32_t x, uint32_t y) { return spreadBits(x) | (spreadBits(y) << 1); }
+
+        inline uint32_t hilbertIndex(uint32_t x, uint32_t y)
+        {
+            uint32_t const n = 1u << Order;
+            uint32_t result = 0;
+            for (uint32_t s = n / 2; s > 0; s /= 2) {
+                uint32_t rx = (x & s) > 0 ? 1 : 0;
+                uint32_t ry = (y & s) > 0 ? 1 : 0;
+                result += s * s * ((3 * rx) ^ ry);
+
+                //rotate quadrant
+                if (ry == 0) {
+                    if (rx == 1) {
+                        x = n - 1 - x;
+                        y = n - 1 - y;
+                    }
+                    std::swap(x, y);
+                }
+            }
+            return result;
+        }
+
+        inline uint32_t calcIndex(float2 pos, int2 const& worldSize, int curve)
+        {
+            auto const maxCoordinate = static_cast<float>((1u << Order) - 1);
+            auto x = static_cast<uint32_t>(std::min(std::max(pos.x / worldSize.x, 0.0f), 1.0f) * maxCoordinate);
+            auto y = static_cast<uint32_t>(std::min(std::max(pos.y / worldSize.y, 0.0f), 1.0f) * maxCoordinate);
+            return Enums::SpaceFillingCurve::HILBERT == curve ? hilbertIndex(x, y) : mortonIndex(x, y);
+        }
+    }
+
+    template <typename Entity>
+    void calcSpaceFillingCurveIndices(
+        Array<Entity*>& pointers,
+        std::vector<std::pair<uint32_t, Entity*>>& indexedPointers,
+        int2 const& worldSize,
+        int curve,
+        ThreadContext const& context)
+    {
+        auto const partition = context.calcPartition(pointers.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& entity = pointers.at(index);
+            indexedPointers[index] = {SpaceFillingCurve::calcIndex(entity->absPos, worldSize, curve), entity};
+        }
+    }
+
+    template <typename Entity>
+    void writeBackSortedPointers(
+        Array<Entity*>& pointers,
+        std::vector<std::pair<uint32_t, Entity*>> const& indexedPointers,
+        ThreadContext const& context)
+    {
+        auto const partition = context.calcPartition(pointers.getNumEntries());
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            pointers.at(index) = indexedPointers[index].second;
+        }
+    }
+
+    /************************************************************************/
+    /* Main                                                                 */
+    /************************************************************************/
+
+    namespace Reorder
+    {
+        //assumes that the pointer arrays contain no null pointers, i.e. cleanupAfterSimulation has been called before
+        template <typename Entity>
+        void sortPointers(ThreadPool& threadPool, Array<Entity*>& pointers, int2 const& worldSize, int curve)
+        {
+            std::vector<std::pair<uint32_t, Entity*>> indexedPointers(pointers.getNumEntries());
+            threadPool.execute([&](ThreadContext const& context) {
+                calcSpaceFillingCurveIndices(pointers, indexedPointers, worldSize, curve, context);
+            });
+            std::sort(indexedPointers.begin(), indexedPointers.end(), [](auto const& left, auto const& right) {
+                return left.first < right.first;
+            });
+            threadPool.execute(
+                [&](ThreadContext const& context) { writeBackSortedPointers(pointers, indexedPointers, context); });
+        }
+    }
+
+    //the copy step of the cleanup preserves the order of the pointer arrays, thus the entities are stored along the
+    //curve afterwards (up to the partition boundaries of the threads)
+    inline void reorderEntities(ThreadPool& threadPool, SimulationData& data, int curve)
+    {
+        auto& entities = data.entities;
+        auto& entitiesForCleanup = data.entitiesForCleanup;
+
+        Reorder::sortPointers(threadPool, entities.cellPointers, data.size, curve);
+        Reorder::sortPointers(threadPool, entities.particlePointers, data.size, curve);
+
+        Cleanup::copyParticles(threadPool, entities.particlePointers, entitiesForCleanup.particles);
+        entities.particles.swapContent(entitiesForCleanup.particles);
+
+        Cleanup::copyCells(
+            threadPool,
+            entities.cellPointers,
+            entities.tokenPointers,
+            entitiesForCleanup.cells,
+            entitiesForCleanup.cellColdData);
+        entities.cells.swapContent(entitiesForCleanup.cells);
+        entities.cellColdData.swapContent(entitiesForCleanup.cellColdData);
+    }
+}
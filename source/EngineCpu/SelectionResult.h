@@ -0,0 +1,69 @@
+#pragma once
+
+#include "EngineInterface/SelectionShallowData.h"
+
+#include "Cell.h"
+#include "Particle.h"
+
+namespace Cpu
+{
+    class SelectionResult
+    {
+    public:
+        SelectionShallowData getSelectionShallowData() const { return _selectionShallowData; }
+
+        void reset() { _selectionShallowData = SelectionShallowData(); }
+
+        void collectCell(Cell* cell)
+        {
+            if (1 == cell->selected) {
+                atomicAdd(&_selectionShallowData.numCells, 1);
+                atomicAdd(&_selectionShallowData.centerPosX, cell->absPos.x);
+                atomicAdd(&_selectionShallowData.centerPosY, cell->absPos.y);
+                atomicAdd(&_selectionShallowData.centerVelX, cell->vel.x);
+                atomicAdd(&_selectionShallowData.centerVelY, cell->vel.y);
+            }
+
+            atomicAdd(&_selectionShallowData.numClusterCells, 1);
+            atomicAdd(&_selectionShallowData.clusterCenterPosX, cell->absPos.x);
+            atomicAdd(&_selectionShallowData.clusterCenterPosY, cell->absPos.y);
+            atomicAdd(&_selectionShallowData.clusterCenterVelX, cell->vel.x);
+            atomicAdd(&_selectionShallowData.clusterCenterVelY, cell->vel.y);
+        }
+
+        void collectParticle(Particle* particle)
+        {
+            atomicAdd(&_selectionShallowData.numParticles, 1);
+            atomicAdd(&_selectionShallowData.centerPosX, particle->absPos.x);
+            atomicAdd(&_selectionShallowData.centerPosY, particle->absPos.y);
+            atomicAdd(&_selectionShallowData.centerVelX, particle->vel.x);
+            atomicAdd(&_selectionShallowData.centerVelY, particle->vel.y);
+            atomicAdd(&_selectionShallowData.clusterCenterPosX, particle->absPos.x);
+            atomicAdd(&_selectionShallowData.clusterCenterPosY, particle->absPos.y);
+            atomicAdd(&_selectionShallowData.clusterCenterVelX, particle->vel.x);
+            atomicAdd(&_selectionShallowData.clusterCenterVelY, particle->vel.y);
+        }
+
+        void finalize()
+        {
+            auto numEntities = _selectionShallowData.numCells + _selectionShallowData.numParticles;
+            if (numEntities > 0) {
+                _selectionShallowData.centerPosX /= numEntities;
+                _selectionShallowData.centerPosY /= numEntities;
+                _selectionShallowData.centerVelX /= numEntities;
+                _selectionShallowData.centerVelY /= numEntities;
+            }
+
+            auto numExtEntities = _selectionShallowData.numClusterCells + _selectionShallowData.numParticles;
+            if (numEntities > 0) {
+                _selectionShallowData.clusterCenterPosX /= numExtEntities;
+                _selectionShallowData.clusterCenterPosY /= numExtEntities;
+                _selectionShallowData.clusterCenterVelX /= numExtEntities;
+                _selectionShallowData.clusterCenterVelY /= numExtEntities;
+            }
+        }
+
+    private:
+        SelectionShallowData _selectionShallowData;
+    };
+}
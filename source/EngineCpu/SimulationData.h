@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "EngineInterface/FlowFieldSettings.h"
+#include "EngineInterface/EngineSettings.h"
+#include "EngineInterface/SimulationParameters.h"
+#include "EngineInterface/SimulationParametersSpots.h"
+
+#include "Base.h"
+#include "Entities.h"
+#include "Map.h"
+#include "Operation.h"
+#include "StringTable.h"
+#include "TileIndex.h"
+
+namespace Cpu
+{
+    //counterpart of the CUDA constant memory
+    struct SimulationConstants
+    {
+        SimulationParameters parameters;
+        SimulationParametersSpots spots;
+        FlowFieldSettings flowFieldSettings;
+        EngineSettings engineSettings;
+    };
+
+    struct SimulationData
+    {
+        int2 size;
+
+        CellMap cellMap;
+        ParticleMap particleMap;
+
+        //spatial index for region queries, valid between the time steps
+        TileIndex<Cell> cellTiles;
+        TileIndex<Particle> particleTiles;
+
+        Entities entities;
+        Entities entitiesForCleanup;
+
+        //metadata strings referenced by the cells
+        StringTable strings;
+
+        std::atomic<int> numOperations{0};
+        Operation* operations = nullptr;  //uses dynamic memory
+
+        DynamicMemory dynamicMemory;
+        NumberGenerator numberGen;
+
+        //ids of entities which have been deleted since the last delta extraction
+        Array<uint64_t> removedCellIds;
+        Array<uint64_t> removedParticleIds;
+        std::atomic<bool> removedIdsOverflow{false};
+
+        //version of the next delta, is stamped on each entity which is created or changed
+        uint64_t dataVersion = 0;
+
+        SimulationConstants constants;
+
+        void init(int2 const& universeSize)
+        {
+            size = universeSize;
+
+            //entity arrays grow in place up to a bound which is derived from the world size
+            auto maxEntities = static_cast<int>(std::min(
+                std::max(
+                    static_cast<uint64_t>(size.x) * size.y * Const::MaxEntitiesPerArea, Const::MinReservedEntities),
+                static_cast<uint64_t>(std::numeric_limits<int>::max() / 10)));
+            entities.init(maxEntities);
+            entitiesForCleanup.init(maxEntities);
+
+            cellMap.init(size);
+            particleMap.init(size);
+            cellTiles.init(size);
+            particleTiles.init(size);
+            numberGen.init();
+        }
+
+        void prepareForSimulation()
+        {
+            cellMap.reset();
+            particleMap.reset();
+            dynamicMemory.reset();
+
+            numOperations.store(0);
+            operations = dynamicMemory.getArray<Operation>(entities.cellPointers.getNumEntries());
+        }
+
+        void buildTileIndices(ThreadPool& threadPool)
+        {
+            cellTiles.build(threadPool, entities.cellPointers);
+            particleTiles.build(threadPool, entities.particlePointers);
+        }
+
+        void invalidateTileIndices()
+        {
+            cellTiles.invalidate();
+            particleTiles.invalidate();
+        }
+
+        int getMaxOperations() const { return entities.cellPointers.getNumEntries(); }
+
+        template <typename Entity>
+        void markChanged(Entity* entity) const
+        {
+            entity->generation = dataVersion;
+        }
+
+        void logRemovedCell(uint64_t id) { logRemovedId(removedCellIds, id); }
+        void logRemovedParticle(uint64_t id) { logRemovedId(removedParticleIds, id); }
+
+        bool shouldResize(int additionalCells, int additionalParticles, int additionalTokens) const
+        {
+            auto cellAndParticleArraySizeInc = std::max(additionalCells, additionalParticles);
+            auto tokenArraySizeInc = std::max(additionalTokens, cellAndParticleArraySizeInc / 3);
+            auto fillLevelFactor = constants.engineSettings.ARRAY_FILL_LEVEL_FACTOR;
+
+            return entities.cells.shouldResize(cellAndParticleArraySizeInc, fillLevelFactor)
+                || entities.cellColdData.shouldResize(cellAndParticleArraySizeInc, fillLevelFactor)
+                || entities.cellPointers.shouldResize(cellAndParticleArraySizeInc * 10, fillLevelFactor)
+                || entities.particles.shouldResize(cellAndParticleArraySizeInc, fillLevelFactor)
+                || entities.particlePointers.shouldResize(cellAndParticleArraySizeInc * 10, fillLevelFactor)
+                || entities.tokens.shouldResize(tokenArraySizeInc, fillLevelFactor)
+                || entities.tokenPointers.shouldResize(tokenArraySizeInc * 10, fillLevelFactor);
+        }
+
+        bool shouldResize() const { return shouldResize(0, 0, 0); }
+
+        //arrays grow in place => entities are not copied
+        void resizeEntities(int additionalCells, int additionalParticles, int additionalTokens)
+        {
+            auto cellAndParticleArraySizeInc = std::max(additionalCells, additionalParticles);
+            auto tokenArraySizeInc = std::max(additionalTokens, cellAndParticleArraySizeInc / 3);
+
+            resizeIntern(entities.cells, entitiesForCleanup.cells, cellAndParticleArraySizeInc);
+            resizeIntern(entities.cellColdData, entitiesForCleanup.cellColdData, cellAndParticleArraySizeInc);
+            resizeIntern(entities.cellPointers, entitiesForCleanup.cellPointers, cellAndParticleArraySizeInc * 10);
+            resizeIntern(entities.particles, entitiesForCleanup.particles, cellAndParticleArraySizeInc);
+            resizeIntern(
+                entities.particlePointers, entitiesForCleanup.particlePointers, cellAndParticleArraySizeInc * 10);
+            resizeIntern(entities.tokens, entitiesForCleanup.tokens, tokenArraySizeInc);
+            resizeIntern(entities.tokenPointers, entitiesForCleanup.tokenPointers, tokenArraySizeInc * 10);
+        }
+
+        void resizeRemainings()
+        {
+            auto cellArraySize = entities.cells.getSize();
+            cellMap.resize(cellArraySize);
+            particleMap.resize(cellArraySize);
+            removedCellIds.resize(cellArraySize);
+            removedParticleIds.resize(entities.particles.getSize());
+
+            uint64_t upperBoundDynamicMemory = sizeof(Operation) * (cellArraySize + 1000);
+            dynamicMemory.resize(upperBoundDynamicMemory);
+        }
+
+        bool isEmpty() const
+        {
+            return 0 == entities.cells.getNumEntries() && 0 == entities.particles.getNumEntries()
+                && 0 == entities.tokens.getNumEntries();
+        }
+
+    private:
+        void logRemovedId(Array<uint64_t>& ids, uint64_t id)
+        {
+            if (auto entry = ids.tryGetNewElement()) {
+                *entry = id;
+            } else {
+                removedIdsOverflow.store(true);
+            }
+        }
+
+        template <typename Entity>
+        void resizeIntern(Array<Entity>& array, Array<Entity>& arrayForCleanup, int additionalEntities)
+        {
+            if (array.shouldResize(additionalEntities, constants.engineSettings.ARRAY_FILL_LEVEL_FACTOR)) {
+                auto newSize = (array.getNumEntries() + additionalEntities) * 2;
+                array.resize(newSize);
+                arrayForCleanup.resize(newSize);
+            }
+        }
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Base.h"
+#include "CellConnectionProcessor.h"
+#include "CellProcessor.h"
+#include "ParticleProcessor.h"
+#include "SimulationResult.h"
+#include "TokenProcessor.h"
+
+//the processing steps correspond to the kernels in EngineGpuKernels/SimulationKernels.cuh,
+//each step is executed by all worker threads and is followed by a barrier
+namespace Cpu
+{
+    inline void processingStep1(SimulationData& data, ThreadContext const& context)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.init(data, context);
+        cellProcessor.clearTag(data, context);
+        cellProcessor.radiation(data, context);  //do not use ParticleProcessor in this kernel
+    }
+
+    inline void processingStep2(SimulationData& data, ThreadContext const& context)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.collisions(data, context);
+
+        ParticleProcessor particleProcessor;
+        particleProcessor.updateMap(data, context);
+    }
+
+    inline void processingStep3(SimulationData& data, ThreadContext const& context)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.applyAndCheckForces(data, context);
+        cellProcessor.clearTag(data, context);
+
+        ParticleProcessor particleProcessor;
+        particleProcessor.movement(data, context);
+        particleProcessor.collision(data, context);
+    }
+
+    inline void processingStep4(SimulationData& data, ThreadContext const& context, int numTokenPointers)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.calcForces(data, context);
+
+        TokenProcessor tokenProcessor;
+        tokenProcessor.movement(data, context, numTokenPointers);  //changes cell energy without lock
+    }
+
+    inline void processingStep5(SimulationData& data, ThreadContext const& context)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.calcPositionsAndCheckBindings(data, context);
+    }
+
+    inline void processingStep6(SimulationData& data, ThreadContext const& context, SimulationResult& result)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.calcForces(data, context);
+
+        TokenProcessor tokenProcessor;
+        tokenProcessor.executeReadonlyCellFunctions(data, context, result);
+    }
+
+    inline void processingStep7(SimulationData& data, ThreadContext const& context, int numCellPointers)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.calcVelocities(data, context, numCellPointers);
+    }
+
+    inline void processingStep8(
+        SimulationData& data,
+        ThreadContext const& context,
+        SimulationResult& result,
+        int numTokenPointers)
+    {
+        TokenProcessor tokenProcessor;
+        tokenProcessor.executeModifyingCellFunctions(data, context, result, numTokenPointers);
+    }
+
+    inline void processingStep9(SimulationData& data, ThreadContext const& context)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.calcAveragedVelocities(data, context);
+    }
+
+    inline void processingStep10(SimulationData& data, ThreadContext const& context)
+    {
+        CellProcessor cellProcessor;
+        cellProcessor.applyAveragedVelocities(data, context);
+        cellProcessor.decay(data, context);
+    }
+
+    inline void processingStep11(SimulationData& data, ThreadContext const& context, int numOperations)
+    {
+        CellConnectionProcessor::processConnectionsOperations(data, context, numOperations);
+    }
+
+    inline void
+    processingStep12(SimulationData& data, ThreadContext const& context, int numParticlePointers, int numOperations)
+    {
+        ParticleProcessor particleProcessor;
+        particleProcessor.transformation(data, context, numParticlePointers);
+
+        CellConnectionProcessor::processDelCellOperations(data, context, numOperations);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+
+namespace Cpu
+{
+    class SimulationResult
+    {
+    public:
+        bool isArrayResizeNeeded() const { return _arrayResizingNeeded.load(); }
+
+        struct Statistics
+        {
+            int createdCells = 0;
+            int sucessfulAttacks = 0;
+            int failedAttacks = 0;
+            int muscleActivities = 0;
+        };
+        Statistics getStatistics() const
+        {
+            Statistics result;
+            result.createdCells = _createdCells.load();
+            result.sucessfulAttacks = _sucessfulAttacks.load();
+            result.failedAttacks = _failedAttacks.load();
+            result.muscleActivities = _muscleActivities.load();
+            return result;
+        }
+
+        void setArrayResizeNeeded(bool value) { _arrayResizingNeeded.store(value); }
+
+        void resetStatistics()
+        {
+            _createdCells.store(0);
+            _sucessfulAttacks.store(0);
+            _failedAttacks.store(0);
+            _muscleActivities.store(0);
+        }
+        void incCreatedCell() { _createdCells.fetch_add(1, std::memory_order_relaxed); }
+        void incSuccessfulAttack() { _sucessfulAttacks.fetch_add(1, std::memory_order_relaxed); }
+        void incFailedAttack() { _failedAttacks.fetch_add(1, std::memory_order_relaxed); }
+        void incMuscleActivity() { _muscleActivities.fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+        std::atomic<int> _createdCells{0};
+        std::atomic<int> _sucessfulAttacks{0};
+        std::atomic<int> _failedAttacks{0};
+        std::atomic<int> _muscleActivities{0};
+        std::atomic<bool> _arrayResizingNeeded{false};
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "EngineInterface/SimulationParametersSpotValues.h"
+
+#include "SimulationData.h"
+
+namespace Cpu
+{
+    class SpotCalculator
+    {
+    public:
+        static float
+        calc(float SimulationParametersSpotValues::*value, SimulationData const& data, float2 const& pos)
+        {
+            auto const& parameters = data.constants.parameters;
+            auto const& spots = data.constants.spots;
+            if (0 == spots.numSpots) {
+                return parameters.spotValues.*value;
+            }
+            if (1 == spots.numSpots) {
+                auto distance = data.cellMap.mapDistance(pos, {spots.spots[0].posX, spots.spots[0].posY});
+                auto coreRadius = spots.spots[0].coreRadius;
+                auto fadeoutRadius = spots.spots[0].fadeoutRadius + 1;
+                auto factor = distance < coreRadius ? 0.0f : std::min(1.0f, (distance - coreRadius) / fadeoutRadius);
+                return mix(parameters.spotValues.*value, spots.spots[0].values.*value, factor);
+            }
+            if (2 == spots.numSpots) {
+                auto distance1 = data.cellMap.mapDistance(pos, {spots.spots[0].posX, spots.spots[0].posY});
+                auto distance2 = data.cellMap.mapDistance(pos, {spots.spots[1].posX, spots.spots[1].posY});
+
+                auto coreRadius1 = spots.spots[0].coreRadius;
+                auto fadeoutRadius1 = spots.spots[0].fadeoutRadius + 1;
+                auto factor1 =
+                    distance1 < coreRadius1 ? 0.0f : std::min(1.0f, (distance1 - coreRadius1) / fadeoutRadius1);
+                auto coreRadius2 = spots.spots[1].coreRadius;
+                auto fadeoutRadius2 = spots.spots[1].fadeoutRadius + 1;
+                auto factor2 =
+                    distance2 < coreRadius2 ? 0.0f : std::min(1.0f, (distance2 - coreRadius2) / fadeoutRadius2);
+
+                return mix(
+                    parameters.spotValues.*value,
+                    spots.spots[0].values.*value,
+                    spots.spots[1].values.*value,
+                    factor1,
+                    factor2);
+            }
+            return 0;
+        }
+
+    private:
+        static float mix(float const& a, float const& b, float factor) { return a * factor + b * (1 - factor); }
+
+        static float mix(float const& a, float const& b, float const& c, float factor1, float factor2)
+        {
+            float weight1 = factor1 * factor2;
+            float weight2 = 1 - factor1;
+            float weight3 = 1 - factor2;
+            float sum = weight1 + weight2 + weight3;
+            weight1 /= sum;
+            weight2 /= sum;
+            weight3 /= sum;
+            return a * weight1 + b * weight2 + c * weight3;
+        }
+    };
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Base.h"
+#include "Cell.h"
+
+namespace Cpu
+{
+    //metadata strings are interned such that cells with equal strings share one entry, id 0 denotes the empty string
+    //entries are reference counted by the cells and freed in collectGarbage when they are no longer referenced
+    class StringTable
+    {
+    public:
+        //the returned id does not carry a reference yet
+        int intern(char const* data, int numBytes)
+        {
+            if (0 == numBytes) {
+                return 0;
+            }
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            auto findResult = _idsByValue.find(std::string_view(data, numBytes));
+            if (findResult != _idsByValue.end()) {
+                return findResult->second;
+            }
+            int id;
+            if (!_freeIds.empty()) {
+                id = _freeIds.back();
+                _freeIds.pop_back();
+            } else {
+                _entries.emplace_back();
+                id = static_cast<int>(_entries.size());
+            }
+            auto& entry = getEntry(id);
+            entry.value.assign(data, numBytes);
+            entry.numReferences.store(0);
+            entry.accessIndex.store(-1);
+            _idsByValue.emplace(std::string_view(entry.value), id);
+            _numBytes += numBytes;
+            ++_numStrings;
+
+            //unreferenced until a cell refers to it
+            _numUnreferenced.fetch_add(1);
+            return id;
+        }
+
+        void addReferences(CellMetadata const& metadata)
+        {
+            addReference(metadata.nameId);
+            addReference(metadata.descriptionId);
+            addReference(metadata.sourceCodeId);
+        }
+
+        void removeReferences(CellMetadata const& metadata)
+        {
+            removeReference(metadata.nameId);
+            removeReference(metadata.descriptionId);
+            removeReference(metadata.sourceCodeId);
+        }
+
+        //frees the entries without references, has to be called outside of kernels
+        void collectGarbage()
+        {
+            if (0 == _numUnreferenced.exchange(0)) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            for (int id = 1; id <= static_cast<int>(_entries.size()); ++id) {
+                auto& entry = getEntry(id);
+                if (!entry.value.empty() && 0 == entry.numReferences.load()) {
+                    _idsByValue.erase(std::string_view(entry.value));
+                    _numBytes -= entry.value.size();
+                    --_numStrings;
+                    std::string().swap(entry.value);
+                    _freeIds.emplace_back(id);
+                }
+            }
+        }
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            _idsByValue.clear();
+            _entries.clear();
+            _freeIds.clear();
+            _numBytes = 0;
+            _numStrings = 0;
+            _numUnreferenced.store(0);
+        }
+
+        //upper bounds for the string arrays of access data
+        int getNumStrings() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _numStrings;
+        }
+
+        uint64_t getNumBytes() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _numBytes;
+        }
+
+        int getNumBytes(int id) const { return 0 == id ? 0 : static_cast<int>(getEntry(id).value.size()); }
+
+        /************************************************************************/
+        /* Data access                                                          */
+        /************************************************************************/
+        //has to be called before strings are copied to new access data
+        void prepareForAccess()
+        {
+            for (auto& entry : _entries) {
+                entry.accessIndex.store(-1, std::memory_order_relaxed);
+            }
+        }
+
+        //each entry is copied at most once to the access data, returns the index of the copy or -1 for id 0
+        int getAccessIndex(int id, DataAccessTO const& accessTO)
+        {
+            if (0 == id) {
+                return -1;
+            }
+            auto& entry = getEntry(id);
+            auto accessIndex = entry.accessIndex.load(std::memory_order_acquire);
+            if (accessIndex >= 0) {
+                return accessIndex;
+            }
+            int expected = -1;
+            if (entry.accessIndex.compare_exchange_strong(expected, -2, std::memory_order_relaxed)) {
+                auto numBytes = static_cast<int>(entry.value.size());
+                accessIndex = atomicAdd(accessTO.numStrings, 1);
+                auto& stringTO = accessTO.strings[accessIndex];
+                stringTO.numBytes = numBytes;
+                stringTO.byteIndex = atomicAdd(accessTO.numStringBytes, numBytes);
+                entry.value.copy(&accessTO.stringBytes[stringTO.byteIndex], numBytes);
+                entry.accessIndex.store(accessIndex, std::memory_order_release);
+                return accessIndex;
+            }
+
+            //another thread is copying the entry
+            while ((accessIndex = entry.accessIndex.load(std::memory_order_acquire)) < 0) {
+            }
+            return accessIndex;
+        }
+
+    private:
+        struct Entry
+        {
+            std::string value;  //empty for free entries
+            std::atomic<int> numReferences{0};
+            std::atomic<int> accessIndex{-1};
+        };
+
+        Entry& getEntry(int id) { return _entries[id - 1]; }
+        Entry const& getEntry(int id) const { return _entries[id - 1]; }
+
+        void addReference(int id)
+        {
+            if (0 != id) {
+                getEntry(id).numReferences.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void removeReference(int id)
+        {
+            if (0 != id && 1 == getEntry(id).numReferences.fetch_sub(1, std::memory_order_relaxed)) {
+                _numUnreferenced.fetch_add(1);
+            }
+        }
+
+        mutable std::mutex _mutex;
+        std::deque<Entry> _entries;  //entries do not move when the table grows
+        std::vector<int> _freeIds;
+        std::unordered_map<std::string_view, int> _idsByValue;  //keys refer to the values of the entries
+        uint64_t _numBytes = 0;
+        int _numStrings = 0;
+        std::atomic<int> _numUnreferenced{0};
+    };
+}
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+Cpu::ThreadPool::ThreadPool(int numThreads)
+{
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    _numThreads = std::max(1, numThreads);
+    for (int i = 1; i < _numThreads; ++i) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+Cpu::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shutdown = true;
+    }
+    _startCondition.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+int Cpu::ThreadPool::getNumThreads() const
+{
+    return _numThreads;
+}
+
+void Cpu::ThreadPool::execute(Kernel const& kernel)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _kernel = &kernel;
+        _exception = nullptr;
+        _numPendingThreads = _numThreads - 1;
+        ++_generation;
+    }
+    _startCondition.notify_all();
+
+    runKernel(0);
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finishCondition.wait(lock, [this] { return 0 == _numPendingThreads; });
+        _kernel = nullptr;
+        exception = _exception;
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void Cpu::ThreadPool::workerLoop(int threadIndex)
+{
+    uint64_t lastGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _startCondition.wait(lock, [&] { return _shutdown || _generation != lastGeneration; });
+            if (_shutdown) {
+                return;
+            }
+            lastGeneration = _generation;
+        }
+
+        runKernel(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_numPendingThreads;
+        }
+        _finishCondition.notify_one();
+    }
+}
+
+void Cpu::ThreadPool::runKernel(int threadIndex)
+{
+    try {
+        (*_kernel)(ThreadContext{threadIndex, _numThreads});
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_exception) {
+            _exception = std::current_exception();
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Base.h"
+
+namespace Cpu
+{
+    //executes a kernel function on all worker threads, the calling thread takes part as thread 0
+    //execute() returns when all threads have finished and thus acts as a barrier between two kernel calls
+    class ThreadPool
+    {
+    public:
+        ThreadPool(int numThreads = 0);  //0 = number of hardware threads
+        ~ThreadPool();
+
+        int getNumThreads() const;
+
+        using Kernel = std::function<void(ThreadContext const&)>;
+        void execute(Kernel const& kernel);  //rethrows the first exception thrown by a worker
+
+    private:
+        void workerLoop(int threadIndex);
+        void runKernel(int threadIndex);
+
+        int _numThreads = 1;
+        std::vector<std::thread> _workers;
+
+        std::mutex _mutex;
+        std::condition_variable _startCondition;
+        std::condition_variable _finishCondition;
+        Kernel const* _kernel = nullptr;
+        uint64_t _generation = 0;
+        int _numPendingThreads = 0;
+        bool _shutdown = false;
+        std::exception_ptr _exception;
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "Array.h"
+#include "Base.h"
+#include "Map.h"
+#include "ThreadPool.h"
+
+namespace Cpu
+{
+    //coarse spatial index for region queries: the entities are sorted into square tiles by a counting sort
+    //it is rebuilt at the end of each time step and after data manipulations which move entities
+    template <typename Entity>
+    class TileIndex : public MapInfo
+    {
+    public:
+        static int const TileSize = 16;
+
+        void init(int2 const& size)
+        {
+            MapInfo::init(size);
+            _numTiles = {(size.x + TileSize - 1) / TileSize, (size.y + TileSize - 1) / TileSize};
+            _tileSizes.assign(_numTiles.x * _numTiles.y, 0);
+            _tileOffsets.assign(_numTiles.x * _numTiles.y + 1, 0);
+            _valid = false;
+        }
+
+        void build(ThreadPool& threadPool, Array<Entity*>& pointers)
+        {
+            auto numEntities = pointers.getNumEntries();
+            if (numEntities > static_cast<int>(_entries.size())) {
+                _entries.resize(numEntities);
+                _entityTiles.resize(numEntities);
+            }
+            std::fill(_tileSizes.begin(), _tileSizes.end(), 0);
+            threadPool.execute([&](ThreadContext const& context) { countEntities(pointers, context); });
+
+            //exclusive prefix sum such that the tiles of a row occupy a contiguous range of entries
+            _tileOffsets[0] = 0;
+            for (int tile = 0, numTiles = static_cast<int>(_tileSizes.size()); tile < numTiles; ++tile) {
+                _tileOffsets[tile + 1] = _tileOffsets[tile] + _tileSizes[tile];
+            }
+            threadPool.execute([&](ThreadContext const& context) { fillTiles(pointers, context); });
+            _valid = true;
+        }
+
+        void invalidate() { _valid = false; }
+        bool isValid() const { return _valid; }
+
+        //calls func for each entity in the tiles intersecting the rectangle (the entities themselves may lie outside)
+        //the work is partitioned among the threads by number of entities
+        template <typename Func>
+        void executeForEachInRect(
+            int2 const& rectUpperLeft,
+            int2 const& rectLowerRight,
+            ThreadContext const& context,
+            Func const& func) const
+        {
+            int2 tileUpperLeft{
+                std::max(rectUpperLeft.x, 0) / TileSize, std::max(rectUpperLeft.y, 0) / TileSize};
+            int2 tileLowerRight{
+                std::min(rectLowerRight.x / TileSize, _numTiles.x - 1),
+                std::min(rectLowerRight.y / TileSize, _numTiles.y - 1)};
+            if (tileUpperLeft.x > tileLowerRight.x || tileUpperLeft.y > tileLowerRight.y) {
+                return;
+            }
+
+            int numEntities = 0;
+            for (int y = tileUpperLeft.y; y <= tileLowerRight.y; ++y) {
+                numEntities += getRowEnd(tileLowerRight.x, y) - getRowBegin(tileUpperLeft.x, y);
+            }
+            auto const partition = context.calcPartition(numEntities);
+
+            //walk the row ranges and process the part belonging to the partition
+            int rowStartIndex = 0;
+            for (int y = tileUpperLeft.y; y <= tileLowerRight.y && rowStartIndex <= partition.endIndex; ++y) {
+                auto begin = getRowBegin(tileUpperLeft.x, y);
+                auto end = getRowEnd(tileLowerRight.x, y);
+                auto rowEndIndex = rowStartIndex + end - begin;
+                auto first = std::max(partition.startIndex, rowStartIndex);
+                auto last = std::min(partition.endIndex + 1, rowEndIndex);
+                for (int index = first; index < last; ++index) {
+                    func(_entries[begin + index - rowStartIndex]);
+                }
+                rowStartIndex = rowEndIndex;
+            }
+        }
+
+    private:
+        int calcTile(float2 pos) const
+        {
+            mapPosCorrection(pos);
+            auto x = std::min(floorInt(pos.x) / TileSize, _numTiles.x - 1);
+            auto y = std::min(floorInt(pos.y) / TileSize, _numTiles.y - 1);
+            return x + y * _numTiles.x;
+        }
+
+        int getRowBegin(int tileX, int tileY) const { return _tileOffsets[tileX + tileY * _numTiles.x]; }
+        int getRowEnd(int tileX, int tileY) const { return _tileOffsets[tileX + tileY * _numTiles.x + 1]; }
+
+        //pass 1: determine tile sizes and the rank of each entity within its tile
+        void countEntities(Array<Entity*>& pointers, ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(pointers.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto tile = calcTile(pointers.at(index)->absPos);
+                _entityTiles[index] = {tile, atomicAdd(&_tileSizes[tile], 1)};
+            }
+        }
+
+        //pass 2: scatter the entities into their ranges
+        void fillTiles(Array<Entity*>& pointers, ThreadContext const& context)
+        {
+            auto partition = context.calcPartition(pointers.getNumEntries());
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                auto const& tileAndRank = _entityTiles[index];
+                _entries[_tileOffsets[tileAndRank.x] + tileAndRank.y] = pointers.at(index);
+            }
+        }
+
+        int2 _numTiles;
+        bool _valid = false;
+        std::vector<int> _tileSizes;
+        std::vector<int> _tileOffsets;  //numTiles + 1 entries
+        std::vector<int2> _entityTiles;  //tile and rank for each entry in the pointer array
+        std::vector<Entity*> _entries;
+    };
+}
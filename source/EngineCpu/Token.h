@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Base.h"
+#include "Cell.h"
+
+namespace Cpu
+{
+    struct Token
+    {
+        char memory[MAX_TOKEN_MEM_SIZE];
+        Cell* sourceCell;
+        Cell* cell;
+        float energy;
+
+        int getTokenBranchNumber(int cellMaxTokenBranchNumber) const
+        {
+            return static_cast<unsigned char>(memory[0]) % cellMaxTokenBranchNumber;
+        }
+    };
+}
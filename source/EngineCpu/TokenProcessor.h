@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Base.h"
+#include "CellComputerFunction.h"
+#include "ConstructorFunction.h"
+#include "EnergyGuidance.h"
+#include "EntityFactory.h"
+#include "MuscleFunction.h"
+#include "PropulsionFunction.h"
+#include "ScannerFunction.h"
+#include "SpotCalculator.h"
+#include "WeaponFunction.h"
+
+namespace Cpu
+{
+    class TokenProcessor
+    {
+    public:
+        void movement(
+            SimulationData& data,
+            ThreadContext const& context,
+            int numTokenPointers);  //prerequisite: clearTag, need numTokenPointers because it might be changed
+
+        void executeReadonlyCellFunctions(SimulationData& data, ThreadContext const& context, SimulationResult& result);
+        void executeModifyingCellFunctions(
+            SimulationData& data,
+            ThreadContext const& context,
+            SimulationResult& result,
+            int numTokenPointers);
+    };
+
+    /************************************************************************/
+    /* Implementation                                                       */
+    /************************************************************************/
+
+    inline void TokenProcessor::movement(SimulationData& data, ThreadContext const& context, int numTokenPointers)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto& tokens = data.entities.tokenPointers;
+        auto partition = context.calcPartition(numTokenPointers);
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& token = tokens.at(index);
+            auto cell = token->cell;
+            atomicAdd(&cell->cold->tokenUsages, 1);
+            data.markChanged(cell);
+
+            int numMovedTokens = 0;
+            EntityFactory factory;
+            factory.init(&data);
+
+            if (token->energy >= parameters.tokenMinEnergy) {
+                auto tokenBranchNumber = token->getTokenBranchNumber(parameters.cellMaxTokenBranchNumber);
+
+                auto cellMinEnergy =
+                    SpotCalculator::calc(&SimulationParametersSpotValues::cellMinEnergy, data, cell->absPos);
+                auto tokenMutationRate =
+                    SpotCalculator::calc(&SimulationParametersSpotValues::tokenMutationRate, data, cell->absPos);
+
+                for (int i = 0; i < cell->numConnections; ++i) {
+                    auto const& connectedCell = cell->connections[i].cell;
+                    if (((tokenBranchNumber + 1 - connectedCell->branchNumber) % parameters.cellMaxTokenBranchNumber)
+                        != 0) {
+                        continue;
+                    }
+                    if (connectedCell->tokenBlocked) {
+                        continue;
+                    }
+
+                    auto tokenIndex = atomicAdd(&connectedCell->tag, 1);
+                    if (tokenIndex >= parameters.cellMaxToken) {
+                        continue;
+                    }
+
+                    token->memory[Enums::Branching::TOKEN_BRANCH_NUMBER] = connectedCell->branchNumber;
+                    if (0 == numMovedTokens) {
+                        token->sourceCell = token->cell;
+                        token->cell = connectedCell;
+                        data.markChanged(connectedCell);
+                        ++numMovedTokens;
+
+                        if (data.numberGen.random(connectedCell) < tokenMutationRate) {
+                            auto memoryIndex = data.numberGen.random(connectedCell, MAX_TOKEN_MEM_SIZE - 1);
+                            token->memory[memoryIndex] = data.numberGen.random(connectedCell, 255);
+                        }
+                    } else {
+                        auto origEnergy = atomicAdd(&connectedCell->energy, -token->energy);
+                        if (origEnergy > cellMinEnergy + token->energy) {
+                            factory.duplicateToken(connectedCell, token);
+                            ++numMovedTokens;
+                        } else {
+                            atomicAdd(&connectedCell->energy, token->energy);
+                        }
+                    }
+                }
+            }
+            if (0 == numMovedTokens) {
+                atomicAdd(&cell->energy, token->energy);
+                token = nullptr;
+            }
+        }
+    }
+
+    inline void TokenProcessor::executeReadonlyCellFunctions(
+        SimulationData& data,
+        ThreadContext const& context,
+        SimulationResult& result)
+    {
+        auto& tokens = data.entities.tokenPointers;
+        auto partition = context.calcPartition(tokens.getNumEntries());
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            if (auto const& token = tokens.at(index)) {
+                auto const& cell = token->cell;
+                auto cellFunctionType = cell->getCellFunctionType();
+                if (cell->tryLock()) {
+                    data.markChanged(cell);  //token memory may be changed
+                    if (Enums::CellFunction::SCANNER == cellFunctionType) {
+                        ScannerFunction::processing(token, data);
+                    }
+                    if (Enums::CellFunction::WEAPON == cellFunctionType) {
+                        WeaponFunction::processing(token, data, result);
+                    }
+                    cell->releaseLock();
+                }
+            }
+        }
+    }
+
+    inline void TokenProcessor::executeModifyingCellFunctions(
+        SimulationData& data,
+        ThreadContext const& context,
+        SimulationResult& result,
+        int numTokenPointers)
+    {
+        auto& tokens = data.entities.tokenPointers;
+        auto partition = context.calcPartition(numTokenPointers);
+
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            if (auto const& token = tokens.at(index)) {
+                auto const& cell = token->cell;
+                auto cellFunctionType = cell->getCellFunctionType();
+                if (cell->tryLock()) {
+                    data.markChanged(cell);
+
+                    EnergyGuidance::processing(data, token);
+                    if (Enums::CellFunction::COMPUTER == cellFunctionType) {
+                        CellComputerFunction::processing(token, data.constants.parameters);
+                    }
+                    if (Enums::CellFunction::CONSTRUCTOR == cellFunctionType) {
+                        ConstructorFunction::processing(token, data, result);
+                    }
+                    if (Enums::CellFunction::PROPULSION == cellFunctionType) {
+                        PropulsionFunction::processing(token, data);
+                    }
+                    if (Enums::CellFunction::MUSCLE == cellFunctionType) {
+                        MuscleFunction::processing(token, data, result);
+                    }
+
+                    cell->releaseLock();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include "VirtualMemory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "Base/Exceptions.h"
+
+namespace
+{
+    //physical memory is committed in units of 2 MB
+    uint64_t const CommitGranularity = 1ull << 21;
+
+    uint64_t roundUp(uint64_t value, uint64_t granularity)
+    {
+        return (value + granularity - 1) / granularity * granularity;
+    }
+
+    unsigned char* reserveAddressRange(uint64_t numBytes)
+    {
+#ifdef _WIN32
+        auto result = VirtualAlloc(nullptr, numBytes, MEM_RESERVE, PAGE_NOACCESS);
+        return static_cast<unsigned char*>(result);
+#else
+        auto result = mmap(nullptr, numBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        return result != MAP_FAILED ? static_cast<unsigned char*>(result) : nullptr;
+#endif
+    }
+
+    bool commitAddressRange(unsigned char* address, uint64_t numBytes)
+    {
+#ifdef _WIN32
+        return VirtualAlloc(address, numBytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+        return mprotect(address, numBytes, PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    void releaseAddressRange(unsigned char* address, uint64_t numBytes)
+    {
+#ifdef _WIN32
+        VirtualFree(address, 0, MEM_RELEASE);
+#else
+        munmap(address, numBytes);
+#endif
+    }
+}
+
+Cpu::VirtualMemory::~VirtualMemory()
+{
+    if (_data) {
+        releaseAddressRange(_data, _reservedBytes);
+    }
+}
+
+void Cpu::VirtualMemory::commit(uint64_t numBytes, uint64_t numReservedBytes)
+{
+    if (numBytes <= _committedBytes) {
+        return;
+    }
+    if (!_data) {
+        _reservedBytes = roundUp(std::max(numBytes, numReservedBytes), CommitGranularity);
+        _data = reserveAddressRange(_reservedBytes);
+        if (!_data) {
+            _reservedBytes = 0;
+            throw SystemRequirementNotMetException("Virtual address space could not be reserved.");
+        }
+    }
+    if (numBytes > _reservedBytes) {
+        relocate(numBytes, numReservedBytes);
+    }
+    auto newCommittedBytes = std::min(roundUp(numBytes, CommitGranularity), _reservedBytes);
+    if (!commitAddressRange(_data + _committedBytes, newCommittedBytes - _committedBytes)) {
+        throw SystemRequirementNotMetException("Not enough memory available.");
+    }
+    _committedBytes = newCommittedBytes;
+}
+
+void Cpu::VirtualMemory::relocate(uint64_t numBytes, uint64_t numReservedBytes)
+{
+    VirtualMemory newMemory;
+    newMemory.commit(numBytes, numReservedBytes);
+    std::memcpy(newMemory._data, _data, _committedBytes);
+    swap(newMemory);
+}
+
+void Cpu::VirtualMemory::swap(VirtualMemory& other)
+{
+    std::swap(_data, other._data);
+    std::swap(_reservedBytes, other._reservedBytes);
+    std::swap(_committedBytes, other._committedBytes);
+}
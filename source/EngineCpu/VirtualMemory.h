@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Cpu
+{
+    //address range which is reserved once and backed by physical memory page by page on demand
+    //=> memory can grow without moving its content
+    class VirtualMemory
+    {
+    public:
+        VirtualMemory() = default;
+        ~VirtualMemory();
+
+        VirtualMemory(VirtualMemory const&) = delete;
+        VirtualMemory& operator=(VirtualMemory const&) = delete;
+
+        unsigned char* getData() const { return _data; }
+        uint64_t getCommittedBytes() const { return _committedBytes; }
+
+        //reserves the address range at the first call, the content is moved to a new range if the reserved one is
+        //exceeded
+        void commit(uint64_t numBytes, uint64_t numReservedBytes);
+
+        void swap(VirtualMemory& other);
+
+    private:
+        void relocate(uint64_t numBytes, uint64_t numReservedBytes);
+
+        unsigned char* _data = nullptr;
+        uint64_t _reservedBytes = 0;
+        uint64_t _committedBytes = 0;
+    };
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+
+#include "EngineInterface/ElementaryTypes.h"
+
+#include "EntityFactory.h"
+#include "Math.h"
+#include "SimulationData.h"
+#include "SimulationResult.h"
+#include "SpotCalculator.h"
+
+namespace Cpu
+{
+    class WeaponFunction
+    {
+    public:
+        static void processing(Token* token, SimulationData& data, SimulationResult& result);
+
+    private:
+        static bool isHomogene(Cell* cell);
+        static float calcOpenAngle(Cell* cell, float2 direction);
+
+        static bool isConnectedConnected(Cell* cell, Cell* otherCell);
+    };
+
+    /************************************************************************/
+    /* Implementation                                                       */
+    /************************************************************************/
+
+    inline void WeaponFunction::processing(Token* token, SimulationData& data, SimulationResult& result)
+    {
+        auto const& parameters = data.constants.parameters;
+        auto const& cell = token->cell;
+        auto& tokenMem = token->memory;
+        tokenMem[Enums::Weapon::OUTPUT] = Enums::WeaponOut::NO_TARGET;
+
+        data.cellMap.executeForEach(cell->absPos, 1.6f, [&](Cell* otherCell) {
+            if (otherCell->tryLock()) {
+                if (!isConnectedConnected(cell, otherCell)) {
+                    auto energyToTransfer = otherCell->energy * parameters.cellFunctionWeaponStrength + 1.0f;
+
+                    auto cellFunctionWeaponGeometryDeviationExponent = SpotCalculator::calc(
+                        &SimulationParametersSpotValues::cellFunctionWeaponGeometryDeviationExponent, data, cell->absPos);
+
+                    if (fabsf(cellFunctionWeaponGeometryDeviationExponent) > FP_PRECISION) {
+                        auto d = otherCell->absPos - cell->absPos;
+                        auto angle1 = calcOpenAngle(cell, d);
+                        auto angle2 = calcOpenAngle(otherCell, d * (-1));
+                        auto deviation =
+                            1.0f - fabsf(360.0f - (angle1 + angle2)) / 360.0f;  //1 = no deviation, 0 = max deviation
+
+                        energyToTransfer = energyToTransfer
+                            * powf(std::max(0.0f, std::min(1.0f, deviation)), cellFunctionWeaponGeometryDeviationExponent);
+                    }
+
+                    auto cellFunctionWeaponColorPenalty = SpotCalculator::calc(
+                        &SimulationParametersSpotValues::cellFunctionWeaponColorPenalty, data, cell->absPos);
+
+                    auto homogene = isHomogene(cell);
+                    auto otherHomogene = isHomogene(otherCell);
+                    if (!homogene) {
+                        energyToTransfer = energyToTransfer * (1.0f - cellFunctionWeaponColorPenalty);
+                    }
+                    auto isColorSuperior = [](unsigned char color1, unsigned char color2) {
+                        color1 = color1 % 7;
+                        color2 = color2 % 7;
+                        if (color1 == color2 + 1 || (color1 == 0 && color2 == 6)) {
+                            return true;
+                        }
+                        return false;
+                    };
+                    if (homogene && otherHomogene && !isColorSuperior(cell->cold->metadata.color, otherCell->cold->metadata.color)) {
+                        energyToTransfer = energyToTransfer * (1.0f - cellFunctionWeaponColorPenalty);
+                    }
+                    if (otherCell->numConnections > cell->numConnections + 1) {
+                        energyToTransfer = 0;
+                    }
+                    if (otherCell->numConnections == cell->numConnections + 1) {
+                        energyToTransfer *= 0.2f;
+                    }
+                    if (otherCell->numConnections == cell->numConnections - 1) {
+                        energyToTransfer *= 2.0f;
+                    }
+                    if (otherCell->numConnections < cell->numConnections - 1) {
+                        energyToTransfer *= 4.0f;
+                    }
+                    if (otherCell->energy > energyToTransfer) {
+                        otherCell->energy -= energyToTransfer;
+                        data.markChanged(otherCell);
+                        token->energy += energyToTransfer / 2;
+                        cell->energy += energyToTransfer / 2;
+                        token->memory[Enums::Weapon::OUTPUT] = Enums::WeaponOut::STRIKE_SUCCESSFUL;
+                        result.incSuccessfulAttack();
+                    }
+                }
+                otherCell->releaseLock();
+            }
+        });
+        if (Enums::WeaponOut::NO_TARGET == token->memory[Enums::Weapon::OUTPUT]) {
+            result.incFailedAttack();
+        }
+        auto cellFunctionWeaponEnergyCost =
+            SpotCalculator::calc(&SimulationParametersSpotValues::cellFunctionWeaponEnergyCost, data, cell->absPos);
+        if (cellFunctionWeaponEnergyCost > 0) {
+            auto const cellEnergy = cell->energy;
+            auto& pos = cell->absPos;
+            float2 particleVel = (cell->vel * parameters.radiationVelocityMultiplier)
+                + float2{
+                    (data.numberGen.random(cell) - 0.5f) * parameters.radiationVelocityPerturbation,
+                    (data.numberGen.random(cell) - 0.5f) * parameters.radiationVelocityPerturbation};
+            float2 particlePos = pos + Math::normalized(particleVel) * 1.5f;
+            data.cellMap.mapPosCorrection(particlePos);
+
+            particlePos = particlePos - particleVel;  //because particle will still be moved in current time step
+            auto const radiationEnergy = std::min(cellEnergy, cellFunctionWeaponEnergyCost);
+            cell->energy -= radiationEnergy;
+            EntityFactory factory;
+            factory.init(&data);
+            factory.createParticle(radiationEnergy, particlePos, particleVel, {cell->cold->metadata.color});
+        }
+    }
+
+    inline bool WeaponFunction::isHomogene(Cell* cell)
+    {
+        int color = cell->cold->metadata.color;
+        for (int i = 0; i < cell->numConnections; ++i) {
+            auto otherCell = cell->connections[i].cell;
+            if ((color % 7) != (otherCell->cold->metadata.color % 7)) {
+                return false;
+            }
+            for (int j = 0; j < otherCell->numConnections; ++j) {
+                auto otherOtherCell = otherCell->connections[j].cell;
+                if ((color % 7) != (otherOtherCell->cold->metadata.color % 7)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    inline float WeaponFunction::calcOpenAngle(Cell* cell, float2 direction)
+    {
+        if (0 == cell->numConnections) {
+            return 0.0f;
+        }
+        if (1 == cell->numConnections) {
+            return 365.0f;
+        }
+
+        auto refAngle = Math::angleOfVector(direction);
+
+        float largerAngle = Math::angleOfVector(cell->connections[0].cell->absPos - cell->absPos);
+        float smallerAngle = largerAngle;
+
+        for (int i = 1; i < cell->numConnections; ++i) {
+            auto otherCell = cell->connections[i].cell;
+            auto angle = Math::angleOfVector(otherCell->absPos - cell->absPos);
+            if (largerAngle >= refAngle) {
+                if (largerAngle > angle && angle >= refAngle) {
+                    largerAngle = angle;
+                }
+            } else {
+                if (largerAngle > angle || angle >= refAngle) {
+                    largerAngle = angle;
+                }
+            }
+
+            if (smallerAngle <= refAngle) {
+                if (smallerAngle < angle && angle <= refAngle) {
+                    smallerAngle = angle;
+                }
+            } else {
+                if (smallerAngle < angle || angle <= refAngle) {
+                    smallerAngle = angle;
+                }
+            }
+        }
+        return Math::subtractAngle(largerAngle, smallerAngle);
+    }
+
+    inline bool WeaponFunction::isConnectedConnected(Cell* cell, Cell* otherCell)
+    {
+        if (cell == otherCell) {
+            return true;
+        }
+        for (int i = 0; i < otherCell->numConnections; ++i) {
+            if (otherCell->connections[i].cell == cell) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -5,6 +5,7 @@
 
 #include "AccessTOs.cuh"
 #include "Base.cuh"
+#include "CellAccessTOPacking.cuh"
 #include "Map.cuh"
 #include "EntityFactory.cuh"
 #include "CleanupKernels.cuh"
@@ -13,21 +14,14 @@
 
 #define SELECTION_RADIUS 30
 
-__device__ void copyString(
-    int& targetLen,
-    int& targetStringIndex,
-    int sourceLen,
-    char* sourceString,
-    int& numStringBytes,
-    char*& stringBytes)
-{
-    targetLen = sourceLen;
-    if (sourceLen > 0) {
-        targetStringIndex = atomicAdd(&numStringBytes, sourceLen);
-        for (int i = 0; i < sourceLen; ++i) {
-            stringBytes[targetStringIndex + i] = sourceString[i];
-        }
-    }
+__global__ void prepareStringsForAccess(SimulationData data)
+{
+    data.strings.prepareForAccess_system();
+}
+
+__global__ void internStrings(SimulationData data, DataAccessTO accessTO)
+{
+    data.strings.internAccessStrings_system(accessTO);
 }
 
 __global__ void tagCells(int2 rectUpperLeft, int2 rectLowerRight, Array<Cell*> cells)
@@ -63,8 +57,76 @@ __global__ void rolloutTagToCellClusters(Array<Cell*> cells, int* change)
     }
 }
 
-//tags cell with cellTO index and tags cellTO connections with cell index
-__global__ void getCellAccessDataWithoutConnections(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
+//tags cell with cellTO index and tags cellTO connections with cell index, returns the cellTO index
+//prerequisite: prepareStringsForAccess has been called for the access data
+__device__ int copyCellToAccessTO(Cell* cell, Cell* firstCell, StringTable& strings, DataAccessTO const& accessTO)
+{
+    auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
+    auto& cellTO = accessTO.cells[cellTOIndex];
+
+    cellTO.id = cell->id;
+    cellTO.pos = cell->absPos;
+    cellTO.vel = cell->vel;
+    cellTO.energy = cell->energy;
+    cellTO.maxConnections = cell->maxConnections;
+    cellTO.numConnections = cell->numConnections;
+    cellTO.branchNumber = cell->branchNumber;
+    cellTO.tokenBlocked = cell->tokenBlocked;
+    cellTO.cellFunctionType = cell->cellFunctionType;
+    cellTO.numStaticBytes = cell->cold->numStaticBytes;
+    cellTO.tokenUsages = cell->cold->tokenUsages;
+    cellTO.metadata.color = cell->cold->metadata.color;
+
+    auto const& metadata = cell->cold->metadata;
+    cellTO.metadata.nameStringIndex = strings.getAccessIndex(metadata.nameId, accessTO);
+    cellTO.metadata.descriptionStringIndex = strings.getAccessIndex(metadata.descriptionId, accessTO);
+    cellTO.metadata.sourceCodeStringIndex = strings.getAccessIndex(metadata.sourceCodeId, accessTO);
+    cell->tag = cellTOIndex;
+    for (int i = 0; i < cell->numConnections; ++i) {
+        auto connectingCell = cell->connections[i].cell;
+        cellTO.connections[i].cellIndex = connectingCell - firstCell;
+        cellTO.connections[i].distance = cell->connections[i].distance;
+        cellTO.connections[i].angleFromPrevious = cell->connections[i].angleFromPrevious;
+    }
+    for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
+        cellTO.staticData[i] = cell->cold->staticData[i];
+    }
+    cellTO.numMutableBytes = cell->cold->numMutableBytes;
+    for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
+        cellTO.mutableData[i] = cell->cold->mutableData[i];
+    }
+    return cellTOIndex;
+}
+
+//returns -1 if the cell has not been copied by the current request
+__device__ __inline__ int getCellTOIndex(Cell const& cell, DataAccessTO const& accessTO)
+{
+    auto const cellTOIndex = cell.tag;
+    if (cellTOIndex < 0 || cellTOIndex >= *accessTO.numCells || accessTO.cells[cellTOIndex].id != cell.id) {
+        return -1;
+    }
+    return cellTOIndex;
+}
+
+//only the cells in the tiles intersecting the rectangle are visited => cells outside may carry stale tags
+__global__ void
+getCellAccessDataWithoutConnections(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
+{
+    auto const firstCell = data.entities.cells.getArray();
+
+    data.cellTiles.executeForEachInRect_system(rectUpperLeft, rectLowerRight, [&](Cell* cell) {
+        auto pos = cell->absPos;
+        data.cellMap.mapPosCorrection(pos);
+        if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+            cell->tag = -1;
+            return;
+        }
+        copyCellToAccessTO(cell, firstCell, data.strings, accessTO);
+    });
+}
+
+//prerequisite: cells of the requested clusters are tagged with 1
+__global__ void getTaggedCellAccessDataWithoutConnections(SimulationData data, DataAccessTO accessTO)
 {
     auto const& cells = data.entities.cellPointers;
     auto const partition =
@@ -73,79 +135,12 @@ __global__ void getCellAccessDataWithoutConnections(int2 rectUpperLeft, int2 rec
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
-
-        auto pos = cell->absPos;
-        data.cellMap.mapPosCorrection(pos);
-        if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+        if (1 != cell->tag) {
             cell->tag = -1;
             continue;
         }
-        auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
-        auto& cellTO = accessTO.cells[cellTOIndex];
-
-        cellTO.id = cell->id;
-        cellTO.pos = cell->absPos;
-        cellTO.vel = cell->vel;
-        cellTO.energy = cell->energy;
-        cellTO.maxConnections = cell->maxConnections;
-        cellTO.numConnections = cell->numConnections;
-        cellTO.branchNumber = cell->branchNumber;
-        cellTO.tokenBlocked = cell->tokenBlocked;
-        cellTO.cellFunctionType = cell->cellFunctionType;
-        cellTO.numStaticBytes = cell->numStaticBytes;
-        cellTO.tokenUsages = cell->tokenUsages;
-        cellTO.metadata.color = cell->metadata.color;
-
-        copyString(
-            cellTO.metadata.nameLen,
-            cellTO.metadata.nameStringIndex,
-            cell->metadata.nameLen,
-            cell->metadata.name,
-            *accessTO.numStringBytes,
-            accessTO.stringBytes);
-        copyString(
-            cellTO.metadata.descriptionLen,
-            cellTO.metadata.descriptionStringIndex,
-            cell->metadata.descriptionLen,
-            cell->metadata.description,
-            *accessTO.numStringBytes,
-            accessTO.stringBytes);
-        copyString(
-            cellTO.metadata.sourceCodeLen,
-            cellTO.metadata.sourceCodeStringIndex,
-            cell->metadata.sourceCodeLen,
-            cell->metadata.sourceCode,
-            *accessTO.numStringBytes,
-            accessTO.stringBytes);
-        cell->tag = cellTOIndex;
-        for (int i = 0; i < cell->numConnections; ++i) {
-            auto connectingCell = cell->connections[i].cell;
-            cellTO.connections[i].cellIndex = connectingCell - firstCell;
-            cellTO.connections[i].distance = cell->connections[i].distance;
-            cellTO.connections[i].angleFromPrevious = cell->connections[i].angleFromPrevious;
-        }
-        for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
-            cellTO.staticData[i] = cell->staticData[i];
-        }
-        cellTO.numMutableBytes = cell->numMutableBytes;
-        for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
-            cellTO.mutableData[i] = cell->mutableData[i];
-        }
+        copyCellToAccessTO(cell, firstCell, data.strings, accessTO);
     }
-
-/*
-            PartitionData tokenBlock = calcPartition(cluster->numTokenPointers, threadIdx.x, blockDim.x);
-            for (auto tokenIndex = tokenBlock.startIndex; tokenIndex <= tokenBlock.endIndex; ++tokenIndex) {
-                Token const& token = *cluster->tokenPointers[tokenIndex];
-                TokenAccessTO& tokenTO = tokenTOs[tokenIndex];
-                tokenTO.energy = token.getEnergy();
-                for (int i = 0; i < cudaSimulationParameters.tokenMemorySize; ++i) {
-                    tokenTO.memory[i] = token.memory[i];
-                }
-                int tokenCellIndex = token.cell->tag + cellTOIndex;
-                tokenTO.cellIndex = tokenCellIndex;
-            }
-*/
 }
 
 __global__ void resolveConnections(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
@@ -159,7 +154,7 @@ __global__ void resolveConnections(int2 rectUpperLeft, int2 rectLowerRight, Simu
         
         for (int i = 0; i < cellTO.numConnections; ++i) {
             auto const cellIndex = cellTO.connections[i].cellIndex;
-            cellTO.connections[i].cellIndex = data.entities.cells.at(cellIndex).tag;
+            cellTO.connections[i].cellIndex = getCellTOIndex(data.entities.cells.at(cellIndex), accessTO);
         }
     }
 }
@@ -170,7 +165,75 @@ __global__ void getCellAccessData(int2 rectUpperLeft, int2 rectLowerRight, Simul
     KERNEL_CALL(resolveConnections, rectUpperLeft, rectLowerRight, data, accessTO);
 }
 
-__global__ void getCellOverlayData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
+__global__ void
+getCellOverlayData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, OverlayAccessTO overlayTO)
+{
+    data.cellTiles.executeForEachInRect_system(rectUpperLeft, rectLowerRight, [&](Cell* cell) {
+        auto pos = cell->absPos;
+        data.cellMap.mapPosCorrection(pos);
+        if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+            return;
+        }
+        auto elementIndex = atomicAdd(overlayTO.numElements, 1);
+        if (elementIndex >= overlayTO.maxElements) {
+            return;
+        }
+        auto& element = overlayTO.elements[elementIndex];
+
+        element.pos = cell->absPos;
+        element.cellFunctionType = cell->cellFunctionType;
+    });
+}
+
+__global__ void getTokenAccessData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
+{
+    auto const& tokens = data.entities.tokenPointers;
+
+    auto partition =
+        calcPartition(tokens.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    for (auto tokenIndex = partition.startIndex; tokenIndex <= partition.endIndex; ++tokenIndex) {
+        auto token = tokens.at(tokenIndex);
+        auto cellTOIndex = getCellTOIndex(*token->cell, accessTO);
+        if (-1 == cellTOIndex) {
+            continue;
+        }
+
+        auto tokenTOIndex = atomicAdd(accessTO.numTokens, 1);
+        auto& tokenTO = accessTO.tokens[tokenTOIndex];
+
+        tokenTO.energy = token->energy;
+        for (int i = 0; i < cudaSimulationParameters.tokenMemorySize; ++i) {
+            tokenTO.memory[i] = token->memory[i];
+        }
+        tokenTO.cellIndex = cellTOIndex;
+    }
+}
+
+__global__ void getParticleAccessData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO access)
+{
+    data.particleTiles.executeForEachInRect_system(rectUpperLeft, rectLowerRight, [&](Particle* particle) {
+        auto pos = particle->absPos;
+        data.particleMap.mapPosCorrection(pos);
+        if (isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+            int particleAccessIndex = atomicAdd(access.numParticles, 1);
+            ParticleAccessTO& particleAccess = access.particles[particleAccessIndex];
+
+            particleAccess.id = particle->id;
+            particleAccess.pos = particle->absPos;
+            particleAccess.vel = particle->vel;
+            particleAccess.energy = particle->energy;
+        }
+    });
+}
+
+//copies the cells changed after sinceVersion
+//tags cells with cellTO index, changed cells outside the rectangle are logged as removed
+__global__ void getChangedCellAccessData(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    uint64_t sinceVersion,
+    SimulationData data,
+    DataAccessTO accessTO)
 {
     auto const& cells = data.entities.cellPointers;
     auto const partition =
@@ -179,29 +242,54 @@ __global__ void getCellOverlayData(int2 rectUpperLeft, int2 rectLowerRight, Simu
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
+        cell->tag = -1;
+        if (cell->generation <= sinceVersion) {
+            continue;
+        }
 
         auto pos = cell->absPos;
         data.cellMap.mapPosCorrection(pos);
         if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+            data.logRemovedCell(cell->id);
             continue;
         }
-        auto cellTOIndex = atomicAdd(accessTO.numCells, 1);
-        auto& cellTO = accessTO.cells[cellTOIndex];
+        copyCellToAccessTO(cell, firstCell, data.strings, accessTO);
+    }
+}
+
+//unchanged cells connected to changed cells are appended such that connections can be resolved,
+//their own connections are omitted
+__global__ void getConnectedCellAccessData(SimulationData data, DataAccessTO accessTO, int numChangedCells)
+{
+    auto const partition =
+        calcPartition(numChangedCells, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    auto const firstCell = data.entities.cells.getArray();
 
-        cellTO.pos = cell->absPos;
-        cellTO.cellFunctionType = cell->cellFunctionType;
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& cellTO = accessTO.cells[index];
+        for (int i = 0; i < cellTO.numConnections; ++i) {
+            auto connectedCell = &data.entities.cells.at(cellTO.connections[i].cellIndex);
+            if (-1 != atomicCAS(&connectedCell->tag, -1, -2)) {
+                continue;
+            }
+            auto connectedCellTOIndex = copyCellToAccessTO(connectedCell, firstCell, data.strings, accessTO);
+            accessTO.cells[connectedCellTOIndex].numConnections = 0;
+        }
     }
 }
 
-__global__ void getTokenAccessData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO accessTO)
+__global__ void getChangedTokenAccessData(SimulationData data, DataAccessTO accessTO, int numChangedCells)
 {
     auto const& tokens = data.entities.tokenPointers;
-
-    auto partition =
+    auto const partition =
         calcPartition(tokens.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
-    for (auto tokenIndex = partition.startIndex; tokenIndex <= partition.endIndex; ++tokenIndex) {
-        auto token = tokens.at(tokenIndex);
 
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& token = tokens.at(index);
+        auto const cellTOIndex = token->cell->tag;
+        if (cellTOIndex < 0 || cellTOIndex >= numChangedCells) {
+            continue;
+        }
         auto tokenTOIndex = atomicAdd(accessTO.numTokens, 1);
         auto& tokenTO = accessTO.tokens[tokenTOIndex];
 
@@ -209,36 +297,211 @@ __global__ void getTokenAccessData(int2 rectUpperLeft, int2 rectLowerRight, Simu
         for (int i = 0; i < cudaSimulationParameters.tokenMemorySize; ++i) {
             tokenTO.memory[i] = token->memory[i];
         }
-        tokenTO.cellIndex = token->cell->tag;
+        tokenTO.cellIndex = cellTOIndex;
     }
 }
 
-__global__ void getParticleAccessData(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO access)
+__global__ void getChangedParticleAccessData(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    uint64_t sinceVersion,
+    SimulationData data,
+    DataAccessTO accessTO)
 {
-    PartitionData particleBlock = calcPartition(
-        data.entities.particlePointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    auto const& particles = data.entities.particlePointers;
+    auto const partition =
+        calcPartition(particles.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto const& particle = *particles.at(index);
+        if (particle.generation <= sinceVersion) {
+            continue;
+        }
 
-    for (int particleIndex = particleBlock.startIndex; particleIndex <= particleBlock.endIndex; ++particleIndex) {
-        auto const& particle = *data.entities.particlePointers.at(particleIndex);
         auto pos = particle.absPos;
         data.particleMap.mapPosCorrection(pos);
-        if (isContainedInRect(rectUpperLeft, rectLowerRight, particle.absPos)) {
-            int particleAccessIndex = atomicAdd(access.numParticles, 1);
-            ParticleAccessTO& particleAccess = access.particles[particleAccessIndex];
+        if (!isContainedInRect(rectUpperLeft, rectLowerRight, pos)) {
+            data.logRemovedParticle(particle.id);
+            continue;
+        }
+        auto particleTOIndex = atomicAdd(accessTO.numParticles, 1);
+        auto& particleTO = accessTO.particles[particleTOIndex];
+
+        particleTO.id = particle.id;
+        particleTO.pos = particle.absPos;
+        particleTO.vel = particle.vel;
+        particleTO.energy = particle.energy;
+        particleTO.metadata.color = particle.metadata.color;
+    }
+}
+
+//row-major tiles for exporting the world in chunks
+//each cluster belongs to the first tile containing one of its cells
+struct ExportTiles
+{
+    int tileSize;
+    int2 numTiles;
+    int* ownerTiles;  //tile of the cluster of each cell in the order of the cell pointers
+
+    __device__ __inline__ int getTile(float2 pos, MapInfo const& map) const
+    {
+        map.mapPosCorrection(pos);
+        auto x = min(floorInt(pos.x) / tileSize, numTiles.x - 1);
+        auto y = min(floorInt(pos.y) / tileSize, numTiles.y - 1);
+        return x + y * numTiles.x;
+    }
+};
+
+//the tag of each cell is its tile, the tags are then reduced to the minimum within each cluster
+__global__ void tagCellsWithExportTiles(ExportTiles exportTiles, SimulationData data)
+{
+    auto const& cells = data.entities.cellPointers;
+    auto const partition =
+        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        cell->tag = exportTiles.getTile(cell->absPos, data.cellMap);
+    }
+}
+
+__global__ void rolloutMinTagToCellClusters(Array<Cell*> cells, int* change)
+{
+    auto const partition =
+        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        auto tag = atomicAdd(&cell->tag, 0);
+        for (int i = 0; i < cell->numConnections; ++i) {
+            auto origTag = atomicMin(&cell->connections[i].cell->tag, tag);
+            if (origTag > tag) {
+                atomicExch(change, 1);
+            }
+        }
+    }
+}
 
-            particleAccess.id = particle.id;
-            particleAccess.pos = particle.absPos;
-            particleAccess.vel = particle.vel;
-            particleAccess.energy = particle.energy;
+__device__ __inline__ void countExportString(int* counters, StringTable const& strings, int stringId)
+{
+    auto const stringLen = strings.getNumBytes(stringId);
+    if (stringLen > 0) {
+        atomicAdd(&counters[3], 1);
+        atomicAdd(&counters[4], stringLen);
+    }
+}
+
+//prerequisite: cells are tagged with the tile of their cluster
+//the tags are kept as owner tiles for the extraction of the single tiles
+//the counters per tile are laid out as in ArraySizes, the string counters are upper bounds
+__global__ void countExportTileEntities(ExportTiles exportTiles, SimulationData data, int* tileCounters)
+{
+    {
+        auto const& cells = data.entities.cellPointers;
+        auto const partition =
+            calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cell = cells.at(index);
+            exportTiles.ownerTiles[index] = cell->tag;
+            auto counters = &tileCounters[cell->tag * 5];
+            atomicAdd(&counters[0], 1);
+            auto const& metadata = cell->cold->metadata;
+            countExportString(counters, data.strings, metadata.nameId);
+            countExportString(counters, data.strings, metadata.descriptionId);
+            countExportString(counters, data.strings, metadata.sourceCodeId);
+        }
+    }
+    {
+        auto const& particles = data.entities.particlePointers;
+        auto const partition =
+            calcPartition(particles.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto tile = exportTiles.getTile(particles.at(index)->absPos, data.particleMap);
+            atomicAdd(&tileCounters[tile * 5 + 1], 1);
+        }
+    }
+    {
+        auto const& tokens = data.entities.tokenPointers;
+        auto const partition =
+            calcPartition(tokens.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            atomicAdd(&tileCounters[tokens.at(index)->cell->tag * 5 + 2], 1);
         }
     }
 }
 
+//prerequisite: owner tiles have been determined by countExportTileEntities and the cells have not changed since then
+__global__ void getExportTileCellAccessDataWithoutConnections(
+    ExportTiles exportTiles,
+    int tile,
+    SimulationData data,
+    DataAccessTO accessTO)
+{
+    auto const& cells = data.entities.cellPointers;
+    auto const partition =
+        calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+    auto const firstCell = data.entities.cells.getArray();
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto& cell = cells.at(index);
+        if (exportTiles.ownerTiles[index] != tile) {
+            cell->tag = -1;
+            continue;
+        }
+        copyCellToAccessTO(cell, firstCell, data.strings, accessTO);
+    }
+}
+
+__global__ void getExportTileParticleAccessData(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    ExportTiles exportTiles,
+    int tile,
+    SimulationData data,
+    DataAccessTO access)
+{
+    data.particleTiles.executeForEachInRect_system(rectUpperLeft, rectLowerRight, [&](Particle* particle) {
+        if (exportTiles.getTile(particle->absPos, data.particleMap) != tile) {
+            return;
+        }
+        int particleAccessIndex = atomicAdd(access.numParticles, 1);
+        ParticleAccessTO& particleAccess = access.particles[particleAccessIndex];
+
+        particleAccess.id = particle->id;
+        particleAccess.pos = particle->absPos;
+        particleAccess.vel = particle->vel;
+        particleAccess.energy = particle->energy;
+    });
+}
+
+__global__ void cleanupTileIndices(SimulationData data)
+{
+    data.cellTiles.cleanup_system();
+    data.particleTiles.cleanup_system();
+}
+
+__global__ void countEntitiesForTileIndices(SimulationData data)
+{
+    data.cellTiles.countEntities_system(data.entities.cellPointers);
+    data.particleTiles.countEntities_system(data.entities.particlePointers);
+}
+
+__global__ void allocateTiles(SimulationData data)
+{
+    data.cellTiles.allocateTiles_system();
+    data.particleTiles.allocateTiles_system();
+}
+
+__global__ void fillTileIndices(SimulationData data)
+{
+    data.cellTiles.fillTiles_system(data.entities.cellPointers);
+    data.particleTiles.fillTiles_system(data.entities.particlePointers);
+}
+
 __global__ void createDataFromTO(
     SimulationData data,
     DataAccessTO simulationTO,
     Particle* particleTargetArray,
     Cell* cellTargetArray,
+    CellColdData* cellColdDataTargetArray,
     Token* tokenTargetArray)
 {
     __shared__ EntityFactory factory;
@@ -256,7 +519,8 @@ __global__ void createDataFromTO(
     auto cellPartition =
         calcPartition(*simulationTO.numCells, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
     for (int index = cellPartition.startIndex; index <= cellPartition.endIndex; ++index) {
-        factory.createCellFromTO(index, simulationTO.cells[index], cellTargetArray, &simulationTO);
+        factory.createCellFromTO(
+            index, simulationTO.cells[index], cellTargetArray, cellColdDataTargetArray, &simulationTO);
     }
 
     auto tokenPartition =
@@ -288,27 +552,180 @@ __global__ void adaptNumberGenerator(CudaNumberGenerator numberGen, DataAccessTO
     }
 }
 
+//the records are placed in the order in which the threads reserve their space
+__global__ void calcPackedCellOffsets(DataAccessTO accessTO, PackedCellsAccessTO packedTO)
+{
+    auto const partition =
+        calcPartition(*accessTO.numCells, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        auto size = static_cast<unsigned long long int>(calcPackedCellSize(accessTO.cells[index]));
+        packedTO.offsets[index] = atomicAdd(packedTO.numBytes, size);
+    }
+}
+
+__global__ void packCellAccessData(DataAccessTO accessTO, PackedCellsAccessTO packedTO)
+{
+    auto const partition =
+        calcPartition(*accessTO.numCells, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        packCell(accessTO.cells[index], packedTO.bytes + packedTO.offsets[index]);
+    }
+}
+
+__global__ void unpackCellAccessData(PackedCellsAccessTO packedTO, DataAccessTO accessTO)
+{
+    auto const partition =
+        calcPartition(*accessTO.numCells, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        unpackCell(packedTO.bytes + packedTO.offsets[index], accessTO.cells[index]);
+    }
+}
+
 /************************************************************************/
 /* Main      															*/
 /************************************************************************/
+__global__ void cudaBuildTileIndices(SimulationData data)
+{
+    KERNEL_CALL(cleanupTileIndices, data);
+    data.cellTiles.reset();
+    data.particleTiles.reset();
+    KERNEL_CALL(countEntitiesForTileIndices, data);
+    KERNEL_CALL(allocateTiles, data);
+    KERNEL_CALL(fillTileIndices, data);
+}
+
 __global__ void
 cudaGetSimulationAccessDataKernel(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO access)
 {
     *access.numCells = 0;
     *access.numParticles = 0;
     *access.numTokens = 0;
+    *access.numStrings = 0;
     *access.numStringBytes = 0;
+    KERNEL_CALL(prepareStringsForAccess, data);
 
     KERNEL_CALL_1_1(getCellAccessData, rectUpperLeft, rectLowerRight, data, access);
     KERNEL_CALL(getTokenAccessData, rectUpperLeft, rectLowerRight, data, access);
     KERNEL_CALL(getParticleAccessData, rectUpperLeft, rectLowerRight, data, access);
 }
 
-__global__ void
-cudaGetSimulationOverlayDataKernel(int2 rectUpperLeft, int2 rectLowerRight, SimulationData data, DataAccessTO access)
+//clusters with at least one cell in the rectangle are copied completely
+__global__ void cudaGetClusterAccessDataKernel(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    SimulationData data,
+    DataAccessTO access,
+    int* rolloutChange)
 {
     *access.numCells = 0;
-    KERNEL_CALL(getCellOverlayData, rectUpperLeft, rectLowerRight, data, access);
+    *access.numParticles = 0;
+    *access.numTokens = 0;
+    *access.numStrings = 0;
+    *access.numStringBytes = 0;
+    KERNEL_CALL(prepareStringsForAccess, data);
+
+    KERNEL_CALL(tagCells, rectUpperLeft, rectLowerRight, data.entities.cellPointers);
+    do {
+        *rolloutChange = 0;
+        KERNEL_CALL(rolloutTagToCellClusters, data.entities.cellPointers, rolloutChange);
+    } while (1 == *rolloutChange);
+
+    KERNEL_CALL(getTaggedCellAccessDataWithoutConnections, data, access);
+    KERNEL_CALL(resolveConnections, rectUpperLeft, rectLowerRight, data, access);
+    KERNEL_CALL(getTokenAccessData, rectUpperLeft, rectLowerRight, data, access);
+    KERNEL_CALL(getParticleAccessData, rectUpperLeft, rectLowerRight, data, access);
+}
+
+__global__ void cudaGetExportTileCountersKernel(
+    ExportTiles exportTiles,
+    SimulationData data,
+    int* tileCounters,
+    int* rolloutChange)
+{
+    KERNEL_CALL(tagCellsWithExportTiles, exportTiles, data);
+    do {
+        *rolloutChange = 0;
+        KERNEL_CALL(rolloutMinTagToCellClusters, data.entities.cellPointers, rolloutChange);
+    } while (1 == *rolloutChange);
+    KERNEL_CALL(countExportTileEntities, exportTiles, data, tileCounters);
+}
+
+//the clusters belonging to the tile are copied completely, particles only if they lie in the tile
+__global__ void cudaGetExportTileAccessDataKernel(
+    ExportTiles exportTiles,
+    int tile,
+    SimulationData data,
+    DataAccessTO access)
+{
+    *access.numCells = 0;
+    *access.numParticles = 0;
+    *access.numTokens = 0;
+    *access.numStrings = 0;
+    *access.numStringBytes = 0;
+    KERNEL_CALL(prepareStringsForAccess, data);
+
+    int2 rectUpperLeft{
+        (tile % exportTiles.numTiles.x) * exportTiles.tileSize, (tile / exportTiles.numTiles.x) * exportTiles.tileSize};
+    int2 rectLowerRight{rectUpperLeft.x + exportTiles.tileSize, rectUpperLeft.y + exportTiles.tileSize};
+    KERNEL_CALL(getExportTileCellAccessDataWithoutConnections, exportTiles, tile, data, access);
+    KERNEL_CALL(resolveConnections, rectUpperLeft, rectLowerRight, data, access);
+    KERNEL_CALL(getTokenAccessData, rectUpperLeft, rectLowerRight, data, access);
+    KERNEL_CALL(getExportTileParticleAccessData, rectUpperLeft, rectLowerRight, exportTiles, tile, data, access);
+}
+
+//copies the entities which have been changed after sinceVersion
+//the cells after numChangedCells in the access data are only referenced by connections
+__global__ void cudaGetSimulationDeltaAccessDataKernel(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    uint64_t sinceVersion,
+    SimulationData data,
+    DataAccessTO access,
+    int* numChangedCells)
+{
+    *access.numCells = 0;
+    *access.numParticles = 0;
+    *access.numTokens = 0;
+    *access.numStrings = 0;
+    *access.numStringBytes = 0;
+    KERNEL_CALL(prepareStringsForAccess, data);
+
+    KERNEL_CALL(getChangedCellAccessData, rectUpperLeft, rectLowerRight, sinceVersion, data, access);
+    KERNEL_CALL(getChangedParticleAccessData, rectUpperLeft, rectLowerRight, sinceVersion, data, access);
+    *numChangedCells = *access.numCells;
+    KERNEL_CALL(getConnectedCellAccessData, data, access, *numChangedCells);
+    KERNEL_CALL(resolveConnections, rectUpperLeft, rectLowerRight, data, access);
+    KERNEL_CALL(getChangedTokenAccessData, data, access, *numChangedCells);
+}
+
+__global__ void cudaGetSimulationOverlayDataKernel(
+    int2 rectUpperLeft,
+    int2 rectLowerRight,
+    SimulationData data,
+    OverlayAccessTO overlayTO)
+{
+    *overlayTO.numElements = 0;
+    KERNEL_CALL(getCellOverlayData, rectUpperLeft, rectLowerRight, data, overlayTO);
+}
+
+__global__ void cudaCalcPackedCellOffsetsKernel(DataAccessTO access, PackedCellsAccessTO packedTO)
+{
+    *packedTO.numBytes = 0;
+    KERNEL_CALL(calcPackedCellOffsets, access, packedTO);
+}
+
+//prerequisite: offsets are calculated by cudaCalcPackedCellOffsetsKernel and the byte buffer is large enough
+__global__ void cudaPackCellAccessDataKernel(DataAccessTO access, PackedCellsAccessTO packedTO)
+{
+    KERNEL_CALL(packCellAccessData, access, packedTO);
+}
+
+__global__ void cudaUnpackCellAccessDataKernel(PackedCellsAccessTO packedTO, DataAccessTO access)
+{
+    KERNEL_CALL(unpackCellAccessData, packedTO, access);
 }
 
 __global__ void cudaClearData(SimulationData data)
@@ -317,22 +734,31 @@ __global__ void cudaClearData(SimulationData data)
     data.entities.tokenPointers.reset();
     data.entities.particlePointers.reset();
     data.entities.cells.reset();
+    data.entities.cellColdData.reset();
     data.entities.tokens.reset();
     data.entities.particles.reset();
-    data.entities.strings.reset();
+    data.strings.reset();
+    KERNEL_CALL(clearStringIndex, data);
 }
 
-__global__ void cudaSetSimulationAccessDataKernel(SimulationData data, DataAccessTO access)
+__global__ void cudaAddSimulationAccessDataKernel(SimulationData data, DataAccessTO access)
 {
-    KERNEL_CALL_1_1(cudaClearData, data);
     KERNEL_CALL(adaptNumberGenerator, data.numberGen, access);
+    KERNEL_CALL(internStrings, data, access);
     KERNEL_CALL(
         createDataFromTO,
         data,
         access,
         data.entities.particles.getNewSubarray(*access.numParticles),
         data.entities.cells.getNewSubarray(*access.numCells),
+        data.entities.cellColdData.getNewSubarray(*access.numCells),
         data.entities.tokens.getNewSubarray(*access.numTokens));
 
     KERNEL_CALL_1_1(cleanupAfterDataManipulationKernel, data);
 }
+
+__global__ void cudaSetSimulationAccessDataKernel(SimulationData data, DataAccessTO access)
+{
+    KERNEL_CALL_1_1(cudaClearData, data);
+    KERNEL_CALL_1_1(cudaAddSimulationAccessDataKernel, data, access);
+}
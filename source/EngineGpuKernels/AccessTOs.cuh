@@ -1,6 +1,6 @@
 #pragma once
 
-#include <cuda_runtime.h>
+#include "VectorTypes.h"
 
 #include "CudaSimulation.cuh"
 
@@ -30,18 +30,21 @@ struct ParticleAccessTO
     ParticleMetadataAccessTO metadata;
 };
 
+//string shared by all cells referring to it
+struct StringAccessTO
+{
+    int numBytes;
+    int byteIndex;
+};
+
 struct CellMetadataAccessTO
 {
     unsigned char color;
 
-    int nameLen;
-    int nameStringIndex;
-
-    int descriptionLen;
-    int descriptionStringIndex;
-
-    int sourceCodeLen;
-    int sourceCodeStringIndex;
+    //indices in DataAccessTO::strings, -1 = empty string
+    int nameStringIndex = -1;
+    int descriptionStringIndex = -1;
+    int sourceCodeStringIndex = -1;
 };
 
 struct CellConnectionTO
@@ -71,6 +74,21 @@ struct CellAccessTO
     CellMetadataAccessTO metadata;
 };
 
+//compact record for the cell function overlay
+struct OverlayElementAccessTO
+{
+    float2 pos;
+    int cellFunctionType;
+};
+
+//numElements counts all elements in the rectangle, only the first maxElements of them are written
+struct OverlayAccessTO
+{
+    int* numElements = nullptr;
+    OverlayElementAccessTO* elements = nullptr;
+    int maxElements = 0;
+};
+
 struct DataAccessTO
 {
 	int* numCells = nullptr;
@@ -79,6 +97,8 @@ struct DataAccessTO
 	ParticleAccessTO* particles = nullptr;
 	int* numTokens = nullptr;
 	TokenAccessTO* tokens = nullptr;
+    int* numStrings = nullptr;
+    StringAccessTO* strings = nullptr;
     int* numStringBytes = nullptr;
     char* stringBytes = nullptr;
 
@@ -90,6 +110,8 @@ struct DataAccessTO
 			&& particles == other.particles
 			&& numTokens == other.numTokens
 			&& tokens == other.tokens
+            && numStrings == other.numStrings
+            && strings == other.strings
             && numStringBytes == other.numStringBytes
             && stringBytes == other.stringBytes;
 	}
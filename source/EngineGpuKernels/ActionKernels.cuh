@@ -17,8 +17,9 @@
 
 #include "SimulationData.cuh"
 
-__global__ void applyForceToCells(ApplyForceData applyData, int2 universeSize, Array<Cell*> cells)
+__global__ void applyForceToCells(ApplyForceData applyData, SimulationData data)
 {
+    auto& cells = data.entities.cellPointers;
     auto const cellBlock = calcAllThreadsPartition(cells.getNumEntries());
 
     for (int index = cellBlock.startIndex; index <= cellBlock.endIndex; ++index) {
@@ -30,12 +31,14 @@ __global__ void applyForceToCells(ApplyForceData applyData, int2 universeSize, A
             auto weightedForce = applyData.force;
             //*(actionRadius - distanceToSegment) / actionRadius;
             cell->vel = cell->vel + weightedForce;
+            data.markChanged(cell);
         }
     }
 }
 
-__global__ void applyForceToParticles(ApplyForceData applyData, int2 universeSize, Array<Particle*> particles)
+__global__ void applyForceToParticles(ApplyForceData applyData, SimulationData data)
 {
+    auto& particles = data.entities.particlePointers;
     auto const particleBlock = calcAllThreadsPartition(particles.getNumEntries());
 
     for (int index = particleBlock.startIndex; index <= particleBlock.endIndex; ++index) {
@@ -46,6 +49,7 @@ __global__ void applyForceToParticles(ApplyForceData applyData, int2 universeSiz
         if (distanceToSegment < applyData.radius) {
             auto weightedForce = applyData.force;//*(actionRadius - distanceToSegment) / actionRadius;
             particle->vel = particle->vel + weightedForce;
+            data.markChanged(particle);
         }
     }
 }
@@ -160,6 +164,7 @@ __global__ void updatePosAndVelForSelection(ShallowUpdateSelectionData updateDat
             || (1 == cell->selected && !updateData.considerClusters)) {
             cell->absPos = cell->absPos + float2{updateData.posDeltaX, updateData.posDeltaY};
             cell->vel = cell->vel + float2{updateData.velDeltaX, updateData.velDeltaY};
+            data.markChanged(cell);
         }
     }
 
@@ -169,6 +174,7 @@ __global__ void updatePosAndVelForSelection(ShallowUpdateSelectionData updateDat
         if (0 != particle->selected) {
             particle->absPos = particle->absPos + float2{updateData.posDeltaX, updateData.posDeltaY};
             particle->vel = particle->vel + float2{updateData.velDeltaX, updateData.velDeltaY};
+            data.markChanged(particle);
         }
     }
 }
@@ -244,12 +250,6 @@ __global__ void disconnectSelection(SimulationData data, int* result)
     }
 }
 
-__global__ void updateMapForConnection(SimulationData data)
-{
-    CellProcessor cellProcessor;
-    cellProcessor.updateMap(data);
-}
-
 __global__ void connectSelection(SimulationData data, int* result)
 {
     auto const partition = calcAllThreadsPartition(data.entities.cellPointers.getNumEntries());
@@ -348,6 +348,7 @@ updateAngleAndAngularVelForSelection(ShallowUpdateSelectionData updateData, Simu
                 || (!updateData.considerClusters && cell->selected == 1)) {
                 auto relPos = cell->absPos - center;
                 data.cellMap.mapDisplacementCorrection(relPos);
+                data.markChanged(cell);
 
                 if (updateData.angleDelta != 0) {
                     cell->absPos = Math::applyMatrix(relPos, rotationMatrix) + center;
@@ -374,6 +375,7 @@ updateAngleAndAngularVelForSelection(ShallowUpdateSelectionData updateData, Simu
                 data.cellMap.mapDisplacementCorrection(relPos);
                 particle->absPos = Math::applyMatrix(relPos, rotationMatrix) + center;
                 data.cellMap.mapPosCorrection(particle->absPos);
+                data.markChanged(particle);
             }
         }
     }
@@ -385,8 +387,8 @@ updateAngleAndAngularVelForSelection(ShallowUpdateSelectionData updateData, Simu
 
 __global__ void cudaApplyForce(ApplyForceData applyData, SimulationData data)
 {
-    KERNEL_CALL(applyForceToCells, applyData, data.size, data.entities.cellPointers);
-    KERNEL_CALL(applyForceToParticles, applyData, data.size, data.entities.particlePointers);
+    KERNEL_CALL(applyForceToCells, applyData, data);
+    KERNEL_CALL(applyForceToParticles, applyData, data);
 }
 
 __global__ void
@@ -473,7 +475,7 @@ __global__ void cudaShallowUpdateSelection(ShallowUpdateSelectionData updateData
             *result = 0;
             data.prepareForSimulation();
 
-            KERNEL_CALL(updateMapForConnection, data);
+            KERNEL_CALL_1_1(cudaBuildCellMap, data);
             KERNEL_CALL(connectSelection, data, result);
             KERNEL_CALL(processConnectionChanges, data);
 
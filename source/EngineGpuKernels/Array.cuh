@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include <cuda_runtime.h>
 #include <device_launch_parameters.h>
 #include <cuda/helper_cuda.h>
@@ -7,17 +9,13 @@
 #include "CudaMemoryManager.cuh"
 #include "Swap.cuh"
 
-namespace Const
-{
-    constexpr float ArrayFillLevelFactor = 2.0f / 3.0f;
-}
-
 template <class T>
 class Array
 {
 private:
     int* _size;
     int* _numEntries;
+    int _maxSize = 0;  //arrays with a maximum size grow in place within a reserved address range
 
 public:
     T** _data;
@@ -136,22 +134,55 @@ public:
         return &(*_data)[oldIndex];
     }
 
+    __device__ __inline__ T* tryGetNewElement()
+    {
+        int oldIndex = atomicAdd(_numEntries, 1);
+        if (oldIndex >= *_size) {
+            atomicAdd(_numEntries, -1);
+            return nullptr;
+        }
+        return &(*_data)[oldIndex];
+    }
+
     __device__ __inline__ T& at(int index) { return (*_data)[index]; }
     __device__ __inline__ T const& at(int index) const { return (*_data)[index]; }
 
     __device__ __inline__ int decNumEntriesAndReturnOrigSize() { return atomicSub(_numEntries, 1); }
 
-    __device__ __inline__ bool shouldResize(int arraySizeInc) const
+    __device__ __inline__ bool shouldResize(int arraySizeInc, float fillLevelFactor) const
     {
-        return getNumEntries() + arraySizeInc > getSize() * Const::ArrayFillLevelFactor;
+        return getNumEntries() + arraySizeInc > getSize() * fillLevelFactor;
     }
-    __host__ __inline__ bool shouldResize_host(int arraySizeInc) const
+    __host__ __inline__ bool shouldResize_host(int arraySizeInc, float fillLevelFactor) const
     {
-        return getNumEntries_host() + arraySizeInc > getSize_host() * Const::ArrayFillLevelFactor;
+        return getNumEntries_host() + arraySizeInc > getSize_host() * fillLevelFactor;
     }
 
+    //determines the reserved address range, must be called before the first resize
+    __host__ __inline__ void setMaxSize(int value) { _maxSize = value; }
+
+    //arrays with a maximum size preserve their content if virtual memory management is supported, other arrays are
+    //reallocated without preserving their content
     __host__ __inline__ void resize(int newSize) const
     {
+        auto& memoryManager = CudaMemoryManager::getInstance();
+        if (_maxSize > 0 && memoryManager.isVirtualMemorySupported()) {
+            newSize = std::min(newSize, _maxSize);
+            auto size = getSize_host();
+            if (newSize <= size) {
+                return;
+            }
+            if (size > 0) {
+                memoryManager.growMemory(getArray_host(), newSize);
+            } else {
+                T* newData;
+                memoryManager.reserveMemory<T>(_maxSize, newSize, newData);
+                setArray_host(newData);
+            }
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(_size, &newSize, sizeof(int), cudaMemcpyHostToDevice));
+            return;
+        }
+
         auto size = getSize_host();
 
         if (size == newSize) {
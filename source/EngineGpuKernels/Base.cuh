@@ -37,52 +37,78 @@ struct PartitionData
     __inline__ __device__ int numElements() const { return endIndex - startIndex + 1; }
 };
 
+//Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): maps a 128 bit counter and a 64 bit
+//key bijectively to 128 random bits without any state
+__device__ __inline__ unsigned int philox4x32_10(uint4 counter, uint2 key)
+{
+    unsigned int const M0 = 0xD2511F53;
+    unsigned int const M1 = 0xCD9E8D57;
+    unsigned int const W0 = 0x9E3779B9;
+    unsigned int const W1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; ++round) {
+        unsigned int hi0 = __umulhi(M0, counter.x);
+        unsigned int lo0 = M0 * counter.x;
+        unsigned int hi1 = __umulhi(M1, counter.z);
+        unsigned int lo1 = M1 * counter.z;
+        counter = make_uint4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+        key.x += W0;
+        key.y += W1;
+    }
+    return counter.x;
+}
+
+//each random number is a function of (seed, time step, entity id, number of previous draws for that entity in the
+//time step) => the numbers do not depend on the thread which processes an entity and no shared counter is needed
 class CudaNumberGenerator
 {
 private:
-    unsigned int* _currentIndex;
-    int* _array;
-    int _size;
+    unsigned int _seed;
+    unsigned long long int _timestep;
 
     unsigned long long int* _currentId;
 
 public:
-    void init(int size)
+    static int const MaxRandomNumber = 0x7fffffff;
+
+    void init()
     {
-        _size = size;
+        _seed = 0;
+        _timestep = 0;
 
-        CudaMemoryManager::getInstance().acquireMemory<unsigned int>(1, _currentIndex);
-        CudaMemoryManager::getInstance().acquireMemory<int>(size, _array);
         CudaMemoryManager::getInstance().acquireMemory<unsigned long long int>(1, _currentId);
 
-        CHECK_FOR_CUDA_ERROR(cudaMemset(_currentIndex, 0, sizeof(unsigned int)));
         unsigned long long int hostCurrentId = 1;
         CHECK_FOR_CUDA_ERROR(cudaMemcpy(_currentId, &hostCurrentId, sizeof(_currentId), cudaMemcpyHostToDevice));
-
-        std::vector<int> randomNumbers(size);
-        for (int i = 0; i < size; ++i) {
-            randomNumbers[i] = rand();
-        }
-        CHECK_FOR_CUDA_ERROR(cudaMemcpy(_array, randomNumbers.data(), sizeof(int) * size, cudaMemcpyHostToDevice));
     }
 
+    //has to be called before the time step kernel is launched since the generator is passed by value
+    void prepareForTimestep_host(unsigned int seed, unsigned long long int timestep)
+    {
+        _seed = seed;
+        _timestep = timestep;
+    }
 
-    __device__ __inline__ int random(int maxVal)
+    //the draw index of an entity is reset at the beginning of each time step
+    template <typename Entity>
+    __device__ __inline__ int random(Entity* entity, int maxVal)
     {
-        int number = getRandomNumber();
+        int number = getRandomNumber(entity);
         return number % (maxVal + 1);
     }
 
-    __device__ __inline__ float random(float maxVal)
+    template <typename Entity>
+    __device__ __inline__ float random(Entity* entity, float maxVal)
     {
-        int number = getRandomNumber();
-        return maxVal * static_cast<float>(number) / RAND_MAX;
+        int number = getRandomNumber(entity);
+        return maxVal * static_cast<float>(number) / MaxRandomNumber;
     }
 
-    __device__ __inline__ float random()
+    template <typename Entity>
+    __device__ __inline__ float random(Entity* entity)
     {
-        int number = getRandomNumber();
-        return static_cast<float>(number) / RAND_MAX;
+        int number = getRandomNumber(entity);
+        return static_cast<float>(number) / MaxRandomNumber;
     }
 
     __device__ __inline__ unsigned long long int createNewId_kernel() { return atomicAdd(_currentId, 1); }
@@ -94,16 +120,21 @@ public:
 
     void free()
     {
-        CudaMemoryManager::getInstance().freeMemory(_currentIndex);
-        CudaMemoryManager::getInstance().freeMemory(_array);
         CudaMemoryManager::getInstance().freeMemory(_currentId);
     }
 
 private:
-    __device__ __inline__ int getRandomNumber()
+    template <typename Entity>
+    __device__ __inline__ int getRandomNumber(Entity* entity)
     {
-        int index = atomicInc(_currentIndex, _size - 1);
-        return _array[index];
+        unsigned int drawIndex = atomicAdd(&entity->numRandomDraws, 1);
+        auto counter = make_uint4(
+            drawIndex,
+            static_cast<unsigned int>(entity->id),
+            static_cast<unsigned int>(entity->id >> 32),
+            static_cast<unsigned int>(_timestep));
+        auto key = make_uint2(_seed, static_cast<unsigned int>(_timestep >> 32));
+        return static_cast<int>(philox4x32_10(counter, key) & MaxRandomNumber);
     }
 };
 
@@ -9,14 +9,10 @@ struct CellMetadata
 {
     unsigned char color;
 
-    int nameLen;
-    char* name;
-
-    int descriptionLen;
-    char* description;
-
-    int sourceCodeLen;
-    char* sourceCode;
+    //ids in the string table of the simulation data, 0 = empty string
+    int nameId;
+    int descriptionId;
+    int sourceCodeId;
 };
 
 struct CellConnection
@@ -26,6 +22,19 @@ struct CellConnection
     float angleFromPrevious;
 };
 
+//data which is only accessed by cell functions, token processing and data access
+//it is stored in a separate array such that the physics kernels do not need to load it
+struct CellColdData
+{
+    unsigned char numStaticBytes;
+    char staticData[MAX_CELL_STATIC_BYTES];
+    unsigned char numMutableBytes;
+    char mutableData[MAX_CELL_MUTABLE_BYTES];
+    int tokenUsages;
+    CellMetadata metadata;
+};
+
+//the hot fields remain an array of structs since the kernels address cells through Cell* handles
 struct Cell
 {
     uint64_t id;
@@ -37,21 +46,20 @@ struct Cell
     int maxConnections;
     int numConnections;
     CellConnection connections[MAX_CELL_BONDS];
-    unsigned char numStaticBytes;
-    char staticData[MAX_CELL_STATIC_BYTES];
-    unsigned char numMutableBytes;
-    char mutableData[MAX_CELL_MUTABLE_BYTES];
-    int tokenUsages;
-    CellMetadata metadata;
     float energy;
     int cellFunctionType;
+    CellColdData* cold;
 
     //editing data
     int selected;   //0 = no, 1 = selected, 2 = indirectly selected
 
+    //change tracking for delta extraction
+    uint64_t generation;  //data version at the last change
+
     //temporary data
     int locked;	//0 = unlocked, 1 = locked
     int tag;
+    unsigned int numRandomDraws;  //draw index for the number generator in the current time step
     float2 temp1;
     float2 temp2;
     float2 temp3;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstring>
+
+#include <cuda_runtime.h>
+
+#include "AccessTOs.cuh"
+
+//packed transfer encoding of CellAccessTO: fixed header followed by the used connections, static and mutable bytes
+//each record is padded to a multiple of 8 bytes such that the next header is aligned
+struct PackedCellHeaderTO
+{
+    uint64_t id;
+    float2 pos;
+    float2 vel;
+    float energy;
+    int branchNumber;
+    int cellFunctionType;
+    int tokenUsages;
+    CellMetadataAccessTO metadata;
+    unsigned char maxConnections;
+    unsigned char numConnections;
+    unsigned char numStaticBytes;
+    unsigned char numMutableBytes;
+    bool tokenBlocked;
+};
+
+//64 bit offsets since the packed size of large worlds can exceed the int range
+struct PackedCellsAccessTO
+{
+    unsigned long long int* numBytes = nullptr;
+    unsigned long long int* offsets = nullptr;  //byte position of the record for each cell index
+    char* bytes = nullptr;
+};
+
+__host__ __device__ __inline__ constexpr int alignPackedCellSize(int size)
+{
+    return (size + 7) / 8 * 8;
+}
+
+__host__ __device__ __inline__ int calcPackedCellSize(CellAccessTO const& cellTO)
+{
+    return alignPackedCellSize(
+        sizeof(PackedCellHeaderTO) + sizeof(CellConnectionTO) * cellTO.numConnections + cellTO.numStaticBytes
+        + cellTO.numMutableBytes);
+}
+
+__host__ __device__ __inline__ void packCell(CellAccessTO const& cellTO, char* target)
+{
+    auto& header = *reinterpret_cast<PackedCellHeaderTO*>(target);
+    header.id = cellTO.id;
+    header.pos = cellTO.pos;
+    header.vel = cellTO.vel;
+    header.energy = cellTO.energy;
+    header.branchNumber = cellTO.branchNumber;
+    header.cellFunctionType = cellTO.cellFunctionType;
+    header.tokenUsages = cellTO.tokenUsages;
+    header.metadata = cellTO.metadata;
+    header.maxConnections = static_cast<unsigned char>(cellTO.maxConnections);
+    header.numConnections = static_cast<unsigned char>(cellTO.numConnections);
+    header.numStaticBytes = cellTO.numStaticBytes;
+    header.numMutableBytes = cellTO.numMutableBytes;
+    header.tokenBlocked = cellTO.tokenBlocked;
+
+    auto tail = target + sizeof(PackedCellHeaderTO);
+    memcpy(tail, cellTO.connections, sizeof(CellConnectionTO) * cellTO.numConnections);
+    tail += sizeof(CellConnectionTO) * cellTO.numConnections;
+    memcpy(tail, cellTO.staticData, cellTO.numStaticBytes);
+    tail += cellTO.numStaticBytes;
+    memcpy(tail, cellTO.mutableData, cellTO.numMutableBytes);
+}
+
+//the unused parts of connections, staticData and mutableData are not written
+__host__ __device__ __inline__ void unpackCell(char const* source, CellAccessTO& cellTO)
+{
+    auto const& header = *reinterpret_cast<PackedCellHeaderTO const*>(source);
+    cellTO.id = header.id;
+    cellTO.pos = header.pos;
+    cellTO.vel = header.vel;
+    cellTO.energy = header.energy;
+    cellTO.maxConnections = header.maxConnections;
+    cellTO.numConnections = header.numConnections;
+    cellTO.branchNumber = header.branchNumber;
+    cellTO.tokenBlocked = header.tokenBlocked;
+    cellTO.cellFunctionType = header.cellFunctionType;
+    cellTO.numStaticBytes = header.numStaticBytes;
+    cellTO.numMutableBytes = header.numMutableBytes;
+    cellTO.tokenUsages = header.tokenUsages;
+    cellTO.metadata = header.metadata;
+
+    auto tail = source + sizeof(PackedCellHeaderTO);
+    memcpy(cellTO.connections, tail, sizeof(CellConnectionTO) * header.numConnections);
+    tail += sizeof(CellConnectionTO) * header.numConnections;
+    memcpy(cellTO.staticData, tail, header.numStaticBytes);
+    tail += header.numStaticBytes;
+    memcpy(cellTO.mutableData, tail, header.numMutableBytes);
+}
+
+//returns the number of packed bytes, the records are stored in the order of the cells
+inline uint64_t calcPackedCellOffsets_host(CellAccessTO const* cells, int numCells, unsigned long long int* offsets)
+{
+    uint64_t result = 0;
+    for (int index = 0; index < numCells; ++index) {
+        offsets[index] = result;
+        result += calcPackedCellSize(cells[index]);
+    }
+    return result;
+}
+
+//prerequisite: offsets are calculated by calcPackedCellOffsets_host
+inline void packCells_host(CellAccessTO const* cells, int numCells, unsigned long long int const* offsets, char* bytes)
+{
+    for (int index = 0; index < numCells; ++index) {
+        packCell(cells[index], bytes + offsets[index]);
+    }
+}
+
+inline void
+unpackCells_host(char const* bytes, unsigned long long int const* offsets, int numCells, CellAccessTO* cells)
+{
+    for (int index = 0; index < numCells; ++index) {
+        unpackCell(bytes + offsets[index], cells[index]);
+    }
+}
@@ -26,7 +26,7 @@ public:
         float desiredAngleOnCell2,
         float desiredDistance,
         int angleAlignment = 0);
-    __inline__ __device__ static void delConnections(Cell* cell1, Cell* cell2);
+    __inline__ __device__ static void delConnections(SimulationData& data, Cell* cell1, Cell* cell2);
 
 private:
     __inline__ __device__ static void addConnectionsIntern(SimulationData& data, Cell* cell1, Cell* cell2, bool addTokens);
@@ -39,9 +39,9 @@ private:
         float desiredAngleOnCell1 = 0,
         int angleAlignment = 0);
 
-    __inline__ __device__ static void delConnectionsIntern(Cell* cell);
-    __inline__ __device__ static void delConnectionIntern(Cell* cell1, Cell* cell2);
-    __inline__ __device__ static void delConnectionOneWay(Cell* cell1, Cell* cell2);
+    __inline__ __device__ static void delConnectionsIntern(SimulationData& data, Cell* cell);
+    __inline__ __device__ static void delConnectionIntern(SimulationData& data, Cell* cell1, Cell* cell2);
+    __inline__ __device__ static void delConnectionOneWay(SimulationData& data, Cell* cell1, Cell* cell2);
 
     __inline__ __device__ static void delCell(SimulationData& data, Cell* cell, int cellIndex);
 };
@@ -125,13 +125,14 @@ __inline__ __device__ void CellConnectionProcessor::processConnectionsOperations
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto const& operation = data.operations[index];
         if (Operation::Type::DelConnection == operation.type) {
-            delConnectionIntern(operation.data.delConnectionOperation.cell1, operation.data.delConnectionOperation.cell2);
+            delConnectionIntern(
+                data, operation.data.delConnectionOperation.cell1, operation.data.delConnectionOperation.cell2);
         }
         if (Operation::Type::DelConnections == operation.type) {
-            delConnectionsIntern(operation.data.delConnectionsOperation.cell);
+            delConnectionsIntern(data, operation.data.delConnectionsOperation.cell);
         }
         if (Operation::Type::DelCellAndConnections == operation.type) {
-            delConnectionsIntern(operation.data.delConnectionsOperation.cell);
+            delConnectionsIntern(data, operation.data.delConnectionsOperation.cell);
             scheduleDelCell(
                 data,
                 operation.data.delCellAndConnectionOperation.cell,
@@ -175,10 +176,10 @@ __inline__ __device__ void CellConnectionProcessor::addConnections(
 }
 
 __inline__ __device__ void
-CellConnectionProcessor::delConnections(Cell* cell1, Cell* cell2)
+CellConnectionProcessor::delConnections(SimulationData& data, Cell* cell1, Cell* cell2)
 {
-    delConnectionOneWay(cell1, cell2);
-    delConnectionOneWay(cell2, cell1);
+    delConnectionOneWay(data, cell1, cell2);
+    delConnectionOneWay(data, cell2, cell1);
 }
 
 __inline__ __device__ void
@@ -215,11 +216,13 @@ CellConnectionProcessor::addConnectionsIntern(SimulationData& data, Cell* cell1,
                     auto token = factory.createToken(cell1, cell2);
                     token->energy = newTokenEnergy;
                     cell1->energy -= newTokenEnergy;
+                    data.markChanged(cell1);
                 }
                 if (cell2->energy > cellMinEnergy + newTokenEnergy) {
                     auto token = factory.createToken(cell2, cell1);
                     token->energy = newTokenEnergy;
                     cell2->energy -= newTokenEnergy;
+                    data.markChanged(cell2);
                 }
             }
         }
@@ -239,6 +242,7 @@ __inline__ __device__ void CellConnectionProcessor::addConnectionIntern(
     int angleAlignment)
 {
     auto newAngle = Math::angleOfVector(posDelta);
+    data.markChanged(cell1);
 
     if (0 == cell1->numConnections) {
         cell1->numConnections++;
@@ -326,15 +330,15 @@ __inline__ __device__ void CellConnectionProcessor::addConnectionIntern(
     cell1->connections[(++i) % cell1->numConnections].angleFromPrevious = angleDiff2 - newConnection.angleFromPrevious;
 }
 
-__inline__ __device__ void CellConnectionProcessor::delConnectionsIntern(Cell* cell)
+__inline__ __device__ void CellConnectionProcessor::delConnectionsIntern(SimulationData& data, Cell* cell)
 {
     if (cell->tryLock()) {
         for (int i = cell->numConnections - 1; i >= 0; --i) {
             auto connectedCell = cell->connections[i].cell;
             if (connectedCell->tryLock()) {
 
-                delConnectionOneWay(cell, connectedCell);
-                delConnectionOneWay(connectedCell, cell);
+                delConnectionOneWay(data, cell, connectedCell);
+                delConnectionOneWay(data, connectedCell, cell);
 
                 connectedCell->releaseLock();
             }
@@ -343,19 +347,21 @@ __inline__ __device__ void CellConnectionProcessor::delConnectionsIntern(Cell* c
     }
 }
 
-__inline__ __device__ void CellConnectionProcessor::delConnectionIntern(Cell* cell1, Cell* cell2)
+__inline__ __device__ void
+CellConnectionProcessor::delConnectionIntern(SimulationData& data, Cell* cell1, Cell* cell2)
 {
     if (cell1->tryLock()) {
         if (cell2->tryLock()) {
-            delConnectionOneWay(cell1, cell2);
-            delConnectionOneWay(cell2, cell1);
+            delConnectionOneWay(data, cell1, cell2);
+            delConnectionOneWay(data, cell2, cell1);
             cell2->releaseLock();
         }
         cell1->releaseLock();
     }
 }
 
-__inline__ __device__ void CellConnectionProcessor::delConnectionOneWay(Cell* cell1, Cell* cell2)
+__inline__ __device__ void
+CellConnectionProcessor::delConnectionOneWay(SimulationData& data, Cell* cell1, Cell* cell2)
 {
     for (int i = 0; i < cell1->numConnections; ++i) {
         if (cell1->connections[i].cell == cell2) {
@@ -371,6 +377,7 @@ __inline__ __device__ void CellConnectionProcessor::delConnectionOneWay(Cell* ce
             }
 
             --cell1->numConnections;
+            data.markChanged(cell1);
             return;
         }
     }
@@ -383,10 +390,12 @@ __inline__ __device__ void CellConnectionProcessor::delCell(SimulationData& data
         if (0 == cell->numConnections && cell->energy != 0 /* && _data->entities.cellPointers.at(cellIndex) == cell*/) {
             EntityFactory factory;
             factory.init(&data);
-            factory.createParticle(cell->energy, cell->absPos, cell->vel, {cell->metadata.color});
+            factory.createParticle(cell->energy, cell->absPos, cell->vel, {cell->cold->metadata.color});
             cell->energy = 0;
 
+            data.strings.removeReferences(cell->cold->metadata);
             data.entities.cellPointers.at(cellIndex) = nullptr;
+            data.logRemovedCell(cell->id);
         }
 
         cell->releaseLock();
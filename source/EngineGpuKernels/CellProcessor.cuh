@@ -16,7 +16,6 @@ class CellProcessor
 public:
     __inline__ __device__ void init(SimulationData& data);
     __inline__ __device__ void clearTag(SimulationData& data);
-    __inline__ __device__ void updateMap(SimulationData& data);
     __inline__ __device__ void collisions(SimulationData& data);    //prerequisite: clearTag
     __inline__ __device__ void applyAndCheckForces(SimulationData& data);    //prerequisite: tag from collisions
     __inline__ __device__ void calcForces(SimulationData& data);
@@ -45,6 +44,7 @@ __inline__ __device__ void CellProcessor::init(SimulationData& data)
         auto& cell = cells.at(index);
 
         cell->temp1 = {0, 0};
+        cell->numRandomDraws = 0;
     }
 }
 
@@ -60,29 +60,17 @@ __inline__ __device__ void CellProcessor::clearTag(SimulationData& data)
     }
 }
 
-__inline__ __device__ void CellProcessor::updateMap(SimulationData& data)
-{
-    auto const partition = calcPartition(data.entities.cellPointers.getNumEntries(), blockIdx.x, gridDim.x);
-    Cell** cellPointers = &data.entities.cellPointers.at(partition.startIndex);
-    data.cellMap.set_block(partition.numElements(), cellPointers);
-}
-
 __inline__ __device__ void CellProcessor::collisions(SimulationData& data)
 {
     _data = &data;
     auto& cells = data.entities.cellPointers;
     _partition = calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
 
-    Cell* otherCells[18];
-    int numOtherCells;
     for (int index = _partition.startIndex; index <= _partition.endIndex; ++index) {
         auto& cell = cells.at(index);
-        data.cellMap.get(otherCells, numOtherCells, cell->absPos);
-        for (int i = 0; i < numOtherCells; ++i) {
-            Cell* otherCell = otherCells[i];
-
-            if (!otherCell || otherCell == cell) {
-                continue;
+        data.cellMap.executeForEachInNeighborhood(cell->absPos, [&](Cell* otherCell) {
+            if (otherCell == cell) {
+                return;
             }
 
             auto posDelta = cell->absPos - otherCell->absPos;
@@ -91,7 +79,7 @@ __inline__ __device__ void CellProcessor::collisions(SimulationData& data)
             auto distance = Math::length(posDelta);
             if (distance >= cudaSimulationParameters.cellMaxCollisionDistance
                 /*|| distance <= cudaSimulationParameters.cellMinDistance*/) {
-                continue;
+                return;
             }
 
             if (distance < cudaSimulationParameters.cellMinDistance && cell->numConnections > 1) {
@@ -163,7 +151,7 @@ __inline__ __device__ void CellProcessor::collisions(SimulationData& data)
                 }
             }
 */
-        }
+        });
     }
 }
 
@@ -180,15 +168,19 @@ __inline__ __device__ void CellProcessor::applyAndCheckForces(SimulationData& da
         auto force = cell->temp1;
         if (Math::length(force)
             > SpotCalculator::calc(&SimulationParametersSpotValues::cellMaxForce, data, cell->absPos)) {
-            if(data.numberGen.random() < cudaSimulationParameters.cellMaxForceDecayProb) {
+            if(data.numberGen.random(cell) < cudaSimulationParameters.cellMaxForceDecayProb) {
                 CellConnectionProcessor::scheduleDelCellAndConnections(data, cell, index);
             }
         }
 
+        auto origVel = cell->vel;
         cell->vel = cell->vel + force;
         if (Math::length(cell->vel) > cudaSimulationParameters.cellMaxVel) {
             cell->vel = Math::normalized(cell->vel) * cudaSimulationParameters.cellMaxVel;
         }
+        if (cell->vel != origVel) {
+            data.markChanged(cell);
+        }
         cell->temp1 = {0, 0};
     }
 }
@@ -269,9 +261,13 @@ __inline__ __device__ void CellProcessor::calcPositionsAndCheckBindings(Simulati
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
 
+        auto origPos = cell->absPos;
         cell->absPos = cell->absPos + cell->vel * cudaSimulationParameters.timestepSize
             + cell->temp1 * cudaSimulationParameters.timestepSize * cudaSimulationParameters.timestepSize / 2;
         data.cellMap.mapPosCorrection(cell->absPos);
+        if (cell->absPos != origPos) {
+            data.markChanged(cell);
+        }
         cell->temp2 = cell->temp1;  //forces
         cell->temp1 = {0, 0};
 
@@ -303,7 +299,10 @@ __inline__ __device__ void CellProcessor::calcVelocities(SimulationData& data, i
         auto& cell = cells.at(index);
 
         auto acceleration = (cell->temp1 + cell->temp2) / 2;
-        cell->vel = cell->vel + acceleration * cudaSimulationParameters.timestepSize;
+        if (acceleration != float2{0, 0}) {
+            cell->vel = cell->vel + acceleration * cudaSimulationParameters.timestepSize;
+            data.markChanged(cell);
+        }
     }
 }
 
@@ -335,7 +334,11 @@ __inline__ __device__ void CellProcessor::applyAveragedVelocities(SimulationData
         auto& cell = cells.at(index);
 
         auto friction = SpotCalculator::calc(&SimulationParametersSpotValues::friction, data, cell->absPos);
+        auto origVel = cell->vel;
         cell->vel = cell->temp1 * (1.0f - friction);
+        if (cell->vel != origVel) {
+            data.markChanged(cell);
+        }
     }
 }
 
@@ -347,7 +350,7 @@ __inline__ __device__ void CellProcessor::radiation(SimulationData& data)
         calcPartition(cells.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
-        if (data.numberGen.random() < cudaSimulationParameters.radiationProb) {
+        if (data.numberGen.random(cell) < cudaSimulationParameters.radiationProb) {
             auto radiationFactor =
                 SpotCalculator::calc(&SimulationParametersSpotValues::radiationFactor, data, cell->absPos);
             if (radiationFactor > 0) {
@@ -355,8 +358,8 @@ __inline__ __device__ void CellProcessor::radiation(SimulationData& data)
                 auto& pos = cell->absPos;
                 float2 particleVel = (cell->vel * cudaSimulationParameters.radiationVelocityMultiplier)
                     + float2{
-                        (data.numberGen.random() - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation,
-                        (data.numberGen.random() - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation};
+                        (data.numberGen.random(cell) - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation,
+                        (data.numberGen.random(cell) - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation};
                 float2 particlePos = pos + Math::normalized(particleVel) * 1.5f;
                 data.cellMap.mapPosCorrection(particlePos);
 
@@ -364,16 +367,17 @@ __inline__ __device__ void CellProcessor::radiation(SimulationData& data)
                 particlePos = particlePos - particleVel;  //because particle will still be moved in current time step
                 float radiationEnergy = powf(cellEnergy, cudaSimulationParameters.radiationExponent) * radiationFactor;
                 radiationEnergy = radiationEnergy / cudaSimulationParameters.radiationProb;
-                radiationEnergy = 2 * radiationEnergy * data.numberGen.random();
+                radiationEnergy = 2 * radiationEnergy * data.numberGen.random(cell);
                 if (cellEnergy > 1) {
                     if (radiationEnergy > cellEnergy - 1) {
                         radiationEnergy = cellEnergy - 1;
                     }
                     cell->energy -= radiationEnergy;
+                    data.markChanged(cell);
 
                     EntityFactory factory;
                     factory.init(&data);
-                    factory.createParticle(radiationEnergy, particlePos, particleVel, {cell->metadata.color});
+                    factory.createParticle(radiationEnergy, particlePos, particleVel, {cell->cold->metadata.color});
                 }
             }
         }
@@ -391,8 +395,8 @@ __inline__ __device__ void CellProcessor::decay(SimulationData& data)
         auto& cell = cells.at(index);
 
         bool destroyDueToTokenUsage = false;
-        if (cell->tokenUsages > cudaSimulationParameters.cellMinTokenUsages) {
-            if (_data->numberGen.random() < cudaSimulationParameters.cellTokenUsageDecayProb) {
+        if (cell->cold->tokenUsages > cudaSimulationParameters.cellMinTokenUsages) {
+            if (_data->numberGen.random(cell) < cudaSimulationParameters.cellTokenUsageDecayProb) {
                 destroyDueToTokenUsage = true;
             }
         }
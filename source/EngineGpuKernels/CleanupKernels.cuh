@@ -68,7 +68,7 @@ cleanupParticles(Array<Particle*> particlePointers, Array<Particle> particles)
     }
 }
 
-__global__ void cleanupCellsStep1(Array<Cell*> cellPointers, Array<Cell> cells)
+__global__ void cleanupCellsStep1(Array<Cell*> cellPointers, Array<Cell> cells, Array<CellColdData> cellColdData)
 {
     //assumes that cellPointers are already cleaned up
     PartitionData pointerBlock =
@@ -77,12 +77,15 @@ __global__ void cleanupCellsStep1(Array<Cell*> cellPointers, Array<Cell> cells)
     int numCellsToCopy = pointerBlock.numElements();
     if (numCellsToCopy > 0) {
         auto newCells = cells.getNewSubarray(numCellsToCopy);
+        auto newCellColdData = cellColdData.getNewSubarray(numCellsToCopy);
 
         int newCellIndex = 0;
         for (int index = pointerBlock.startIndex; index <= pointerBlock.endIndex; ++index) {
             auto& cellPointer = cellPointers.at(index);
             auto& newCell = newCells[newCellIndex];
             newCell = *cellPointer;
+            newCellColdData[newCellIndex] = *cellPointer->cold;
+            newCell.cold = &newCellColdData[newCellIndex];
 
             cellPointer->tag = &newCell - cells.getArray();    //save index of new cell in old cell
             cellPointer = &newCell;
@@ -137,6 +140,21 @@ __global__ void cleanupTokens(Array<Token*> tokenPointers, Array<Token> newToken
     }
 }
 
+__global__ void countCellsForMap(SimulationData data)
+{
+    data.cellMap.countCells_system(data.entities.cellPointers);
+}
+
+__global__ void allocateCellMapBuckets(SimulationData data)
+{
+    data.cellMap.allocateBuckets_system();
+}
+
+__global__ void fillCellMap(SimulationData data)
+{
+    data.cellMap.fillBuckets_system(data.entities.cellPointers);
+}
+
 __global__ void cleanupCellMap(SimulationData data)
 {
     data.cellMap.cleanup_system();
@@ -147,59 +165,53 @@ __global__ void cleanupParticleMap(SimulationData data)
     data.particleMap.cleanup_system();
 }
 
-/*
-__global__ void cleanupMetadata(Array<Cluster*> clusterPointers, DynamicMemory strings)
+__global__ void collectStringGarbage(SimulationData data)
 {
-    auto const clusterBlock = calcPartition(clusterPointers.getNumEntries(), blockIdx.x, gridDim.x);
-    for (int clusterIndex = clusterBlock.startIndex; clusterIndex <= clusterBlock.endIndex; ++clusterIndex) {
-        auto& cluster = clusterPointers.at(clusterIndex);
-
-        if (0 == threadIdx.x) {
-            auto const len = cluster->metadata.nameLen;
-            auto newName = strings.getArray<char>(len);
-            for(int i = 0; i < len; ++i) {
-                newName[i] = cluster->metadata.name[i];
-            }
-            cluster->metadata.name = newName;
-        }
+    data.strings.collectGarbage_system();
+}
 
-        auto const cellBlock = calcPartition(cluster->numCellPointers, threadIdx.x, blockDim.x);
-        for (int cellIndex = cellBlock.startIndex; cellIndex <= cellBlock.endIndex; ++cellIndex) {
-            auto& cell = cluster->cellPointers[cellIndex];
-            {
-                auto const len = cell->metadata.nameLen;
-                auto newName = strings.getArray<char>(len);
-                for (int i = 0; i < len; ++i) {
-                    newName[i] = cell->metadata.name[i];
-                }
-                cell->metadata.name = newName;
-            }
-            {
-                auto const len = cell->metadata.descriptionLen;
-                auto newDescription = strings.getArray<char>(len);
-                for (int i = 0; i < len; ++i) {
-                    newDescription[i] = cell->metadata.description[i];
-                }
-                cell->metadata.description = newDescription;
-            }
-            {
-                auto const len = cell->metadata.sourceCodeLen;
-                auto newSourceCode = strings.getArray<char>(len);
-                for (int i = 0; i < len; ++i) {
-                    newSourceCode[i] = cell->metadata.sourceCode[i];
-                }
-                cell->metadata.sourceCode = newSourceCode;
-            }
-        }
+__global__ void clearStringIndex(SimulationData data)
+{
+    data.strings.clearIndex_system();
+}
+
+__global__ void rebuildStringIndex(SimulationData data)
+{
+    data.strings.rebuildIndex_system();
+}
+
+//frees the strings which are no longer referenced by a cell
+__global__ void cleanupStrings(SimulationData data)
+{
+    if (!data.strings.isGarbageCollectionNeeded()) {
+        return;
     }
+    data.strings.prepareForGarbageCollection();
+    KERNEL_CALL(collectStringGarbage, data);
+    data.strings.swapBytes();
+    KERNEL_CALL(clearStringIndex, data);
+    KERNEL_CALL(rebuildStringIndex, data);
 }
-*/
 
 /************************************************************************/
 /* Main                                                                 */
 /************************************************************************/
 
-__global__ void cleanupAfterSimulationKernel(SimulationData data)
+//prerequisite: the cell map has been cleaned up after its last use
+__global__ void cudaBuildCellMap(SimulationData data)
+{
+    KERNEL_CALL(countCellsForMap, data);
+    KERNEL_CALL(allocateCellMapBuckets, data);
+    KERNEL_CALL(fillCellMap, data);
+}
+
+//prerequisite: the index of the string table has been reallocated by StringTable::reserve
+__global__ void cudaRebuildStringIndex(SimulationData data)
+{
+    KERNEL_CALL(rebuildStringIndex, data);
+}
+
+__global__ void cleanupAfterSimulationKernel(SimulationData data, float fillLevelFactor)
 {
     KERNEL_CALL(cleanupCellMap, data);
     KERNEL_CALL(cleanupParticleMap, data);
@@ -217,32 +229,33 @@ __global__ void cleanupAfterSimulationKernel(SimulationData data)
     KERNEL_CALL(cleanupEntities<Token*>, data.entities.tokenPointers, data.entitiesForCleanup.tokenPointers);
     data.entities.tokenPointers.swapContent(data.entitiesForCleanup.tokenPointers);
 
-    if (data.entities.particles.getNumEntries() > data.entities.particles.getSize() * Const::ArrayFillLevelFactor) {
+    if (data.entities.particles.getNumEntries() > data.entities.particles.getSize() * fillLevelFactor) {
         data.entitiesForCleanup.particles.reset();
         KERNEL_CALL(cleanupParticles, data.entities.particlePointers, data.entitiesForCleanup.particles);
         data.entities.particles.swapContent(data.entitiesForCleanup.particles);
     }
 
-    if (data.entities.cells.getNumEntries() > data.entities.cells.getSize() * Const::ArrayFillLevelFactor) {
+    if (data.entities.cells.getNumEntries() > data.entities.cells.getSize() * fillLevelFactor
+        || data.entities.cellColdData.getNumEntries() > data.entities.cellColdData.getSize() * fillLevelFactor) {
         data.entitiesForCleanup.cells.reset();
-        KERNEL_CALL(cleanupCellsStep1, data.entities.cellPointers, data.entitiesForCleanup.cells);
+        data.entitiesForCleanup.cellColdData.reset();
+        KERNEL_CALL(
+            cleanupCellsStep1,
+            data.entities.cellPointers,
+            data.entitiesForCleanup.cells,
+            data.entitiesForCleanup.cellColdData);
         KERNEL_CALL(cleanupCellsStep2, data.entities.tokenPointers, data.entitiesForCleanup.cells);
         data.entities.cells.swapContent(data.entitiesForCleanup.cells);
+        data.entities.cellColdData.swapContent(data.entitiesForCleanup.cellColdData);
     }
         
-    if (data.entities.tokens.getNumEntries() > data.entities.tokens.getSize() * Const::ArrayFillLevelFactor) {
+    if (data.entities.tokens.getNumEntries() > data.entities.tokens.getSize() * fillLevelFactor) {
         data.entitiesForCleanup.tokens.reset();
         KERNEL_CALL(cleanupTokens, data.entities.tokenPointers, data.entitiesForCleanup.tokens);
         data.entities.tokens.swapContent(data.entitiesForCleanup.tokens);
     }
 
-    /*
-        if (data.entities.strings.getNumBytes() > cudaConstants.METADATA_DYNAMIC_MEMORY_SIZE * Const::FillLevelFactor) {
-            data.entitiesForCleanup.strings.reset();
-            KERNEL_CALL(cleanupMetadata, data.entities.clusterPointers, data.entitiesForCleanup.strings);
-            data.entities.strings.swapContent(data.entitiesForCleanup.strings);
-        }
-*/
+    KERNEL_CALL_1_1(cleanupStrings, data);
 }
 
 __global__ void cleanupAfterDataManipulationKernel(SimulationData data)
@@ -265,19 +278,21 @@ __global__ void cleanupAfterDataManipulationKernel(SimulationData data)
     data.entities.particles.swapContent(data.entitiesForCleanup.particles);
 
     data.entitiesForCleanup.cells.reset();
-    KERNEL_CALL(cleanupCellsStep1, data.entities.cellPointers, data.entitiesForCleanup.cells);
+    data.entitiesForCleanup.cellColdData.reset();
+    KERNEL_CALL(
+        cleanupCellsStep1,
+        data.entities.cellPointers,
+        data.entitiesForCleanup.cells,
+        data.entitiesForCleanup.cellColdData);
     KERNEL_CALL(cleanupCellsStep2, data.entities.tokenPointers, data.entitiesForCleanup.cells);
     data.entities.cells.swapContent(data.entitiesForCleanup.cells);
+    data.entities.cellColdData.swapContent(data.entitiesForCleanup.cellColdData);
 
     data.entitiesForCleanup.tokens.reset();
     KERNEL_CALL(cleanupTokens, data.entities.tokenPointers, data.entitiesForCleanup.tokens);
     data.entities.tokens.swapContent(data.entitiesForCleanup.tokens);
 
-    data.entitiesForCleanup.strings.reset();
-/*
-    KERNEL_CALL(cleanupMetadata, data.entities.clusterPointers, data.entitiesForCleanup.strings);
-    data.entities.strings.swapContent(data.entitiesForCleanup.strings);
-*/
+    KERNEL_CALL_1_1(cleanupStrings, data);
 }
 
 __global__ void cudaCopyEntities(SimulationData data)
@@ -295,7 +310,12 @@ __global__ void cudaCopyEntities(SimulationData data)
     KERNEL_CALL(cleanupParticles, data.entitiesForCleanup.particlePointers, data.entitiesForCleanup.particles);
 
     data.entitiesForCleanup.cells.reset();
-    KERNEL_CALL(cleanupCellsStep1, data.entitiesForCleanup.cellPointers, data.entitiesForCleanup.cells);
+    data.entitiesForCleanup.cellColdData.reset();
+    KERNEL_CALL(
+        cleanupCellsStep1,
+        data.entitiesForCleanup.cellPointers,
+        data.entitiesForCleanup.cells,
+        data.entitiesForCleanup.cellColdData);
     KERNEL_CALL(cleanupCellsStep2, data.entitiesForCleanup.tokenPointers, data.entitiesForCleanup.cells);
 
     data.entitiesForCleanup.tokens.reset();
@@ -119,52 +119,52 @@ __inline__ __device__ Enums::CommunicatorIn::Type CommunicatorFunction::getComma
 
 __inline__ __device__ void CommunicatorFunction::setListeningChannel(Cell* cell, unsigned char channel) const
 {
-    cell->staticData[StaticDataInternal::Channel] = channel;
+    cell->cold->staticData[StaticDataInternal::Channel] = channel;
 }
 
 __inline__ __device__ unsigned char CommunicatorFunction::getListeningChannel(Cell * cell) const
 {
-    return cell->staticData[StaticDataInternal::Channel];
+    return cell->cold->staticData[StaticDataInternal::Channel];
 }
 
 __inline__ __device__ void CommunicatorFunction::setAngle(Cell * cell, unsigned char angle) const
 {
-    cell->staticData[StaticDataInternal::OriginAngle] = angle;
+    cell->cold->staticData[StaticDataInternal::OriginAngle] = angle;
 }
 
 __inline__ __device__ unsigned char CommunicatorFunction::getAngle(Cell * cell) const
 {
-    return cell->staticData[StaticDataInternal::OriginAngle];
+    return cell->cold->staticData[StaticDataInternal::OriginAngle];
 }
 
 __inline__ __device__ void CommunicatorFunction::setDistance(Cell * cell, unsigned char distance) const
 {
-    cell->staticData[StaticDataInternal::OriginDistance] = distance;
+    cell->cold->staticData[StaticDataInternal::OriginDistance] = distance;
 }
 
 __inline__ __device__ unsigned char CommunicatorFunction::getDistance(Cell * cell) const
 {
-    return cell->staticData[StaticDataInternal::OriginDistance];
+    return cell->cold->staticData[StaticDataInternal::OriginDistance];
 }
 
 __inline__ __device__ void CommunicatorFunction::setMessage(Cell * cell, unsigned char message) const
 {
-    cell->staticData[StaticDataInternal::MessageCode] = message;
+    cell->cold->staticData[StaticDataInternal::MessageCode] = message;
 }
 
 __inline__ __device__ unsigned char CommunicatorFunction::getMessage(Cell * cell) const
 {
-    return cell->staticData[StaticDataInternal::MessageCode];
+    return cell->cold->staticData[StaticDataInternal::MessageCode];
 }
 
 __inline__ __device__ void CommunicatorFunction::setNewMessageReceived(Cell * cell, bool value) const
 {
-    cell->staticData[StaticDataInternal::NewMessageReceived] = value;
+    cell->cold->staticData[StaticDataInternal::NewMessageReceived] = value;
 }
 
 __inline__ __device__ bool CommunicatorFunction::getNewMessageReceived(Cell * cell) const
 {
-    return cell->staticData[StaticDataInternal::NewMessageReceived];
+    return cell->cold->staticData[StaticDataInternal::NewMessageReceived];
 }
 
 __inline__ __device__ void CommunicatorFunction::sendMessage_block(Token * token) const
@@ -306,7 +306,7 @@ __inline__ __device__ void ConstructorFunction::continueConstruction(
             break;
         }
     }
-    CellConnectionProcessor::delConnections(cell, firstConstructedCell);
+    CellConnectionProcessor::delConnections(data, cell, firstConstructedCell);
     if (!constructionData.isFinishConstruction || !constructionData.isSeparateConstruction) {
         CellConnectionProcessor::addConnections(
             data,
@@ -410,20 +410,20 @@ __inline__ __device__ void ConstructorFunction::constructCell(
         % cudaSimulationParameters.cellMaxTokenBranchNumber;
     result->tokenBlocked = true;
     result->cellFunctionType = constructionData.cellFunctionType;
-    result->numStaticBytes = static_cast<unsigned char>(token->memory[Enums::Constr::IN_CELL_FUNCTION_DATA])
+    result->cold->numStaticBytes = static_cast<unsigned char>(token->memory[Enums::Constr::IN_CELL_FUNCTION_DATA])
         % (MAX_CELL_STATIC_BYTES + 1);
-    auto offset = result->numStaticBytes + 1;
-    result->numMutableBytes =
+    auto offset = result->cold->numStaticBytes + 1;
+    result->cold->numMutableBytes =
         static_cast<unsigned char>(
             token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset) % MAX_TOKEN_MEM_SIZE])
         % (MAX_CELL_MUTABLE_BYTES + 1);
-    result->metadata.color = constructionData.metaData;
+    result->cold->metadata.color = constructionData.metaData;
 
-    for (int i = 0; i < result->numStaticBytes; ++i) {
-        result->staticData[i] = token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + i + 1) % MAX_TOKEN_MEM_SIZE];
+    for (int i = 0; i < result->cold->numStaticBytes; ++i) {
+        result->cold->staticData[i] = token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + i + 1) % MAX_TOKEN_MEM_SIZE];
     }
-    for (int i = 0; i <= result->numMutableBytes; ++i) {
-        result->mutableData[i] =
+    for (int i = 0; i <= result->cold->numMutableBytes; ++i) {
+        result->cold->mutableData[i] =
             token->memory[(Enums::Constr::IN_CELL_FUNCTION_DATA + offset + i + 1) % MAX_TOKEN_MEM_SIZE];
     }
 }
@@ -582,22 +582,22 @@ __inline__ __device__ void ConstructorFunction::mutateConstructionData(
 __inline__ __device__ void ConstructorFunction::mutateCellFunctionData(SimulationData& data, Cell* cell)
 {
     if (data.numberGen.random() < cudaSimulationParameters.cellFunctionConstructorCellDataMutationProb) {
-        cell->numStaticBytes = data.numberGen.random(MAX_CELL_STATIC_BYTES);
+        cell->cold->numStaticBytes = data.numberGen.random(MAX_CELL_STATIC_BYTES);
     }
 
     for (int i = 0; i <= MAX_CELL_STATIC_BYTES; ++i) {
         if (data.numberGen.random() < cudaSimulationParameters.cellFunctionConstructorCellDataMutationProb) {
-            cell->staticData[i] = data.numberGen.random(255);
+            cell->cold->staticData[i] = data.numberGen.random(255);
         }
     }
 
     if (data.numberGen.random() < cudaSimulationParameters.cellFunctionConstructorCellDataMutationProb) {
-        cell->numMutableBytes = data.numberGen.random(MAX_CELL_MUTABLE_BYTES);
+        cell->cold->numMutableBytes = data.numberGen.random(MAX_CELL_MUTABLE_BYTES);
     }
 
     for (int i = 0; i <= MAX_CELL_MUTABLE_BYTES; ++i) {
         if (data.numberGen.random() < cudaSimulationParameters.cellFunctionConstructorCellDataMutationProb) {
-            cell->mutableData[i] = data.numberGen.random(255);
+            cell->cold->mutableData[i] = data.numberGen.random(255);
         }
     }
 }
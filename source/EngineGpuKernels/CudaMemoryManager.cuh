@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <optional>
+#include <string>
+#include <vector>
 
+#include <cuda.h>
 #include <cuda/helper_cuda.h>
 
 #include "Base.cuh"
@@ -38,6 +43,9 @@ public:
         if (!memory) {
             return;
         }
+        if (freeVirtualMemory(reinterpret_cast<void*>(memory))) {
+            return;
+        }
         auto findResult = _pointerToSizeMap.find(reinterpret_cast<void*>(memory));
         if (findResult != _pointerToSizeMap.end()) {
             CHECK_FOR_CUDA_ERROR(cudaFree(memory));
@@ -51,10 +59,133 @@ public:
         return _bytes;
     }
 
+    bool isVirtualMemorySupported()
+    {
+        if (!_virtualMemorySupported) {
+            int device;
+            CHECK_FOR_CUDA_ERROR(cudaGetDevice(&device));
+            int supported = 0;
+            checkDriverResult(
+                cuDeviceGetAttribute(&supported, CU_DEVICE_ATTRIBUTE_VIRTUAL_MEMORY_MANAGEMENT_SUPPORTED, device));
+            _virtualMemorySupported = supported != 0;
+        }
+        return *_virtualMemorySupported;
+    }
+
+    //reserves an address range for maxArraySize elements and backs the first arraySize elements by device memory
+    //=> the memory can grow later without moving its content
+    template <typename T>
+    void reserveMemory(uint64_t maxArraySize, uint64_t arraySize, T*& result)
+    {
+        VirtualMemoryRange range;
+        range.reservedBytes = roundUp(sizeof(T) * maxArraySize, getGranularity());
+        checkDriverResult(cuMemAddressReserve(&range.address, range.reservedBytes, 0, 0, 0));
+        result = reinterpret_cast<T*>(range.address);
+        _virtualMemoryRanges.emplace(reinterpret_cast<void*>(result), range);
+        growMemory(result, arraySize);
+    }
+
+    //memory must have been reserved by reserveMemory
+    template <typename T>
+    void growMemory(T* memory, uint64_t arraySize)
+    {
+        auto& range = _virtualMemoryRanges.at(reinterpret_cast<void*>(memory));
+        auto numBytes = std::min(roundUp(sizeof(T) * arraySize, getGranularity()), range.reservedBytes);
+        if (numBytes <= range.committedBytes) {
+            return;
+        }
+        auto chunkAddress = range.address + range.committedBytes;
+        auto chunkSize = numBytes - range.committedBytes;
+
+        CUmemGenericAllocationHandle handle;
+        checkDriverResult(cuMemCreate(&handle, chunkSize, &getAllocationProp(), 0));
+        checkDriverResult(cuMemMap(chunkAddress, chunkSize, 0, handle, 0));
+        CUmemAccessDesc accessDesc = {};
+        accessDesc.location = getAllocationProp().location;
+        accessDesc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+        checkDriverResult(cuMemSetAccess(chunkAddress, chunkSize, &accessDesc, 1));
+
+        range.chunks.emplace_back(handle, chunkSize);
+        range.committedBytes = numBytes;
+        _bytes += chunkSize;
+    }
+
 private:
+    struct VirtualMemoryRange
+    {
+        CUdeviceptr address = 0;
+        uint64_t reservedBytes = 0;
+        uint64_t committedBytes = 0;
+        std::vector<std::pair<CUmemGenericAllocationHandle, uint64_t>> chunks;
+    };
+
     CudaMemoryManager() {}
     ~CudaMemoryManager() {}
 
+    bool freeVirtualMemory(void* memory)
+    {
+        auto findResult = _virtualMemoryRanges.find(memory);
+        if (findResult == _virtualMemoryRanges.end()) {
+            return false;
+        }
+        auto& range = findResult->second;
+        auto chunkAddress = range.address;
+        for (auto const& [handle, chunkSize] : range.chunks) {
+            checkDriverResult(cuMemUnmap(chunkAddress, chunkSize));
+            checkDriverResult(cuMemRelease(handle));
+            chunkAddress += chunkSize;
+            _bytes -= chunkSize;
+        }
+        checkDriverResult(cuMemAddressFree(range.address, range.reservedBytes));
+        _virtualMemoryRanges.erase(findResult);
+        return true;
+    }
+
+    CUmemAllocationProp const& getAllocationProp()
+    {
+        if (!_allocationProp) {
+            int device;
+            CHECK_FOR_CUDA_ERROR(cudaGetDevice(&device));
+            CUmemAllocationProp prop = {};
+            prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+            prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+            prop.location.id = device;
+            _allocationProp = prop;
+        }
+        return *_allocationProp;
+    }
+
+    uint64_t getGranularity()
+    {
+        if (0 == _granularity) {
+            size_t granularity;
+            checkDriverResult(cuMemGetAllocationGranularity(
+                &granularity, &getAllocationProp(), CU_MEM_ALLOC_GRANULARITY_RECOMMENDED));
+            _granularity = granularity;
+        }
+        return _granularity;
+    }
+
+    static uint64_t roundUp(uint64_t value, uint64_t granularity)
+    {
+        return (value + granularity - 1) / granularity * granularity;
+    }
+
+    static void checkDriverResult(CUresult result)
+    {
+        if (CUDA_SUCCESS != result) {
+            char const* errorName = nullptr;
+            cuGetErrorName(result, &errorName);
+            auto errorString = errorName ? std::string(errorName) : std::to_string(static_cast<int>(result));
+            throw BugReportException("CUDA driver error: " + errorString);
+        }
+    }
+
     uint64_t _bytes = 0;
     std::map<void*, uint64_t> _pointerToSizeMap;
+
+    std::optional<bool> _virtualMemorySupported;
+    std::optional<CUmemAllocationProp> _allocationProp;
+    uint64_t _granularity = 0;
+    std::map<void*, VirtualMemoryRange> _virtualMemoryRanges;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "CudaSimulation.cuh"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <iostream>
 #include <list>
@@ -9,6 +11,8 @@
 
 #include <device_launch_parameters.h>
 #include <cuda/helper_cuda.h>
+#include <thrust/execution_policy.h>
+#include <thrust/sort.h>
 
 #include "Base/Exceptions.h"
 #include "EngineInterface/SimulationParameters.h"
@@ -19,6 +23,7 @@
 #include "AccessKernels.cuh"
 #include "AccessTOs.cuh"
 #include "Base.cuh"
+#include "CellAccessTOPacking.cuh"
 #include "CleanupKernels.cuh"
 #include "ConstantMemory.cuh"
 #include "CudaMemoryManager.cuh"
@@ -28,6 +33,7 @@
 #include "MonitorKernels.cuh"
 #include "ActionKernels.cuh"
 #include "RenderingKernels.cuh"
+#include "ReorderKernels.cuh"
 #include "SimulationData.cuh"
 #include "SimulationKernels.cuh"
 #include "SimulationResult.cuh"
@@ -36,6 +42,34 @@
 
 namespace
 {
+    size_t const MaxRemovedIdHistory = 1 << 22;
+
+    //same names as in the CPU engine such that the profiling results of both engines can be compared
+    char const* const SimulationStageNames[NumSimulationStages] = {
+        "applyFlowFieldSettings",
+        "buildCellMap",
+        "processingStep1",
+        "processingStep2",
+        "processingStep3",
+        "processingStep4",
+        "processingStep5",
+        "processingStep6",
+        "processingStep7",
+        "processingStep8",
+        "processingStep9",
+        "processingStep10",
+        "processingStep11",
+        "processingStep12",
+        "cleanupAfterSimulation"};
+
+    //versions are unique among all simulations such that a version of a previous simulation yields complete data
+    std::atomic<uint64_t> LastDataVersion{0};
+
+    uint64_t createDataVersion()
+    {
+        return ++LastDataVersion;
+    }
+
     class CudaInitializer
     {
     public:
@@ -109,13 +143,20 @@ void _CudaSimulation::initCuda()
     CudaInitializer::init();
 }
 
-_CudaSimulation::_CudaSimulation(uint64_t timestep, Settings const& settings, GpuSettings const& gpuSettings)
+_CudaSimulation::_CudaSimulation(
+    uint64_t timestep,
+    Settings const& settings,
+    GpuSettings const& gpuSettings,
+    EngineSettings const& engineSettings)
+    : _dataVersion(createDataVersion())
+    , _oldestDeltaVersion(_dataVersion)
 {
     CHECK_FOR_CUDA_ERROR(cudaGetLastError());
 
     setSimulationParameters(settings.simulationParameters);
     setSimulationParametersSpots(settings.simulationParametersSpots);
     setGpuConstants(gpuSettings);
+    setEngineSettings(engineSettings);
     setFlowFieldSettings(settings.flowFieldSettings);
 
     auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
@@ -127,10 +168,13 @@ _CudaSimulation::_CudaSimulation(uint64_t timestep, Settings const& settings, Gp
     _cudaSimulationResult = new SimulationResult();
     _cudaSelectionResult = new SelectionResult();
     _cudaAccessTO = new DataAccessTO();
+    _cudaPackedCellsTO = new PackedCellsAccessTO();
+    _cudaOverlayTO = new OverlayAccessTO();
     _cudaMonitorData = new CudaMonitorData();
 
     int2 worldSize{settings.generalSettings.worldSizeX, settings.generalSettings.worldSizeY};
     _cudaSimulationData->init(worldSize);
+    _cudaSimulationData->dataVersion = _dataVersion;
     _cudaRenderingData->init();
     _cudaMonitorData->init();
     _cudaSimulationResult->init();
@@ -139,8 +183,15 @@ _CudaSimulation::_CudaSimulation(uint64_t timestep, Settings const& settings, Gp
     CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numCells);
     CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numParticles);
     CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numTokens);
+    CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numStrings);
     CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaAccessTO->numStringBytes);
-    CudaMemoryManager::getInstance().acquireMemory<char>(Const::MetadataMemorySize, _cudaAccessTO->stringBytes);
+    _stringBytesSize = _cudaSimulationData->strings.getMaxBytes();
+    CudaMemoryManager::getInstance().acquireMemory<char>(_stringBytesSize, _cudaAccessTO->stringBytes);
+    CudaMemoryManager::getInstance().acquireMemory<unsigned long long int>(1, _cudaPackedCellsTO->numBytes);
+    CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaOverlayTO->numElements);
+    CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaRolloutChange);
+    CudaMemoryManager::getInstance().acquireMemory<int>(1, _cudaNumChangedCells);
+    CudaMemoryManager::getInstance().acquireMemory<Operation*>(1, _cudaOperations);
 
     //default array sizes for empty simulation (will be resized later if not sufficient)
     resizeArrays({100000, 100000, 10000});
@@ -157,16 +208,31 @@ _CudaSimulation::~_CudaSimulation()
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->cells);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->particles);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->tokens);
+    CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->strings);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->stringBytes);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numCells);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numParticles);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numTokens);
+    CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numStrings);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->numStringBytes);
+    CudaMemoryManager::getInstance().freeMemory(_cudaCellCurveIndices);
+    CudaMemoryManager::getInstance().freeMemory(_cudaParticleCurveIndices);
+    CudaMemoryManager::getInstance().freeMemory(_cudaExportOwnerTiles);
+    CudaMemoryManager::getInstance().freeMemory(_cudaPackedCellsTO->offsets);
+    CudaMemoryManager::getInstance().freeMemory(_cudaPackedCellsTO->bytes);
+    CudaMemoryManager::getInstance().freeMemory(_cudaPackedCellsTO->numBytes);
+    CudaMemoryManager::getInstance().freeMemory(_cudaOverlayTO->elements);
+    CudaMemoryManager::getInstance().freeMemory(_cudaOverlayTO->numElements);
+    CudaMemoryManager::getInstance().freeMemory(_cudaRolloutChange);
+    CudaMemoryManager::getInstance().freeMemory(_cudaNumChangedCells);
+    CudaMemoryManager::getInstance().freeMemory(_cudaOperations);
 
     auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
     loggingService->logMessage(Priority::Important, "close simulation");
 
     delete _cudaAccessTO;
+    delete _cudaPackedCellsTO;
+    delete _cudaOverlayTO;
     delete _cudaSimulationData;
     delete _cudaRenderingData;
     delete _cudaMonitorData;
@@ -182,11 +248,28 @@ void* _CudaSimulation::registerImageResource(GLuint image)
     return reinterpret_cast<void*>(cudaResource);
 }
 
-void _CudaSimulation::calcCudaTimestep()
+void _CudaSimulation::calcTimestep()
 {
-    KERNEL_CALL_HOST(calcSimulationTimestepKernel, *_cudaSimulationData, *_cudaSimulationResult);
-    automaticResizeArrays();
+    _stageProfiler.beginTimestep();
+    _cudaSimulationData->numberGen.prepareForTimestep_host(
+        static_cast<unsigned int>(_engineSettings.RANDOM_SEED), _currentTimestep.load());
+    if (_engineSettings.STAGE_PROFILING) {
+        calcTimestepByStages();
+    } else {
+        //the processing steps are launched by a single kernel and can therefore only be measured as a whole
+        _stageProfiler.measure("calcSimulationTimestep", [&] {
+            KERNEL_CALL_HOST(
+                calcSimulationTimestepKernel,
+                *_cudaSimulationData,
+                *_cudaSimulationResult,
+                _engineSettings.ARRAY_FILL_LEVEL_FACTOR);
+        });
+    }
+    _stageProfiler.measure("reorderEntities", [&] { automaticReorderEntities(); });
+    _stageProfiler.measure("automaticResizeArrays", [&] { automaticResizeArrays(); });
+    _stageProfiler.endTimestep();
     ++_currentTimestep;
+    invalidateTileIndices();
 }
 
 void _CudaSimulation::drawVectorGraphics(
@@ -232,65 +315,159 @@ void _CudaSimulation::getSimulationData(
     int2 const& rectLowerRight,
     DataAccessTO const& dataTO)
 {
+    updateTileIndicesIfNecessary();
     KERNEL_CALL_HOST(
         cudaGetSimulationAccessDataKernel, rectUpperLeft, rectLowerRight, *_cudaSimulationData, *_cudaAccessTO);
+    copyDataTOtoHost(dataTO);
+}
 
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(dataTO.numCells, _cudaAccessTO->numCells, sizeof(int), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(
-        cudaMemcpy(dataTO.numParticles, _cudaAccessTO->numParticles, sizeof(int), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(
-        cudaMemcpy(dataTO.numTokens, _cudaAccessTO->numTokens, sizeof(int), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(
-        cudaMemcpy(dataTO.numStringBytes, _cudaAccessTO->numStringBytes, sizeof(int), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.cells, _cudaAccessTO->cells, sizeof(CellAccessTO) * (*dataTO.numCells), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.particles,
-        _cudaAccessTO->particles,
-        sizeof(ParticleAccessTO) * (*dataTO.numParticles),
-        cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.tokens, _cudaAccessTO->tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyDeviceToHost));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.stringBytes,
-        _cudaAccessTO->stringBytes,
-        sizeof(char) * (*dataTO.numStringBytes),
-        cudaMemcpyDeviceToHost));
+void _CudaSimulation::getClusterData(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    DataAccessTO const& dataTO)
+{
+    updateTileIndicesIfNecessary();
+    KERNEL_CALL_HOST(
+        cudaGetClusterAccessDataKernel,
+        rectUpperLeft,
+        rectLowerRight,
+        *_cudaSimulationData,
+        *_cudaAccessTO,
+        _cudaRolloutChange);
+    copyDataTOtoHost(dataTO);
 }
 
-void _CudaSimulation::getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO)
+auto _CudaSimulation::getExportTileSizes(int tileSize) -> std::vector<ArraySizes>
 {
+    auto numCells = _cudaSimulationData->entities.cellPointers.getNumEntries_host();
+    if (numCells > _exportOwnerTilesSize) {
+        CudaMemoryManager::getInstance().freeMemory(_cudaExportOwnerTiles);
+        _exportOwnerTilesSize = numCells;
+        CudaMemoryManager::getInstance().acquireMemory<int>(_exportOwnerTilesSize, _cudaExportOwnerTiles);
+    }
+
+    auto exportTiles = createExportTiles(tileSize);
+    auto numTiles = exportTiles.numTiles.x * exportTiles.numTiles.y;
+
+    int* tileCounters;
+    CudaMemoryManager::getInstance().acquireMemory<int>(numTiles * 5, tileCounters);
+    CHECK_FOR_CUDA_ERROR(cudaMemset(tileCounters, 0, sizeof(int) * numTiles * 5));
     KERNEL_CALL_HOST(
-        cudaGetSimulationOverlayDataKernel, rectUpperLeft, rectLowerRight, *_cudaSimulationData, *_cudaAccessTO);
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(dataTO.numCells, _cudaAccessTO->numCells, sizeof(int), cudaMemcpyDeviceToHost));
+        cudaGetExportTileCountersKernel, exportTiles, *_cudaSimulationData, tileCounters, _cudaRolloutChange);
+    std::vector<int> hostTileCounters(numTiles * 5);
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        dataTO.cells, _cudaAccessTO->cells, sizeof(CellAccessTO) * (*dataTO.numCells), cudaMemcpyDeviceToHost));
+        hostTileCounters.data(), tileCounters, sizeof(int) * numTiles * 5, cudaMemcpyDeviceToHost));
+    CudaMemoryManager::getInstance().freeMemory(tileCounters);
+
+    std::vector<ArraySizes> result(numTiles);
+    for (int tile = 0; tile < numTiles; ++tile) {
+        auto counters = &hostTileCounters[tile * 5];
+        result[tile] = {counters[0], counters[1], counters[2], counters[3], counters[4]};
+    }
+    return result;
 }
 
-void _CudaSimulation::setSimulationData(DataAccessTO const& dataTO)
+void _CudaSimulation::getExportTileData(int tileSize, int tile, DataAccessTO const& dataTO)
 {
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(_cudaAccessTO->numCells, dataTO.numCells, sizeof(int), cudaMemcpyHostToDevice));
-    CHECK_FOR_CUDA_ERROR(
-        cudaMemcpy(_cudaAccessTO->numParticles, dataTO.numParticles, sizeof(int), cudaMemcpyHostToDevice));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(_cudaAccessTO->numTokens, dataTO.numTokens, sizeof(int), cudaMemcpyHostToDevice));
+    updateTileIndicesIfNecessary();
+    KERNEL_CALL_HOST(
+        cudaGetExportTileAccessDataKernel,
+        createExportTiles(tileSize),
+        tile,
+        *_cudaSimulationData,
+        *_cudaAccessTO);
+    copyDataTOtoHost(dataTO);
+}
+
+void _CudaSimulation::getOverlayData(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    OverlayAccessTO const& overlayTO)
+{
+    updateTileIndicesIfNecessary();
+    KERNEL_CALL_HOST(
+        cudaGetSimulationOverlayDataKernel, rectUpperLeft, rectLowerRight, *_cudaSimulationData, *_cudaOverlayTO);
     CHECK_FOR_CUDA_ERROR(
-        cudaMemcpy(_cudaAccessTO->numStringBytes, dataTO.numStringBytes, sizeof(int), cudaMemcpyHostToDevice));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        _cudaAccessTO->cells, dataTO.cells, sizeof(CellAccessTO) * (*dataTO.numCells), cudaMemcpyHostToDevice));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        _cudaAccessTO->particles,
-        dataTO.particles,
-        sizeof(ParticleAccessTO) * (*dataTO.numParticles),
-        cudaMemcpyHostToDevice));
-    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        _cudaAccessTO->tokens, dataTO.tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyHostToDevice));
+        cudaMemcpy(overlayTO.numElements, _cudaOverlayTO->numElements, sizeof(int), cudaMemcpyDeviceToHost));
+    auto numElements = std::min(*overlayTO.numElements, overlayTO.maxElements);
     CHECK_FOR_CUDA_ERROR(cudaMemcpy(
-        _cudaAccessTO->stringBytes,
-        dataTO.stringBytes,
-        sizeof(char) * (*dataTO.numStringBytes),
-        cudaMemcpyHostToDevice));
+        overlayTO.elements,
+        _cudaOverlayTO->elements,
+        sizeof(OverlayElementAccessTO) * numElements,
+        cudaMemcpyDeviceToHost));
+}
 
+auto _CudaSimulation::getSimulationDataDelta(
+    int2 const& rectUpperLeft,
+    int2 const& rectLowerRight,
+    uint64_t sinceVersion,
+    DataAccessTO const& dataTO) -> DataDelta
+{
+    auto& data = *_cudaSimulationData;
+    //entities changed from now on are stamped with the version of the next delta
+    auto const version = _dataVersion;
+    takeOverRemovedIds(version);
+    _dataVersion = createDataVersion();
+    data.dataVersion = _dataVersion;
+
+    DataDelta result;
+    result.version = version;
+    result.complete = 0 == sinceVersion || sinceVersion < _oldestDeltaVersion;
+    if (result.complete) {
+        sinceVersion = 0;
+    } else {
+        for (auto it = _removedCellIds.rbegin(); it != _removedCellIds.rend() && it->first > sinceVersion; ++it) {
+            result.removedCellIds.emplace_back(it->second);
+        }
+        for (auto it = _removedParticleIds.rbegin(); it != _removedParticleIds.rend() && it->first > sinceVersion;
+             ++it) {
+            result.removedParticleIds.emplace_back(it->second);
+        }
+    }
+
+    KERNEL_CALL_HOST(
+        cudaGetSimulationDeltaAccessDataKernel,
+        rectUpperLeft,
+        rectLowerRight,
+        sinceVersion,
+        data,
+        *_cudaAccessTO,
+        _cudaNumChangedCells);
+    copyDataTOtoHost(dataTO);
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(&result.numChangedCells, _cudaNumChangedCells, sizeof(int), cudaMemcpyDeviceToHost));
+
+    //the removal logs now contain the changed entities outside the rectangle
+    auto copyIds = [](Array<uint64_t> const& ids, std::vector<uint64_t>& target) {
+        auto numIds = ids.getNumEntries_host();
+        auto origSize = target.size();
+        target.resize(origSize + numIds);
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            target.data() + origSize, ids.getArray_host(), sizeof(uint64_t) * numIds, cudaMemcpyDeviceToHost));
+    };
+    if (!result.complete) {
+        copyIds(data.removedCellIds, result.removedCellIds);
+        copyIds(data.removedParticleIds, result.removedParticleIds);
+    }
+    data.removedCellIds.setNumEntries_host(0);
+    data.removedParticleIds.setNumEntries_host(0);
+    return result;
+}
+
+void _CudaSimulation::setSimulationData(DataAccessTO const& dataTO)
+{
+    copyDataTOtoDevice(dataTO);
     KERNEL_CALL_HOST(cudaSetSimulationAccessDataKernel, *_cudaSimulationData, *_cudaAccessTO);
+    invalidateDataDeltas();
+    invalidateTileIndices();
+}
+
+void _CudaSimulation::addSimulationData(DataAccessTO const& dataTO)
+{
+    copyDataTOtoDevice(dataTO);
+    KERNEL_CALL_HOST(cudaAddSimulationAccessDataKernel, *_cudaSimulationData, *_cudaAccessTO);
+    invalidateDataDeltas();
+    invalidateTileIndices();
 }
 
 void _CudaSimulation::applyForce(ApplyForceData const& applyData)
@@ -317,25 +494,36 @@ void _CudaSimulation::setSelection(SetSelectionData const& selectionData)
 void _CudaSimulation::shallowUpdateSelection(ShallowUpdateSelectionData const& shallowUpdateData)
 {
     KERNEL_CALL_HOST(cudaShallowUpdateSelection, shallowUpdateData, *_cudaSimulationData);
+    invalidateTileIndices();
 }
 
 void _CudaSimulation::removeSelection()
 {
     KERNEL_CALL_HOST(cudaRemoveSelection, *_cudaSimulationData);
+    invalidateTileIndices();
 }
 
 void _CudaSimulation::setGpuConstants(GpuSettings const& gpuConstants_)
 {
+    _gpuSettings = gpuConstants_;
     CHECK_FOR_CUDA_ERROR(
         cudaMemcpyToSymbol(gpuConstants, &gpuConstants_, sizeof(GpuSettings), 0, cudaMemcpyHostToDevice));
 }
 
+void _CudaSimulation::setEngineSettings(EngineSettings const& engineSettings)
+{
+    _engineSettings = engineSettings;
+}
+
 auto _CudaSimulation::getArraySizes() const -> ArraySizes
 {
+    auto cellArraySize = _cudaSimulationData->entities.cells.getSize_host();
     return {
-        _cudaSimulationData->entities.cells.getSize_host(),
+        cellArraySize,
         _cudaSimulationData->entities.particles.getSize_host(),
-        _cudaSimulationData->entities.tokens.getSize_host()};
+        _cudaSimulationData->entities.tokens.getSize_host(),
+        cellArraySize * 3,
+        static_cast<int>(_stringBytesSize)};
 }
 
 OverallStatistics _CudaSimulation::getMonitorData()
@@ -359,6 +547,11 @@ OverallStatistics _CudaSimulation::getMonitorData()
     return result;
 }
 
+vector<StageStatistics> _CudaSimulation::getStageStatistics() const
+{
+    return _stageProfiler.getStatistics();
+}
+
 uint64_t _CudaSimulation::getCurrentTimestep() const
 {
     return _currentTimestep.load();
@@ -383,6 +576,7 @@ void _CudaSimulation::setSimulationParametersSpots(SimulationParametersSpots con
 
 void _CudaSimulation::setFlowFieldSettings(FlowFieldSettings const& settings)
 {
+    _isFlowFieldActive = settings.active;
     CHECK_FOR_CUDA_ERROR(
         cudaMemcpyToSymbol(cudaFlowFieldSettings, &settings, sizeof(FlowFieldSettings), 0, cudaMemcpyHostToDevice));
 }
@@ -391,12 +585,17 @@ void _CudaSimulation::setFlowFieldSettings(FlowFieldSettings const& settings)
 void _CudaSimulation::clear()
 {
     KERNEL_CALL_HOST(cudaClearData, *_cudaSimulationData);
+    invalidateDataDeltas();
+    invalidateTileIndices();
 }
 
 void _CudaSimulation::resizeArraysIfNecessary(ArraySizes const& additionals)
 {
     if (_cudaSimulationData->shouldResize(
-            additionals.cellArraySize, additionals.particleArraySize, additionals.tokenArraySize)) {
+            additionals.cellArraySize,
+            additionals.particleArraySize,
+            additionals.tokenArraySize,
+            _engineSettings.ARRAY_FILL_LEVEL_FACTOR)) {
         resizeArrays(additionals);
     }
 }
@@ -411,30 +610,104 @@ void _CudaSimulation::automaticResizeArrays()
     }
 }
 
+void _CudaSimulation::calcTimestepByStages()
+{
+    KERNEL_CALL_HOST(prepareForSimulationKernel, *_cudaSimulationData, *_cudaSimulationResult, _cudaOperations);
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(&_cudaSimulationData->operations, _cudaOperations, sizeof(Operation*), cudaMemcpyDeviceToHost));
+
+    for (int stage = 0; stage < NumSimulationStages; ++stage) {
+        if (0 == stage && !_isFlowFieldActive) {
+            continue;
+        }
+        _stageProfiler.measure(SimulationStageNames[stage], [&] {
+            KERNEL_CALL_HOST(
+                calcSimulationStageKernel,
+                stage,
+                *_cudaSimulationData,
+                *_cudaSimulationResult,
+                _engineSettings.ARRAY_FILL_LEVEL_FACTOR);
+        });
+    }
+}
+
+void _CudaSimulation::automaticReorderEntities()
+{
+    auto const interval = _engineSettings.REORDER_INTERVAL;
+    if (interval <= 0 || _currentTimestep.load() % interval != 0) {
+        return;
+    }
+    auto& entities = _cudaSimulationData->entities;
+    auto numCells = entities.cellPointers.getNumEntries_host();
+    auto numParticles = entities.particlePointers.getNumEntries_host();
+    if (std::max(numCells, numParticles) > _curveIndicesSize) {
+        CudaMemoryManager::getInstance().freeMemory(_cudaCellCurveIndices);
+        CudaMemoryManager::getInstance().freeMemory(_cudaParticleCurveIndices);
+        _curveIndicesSize = std::max(numCells, numParticles);
+        CudaMemoryManager::getInstance().acquireMemory<unsigned int>(_curveIndicesSize, _cudaCellCurveIndices);
+        CudaMemoryManager::getInstance().acquireMemory<unsigned int>(_curveIndicesSize, _cudaParticleCurveIndices);
+    }
+
+    //the pointer arrays contain no null pointers since the cleanup has been done at the end of the time step
+    KERNEL_CALL_HOST(
+        cudaCalcSpaceFillingCurveIndices,
+        *_cudaSimulationData,
+        _cudaCellCurveIndices,
+        _cudaParticleCurveIndices,
+        _engineSettings.REORDER_CURVE);
+    auto cellPointers = entities.cellPointers.getArray_host();
+    thrust::sort_by_key(thrust::device, _cudaCellCurveIndices, _cudaCellCurveIndices + numCells, cellPointers);
+    auto particlePointers = entities.particlePointers.getArray_host();
+    thrust::sort_by_key(
+        thrust::device, _cudaParticleCurveIndices, _cudaParticleCurveIndices + numParticles, particlePointers);
+
+    KERNEL_CALL_HOST(cudaReorderEntities, *_cudaSimulationData);
+}
+
 void _CudaSimulation::resizeArrays(ArraySizes const& additionals)
 {
     auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
     loggingService->logMessage(Priority::Important, "resize arrays");
 
-    _cudaSimulationData->resizeEntitiesForCleanup(
-        additionals.cellArraySize, additionals.particleArraySize, additionals.tokenArraySize);
-    if (!_cudaSimulationData->isEmpty()) {
-        KERNEL_CALL_HOST(cudaCopyEntities, *_cudaSimulationData);
+    //the removal logs are reallocated
+    takeOverRemovedIds(_dataVersion);
+
+    if (CudaMemoryManager::getInstance().isVirtualMemorySupported()) {
+        _cudaSimulationData->resizeEntities(
+            additionals.cellArraySize,
+            additionals.particleArraySize,
+            additionals.tokenArraySize,
+            _engineSettings.ARRAY_FILL_LEVEL_FACTOR);
         _cudaSimulationData->resizeRemainings();
-        _cudaSimulationData->swap();
     } else {
-        _cudaSimulationData->resizeRemainings();
+        _cudaSimulationData->resizeEntitiesForCleanup(
+            additionals.cellArraySize,
+            additionals.particleArraySize,
+            additionals.tokenArraySize,
+            _engineSettings.ARRAY_FILL_LEVEL_FACTOR);
+        if (!_cudaSimulationData->isEmpty()) {
+            KERNEL_CALL_HOST(cudaCopyEntities, *_cudaSimulationData);
+            _cudaSimulationData->resizeRemainings();
+            _cudaSimulationData->swap();
+        } else {
+            _cudaSimulationData->resizeRemainings();
+        }
     }
 
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->cells);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->particles);
     CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->tokens);
+    CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->strings);
+    CudaMemoryManager::getInstance().freeMemory(_cudaOverlayTO->elements);
 
     auto cellArraySize = _cudaSimulationData->entities.cells.getSize_host();
     auto tokenArraySize = _cudaSimulationData->entities.tokens.getSize_host();
     CudaMemoryManager::getInstance().acquireMemory<CellAccessTO>(cellArraySize, _cudaAccessTO->cells);
     CudaMemoryManager::getInstance().acquireMemory<ParticleAccessTO>(cellArraySize, _cudaAccessTO->particles);
     CudaMemoryManager::getInstance().acquireMemory<TokenAccessTO>(tokenArraySize, _cudaAccessTO->tokens);
+    CudaMemoryManager::getInstance().acquireMemory<StringAccessTO>(cellArraySize * 3, _cudaAccessTO->strings);
+    CudaMemoryManager::getInstance().acquireMemory<OverlayElementAccessTO>(cellArraySize, _cudaOverlayTO->elements);
+    _cudaOverlayTO->maxElements = cellArraySize;
 
     CHECK_FOR_CUDA_ERROR(cudaGetLastError());
 
@@ -445,3 +718,206 @@ void _CudaSimulation::resizeArrays(ArraySizes const& additionals)
         auto const memorySizeAfter = CudaMemoryManager::getInstance().getSizeOfAcquiredMemory();
     loggingService->logMessage(Priority::Important, std::to_string(memorySizeAfter / (1024 * 1024)) + " MB GPU memory acquired");
 }
+
+void _CudaSimulation::takeOverRemovedIds(uint64_t version)
+{
+    auto& data = *_cudaSimulationData;
+    int overflow;
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(&overflow, data.removedIdsOverflow, sizeof(int), cudaMemcpyDeviceToHost));
+    if (0 != overflow) {
+        invalidateDataDeltas();
+        return;
+    }
+
+    auto takeOver = [&](Array<uint64_t>& ids, std::deque<std::pair<uint64_t, uint64_t>>& history) {
+        std::vector<uint64_t> idsOnHost(ids.getNumEntries_host());
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            idsOnHost.data(), ids.getArray_host(), sizeof(uint64_t) * idsOnHost.size(), cudaMemcpyDeviceToHost));
+        ids.setNumEntries_host(0);
+        for (auto const& id : idsOnHost) {
+            history.emplace_back(version, id);
+        }
+
+        //older deltas cannot be reconstructed once their removals are discarded
+        while (history.size() > MaxRemovedIdHistory) {
+            _oldestDeltaVersion = std::max(_oldestDeltaVersion, history.front().first);
+            history.pop_front();
+        }
+    };
+    takeOver(data.removedCellIds, _removedCellIds);
+    takeOver(data.removedParticleIds, _removedParticleIds);
+}
+
+void _CudaSimulation::invalidateDataDeltas()
+{
+    auto& data = *_cudaSimulationData;
+    _oldestDeltaVersion = _dataVersion;
+    _removedCellIds.clear();
+    _removedParticleIds.clear();
+    data.removedCellIds.setNumEntries_host(0);
+    data.removedParticleIds.setNumEntries_host(0);
+    CHECK_FOR_CUDA_ERROR(cudaMemset(data.removedIdsOverflow, 0, sizeof(int)));
+}
+
+//the tile indices are only built for region queries => no costs for time steps without queries
+ExportTiles _CudaSimulation::createExportTiles(int tileSize) const
+{
+    auto const& size = _cudaSimulationData->size;
+    return {
+        tileSize, {(size.x + tileSize - 1) / tileSize, (size.y + tileSize - 1) / tileSize}, _cudaExportOwnerTiles};
+}
+
+void _CudaSimulation::updateTileIndicesIfNecessary()
+{
+    auto& data = *_cudaSimulationData;
+    if (data.cellTiles.isValid() && data.particleTiles.isValid()) {
+        return;
+    }
+    KERNEL_CALL_HOST(cudaBuildTileIndices, data);
+    data.cellTiles.setValid(true);
+    data.particleTiles.setValid(true);
+}
+
+void _CudaSimulation::invalidateTileIndices()
+{
+    _cudaSimulationData->cellTiles.setValid(false);
+    _cudaSimulationData->particleTiles.setValid(false);
+}
+
+void _CudaSimulation::copyDataTOtoHost(DataAccessTO const& dataTO)
+{
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(dataTO.numCells, _cudaAccessTO->numCells, sizeof(int), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(dataTO.numParticles, _cudaAccessTO->numParticles, sizeof(int), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(dataTO.numTokens, _cudaAccessTO->numTokens, sizeof(int), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(dataTO.numStrings, _cudaAccessTO->numStrings, sizeof(int), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(dataTO.numStringBytes, _cudaAccessTO->numStringBytes, sizeof(int), cudaMemcpyDeviceToHost));
+    copyCellsToHost(dataTO);
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        dataTO.particles,
+        _cudaAccessTO->particles,
+        sizeof(ParticleAccessTO) * (*dataTO.numParticles),
+        cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        dataTO.tokens, _cudaAccessTO->tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        dataTO.strings,
+        _cudaAccessTO->strings,
+        sizeof(StringAccessTO) * (*dataTO.numStrings),
+        cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        dataTO.stringBytes,
+        _cudaAccessTO->stringBytes,
+        sizeof(char) * (*dataTO.numStringBytes),
+        cudaMemcpyDeviceToHost));
+}
+
+void _CudaSimulation::copyDataTOtoDevice(DataAccessTO const& dataTO)
+{
+    //the string table grows with the strings to be added, the device buffer for the string bytes grows with it
+    if (_cudaSimulationData->strings.reserve(*dataTO.numStrings, *dataTO.numStringBytes)) {
+        KERNEL_CALL_HOST(cudaRebuildStringIndex, *_cudaSimulationData);
+    }
+    if (_cudaSimulationData->strings.getMaxBytes() > _stringBytesSize) {
+        CudaMemoryManager::getInstance().freeMemory(_cudaAccessTO->stringBytes);
+        _stringBytesSize = _cudaSimulationData->strings.getMaxBytes();
+        CudaMemoryManager::getInstance().acquireMemory<char>(_stringBytesSize, _cudaAccessTO->stringBytes);
+    }
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(_cudaAccessTO->numCells, dataTO.numCells, sizeof(int), cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(_cudaAccessTO->numParticles, dataTO.numParticles, sizeof(int), cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(_cudaAccessTO->numTokens, dataTO.numTokens, sizeof(int), cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(_cudaAccessTO->numStrings, dataTO.numStrings, sizeof(int), cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(_cudaAccessTO->numStringBytes, dataTO.numStringBytes, sizeof(int), cudaMemcpyHostToDevice));
+    copyCellsToDevice(dataTO);
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _cudaAccessTO->particles,
+        dataTO.particles,
+        sizeof(ParticleAccessTO) * (*dataTO.numParticles),
+        cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _cudaAccessTO->tokens, dataTO.tokens, sizeof(TokenAccessTO) * (*dataTO.numTokens), cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _cudaAccessTO->strings,
+        dataTO.strings,
+        sizeof(StringAccessTO) * (*dataTO.numStrings),
+        cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _cudaAccessTO->stringBytes,
+        dataTO.stringBytes,
+        sizeof(char) * (*dataTO.numStringBytes),
+        cudaMemcpyHostToDevice));
+}
+
+void _CudaSimulation::copyCellsToHost(DataAccessTO const& dataTO)
+{
+    auto numCells = *dataTO.numCells;
+    if (!_engineSettings.PACKED_CELL_TRANSFER) {
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            dataTO.cells, _cudaAccessTO->cells, sizeof(CellAccessTO) * numCells, cudaMemcpyDeviceToHost));
+        return;
+    }
+    reservePackedCellBuffers(numCells, 0);
+    KERNEL_CALL_HOST(cudaCalcPackedCellOffsetsKernel, *_cudaAccessTO, *_cudaPackedCellsTO);
+    unsigned long long int numBytes;
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(&numBytes, _cudaPackedCellsTO->numBytes, sizeof(numBytes), cudaMemcpyDeviceToHost));
+    reservePackedCellBuffers(numCells, numBytes);
+    KERNEL_CALL_HOST(cudaPackCellAccessDataKernel, *_cudaAccessTO, *_cudaPackedCellsTO);
+
+    _packedCellOffsets.resize(std::max(numCells, 1));
+    _packedCellBytes.resize(std::max(numBytes, 1ull));
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _packedCellOffsets.data(),
+        _cudaPackedCellsTO->offsets,
+        sizeof(unsigned long long int) * numCells,
+        cudaMemcpyDeviceToHost));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(_packedCellBytes.data(), _cudaPackedCellsTO->bytes, numBytes, cudaMemcpyDeviceToHost));
+    unpackCells_host(_packedCellBytes.data(), _packedCellOffsets.data(), numCells, dataTO.cells);
+}
+
+void _CudaSimulation::copyCellsToDevice(DataAccessTO const& dataTO)
+{
+    auto numCells = *dataTO.numCells;
+    if (!_engineSettings.PACKED_CELL_TRANSFER) {
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+            _cudaAccessTO->cells, dataTO.cells, sizeof(CellAccessTO) * numCells, cudaMemcpyHostToDevice));
+        return;
+    }
+    _packedCellOffsets.resize(std::max(numCells, 1));
+    auto numBytes = calcPackedCellOffsets_host(dataTO.cells, numCells, _packedCellOffsets.data());
+    _packedCellBytes.resize(std::max(numBytes, uint64_t(1)));
+    packCells_host(dataTO.cells, numCells, _packedCellOffsets.data(), _packedCellBytes.data());
+
+    reservePackedCellBuffers(numCells, numBytes);
+    CHECK_FOR_CUDA_ERROR(cudaMemcpy(
+        _cudaPackedCellsTO->offsets,
+        _packedCellOffsets.data(),
+        sizeof(unsigned long long int) * numCells,
+        cudaMemcpyHostToDevice));
+    CHECK_FOR_CUDA_ERROR(
+        cudaMemcpy(_cudaPackedCellsTO->bytes, _packedCellBytes.data(), numBytes, cudaMemcpyHostToDevice));
+    KERNEL_CALL_HOST(cudaUnpackCellAccessDataKernel, *_cudaPackedCellsTO, *_cudaAccessTO);
+}
+
+//the device buffers for the packed cell transfer are sized by the packed data and only grow
+void _CudaSimulation::reservePackedCellBuffers(int numCells, uint64_t numBytes)
+{
+    if (numCells > _packedCellOffsetsSize) {
+        CudaMemoryManager::getInstance().freeMemory(_cudaPackedCellsTO->offsets);
+        CudaMemoryManager::getInstance().acquireMemory<unsigned long long int>(
+            numCells, _cudaPackedCellsTO->offsets);
+        _packedCellOffsetsSize = numCells;
+    }
+    if (numBytes > _packedCellBytesSize) {
+        CudaMemoryManager::getInstance().freeMemory(_cudaPackedCellsTO->bytes);
+        CudaMemoryManager::getInstance().acquireMemory<char>(numBytes, _cudaPackedCellsTO->bytes);
+        _packedCellBytesSize = numBytes;
+    }
+}
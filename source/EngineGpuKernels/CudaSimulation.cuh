@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <atomic>
+#include <deque>
+#include <vector>
 
 #if defined(_WIN32)
 #define NOMINMAX
@@ -16,69 +18,116 @@
 
 #include "Definitions.cuh"
 #include "DllExport.h"
+#include "SimulationBackend.cuh"
 
-class _CudaSimulation
+class _CudaSimulation : public _SimulationBackend
 {
 public:
     ENGINEGPUKERNELS_EXPORT static void initCuda();
 
-    ENGINEGPUKERNELS_EXPORT
-    _CudaSimulation(uint64_t timestep, Settings const& settings, GpuSettings const& gpuSettings);
-    ENGINEGPUKERNELS_EXPORT ~_CudaSimulation();
+    ENGINEGPUKERNELS_EXPORT _CudaSimulation(
+        uint64_t timestep,
+        Settings const& settings,
+        GpuSettings const& gpuSettings,
+        EngineSettings const& engineSettings);
+    ENGINEGPUKERNELS_EXPORT ~_CudaSimulation() override;
 
-    ENGINEGPUKERNELS_EXPORT void* registerImageResource(GLuint image);
+    ENGINEGPUKERNELS_EXPORT void* registerImageResource(GLuint image) override;
 
-    ENGINEGPUKERNELS_EXPORT void calcCudaTimestep();
+    ENGINEGPUKERNELS_EXPORT void calcTimestep() override;
 
     ENGINEGPUKERNELS_EXPORT void drawVectorGraphics(
         float2 const& rectUpperLeft,
         float2 const& rectLowerRight,
         void* cudaResource,
         int2 const& imageSize,
-        double zoom);
+        double zoom) override;
     ENGINEGPUKERNELS_EXPORT void
-    getSimulationData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO);
+    getSimulationData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO) override;
     ENGINEGPUKERNELS_EXPORT void
-    getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO);
-    ENGINEGPUKERNELS_EXPORT void setSimulationData(DataAccessTO const& dataTO);
-
-    ENGINEGPUKERNELS_EXPORT void applyForce(ApplyForceData const& applyData);
-    ENGINEGPUKERNELS_EXPORT void switchSelection(SwitchSelectionData const& switchData);
-    ENGINEGPUKERNELS_EXPORT void setSelection(SetSelectionData const& selectionData);
-    ENGINEGPUKERNELS_EXPORT SelectionShallowData getSelectionShallowData();
-    ENGINEGPUKERNELS_EXPORT void shallowUpdateSelection(ShallowUpdateSelectionData const& shallowUpdateData);
-    ENGINEGPUKERNELS_EXPORT void removeSelection();
-
-    ENGINEGPUKERNELS_EXPORT void setGpuConstants(GpuSettings const& cudaConstants);
-    ENGINEGPUKERNELS_EXPORT void setSimulationParameters(SimulationParameters const& parameters);
-    ENGINEGPUKERNELS_EXPORT void setSimulationParametersSpots(SimulationParametersSpots const& spots);
-    ENGINEGPUKERNELS_EXPORT void setFlowFieldSettings(FlowFieldSettings const& settings);
-
-    struct ArraySizes
-    {
-        int cellArraySize;
-        int particleArraySize;
-        int tokenArraySize;
-    };
-    ENGINEGPUKERNELS_EXPORT ArraySizes getArraySizes() const;
-
-    ENGINEGPUKERNELS_EXPORT OverallStatistics getMonitorData();
-    ENGINEGPUKERNELS_EXPORT uint64_t getCurrentTimestep() const;
-    ENGINEGPUKERNELS_EXPORT void setCurrentTimestep(uint64_t timestep);
-
-    ENGINEGPUKERNELS_EXPORT void clear();
-
-    ENGINEGPUKERNELS_EXPORT void resizeArraysIfNecessary(ArraySizes const& additionals);
+    getClusterData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO) override;
+    ENGINEGPUKERNELS_EXPORT void
+    getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, OverlayAccessTO const& overlayTO) override;
+    ENGINEGPUKERNELS_EXPORT std::vector<ArraySizes> getExportTileSizes(int tileSize) override;
+    ENGINEGPUKERNELS_EXPORT void getExportTileData(int tileSize, int tile, DataAccessTO const& dataTO) override;
+    ENGINEGPUKERNELS_EXPORT DataDelta getSimulationDataDelta(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        uint64_t sinceVersion,
+        DataAccessTO const& dataTO) override;
+    ENGINEGPUKERNELS_EXPORT void setSimulationData(DataAccessTO const& dataTO) override;
+    ENGINEGPUKERNELS_EXPORT void addSimulationData(DataAccessTO const& dataTO) override;
+
+    ENGINEGPUKERNELS_EXPORT void applyForce(ApplyForceData const& applyData) override;
+    ENGINEGPUKERNELS_EXPORT void switchSelection(SwitchSelectionData const& switchData) override;
+    ENGINEGPUKERNELS_EXPORT void setSelection(SetSelectionData const& selectionData) override;
+    ENGINEGPUKERNELS_EXPORT SelectionShallowData getSelectionShallowData() override;
+    ENGINEGPUKERNELS_EXPORT void shallowUpdateSelection(ShallowUpdateSelectionData const& shallowUpdateData) override;
+    ENGINEGPUKERNELS_EXPORT void removeSelection() override;
+
+    ENGINEGPUKERNELS_EXPORT void setGpuConstants(GpuSettings const& cudaConstants) override;
+    ENGINEGPUKERNELS_EXPORT void setEngineSettings(EngineSettings const& engineSettings) override;
+    ENGINEGPUKERNELS_EXPORT void setSimulationParameters(SimulationParameters const& parameters) override;
+    ENGINEGPUKERNELS_EXPORT void setSimulationParametersSpots(SimulationParametersSpots const& spots) override;
+    ENGINEGPUKERNELS_EXPORT void setFlowFieldSettings(FlowFieldSettings const& settings) override;
+
+    ENGINEGPUKERNELS_EXPORT ArraySizes getArraySizes() const override;
+
+    ENGINEGPUKERNELS_EXPORT OverallStatistics getMonitorData() override;
+    ENGINEGPUKERNELS_EXPORT vector<StageStatistics> getStageStatistics() const override;
+    ENGINEGPUKERNELS_EXPORT uint64_t getCurrentTimestep() const override;
+    ENGINEGPUKERNELS_EXPORT void setCurrentTimestep(uint64_t timestep) override;
+
+    ENGINEGPUKERNELS_EXPORT void clear() override;
+
+    ENGINEGPUKERNELS_EXPORT void resizeArraysIfNecessary(ArraySizes const& additionals) override;
 
 private:
+    void calcTimestepByStages();
     void automaticResizeArrays();
+    void automaticReorderEntities();
     void resizeArrays(ArraySizes const& additionals);
+    void copyDataTOtoHost(DataAccessTO const& dataTO);
+    void copyDataTOtoDevice(DataAccessTO const& dataTO);
+    void copyCellsToHost(DataAccessTO const& dataTO);
+    void copyCellsToDevice(DataAccessTO const& dataTO);
+    void reservePackedCellBuffers(int numCells, uint64_t numBytes);
+    void takeOverRemovedIds(uint64_t version);
+    void invalidateDataDeltas();
+    void updateTileIndicesIfNecessary();
+    void invalidateTileIndices();
+    ExportTiles createExportTiles(int tileSize) const;
 
     std::atomic<uint64_t> _currentTimestep;
+    GpuSettings _gpuSettings;
+    EngineSettings _engineSettings;
+    StageProfiler _stageProfiler;
     SimulationData* _cudaSimulationData;
     RenderingData* _cudaRenderingData;
     SimulationResult* _cudaSimulationResult;
     SelectionResult* _cudaSelectionResult;
     DataAccessTO* _cudaAccessTO;
+    uint64_t _stringBytesSize = 0;  //of the buffer for the string bytes in the access data
+    PackedCellsAccessTO* _cudaPackedCellsTO;
+    std::vector<char> _packedCellBytes;  //host buffers for the packed cell transfer
+    std::vector<unsigned long long int> _packedCellOffsets;
+    int _packedCellOffsetsSize = 0;  //sizes of the device buffers for the packed cell transfer
+    uint64_t _packedCellBytesSize = 0;
+    unsigned int* _cudaCellCurveIndices = nullptr;  //sort keys for the reordering along a space-filling curve
+    unsigned int* _cudaParticleCurveIndices = nullptr;
+    int _curveIndicesSize = 0;
+    int* _cudaExportOwnerTiles = nullptr;  //tile of the cluster of each cell, determined by getExportTileSizes
+    int _exportOwnerTilesSize = 0;
+    int* _cudaRolloutChange;
+    Operation** _cudaOperations;  //receives the operation array when the stages are launched one by one
+    bool _isFlowFieldActive = false;
+    OverlayAccessTO* _cudaOverlayTO;
     CudaMonitorData* _cudaMonitorData;
+
+    //delta extraction
+    uint64_t _dataVersion;  //of the next delta
+    uint64_t _oldestDeltaVersion;  //deltas for older versions are not available anymore
+    std::deque<std::pair<uint64_t, uint64_t>> _removedCellIds;  //pairs of version and id
+    std::deque<std::pair<uint64_t, uint64_t>> _removedParticleIds;
+    int* _cudaNumChangedCells;
 };
@@ -84,11 +84,11 @@ public:
                 STOP(a, b)
             }
 
-            if (cell->numStaticBytes > MAX_CELL_STATIC_BYTES) {
+            if (cell->cold->numStaticBytes > MAX_CELL_STATIC_BYTES) {
                 printf("numStaticBytes too large\n");
             }
 
-            if (cell->numMutableBytes > MAX_CELL_MUTABLE_BYTES) {
+            if (cell->cold->numMutableBytes > MAX_CELL_MUTABLE_BYTES) {
                 printf("numMutableBytes too large\n");
             }
 
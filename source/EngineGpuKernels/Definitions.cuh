@@ -1,9 +1,11 @@
 #pragma once
 
 struct Cell;
+struct CellColdData;
 struct Token;
 struct Particle;
 struct Entities;
+struct Operation;
 
 struct SimulationData;
 struct RenderingData;
@@ -12,9 +14,13 @@ class SelectionResult;
 struct CellAccessTO;
 struct ClusterAccessTO;
 struct DataAccessTO;
+struct PackedCellsAccessTO;
+struct OverlayAccessTO;
 struct SimulationParameters;
 struct GpuSettings;
+struct EngineSettings;
 class CudaMonitorData;
+struct ExportTiles;
 
 struct ApplyForceData
 {
@@ -4,3 +4,6 @@
 
 class _CudaSimulation;
 using CudaSimulation = boost::shared_ptr<_CudaSimulation>;
+
+class _SimulationBackend;
+using SimulationBackend = boost::shared_ptr<_SimulationBackend>;
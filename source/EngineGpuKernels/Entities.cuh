@@ -4,7 +4,13 @@
 
 #include "Base.cuh"
 #include "Definitions.cuh"
-#include "DynamicMemory.cuh"
+
+namespace Const
+{
+    //bounds for the reserved address ranges of the entity arrays which are derived from the world size
+    uint64_t const MaxEntitiesPerArea = 4;
+    uint64_t const MinReservedEntities = 1ull << 22;
+}
 
 struct Entities
 {
@@ -13,32 +19,40 @@ struct Entities
     Array<Particle*> particlePointers;
 
     Array<Cell> cells;
+    Array<CellColdData> cellColdData;  //entry of cells[i] is referenced by cells[i].cold
     Array<Token> tokens;
     Array<Particle> particles;
 
-    DynamicMemory strings;
-
-    void init()
+    //the pointer arrays also hold pointers to entities which are deleted in the current time step
+    void init(int maxEntities)
     {
+        auto maxPointers = maxEntities * 10;
+        cellPointers.setMaxSize(maxPointers);
+        tokenPointers.setMaxSize(maxPointers);
+        particlePointers.setMaxSize(maxPointers);
+        cells.setMaxSize(maxEntities);
+        cellColdData.setMaxSize(maxEntities);
+        tokens.setMaxSize(maxEntities);
+        particles.setMaxSize(maxEntities);
+
         cellPointers.init();
         cells.init();
+        cellColdData.init();
         tokenPointers.init();
         tokens.init();
         particles.init();
         particlePointers.init();
-        strings.init();
-        strings.resize(Const::MetadataMemorySize);
     }
 
     void free()
     {
         cellPointers.free();
         cells.free();
+        cellColdData.free();
         tokenPointers.free();
         tokens.free();
         particles.free();
         particlePointers.free();
-        strings.free();
     }
 };
 
@@ -18,8 +18,12 @@ public:
     __inline__ __device__ void init(SimulationData* data);
     __inline__ __device__ Particle*
     createParticleFromTO(int targetIndex, ParticleAccessTO const& particleTO, Particle* particleTargetArray);
-    __inline__ __device__ Cell*
-    createCellFromTO(int targetIndex, CellAccessTO const& cellTO, Cell* cellArray, DataAccessTO* simulationTO);
+    __inline__ __device__ Cell* createCellFromTO(
+        int targetIndex,
+        CellAccessTO const& cellTO,
+        Cell* cellArray,
+        CellColdData* cellColdDataArray,
+        DataAccessTO* simulationTO);
     __inline__ __device__ Token* createTokenFromTO(
         int targetIndex,
         TokenAccessTO const& tokenTO,
@@ -38,9 +42,6 @@ public:
     __inline__ __device__ Token* createToken(Cell* cell, Cell* sourceCell);
 
 private:
-    __inline__ __device__ void
-    copyString(int& targetLen, char*& targetString, int sourceLen, int sourceStringIndex, char* stringBytes);
-
     MapInfo _map;
     SimulationData* _data;
 };
@@ -69,18 +70,25 @@ EntityFactory::createParticleFromTO(int targetIndex, ParticleAccessTO const& par
     particle->energy = particleTO.energy;
     particle->locked = 0;
     particle->selected = 0;
+    particle->generation = _data->dataVersion;
     particle->metadata.color = particleTO.metadata.color;
     return particle;
 }
 
-__inline__ __device__ Cell*
-EntityFactory::createCellFromTO(int targetIndex, CellAccessTO const& cellTO, Cell* cellTargetArray, DataAccessTO* simulationTO)
+__inline__ __device__ Cell* EntityFactory::createCellFromTO(
+    int targetIndex,
+    CellAccessTO const& cellTO,
+    Cell* cellTargetArray,
+    CellColdData* cellColdDataTargetArray,
+    DataAccessTO* simulationTO)
 {
     Cell** cellPointer = _data->entities.cellPointers.getNewElement();
     Cell* cell = cellTargetArray + targetIndex;
     *cellPointer = cell;
+    cell->cold = cellColdDataTargetArray + targetIndex;
 
     cell->id = _data->numberGen.createNewId_kernel();
+    cell->numRandomDraws = 0;
     cell->absPos = cellTO.pos;
     _map.mapPosCorrection(cell->absPos);
     cell->vel = cellTO.vel;
@@ -99,50 +107,37 @@ EntityFactory::createCellFromTO(int targetIndex, CellAccessTO const& cellTO, Cel
 
     switch (cell->cellFunctionType) {
     case Enums::CellFunction::COMPUTER: {
-        cell->numStaticBytes = cellTO.numStaticBytes;
-        cell->numMutableBytes = cudaSimulationParameters.cellFunctionComputerCellMemorySize;
+        cell->cold->numStaticBytes = cellTO.numStaticBytes;
+        cell->cold->numMutableBytes = cudaSimulationParameters.cellFunctionComputerCellMemorySize;
     } break;
     case Enums::CellFunction::SENSOR: {
-        cell->numStaticBytes = 0;
-        cell->numMutableBytes = 5;
+        cell->cold->numStaticBytes = 0;
+        cell->cold->numMutableBytes = 5;
     } break;
     default: {
-        cell->numStaticBytes = 0;
-        cell->numMutableBytes = 0;
+        cell->cold->numStaticBytes = 0;
+        cell->cold->numMutableBytes = 0;
     }
     }
     for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
-        cell->staticData[i] = cellTO.staticData[i];
+        cell->cold->staticData[i] = cellTO.staticData[i];
     }
     for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
-        cell->mutableData[i] = cellTO.mutableData[i];
+        cell->cold->mutableData[i] = cellTO.mutableData[i];
     }
-    cell->tokenUsages = cellTO.tokenUsages;
-    cell->metadata.color = cellTO.metadata.color;
+    cell->cold->tokenUsages = cellTO.tokenUsages;
+    cell->cold->metadata.color = cellTO.metadata.color;
 
-    copyString(
-        cell->metadata.nameLen,
-        cell->metadata.name,
-        cellTO.metadata.nameLen,
-        cellTO.metadata.nameStringIndex,
-        simulationTO->stringBytes);
-
-    copyString(
-        cell->metadata.descriptionLen,
-        cell->metadata.description,
-        cellTO.metadata.descriptionLen,
-        cellTO.metadata.descriptionStringIndex,
-        simulationTO->stringBytes);
-
-    copyString(
-        cell->metadata.sourceCodeLen,
-        cell->metadata.sourceCode,
-        cellTO.metadata.sourceCodeLen,
-        cellTO.metadata.sourceCodeStringIndex,
-        simulationTO->stringBytes);
+    //prerequisite: the strings of the access data have been interned
+    auto& metadata = cell->cold->metadata;
+    metadata.nameId = _data->strings.getInternedId(cellTO.metadata.nameStringIndex);
+    metadata.descriptionId = _data->strings.getInternedId(cellTO.metadata.descriptionStringIndex);
+    metadata.sourceCodeId = _data->strings.getInternedId(cellTO.metadata.sourceCodeStringIndex);
+    _data->strings.addReferences(metadata);
 
     cell->selected = 0;
     cell->locked = 0;
+    cell->generation = _data->dataVersion;
     cell->temp3 = {0, 0};
 
     return cell;
@@ -168,18 +163,6 @@ __inline__ __device__ Token* EntityFactory::createTokenFromTO(
     return token;
 }
 
-__inline__ __device__ void
-EntityFactory::copyString(int& targetLen, char*& targetString, int sourceLen, int sourceStringIndex, char* stringBytes)
-{
-    targetLen = sourceLen;
-    if (sourceLen > 0) {
-        targetString = _data->entities.strings.getArray<char>(sourceLen);
-        for (int i = 0; i < sourceLen; ++i) {
-            targetString[i] = stringBytes[sourceStringIndex + i];
-        }
-    }
-}
-
 __inline__ __device__ Particle*
 EntityFactory::createParticle(float energy, float2 const& pos, float2 const& vel, ParticleMetadata const& metadata)
 {
@@ -189,6 +172,7 @@ EntityFactory::createParticle(float energy, float2 const& pos, float2 const& vel
     particle->id = _data->numberGen.createNewId_kernel();
     particle->selected = 0;
     particle->locked = 0;
+    particle->generation = _data->dataVersion;
     particle->energy = energy;
     particle->absPos = pos;
     particle->vel = vel;
@@ -201,44 +185,47 @@ __inline__ __device__ Cell* EntityFactory::createRandomCell(float energy, float2
     auto cell = _data->entities.cells.getNewElement();
     auto cellPointers = _data->entities.cellPointers.getNewElement();
     *cellPointers = cell;
+    cell->cold = _data->entities.cellColdData.getNewElement();
 
     cell->id = _data->numberGen.createNewId_kernel();
+    cell->numRandomDraws = 0;
     cell->absPos = pos;
     cell->vel = vel;
     cell->energy = energy;
-    cell->maxConnections = _data->numberGen.random(MAX_CELL_BONDS);
-    cell->branchNumber = _data->numberGen.random(cudaSimulationParameters.cellMaxTokenBranchNumber - 1);
+    cell->maxConnections = _data->numberGen.random(cell, MAX_CELL_BONDS);
+    cell->branchNumber = _data->numberGen.random(cell, cudaSimulationParameters.cellMaxTokenBranchNumber - 1);
     cell->numConnections = 0;
     cell->tokenBlocked = false;
     cell->locked = 0;
     cell->selected = 0;
+    cell->generation = _data->dataVersion;
     cell->temp3 = {0, 0};
-    cell->metadata.color = 0;
-    cell->metadata.nameLen = 0;
-    cell->metadata.descriptionLen = 0;
-    cell->metadata.sourceCodeLen = 0;
-    cell->cellFunctionType = _data->numberGen.random(static_cast<int>(Enums::CellFunction::_COUNTER) - 1);
+    cell->cold->metadata.color = 0;
+    cell->cold->metadata.nameId = 0;
+    cell->cold->metadata.descriptionId = 0;
+    cell->cold->metadata.sourceCodeId = 0;
+    cell->cellFunctionType = _data->numberGen.random(cell, static_cast<int>(Enums::CellFunction::_COUNTER) - 1);
     switch (cell->cellFunctionType) {
     case Enums::CellFunction::COMPUTER: {
-        cell->numStaticBytes = cudaSimulationParameters.cellFunctionComputerMaxInstructions * 3;
-        cell->numMutableBytes = cudaSimulationParameters.cellFunctionComputerCellMemorySize;
+        cell->cold->numStaticBytes = cudaSimulationParameters.cellFunctionComputerMaxInstructions * 3;
+        cell->cold->numMutableBytes = cudaSimulationParameters.cellFunctionComputerCellMemorySize;
     } break;
     case Enums::CellFunction::SENSOR: {
-        cell->numStaticBytes = 0;
-        cell->numMutableBytes = 5;
+        cell->cold->numStaticBytes = 0;
+        cell->cold->numMutableBytes = 5;
     } break;
     default: {
-        cell->numStaticBytes = 0;
-        cell->numMutableBytes = 0;
+        cell->cold->numStaticBytes = 0;
+        cell->cold->numMutableBytes = 0;
     }
     }
     for (int i = 0; i < MAX_CELL_STATIC_BYTES; ++i) {
-        cell->staticData[i] = _data->numberGen.random(255);
+        cell->cold->staticData[i] = _data->numberGen.random(cell, 255);
     }
     for (int i = 0; i < MAX_CELL_MUTABLE_BYTES; ++i) {
-        cell->mutableData[i] = _data->numberGen.random(255);
+        cell->cold->mutableData[i] = _data->numberGen.random(cell, 255);
     }
-    cell->tokenUsages = 0;
+    cell->cold->tokenUsages = 0;
     return cell;
 }
 
@@ -247,15 +234,18 @@ __inline__ __device__ Cell* EntityFactory::createCell()
     auto result = _data->entities.cells.getNewElement();
     auto cellPointer = _data->entities.cellPointers.getNewElement();
     *cellPointer = result;
-    result->tokenUsages = 0;
+    result->cold = _data->entities.cellColdData.getNewElement();
+    result->cold->tokenUsages = 0;
     result->id = _data->numberGen.createNewId_kernel();
+    result->numRandomDraws = 0;
     result->selected = 0;
     result->locked = 0;
+    result->generation = _data->dataVersion;
     result->temp3 = {0, 0};
-    result->metadata.color = 0;
-    result->metadata.nameLen = 0;
-    result->metadata.descriptionLen = 0;
-    result->metadata.sourceCodeLen = 0;
+    result->cold->metadata.color = 0;
+    result->cold->metadata.nameId = 0;
+    result->cold->metadata.descriptionId = 0;
+    result->cold->metadata.sourceCodeId = 0;
     return result;
 }
 
@@ -269,6 +259,7 @@ __inline__ __device__ Token* EntityFactory::duplicateToken(Cell* targetCell, Tok
     token->memory[0] = targetCell->branchNumber;
     token->sourceCell = token->cell;
     token->cell = targetCell;
+    _data->markChanged(targetCell);
     return token;
 }
 
@@ -284,5 +275,6 @@ __inline__ __device__ Token* EntityFactory::createToken(Cell* cell, Cell* source
     for (int i = 1; i < MAX_TOKEN_MEM_SIZE; ++i) {
         token->memory[i] = 0;
     }
+    _data->markChanged(cell);
     return token;
 }
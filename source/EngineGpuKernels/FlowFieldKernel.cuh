@@ -40,7 +40,11 @@ __global__ void applyFlowFieldSettings(SimulationData data)
 
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& cell = cells.at(index);
-        cell->vel = cell->vel + calcVelocity(cell->absPos, data.cellMap);
+        auto velInc = calcVelocity(cell->absPos, data.cellMap);
+        if (velInc != float2{0, 0}) {
+            cell->vel = cell->vel + velInc;
+            data.markChanged(cell);
+        }
     }
 }
 
@@ -67,128 +67,166 @@ class BasicMap : public MapInfo
 public:
 };
 
+//cell list which is built once per time step by a counting sort, i.e. all cells in a grid unit are stored
 class CellMap : public MapInfo
 {
 public:
     __host__ __inline__ void init(int2 const& size)
     {
         MapInfo::init(size);
-        CudaMemoryManager::getInstance().acquireMemory<Cell*>(size.x * size.y * 2, _map);
-        _mapEntries.init();
+        CudaMemoryManager::getInstance().acquireMemory<int>(size.x * size.y, _bucketSizes);
+        CudaMemoryManager::getInstance().acquireMemory<int>(size.x * size.y, _bucketOffsets);
+        _cellBuckets.init();
+        _entries.init();
+        _occupiedBuckets.init();
 
-        std::vector<Cell*> hostMap(size.x * size.y * 2, 0);
-        CHECK_FOR_CUDA_ERROR(cudaMemcpy(_map, hostMap.data(), sizeof(Cell*) * size.x * size.y * 2, cudaMemcpyHostToDevice));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_bucketSizes, 0, sizeof(int) * size.x * size.y));
     }
 
-    __host__ __inline__ void resize(int maxEntries) { _mapEntries.resize(maxEntries); }
+    __host__ __inline__ void resize(int maxEntries)
+    {
+        _cellBuckets.resize(maxEntries);
+        _entries.resize(maxEntries);
+        _occupiedBuckets.resize(maxEntries);
+    }
 
-    __device__ __inline__ void reset() { _mapEntries.reset(); }
+    __device__ __inline__ void reset()
+    {
+        _entries.reset();
+        _occupiedBuckets.reset();
+    }
 
     __host__ __inline__ void free()
     {
-        CudaMemoryManager::getInstance().freeMemory(_map);
-        _mapEntries.free();
+        CudaMemoryManager::getInstance().freeMemory(_bucketSizes);
+        CudaMemoryManager::getInstance().freeMemory(_bucketOffsets);
+        _cellBuckets.free();
+        _entries.free();
+        _occupiedBuckets.free();
     }
 
-    __device__ __inline__ void set_block(int numEntities, Cell** entities)
+    //pass 1 of the build: determine bucket sizes and the rank of each cell within its bucket
+    __device__ __inline__ void countCells_system(Array<Cell*> const& cellPointers)
     {
-        if (0 == numEntities) {
-            return;
+        auto partition =
+            calcPartition(cellPointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& cell = cellPointers.at(index);
+            if (!cell) {
+                _cellBuckets.at(index) = {-1, 0};
+                continue;
+            }
+            auto bucket = calcBucket({floorInt(cell->absPos.x), floorInt(cell->absPos.y)});
+            auto rank = atomicAdd(&_bucketSizes[bucket], 1);
+            if (0 == rank) {
+                *_occupiedBuckets.getNewElement() = bucket;
+            }
+            _cellBuckets.at(index) = {bucket, rank};
         }
+    }
 
-        __shared__ int* entrySubarray;
-        if (0 == threadIdx.x) {
-            entrySubarray = _mapEntries.getNewSubarray(numEntities);
+    //pass 2: reserve a contiguous range of entries for each occupied bucket
+    __device__ __inline__ void allocateBuckets_system()
+    {
+        auto partition = calcPartition(
+            _occupiedBuckets.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto bucket = _occupiedBuckets.at(index);
+            auto bucketEntries = _entries.getNewSubarray(_bucketSizes[bucket]);
+            _bucketOffsets[bucket] = static_cast<int>(bucketEntries - _entries.getArray());
         }
-        __syncthreads();
+    }
 
-        auto partition = calcPartition(numEntities, threadIdx.x, blockDim.x);
+    //pass 3: scatter the cells into their ranges
+    __device__ __inline__ void fillBuckets_system(Array<Cell*> const& cellPointers)
+    {
+        auto partition =
+            calcPartition(cellPointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
         for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-            auto const& entity = entities[index];
-            int2 posInt = {floorInt(entity->absPos.x), floorInt(entity->absPos.y)};
-            mapPosCorrection(posInt);
-            auto mapEntry = (posInt.x + posInt.y * _size.x) * 2;
-            auto old = reinterpret_cast<Cell*>(atomicCAS(
-                reinterpret_cast<unsigned long long int*>(&_map[mapEntry]),
-                reinterpret_cast<unsigned long long int>(nullptr),
-                reinterpret_cast<unsigned long long int>(entity)));
-            if (old != nullptr) {
-                atomicExch(&_map[mapEntry + 1], entity);
+            auto const& bucketAndRank = _cellBuckets.at(index);
+            if (bucketAndRank.x >= 0) {
+                _entries.at(_bucketOffsets[bucketAndRank.x] + bucketAndRank.y) = cellPointers.at(index);
             }
-            entrySubarray[index] = mapEntry;
         }
-        __syncthreads();
     }
 
-    //returns at most 18 cells
-    __device__ __inline__ void get(Cell* cells[], int& numCells, float2 const& pos) const
+    //calls func for each cell in the 3x3 grid units around pos
+    template <typename Func>
+    __device__ __inline__ void executeForEachInNeighborhood(float2 const& pos, Func const& func) const
     {
         int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
-        numCells = 0;
         for (int dx = -1; dx <= 1; ++dx) {
             for (int dy = -1; dy <= 1; ++dy) {
-                int2 scanPos{posInt.x + dx, posInt.y + dy};
-                mapPosCorrection(scanPos);
-
-                auto mapEntry = (scanPos.x + scanPos.y * _size.x) * 2;
-                if (cells[numCells] = _map[mapEntry]) {
-                    ++numCells;
-                    if (cells[numCells] = _map[mapEntry + 1]) {
-                        ++numCells;
-                    }
-                }
+                executeForEachInBucket({posInt.x + dx, posInt.y + dy}, func);
             }
         }
     }
 
-    __device__ __inline__ void get(Cell* cells[], int arraySize, int& numCells, float2 const& pos, float radius) const
+    //calls func for each cell within radius around pos
+    template <typename Func>
+    __device__ __inline__ void executeForEach(float2 const& pos, float radius, Func const& func) const
     {
         int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
-        numCells = 0;
         int radiusInt = ceilf(radius);
         for (int dx = -radiusInt; dx <= radiusInt; ++dx) {
             for (int dy = -radiusInt; dy <= radiusInt; ++dy) {
-                int2 scanPos{posInt.x + dx, posInt.y + dy};
-                mapPosCorrection(scanPos);
-
-                auto mapEntry = (scanPos.x + scanPos.y * _size.x) * 2;
-                auto cell1 = _map[mapEntry];
-                if (cell1 && Math::length(cell1->absPos - pos) <= radius && numCells < arraySize) {
-                    cells[numCells] = cell1;
-                    ++numCells;
-
-                    auto cell2 = _map[mapEntry + 1];
-                    if (cell2 && Math::length(cell2->absPos - pos) <= radius && numCells < arraySize) {
-                        cells[numCells] = cell2;
-                        ++numCells;
+                executeForEachInBucket({posInt.x + dx, posInt.y + dy}, [&](Cell* cell) {
+                    if (mapDistance(cell->absPos, pos) <= radius) {
+                        func(cell);
                     }
-                }
+                });
             }
         }
     }
 
+    //returns at most arraySize cells within radius around pos
+    __device__ __inline__ void get(Cell* cells[], int arraySize, int& numCells, float2 const& pos, float radius) const
+    {
+        numCells = 0;
+        executeForEach(pos, radius, [&](Cell* cell) {
+            if (numCells < arraySize) {
+                cells[numCells++] = cell;
+            }
+        });
+    }
+
     __device__ __inline__ Cell* getFirst(float2 const& pos) const
     {
-        int2 posInt = {floorInt(pos.x), floorInt(pos.y)};
-        mapPosCorrection(posInt);
-        auto mapEntry = (posInt.x + posInt.y * _size.x) * 2;
-        return _map[mapEntry];
+        auto bucket = calcBucket({floorInt(pos.x), floorInt(pos.y)});
+        return _bucketSizes[bucket] > 0 ? _entries.at(_bucketOffsets[bucket]) : nullptr;
     }
 
     __device__ __inline__ void cleanup_system()
     {
-        auto partition =
-            calcPartition(_mapEntries.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        auto partition = calcPartition(
+            _occupiedBuckets.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
         for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
-            auto const& mapEntry = _mapEntries.at(index);
-            _map[mapEntry] = nullptr;
-            _map[mapEntry + 1] = nullptr;
+            _bucketSizes[_occupiedBuckets.at(index)] = 0;
         }
     }
 
 private:
-    Cell** _map;
-    Array<int> _mapEntries;
+    __device__ __inline__ int calcBucket(int2 pos) const
+    {
+        mapPosCorrection(pos);
+        return pos.x + pos.y * _size.x;
+    }
+
+    template <typename Func>
+    __device__ __inline__ void executeForEachInBucket(int2 const& pos, Func const& func) const
+    {
+        auto bucket = calcBucket(pos);
+        auto offset = _bucketOffsets[bucket];
+        for (int i = 0, size = _bucketSizes[bucket]; i < size; ++i) {
+            func(_entries.at(offset + i));
+        }
+    }
+
+    int* _bucketSizes;  //zero outside of occupied buckets
+    int* _bucketOffsets;  //only valid for occupied buckets
+    Array<int2> _cellBuckets;  //bucket and rank for each entry in cellPointers
+    Array<Cell*> _entries;
+    Array<int> _occupiedBuckets;
 };
 
 class ParticleMap : public MapInfo
@@ -75,6 +75,11 @@ __inline__ __device__ bool operator==(int2 const& p, int2 const& q)
     return p.x == q.x && p.y == q.y;
 }
 
+__inline__ __device__ bool operator!=(float2 const& p, float2 const& q)
+{
+    return p.x != q.x || p.y != q.y;
+}
+
 /************************************************************************/
 /* Implementation                                                       */
 /************************************************************************/
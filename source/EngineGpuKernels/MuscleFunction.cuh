@@ -48,6 +48,7 @@ __inline__ __device__ void MuscleFunction::processing(Token* token, SimulationDa
             auto connectingCell = connection.cell;
             auto otherIndex = getConnectionIndex(connectingCell, cell);
             connectingCell->connections[otherIndex].distance *= factor;
+            data.markChanged(connectingCell);
         } else {
             tokenMem[Enums::Muscle::OUTPUT] = Enums::MuscleOut::LIMIT_REACHED;
             sourceCell->releaseLock();
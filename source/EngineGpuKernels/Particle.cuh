@@ -18,6 +18,9 @@ struct Particle
     //editing data
     int selected;  //0 = no, 1 = selected
 
+    //change tracking for delta extraction
+    uint64_t generation;  //data version at the last change
+
     //auxiliary data
     int locked;	//0 = unlocked, 1 = locked
 
@@ -37,8 +37,11 @@ __inline__ __device__ void ParticleProcessor::movement(SimulationData& data)
 
     for (int particleIndex = partition.startIndex; particleIndex <= partition.endIndex; ++particleIndex) {
         auto& particle = data.entities.particlePointers.at(particleIndex);
-        particle->absPos = particle->absPos + particle->vel;
-        data.particleMap.mapPosCorrection(particle->absPos);
+        if (particle->vel != float2{0, 0}) {
+            particle->absPos = particle->absPos + particle->vel;
+            data.particleMap.mapPosCorrection(particle->absPos);
+            data.markChanged(particle);
+        }
     }
 }
 
@@ -63,6 +66,8 @@ __inline__ __device__ void ParticleProcessor::collision(SimulationData& data)
                     otherParticle->vel = particle->vel * factor1 + otherParticle->vel * (1.0f - factor1);
                     otherParticle->energy += particle->energy;
                     particle->energy = 0;
+                    data.markChanged(otherParticle);
+                    data.logRemovedParticle(particle->id);
                     particle = nullptr;
                 }
 
@@ -78,9 +83,12 @@ __inline__ __device__ void ParticleProcessor::collision(SimulationData& data)
                     
                     atomicAdd(&cell->energy, particle->energy);
                     particle->energy = 0;
+                    data.markChanged(cell);
 
                     particle->releaseLock();
 
+                    data.logRemovedParticle(particle->id);
+
                     particle = nullptr;
                 }
                 cell->releaseLock();
@@ -102,8 +110,9 @@ __inline__ __device__ void ParticleProcessor::transformation(SimulationData& dat
                 EntityFactory factory;
                 factory.init(&data);
                 auto cell = factory.createRandomCell(particle->energy, particle->absPos, particle->vel);
-                cell->metadata.color = particle->metadata.color;
+                cell->cold->metadata.color = particle->metadata.color;
 
+                data.logRemovedParticle(particle->id);
                 particle = nullptr;
             }
         }
@@ -61,7 +61,7 @@ __inline__ __device__ void PropulsionFunction::processing(Token* token, Simulati
 
     EntityFactory factory;
     factory.init(&data);
-    factory.createParticle(energyCost, particlePos, particleVel, {cell->metadata.color});
+    factory.createParticle(energyCost, particlePos, particleVel, {cell->cold->metadata.color});
 
     token->energy -= energyCost;
 */
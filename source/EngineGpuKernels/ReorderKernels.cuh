@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cuda_runtime_api.h"
+
+#include "EngineInterface/EngineSettings.h"
+
+#include "CleanupKernels.cuh"
+#include "SimulationData.cuh"
+#include "Cell.cuh"
+#include "Particle.cuh"
+
+//sorts cells and particles along a space-filling curve such that entities which are close in space are also close
+//in memory
+namespace SpaceFillingCurve
+{
+    int const Order = 16;  //number of bits per coordinate
+
+    __device__ __inline__ unsigned int spreadBits(unsigned int value)
+    {
+        value &= 0x0000ffff;
+        value = (value | (value << 8)) & 0x00ff00ff;
+        value = (value | (value << 4)) & 0x0f0f0f0f;
+        value = (value | (value << 2)) & 0x33333333;
+        value = (value | (value << 1)) & 0x55555555;
+        return value;
+    }
+
+    __device__ __inline__ unsigned int mortonIndex(unsigned int x, unsigned int y)
+    {
+        return spreadBits(x) | (spreadBits(y) << 1);
+    }
+
+    __device__ __inline__ unsigned int hilbertIndex(unsigned int x, unsigned int y)
+    {
+        unsigned int const n = 1u << Order;
+        unsigned int result = 0;
+        for (unsigned int s = n / 2; s > 0; s /= 2) {
+            unsigned int rx = (x & s) > 0 ? 1 : 0;
+            unsigned int ry = (y & s) > 0 ? 1 : 0;
+            result += s * s * ((3 * rx) ^ ry);
+
+            //rotate quadrant
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = n - 1 - x;
+                    y = n - 1 - y;
+                }
+                auto temp = x;
+                x = y;
+                y = temp;
+            }
+        }
+        return result;
+    }
+
+    __device__ __inline__ unsigned int calcIndex(float2 const& pos, int2 const& worldSize, int curve)
+    {
+        auto const maxCoordinate = static_cast<float>((1u << Order) - 1);
+        auto x = static_cast<unsigned int>(min(max(pos.x / worldSize.x, 0.0f), 1.0f) * maxCoordinate);
+        auto y = static_cast<unsigned int>(min(max(pos.y / worldSize.y, 0.0f), 1.0f) * maxCoordinate);
+        return Enums::SpaceFillingCurve::HILBERT == curve ? hilbertIndex(x, y) : mortonIndex(x, y);
+    }
+}
+
+template <typename Entity>
+__global__ void
+calcSpaceFillingCurveIndices(Array<Entity*> pointers, unsigned int* indices, int2 worldSize, int curve)
+{
+    auto const partition =
+        calcPartition(pointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+
+    for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+        indices[index] = SpaceFillingCurve::calcIndex(pointers.at(index)->absPos, worldSize, curve);
+    }
+}
+
+/************************************************************************/
+/* Main                                                                 */
+/************************************************************************/
+
+//the pointer arrays are sorted on the host side by the returned indices
+__global__ void cudaCalcSpaceFillingCurveIndices(
+    SimulationData data,
+    unsigned int* cellIndices,
+    unsigned int* particleIndices,
+    int curve)
+{
+    KERNEL_CALL(calcSpaceFillingCurveIndices<Cell>, data.entities.cellPointers, cellIndices, data.size, curve);
+    KERNEL_CALL(
+        calcSpaceFillingCurveIndices<Particle>, data.entities.particlePointers, particleIndices, data.size, curve);
+}
+
+//the copy step of the cleanup preserves the order of the pointer arrays, thus the entities are stored along the
+//curve afterwards (up to the partition boundaries of the threads)
+__global__ void cudaReorderEntities(SimulationData data)
+{
+    data.entitiesForCleanup.particles.reset();
+    KERNEL_CALL(cleanupParticles, data.entities.particlePointers, data.entitiesForCleanup.particles);
+    data.entities.particles.swapContent(data.entitiesForCleanup.particles);
+
+    data.entitiesForCleanup.cells.reset();
+    data.entitiesForCleanup.cellColdData.reset();
+    KERNEL_CALL(
+        cleanupCellsStep1,
+        data.entities.cellPointers,
+        data.entitiesForCleanup.cells,
+        data.entitiesForCleanup.cellColdData);
+    KERNEL_CALL(cleanupCellsStep2, data.entities.tokenPointers, data.entitiesForCleanup.cells);
+    data.entities.cells.swapContent(data.entitiesForCleanup.cells);
+    data.entities.cellColdData.swapContent(data.entitiesForCleanup.cellColdData);
+}
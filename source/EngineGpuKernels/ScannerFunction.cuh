@@ -94,17 +94,17 @@ __inline__ __device__ void ScannerFunction::processing(Token* token, SimulationD
     tokenMem[Enums::Scanner::OUT_ENERGY] = cellEnergy;
     tokenMem[Enums::Scanner::OUT_CELL_MAX_CONNECTIONS] = lookupResult.prevCell->maxConnections;
     tokenMem[Enums::Scanner::OUT_CELL_BRANCH_NO] = lookupResult.prevCell->branchNumber;
-    tokenMem[Enums::Scanner::OUT_CELL_METADATA] = lookupResult.prevCell->metadata.color;
+    tokenMem[Enums::Scanner::OUT_CELL_METADATA] = lookupResult.prevCell->cold->metadata.color;
     tokenMem[Enums::Scanner::OUT_CELL_FUNCTION] = lookupResult.prevCell->getCellFunctionType();
-    tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA] = lookupResult.prevCell->numStaticBytes;
-    for (int i = 0; i < lookupResult.prevCell->numStaticBytes; ++i) {
-        tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + 1 + i] = lookupResult.prevCell->staticData[i];
+    tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA] = lookupResult.prevCell->cold->numStaticBytes;
+    for (int i = 0; i < lookupResult.prevCell->cold->numStaticBytes; ++i) {
+        tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + 1 + i] = lookupResult.prevCell->cold->staticData[i];
     }
-    int mutableDataIndex = lookupResult.prevCell->numStaticBytes + 1;
-    tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex] = lookupResult.prevCell->numMutableBytes;
-    for (int i = 0; i < lookupResult.prevCell->numMutableBytes; ++i) {
+    int mutableDataIndex = lookupResult.prevCell->cold->numStaticBytes + 1;
+    tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex] = lookupResult.prevCell->cold->numMutableBytes;
+    for (int i = 0; i < lookupResult.prevCell->cold->numMutableBytes; ++i) {
         tokenMem[Enums::Scanner::OUT_CELL_FUNCTION_DATA + mutableDataIndex + 1 + i] =
-            lookupResult.prevCell->mutableData[i];
+            lookupResult.prevCell->cold->mutableData[i];
     }
 }
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+
+#include "VectorTypes.h"
+
+#include "Base/StageProfiler.h"
+
+#include "EngineInterface/OverallStatistics.h"
+#include "EngineInterface/Settings.h"
+#include "EngineInterface/SelectionShallowData.h"
+#include "EngineInterface/ShallowUpdateSelectionData.h"
+
+#include "Definitions.cuh"
+
+//interface of a simulation engine which is shared by the CUDA and the CPU implementation
+class _SimulationBackend
+{
+public:
+    virtual ~_SimulationBackend() = default;
+
+    struct ArraySizes
+    {
+        int cellArraySize;
+        int particleArraySize;
+        int tokenArraySize;
+
+        //upper bounds for the strings in the access data
+        int stringArraySize = 0;
+        int stringByteArraySize = 0;
+    };
+
+    virtual void* registerImageResource(GLuint image) = 0;
+
+    virtual void calcTimestep() = 0;
+
+    virtual void drawVectorGraphics(
+        float2 const& rectUpperLeft,
+        float2 const& rectLowerRight,
+        void* imageResource,
+        int2 const& imageSize,
+        double zoom) = 0;
+    virtual void
+    getSimulationData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO) = 0;
+    //clusters with at least one cell in the rectangle are written completely
+    virtual void
+    getClusterData(int2 const& rectUpperLeft, int2 const& rectLowerRight, DataAccessTO const& dataTO) = 0;
+    virtual void
+    getOverlayData(int2 const& rectUpperLeft, int2 const& rectLowerRight, OverlayAccessTO const& overlayTO) = 0;
+
+    //the world is divided into square tiles in row-major order for exporting it in chunks
+    //each cluster belongs to the first tile which contains one of its cells
+    //returns the sizes of the access data needed by each tile
+    virtual std::vector<ArraySizes> getExportTileSizes(int tileSize) = 0;
+    //writes the clusters belonging to the tile and the particles in the tile
+    //prerequisite: getExportTileSizes has been called for the same tile size and the simulation has not changed since
+    virtual void getExportTileData(int tileSize, int tile, DataAccessTO const& dataTO) = 0;
+
+    struct DataDelta
+    {
+        uint64_t version = 0;   //has to be passed to the next delta request
+        bool complete = false;  //true = all entities in the rectangle are contained since the delta was not available
+        int numChangedCells = 0;  //further cells in the access data are only referenced by connections
+        std::vector<uint64_t> removedCellIds;  //deleted or moved out of the rectangle
+        std::vector<uint64_t> removedParticleIds;
+    };
+    //writes the entities which have been created or modified after sinceVersion, 0 = all entities
+    virtual DataDelta getSimulationDataDelta(
+        int2 const& rectUpperLeft,
+        int2 const& rectLowerRight,
+        uint64_t sinceVersion,
+        DataAccessTO const& dataTO) = 0;
+    virtual void setSimulationData(DataAccessTO const& dataTO) = 0;
+    //the entities are added to the existing ones, e.g. for uploading a world in several batches
+    virtual void addSimulationData(DataAccessTO const& dataTO) = 0;
+
+    virtual void applyForce(ApplyForceData const& applyData) = 0;
+    virtual void switchSelection(SwitchSelectionData const& switchData) = 0;
+    virtual void setSelection(SetSelectionData const& selectionData) = 0;
+    virtual SelectionShallowData getSelectionShallowData() = 0;
+    virtual void shallowUpdateSelection(ShallowUpdateSelectionData const& shallowUpdateData) = 0;
+    virtual void removeSelection() = 0;
+
+    virtual void setGpuConstants(GpuSettings const& cudaConstants) = 0;
+    virtual void setEngineSettings(EngineSettings const& engineSettings) = 0;
+    virtual void setSimulationParameters(SimulationParameters const& parameters) = 0;
+    virtual void setSimulationParametersSpots(SimulationParametersSpots const& spots) = 0;
+    virtual void setFlowFieldSettings(FlowFieldSettings const& settings) = 0;
+
+    virtual ArraySizes getArraySizes() const = 0;
+
+    virtual OverallStatistics getMonitorData() = 0;
+    virtual vector<StageStatistics> getStageStatistics() const = 0;
+    virtual uint64_t getCurrentTimestep() const = 0;
+    virtual void setCurrentTimestep(uint64_t timestep) = 0;
+
+    virtual void clear() = 0;
+
+    virtual void resizeArraysIfNecessary(ArraySizes const& additionals) = 0;
+};
@@ -1,14 +1,18 @@
 #pragma once
 
 #include <atomic>
+#include <limits>
 
 #include "EngineInterface/GpuSettings.h"
 
 #include "Base.cuh"
 #include "Definitions.cuh"
+#include "DynamicMemory.cuh"
 #include "Entities.cuh"
 #include "CellFunctionData.cuh"
 #include "Operation.cuh"
+#include "StringTable.cuh"
+#include "TileIndex.cuh"
 
 struct SimulationData
 {
@@ -16,10 +20,13 @@ struct SimulationData
 
     CellMap cellMap;
     ParticleMap particleMap;
+    TileIndex<Cell> cellTiles;  //for region queries, built on demand
+    TileIndex<Particle> particleTiles;
     CellFunctionData cellFunctionData;
 
     Entities entities;
     Entities entitiesForCleanup;
+    StringTable strings;  //for the metadata of the cells
 
     unsigned int* numOperations;
     Operation* operations;  //uses dynamic memory
@@ -27,20 +34,39 @@ struct SimulationData
     DynamicMemory dynamicMemory;
     CudaNumberGenerator numberGen;
 
+    //ids of entities which have been deleted since the last delta extraction
+    Array<uint64_t> removedCellIds;
+    Array<uint64_t> removedParticleIds;
+    int* removedIdsOverflow;
+
+    //version of the next delta, is stamped on each entity which is created or changed
+    uint64_t dataVersion = 0;
+
     void init(int2 const& universeSize)
     {
         size = universeSize;
 
-        entities.init();
-        entitiesForCleanup.init();
+        //entity arrays grow in place up to a bound which is derived from the world size
+        auto maxEntities = static_cast<int>(std::min(
+            std::max(static_cast<uint64_t>(size.x) * size.y * Const::MaxEntitiesPerArea, Const::MinReservedEntities),
+            static_cast<uint64_t>(std::numeric_limits<int>::max() / 10)));
+        entities.init(maxEntities);
+        entitiesForCleanup.init(maxEntities);
         cellFunctionData.init(universeSize);
         cellMap.init(size);
         particleMap.init(size);
+        cellTiles.init(size);
+        particleTiles.init(size);
 
         dynamicMemory.init();
-        numberGen.init(40312357);   //some array size for random numbers (~ 40 MB)
+        strings.init();
+        numberGen.init();
+        removedCellIds.init();
+        removedParticleIds.init();
 
         CudaMemoryManager::getInstance().acquireMemory<unsigned int>(1, numOperations);
+        CudaMemoryManager::getInstance().acquireMemory<int>(1, removedIdsOverflow);
+        CHECK_FOR_CUDA_ERROR(cudaMemset(removedIdsOverflow, 0, sizeof(int)));
     }
 
     __device__ void prepareForSimulation()
@@ -55,42 +81,92 @@ struct SimulationData
 
     __device__ int getMaxOperations() { return entities.cellPointers.getNumEntries(); }
 
-    bool shouldResize(int additionalCells, int additionalParticles, int additionalTokens)
+    template <typename Entity>
+    __device__ void markChanged(Entity* entity) const
+    {
+        entity->generation = dataVersion;
+    }
+
+    __device__ void logRemovedCell(uint64_t id) { logRemovedId(removedCellIds, id); }
+    __device__ void logRemovedParticle(uint64_t id) { logRemovedId(removedParticleIds, id); }
+
+    bool shouldResize(int additionalCells, int additionalParticles, int additionalTokens, float fillLevelFactor)
     {
         auto cellAndParticleArraySizeInc = std::max(additionalCells, additionalParticles);
         auto tokenArraySizeInc = std::max(additionalTokens, cellAndParticleArraySizeInc / 3);
 
-        return entities.cells.shouldResize_host(cellAndParticleArraySizeInc)
-            || entities.cellPointers.shouldResize_host(cellAndParticleArraySizeInc * 10)
-            || entities.particles.shouldResize_host(cellAndParticleArraySizeInc)
-            || entities.particlePointers.shouldResize_host(cellAndParticleArraySizeInc * 10)
-            || entities.tokens.shouldResize_host(tokenArraySizeInc)
-            || entities.tokenPointers.shouldResize_host(tokenArraySizeInc * 10);
+        return entities.cells.shouldResize_host(cellAndParticleArraySizeInc, fillLevelFactor)
+            || entities.cellColdData.shouldResize_host(cellAndParticleArraySizeInc, fillLevelFactor)
+            || entities.cellPointers.shouldResize_host(cellAndParticleArraySizeInc * 10, fillLevelFactor)
+            || entities.particles.shouldResize_host(cellAndParticleArraySizeInc, fillLevelFactor)
+            || entities.particlePointers.shouldResize_host(cellAndParticleArraySizeInc * 10, fillLevelFactor)
+            || entities.tokens.shouldResize_host(tokenArraySizeInc, fillLevelFactor)
+            || entities.tokenPointers.shouldResize_host(tokenArraySizeInc * 10, fillLevelFactor);
     }
 
-    __device__ bool shouldResize()
+    __device__ bool shouldResize(float fillLevelFactor)
     {
-        return entities.cells.shouldResize(0) || entities.cellPointers.shouldResize(0)
-            || entities.particles.shouldResize(0) || entities.particlePointers.shouldResize(0)
-            || entities.tokens.shouldResize(0) || entities.tokenPointers.shouldResize(0);
+        return entities.cells.shouldResize(0, fillLevelFactor) || entities.cellPointers.shouldResize(0, fillLevelFactor)
+            || entities.cellColdData.shouldResize(0, fillLevelFactor)
+            || entities.particles.shouldResize(0, fillLevelFactor)
+            || entities.particlePointers.shouldResize(0, fillLevelFactor)
+            || entities.tokens.shouldResize(0, fillLevelFactor)
+            || entities.tokenPointers.shouldResize(0, fillLevelFactor);
+    }
+
+    //arrays grow in place => entities are not copied
+    void resizeEntities(int additionalCells, int additionalParticles, int additionalTokens, float fillLevelFactor)
+    {
+        auto cellAndParticleArraySizeInc = std::max(additionalCells, additionalParticles);
+        auto tokenArraySizeInc = std::max(additionalTokens, cellAndParticleArraySizeInc / 3);
+
+        resizeIntern(entities.cells, entitiesForCleanup.cells, cellAndParticleArraySizeInc, fillLevelFactor);
+        resizeIntern(
+            entities.cellColdData, entitiesForCleanup.cellColdData, cellAndParticleArraySizeInc, fillLevelFactor);
+        resizeIntern(
+            entities.cellPointers, entitiesForCleanup.cellPointers, cellAndParticleArraySizeInc * 10, fillLevelFactor);
+        resizeIntern(entities.particles, entitiesForCleanup.particles, cellAndParticleArraySizeInc, fillLevelFactor);
+        resizeIntern(
+            entities.particlePointers,
+            entitiesForCleanup.particlePointers,
+            cellAndParticleArraySizeInc * 10,
+            fillLevelFactor);
+        resizeIntern(entities.tokens, entitiesForCleanup.tokens, tokenArraySizeInc, fillLevelFactor);
+        resizeIntern(
+            entities.tokenPointers, entitiesForCleanup.tokenPointers, tokenArraySizeInc * 10, fillLevelFactor);
     }
 
-    void resizeEntitiesForCleanup(int additionalCells, int additionalParticles, int additionalTokens)
+    //used if virtual memory management is not supported => entities are copied to the arrays for cleanup
+    void resizeEntitiesForCleanup(
+        int additionalCells,
+        int additionalParticles,
+        int additionalTokens,
+        float fillLevelFactor)
     {
         auto cellAndParticleArraySizeInc = std::max(additionalCells, additionalParticles);
         auto tokenArraySizeInc = std::max(additionalTokens, cellAndParticleArraySizeInc / 3);
 
-        resizeTargetIntern(entities.cells, entitiesForCleanup.cells, cellAndParticleArraySizeInc);
-        resizeTargetIntern(entities.cellPointers, entitiesForCleanup.cellPointers, cellAndParticleArraySizeInc * 10);
-        resizeTargetIntern(entities.particles, entitiesForCleanup.particles, cellAndParticleArraySizeInc);
-        resizeTargetIntern(entities.particlePointers, entitiesForCleanup.particlePointers, cellAndParticleArraySizeInc * 10);
-        resizeTargetIntern(entities.tokens, entitiesForCleanup.tokens, tokenArraySizeInc);
-        resizeTargetIntern(entities.tokenPointers, entitiesForCleanup.tokenPointers, tokenArraySizeInc * 10);
+        resizeTargetIntern(entities.cells, entitiesForCleanup.cells, cellAndParticleArraySizeInc, fillLevelFactor);
+        resizeTargetIntern(
+            entities.cellColdData, entitiesForCleanup.cellColdData, cellAndParticleArraySizeInc, fillLevelFactor);
+        resizeTargetIntern(
+            entities.cellPointers, entitiesForCleanup.cellPointers, cellAndParticleArraySizeInc * 10, fillLevelFactor);
+        resizeTargetIntern(
+            entities.particles, entitiesForCleanup.particles, cellAndParticleArraySizeInc, fillLevelFactor);
+        resizeTargetIntern(
+            entities.particlePointers,
+            entitiesForCleanup.particlePointers,
+            cellAndParticleArraySizeInc * 10,
+            fillLevelFactor);
+        resizeTargetIntern(entities.tokens, entitiesForCleanup.tokens, tokenArraySizeInc, fillLevelFactor);
+        resizeTargetIntern(
+            entities.tokenPointers, entitiesForCleanup.tokenPointers, tokenArraySizeInc * 10, fillLevelFactor);
     }
 
     void resizeRemainings()
     {
         entities.cells.resize(entitiesForCleanup.cells.getSize_host());
+        entities.cellColdData.resize(entitiesForCleanup.cellColdData.getSize_host());
         entities.cellPointers.resize(entitiesForCleanup.cellPointers.getSize_host());
         entities.particles.resize(entitiesForCleanup.particles.getSize_host());
         entities.particlePointers.resize(entitiesForCleanup.particlePointers.getSize_host());
@@ -100,6 +176,10 @@ struct SimulationData
         auto cellArraySize = entities.cells.getSize_host();
         cellMap.resize(cellArraySize);
         particleMap.resize(cellArraySize);
+        removedCellIds.resize(cellArraySize);
+        removedParticleIds.resize(entities.particles.getSize_host());
+        cellTiles.resize(cellArraySize, entities.cellPointers.getSize_host());
+        particleTiles.resize(entities.particles.getSize_host(), entities.particlePointers.getSize_host());
 
         int upperBoundDynamicMemory = sizeof(Operation) * (cellArraySize + 1000);
         dynamicMemory.resize(upperBoundDynamicMemory);
@@ -114,6 +194,7 @@ struct SimulationData
     void swap()
     {
         entities.cells.swapContent_host(entitiesForCleanup.cells);
+        entities.cellColdData.swapContent_host(entitiesForCleanup.cellColdData);
         entities.cellPointers.swapContent_host(entitiesForCleanup.cellPointers);
         entities.particles.swapContent_host(entitiesForCleanup.particles);
         entities.particlePointers.swapContent_host(entitiesForCleanup.particlePointers);
@@ -128,17 +209,50 @@ struct SimulationData
         cellFunctionData.free();
         cellMap.free();
         particleMap.free();
+        cellTiles.free();
+        particleTiles.free();
         numberGen.free();
         dynamicMemory.free();
+        strings.free();
+        removedCellIds.free();
+        removedParticleIds.free();
 
         CudaMemoryManager::getInstance().freeMemory(numOperations);
+        CudaMemoryManager::getInstance().freeMemory(removedIdsOverflow);
     }
 
 private:
+    __device__ void logRemovedId(Array<uint64_t>& ids, uint64_t id)
+    {
+        if (auto entry = ids.tryGetNewElement()) {
+            *entry = id;
+        } else {
+            atomicExch(removedIdsOverflow, 1);
+        }
+    }
+
+    template <typename Entity>
+    void resizeIntern(
+        Array<Entity>& array,
+        Array<Entity>& arrayForCleanup,
+        int additionalEntities,
+        float fillLevelFactor)
+    {
+        if (array.shouldResize_host(additionalEntities, fillLevelFactor)) {
+            auto newSize = (array.getNumEntries_host() + additionalEntities) * 2;
+            array.resize(newSize);
+            arrayForCleanup.resize(newSize);
+        }
+    }
+
     template <typename Entity>
-    void resizeTargetIntern(Array<Entity> const& sourceArray, Array<Entity>& targetArray, int additionalEntities)
+    void resizeTargetIntern(
+        Array<Entity> const& sourceArray,
+        Array<Entity>& targetArray,
+        int additionalEntities,
+        float fillLevelFactor)
     {
-        if (sourceArray.shouldResize_host(additionalEntities)) {
+        if (sourceArray.shouldResize_host(additionalEntities, fillLevelFactor)) {
             auto newSize = (sourceArray.getNumEntries_host() + additionalEntities) * 2;
             targetArray.resize(newSize);
         }
@@ -21,7 +21,6 @@ __global__ void processingStep1(SimulationData data)
     CellProcessor cellProcessor;
     cellProcessor.init(data);
     cellProcessor.clearTag(data);
-    cellProcessor.updateMap(data);
     cellProcessor.radiation(data);  //do not use ParticleProcessor in this kernel
 }
 
@@ -111,27 +110,83 @@ __global__ void processingStep12(SimulationData data, int numParticlePointers)
 /* Main      															*/
 /************************************************************************/
 
-__global__ void calcSimulationTimestepKernel(SimulationData data, SimulationResult result)
+//stages in the order of execution: flow field, cell map, processing steps 1 to 12 and cleanup
+int const NumSimulationStages = 15;
+
+__device__ void calcSimulationStage(int stage, SimulationData& data, SimulationResult& result, float fillLevelFactor)
+{
+    //the number of entries has to be determined before each step since it may be changed during the step
+    switch (stage) {
+    case 0:
+        KERNEL_CALL_1_1(applyFlowFieldSettingsKernel, data);
+        break;
+    case 1:
+        KERNEL_CALL_1_1(cudaBuildCellMap, data);
+        break;
+    case 2:
+        KERNEL_CALL(processingStep1, data);
+        break;
+    case 3:
+        KERNEL_CALL(processingStep2, data);
+        break;
+    case 4:
+        KERNEL_CALL(processingStep3, data);
+        break;
+    case 5:
+        KERNEL_CALL(processingStep4, data, data.entities.tokenPointers.getNumEntries());
+        break;
+    case 6:
+        KERNEL_CALL(processingStep5, data);
+        break;
+    case 7:
+        KERNEL_CALL(processingStep6, data, result);
+        break;
+    case 8:
+        KERNEL_CALL(processingStep7, data, data.entities.cellPointers.getNumEntries());
+        break;
+    case 9:
+        KERNEL_CALL(processingStep8, data, result, data.entities.tokenPointers.getNumEntries());
+        break;
+    case 10:
+        KERNEL_CALL(processingStep9, data);
+        break;
+    case 11:
+        KERNEL_CALL(processingStep10, data);
+        break;
+    case 12:
+        KERNEL_CALL(processingStep11, data);
+        break;
+    case 13:
+        KERNEL_CALL(processingStep12, data, data.entities.particlePointers.getNumEntries());
+        break;
+    case 14:
+        KERNEL_CALL_1_1(cleanupAfterSimulationKernel, data, fillLevelFactor);
+        result.setArrayResizeNeeded(data.shouldResize(fillLevelFactor));
+        break;
+    }
+}
+
+//used when the stages are launched one by one: the operation array lies in the dynamic memory and its address has
+//to be passed to the host copy of the simulation data
+__global__ void prepareForSimulationKernel(SimulationData data, SimulationResult result, Operation** operations)
 {
     data.prepareForSimulation();
     result.resetStatistics();
+    *operations = data.operations;
+}
 
-    KERNEL_CALL_1_1(applyFlowFieldSettingsKernel, data);
-    KERNEL_CALL(processingStep1, data);
-    KERNEL_CALL(processingStep2, data);
-    KERNEL_CALL(processingStep3, data);
-    KERNEL_CALL(processingStep4, data, data.entities.tokenPointers.getNumEntries());
-    KERNEL_CALL(processingStep5, data);
-    KERNEL_CALL(processingStep6, data, result);
-    KERNEL_CALL(processingStep7, data, data.entities.cellPointers.getNumEntries());
-    KERNEL_CALL(processingStep8, data, result, data.entities.tokenPointers.getNumEntries());
-    KERNEL_CALL(processingStep9, data);
-    KERNEL_CALL(processingStep10, data);
-    KERNEL_CALL(processingStep11, data);
-    KERNEL_CALL(processingStep12, data, data.entities.particlePointers.getNumEntries());
-
-    KERNEL_CALL_1_1(cleanupAfterSimulationKernel, data);
-
-    result.setArrayResizeNeeded(data.shouldResize());
+__global__ void
+calcSimulationStageKernel(int stage, SimulationData data, SimulationResult result, float fillLevelFactor)
+{
+    calcSimulationStage(stage, data, result, fillLevelFactor);
 }
 
+__global__ void calcSimulationTimestepKernel(SimulationData data, SimulationResult result, float fillLevelFactor)
+{
+    data.prepareForSimulation();
+    result.resetStatistics();
+
+    for (int stage = 0; stage < NumSimulationStages; ++stage) {
+        calcSimulationStage(stage, data, result, fillLevelFactor);
+    }
+}
@@ -0,0 +1,443 @@
+#pragma once
+
+#include <algorithm>
+
+#include <cuda_runtime.h>
+#include <device_launch_parameters.h>
+#include <cuda/helper_cuda.h>
+
+#include "AccessTOs.cuh"
+#include "Base.cuh"
+#include "Cell.cuh"
+#include "CudaMemoryManager.cuh"
+#include "Swap.cuh"
+
+//metadata strings are interned such that cells with equal strings share one entry, id 0 denotes the empty string
+//entries are reference counted by the cells and freed by the garbage collection in the cleanup kernels
+//strings are only interned when access data is added => the host reserves the capacity before
+class StringTable
+{
+public:
+    __host__ __inline__ void init()
+    {
+        CudaMemoryManager::getInstance().acquireMemory<int>(1, _numEntries);
+        CudaMemoryManager::getInstance().acquireMemory<int>(1, _numFreeIds);
+        CudaMemoryManager::getInstance().acquireMemory<char*>(1, _bytes);
+        CudaMemoryManager::getInstance().acquireMemory<char*>(1, _bytesForCleanup);
+        CudaMemoryManager::getInstance().acquireMemory<unsigned long long int>(1, _numBytes);
+        CudaMemoryManager::getInstance().acquireMemory<unsigned long long int>(1, _numBytesForCleanup);
+        CudaMemoryManager::getInstance().acquireMemory<int>(1, _numUnreferenced);
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_numEntries, 0, sizeof(int)));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_numFreeIds, 0, sizeof(int)));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_numBytes, 0, sizeof(unsigned long long int)));
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_numUnreferenced, 0, sizeof(int)));
+
+        resizeEntries(InitialMaxEntries, 0, 0);
+        resizeInternedIds(InitialMaxEntries);
+        resizeBytes(InitialMaxBytes, 0);
+    }
+
+    __host__ __inline__ void free()
+    {
+        auto bytes = getBytes_host(_bytes);
+        auto bytesForCleanup = getBytes_host(_bytesForCleanup);
+        CudaMemoryManager::getInstance().freeMemory(bytes);
+        CudaMemoryManager::getInstance().freeMemory(bytesForCleanup);
+        CudaMemoryManager::getInstance().freeMemory(_entries);
+        CudaMemoryManager::getInstance().freeMemory(_freeIds);
+        CudaMemoryManager::getInstance().freeMemory(_slots);
+        CudaMemoryManager::getInstance().freeMemory(_internedIds);
+        CudaMemoryManager::getInstance().freeMemory(_numEntries);
+        CudaMemoryManager::getInstance().freeMemory(_numFreeIds);
+        CudaMemoryManager::getInstance().freeMemory(_bytes);
+        CudaMemoryManager::getInstance().freeMemory(_bytesForCleanup);
+        CudaMemoryManager::getInstance().freeMemory(_numBytes);
+        CudaMemoryManager::getInstance().freeMemory(_numBytesForCleanup);
+        CudaMemoryManager::getInstance().freeMemory(_numUnreferenced);
+        _maxEntries = 0;
+        _maxBytes = 0;
+        _numSlots = 0;
+        _maxInternedIds = 0;
+    }
+
+    //has to be called before access data with the given strings is added
+    //returns true if the index has been reallocated and has to be rebuilt by rebuildIndex_system
+    __host__ __inline__ bool reserve(int additionalStrings, int additionalBytes)
+    {
+        int numEntries;
+        int numFreeIds;
+        unsigned long long int numBytes;
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(&numEntries, _numEntries, sizeof(int), cudaMemcpyDeviceToHost));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(&numFreeIds, _numFreeIds, sizeof(int), cudaMemcpyDeviceToHost));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(&numBytes, _numBytes, sizeof(unsigned long long int), cudaMemcpyDeviceToHost));
+
+        if (additionalStrings > _maxInternedIds) {
+            resizeInternedIds(additionalStrings * 2);
+        }
+        if (numBytes + additionalBytes > _maxBytes) {
+            resizeBytes((numBytes + additionalBytes) * 2, numBytes);
+        }
+        if (numEntries + additionalStrings > _maxEntries) {
+            resizeEntries((numEntries + additionalStrings) * 2, numEntries, numFreeIds);
+            return true;
+        }
+        return false;
+    }
+
+    //upper bound for the bytes of the strings which are copied to access data
+    __host__ __inline__ uint64_t getMaxBytes() const { return _maxBytes; }
+
+    /************************************************************************/
+    /* Interning                                                            */
+    /************************************************************************/
+    //the returned id does not carry a reference yet
+    __device__ __inline__ int intern(char const* data, int numBytes)
+    {
+        if (0 == numBytes) {
+            return 0;
+        }
+        auto const hash = calcHash(data, numBytes);
+
+        //the entry is created before it is published in the index => no thread waits for another one
+        int newId = 0;
+        for (auto slot = hash & (_numSlots - 1);; slot = (slot + 1) & (_numSlots - 1)) {
+            auto id = atomicAdd(&_slots[slot], 0);
+            if (0 == id) {
+                if (0 == newId) {
+                    newId = createEntry(hash, data, numBytes);
+                }
+                id = atomicCAS(&_slots[slot], 0, newId);
+                if (0 == id) {
+                    return newId;
+                }
+            }
+
+            //an entry created in vain remains unreferenced and is freed by the next garbage collection
+            if (isEqual(id, hash, data, numBytes)) {
+                return id;
+            }
+        }
+    }
+
+    //interns the strings of access data which is added, their ids are then available via getInternedId
+    __device__ __inline__ void internAccessStrings_system(DataAccessTO const& accessTO)
+    {
+        auto const partition =
+            calcPartition(*accessTO.numStrings, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& stringTO = accessTO.strings[index];
+            _internedIds[index] = intern(&accessTO.stringBytes[stringTO.byteIndex], stringTO.numBytes);
+        }
+    }
+
+    __device__ __inline__ int getInternedId(int stringIndex) const
+    {
+        return -1 == stringIndex ? 0 : _internedIds[stringIndex];
+    }
+
+    __device__ __inline__ void addReferences(CellMetadata const& metadata)
+    {
+        addReference(metadata.nameId);
+        addReference(metadata.descriptionId);
+        addReference(metadata.sourceCodeId);
+    }
+
+    __device__ __inline__ void removeReferences(CellMetadata const& metadata)
+    {
+        removeReference(metadata.nameId);
+        removeReference(metadata.descriptionId);
+        removeReference(metadata.sourceCodeId);
+    }
+
+    __device__ __inline__ int getNumBytes(int id) const { return 0 == id ? 0 : _entries[id - 1].numBytes; }
+
+    /************************************************************************/
+    /* Garbage collection                                                   */
+    /************************************************************************/
+    __device__ __inline__ bool isGarbageCollectionNeeded() const { return *_numUnreferenced > 0; }
+
+    __device__ __inline__ void prepareForGarbageCollection()
+    {
+        *_numUnreferenced = 0;
+        *_numBytesForCleanup = 0;
+    }
+
+    //frees the unreferenced entries and copies the bytes of the others without gaps to the buffer for cleanup
+    __device__ __inline__ void collectGarbage_system()
+    {
+        auto const partition =
+            calcPartition(*_numEntries, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        auto const bytes = *_bytes;
+        auto const bytesForCleanup = *_bytesForCleanup;
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto& entry = _entries[index];
+            if (0 == entry.numBytes) {
+                continue;
+            }
+            if (0 == entry.numReferences) {
+                entry.numBytes = 0;
+                _freeIds[atomicAdd(_numFreeIds, 1)] = index + 1;
+                continue;
+            }
+            auto byteIndex = atomicAdd(_numBytesForCleanup, static_cast<unsigned long long int>(entry.numBytes));
+            for (int i = 0; i < entry.numBytes; ++i) {
+                bytesForCleanup[byteIndex + i] = bytes[entry.byteIndex + i];
+            }
+            entry.byteIndex = byteIndex;
+        }
+    }
+
+    __device__ __inline__ void swapBytes()
+    {
+        swap(*_bytes, *_bytesForCleanup);
+        swap(*_numBytes, *_numBytesForCleanup);
+    }
+
+    __device__ __inline__ void clearIndex_system()
+    {
+        auto const partition = calcPartition(_numSlots, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int slot = partition.startIndex; slot <= partition.endIndex; ++slot) {
+            _slots[slot] = 0;
+        }
+    }
+
+    //prerequisite: the index is cleared
+    __device__ __inline__ void rebuildIndex_system()
+    {
+        auto const partition =
+            calcPartition(*_numEntries, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& entry = _entries[index];
+            if (0 == entry.numBytes) {
+                continue;
+            }
+            auto slot = entry.hash & (_numSlots - 1);
+            while (0 != atomicCAS(&_slots[slot], 0, index + 1)) {
+                slot = (slot + 1) & (_numSlots - 1);
+            }
+        }
+    }
+
+    //the index has to be cleared separately
+    __device__ __inline__ void reset()
+    {
+        *_numEntries = 0;
+        *_numFreeIds = 0;
+        *_numBytes = 0;
+        *_numUnreferenced = 0;
+    }
+
+    /************************************************************************/
+    /* Data access                                                          */
+    /************************************************************************/
+    //has to be called before strings are copied to new access data
+    __device__ __inline__ void prepareForAccess_system()
+    {
+        auto const partition =
+            calcPartition(*_numEntries, threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            _entries[index].accessIndex = -1;
+        }
+    }
+
+    //each entry is copied at most once to the access data, returns the index of the copy or -1 for id 0
+    __device__ __inline__ int getAccessIndex(int id, DataAccessTO const& accessTO)
+    {
+        if (0 == id) {
+            return -1;
+        }
+        auto& entry = _entries[id - 1];
+        auto accessIndex = atomicAdd(&entry.accessIndex, 0);
+        if (accessIndex >= 0) {
+            return accessIndex;
+        }
+
+        //the access index is reserved before it is published => no thread waits for another one
+        //a reserved index which loses the race remains an empty string in the access data
+        accessIndex = atomicAdd(accessTO.numStrings, 1);
+        auto& stringTO = accessTO.strings[accessIndex];
+        auto origAccessIndex = atomicCAS(&entry.accessIndex, -1, accessIndex);
+        if (-1 != origAccessIndex) {
+            stringTO.numBytes = 0;
+            stringTO.byteIndex = 0;
+            return origAccessIndex;
+        }
+        stringTO.numBytes = entry.numBytes;
+        stringTO.byteIndex = atomicAdd(accessTO.numStringBytes, entry.numBytes);
+        auto const bytes = *_bytes;
+        for (int i = 0; i < entry.numBytes; ++i) {
+            accessTO.stringBytes[stringTO.byteIndex + i] = bytes[entry.byteIndex + i];
+        }
+        return accessIndex;
+    }
+
+private:
+    static int const InitialMaxEntries = 1 << 16;
+    static uint64_t const InitialMaxBytes = 1 << 22;
+
+    struct Entry
+    {
+        unsigned long long int byteIndex;
+        int numBytes;  //0 for free entries
+        int numReferences;
+        int accessIndex;
+        unsigned int hash;
+    };
+
+    __device__ __inline__ static unsigned int calcHash(char const* data, int numBytes)
+    {
+        //FNV-1a
+        unsigned int result = 2166136261u;
+        for (int i = 0; i < numBytes; ++i) {
+            result = (result ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        }
+        return result;
+    }
+
+    __device__ __inline__ int createEntry(unsigned int hash, char const* data, int numBytes)
+    {
+        auto id = allocateId();
+        auto byteIndex = atomicAdd(_numBytes, static_cast<unsigned long long int>(numBytes));
+        if (id > _maxEntries || byteIndex + numBytes > _maxBytes) {
+            printf("Not enough string memory!\n");
+            ABORT();
+        }
+        auto const bytes = *_bytes;
+        for (int i = 0; i < numBytes; ++i) {
+            bytes[byteIndex + i] = data[i];
+        }
+        auto& entry = _entries[id - 1];
+        entry.byteIndex = byteIndex;
+        entry.numBytes = numBytes;
+        entry.numReferences = 0;
+        entry.accessIndex = -1;
+        entry.hash = hash;
+
+        //unreferenced until a cell refers to it
+        atomicAdd(_numUnreferenced, 1);
+        __threadfence();
+        return id;
+    }
+
+    __device__ __inline__ int allocateId()
+    {
+        auto numFreeIds = atomicAdd(_numFreeIds, 0);
+        while (numFreeIds > 0) {
+            auto origNumFreeIds = atomicCAS(_numFreeIds, numFreeIds, numFreeIds - 1);
+            if (origNumFreeIds == numFreeIds) {
+                return _freeIds[numFreeIds - 1];
+            }
+            numFreeIds = origNumFreeIds;
+        }
+        return atomicAdd(_numEntries, 1) + 1;
+    }
+
+    __device__ __inline__ bool isEqual(int id, unsigned int hash, char const* data, int numBytes) const
+    {
+        auto const& entry = _entries[id - 1];
+        if (entry.hash != hash || entry.numBytes != numBytes) {
+            return false;
+        }
+        auto const bytes = *_bytes;
+        for (int i = 0; i < numBytes; ++i) {
+            if (bytes[entry.byteIndex + i] != data[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    __device__ __inline__ void addReference(int id)
+    {
+        if (0 != id) {
+            atomicAdd(&_entries[id - 1].numReferences, 1);
+        }
+    }
+
+    __device__ __inline__ void removeReference(int id)
+    {
+        if (0 != id && 1 == atomicSub(&_entries[id - 1].numReferences, 1)) {
+            atomicAdd(_numUnreferenced, 1);
+        }
+    }
+
+    __host__ __inline__ static char* getBytes_host(char** bytes)
+    {
+        char* result;
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(&result, bytes, sizeof(char*), cudaMemcpyDeviceToHost));
+        return result;
+    }
+
+    //the index is reallocated with at least twice as many slots as entries
+    __host__ __inline__ void resizeEntries(int maxEntries, int numEntries, int numFreeIds)
+    {
+        Entry* entries;
+        int* freeIds;
+        CudaMemoryManager::getInstance().acquireMemory<Entry>(maxEntries, entries);
+        CudaMemoryManager::getInstance().acquireMemory<int>(maxEntries, freeIds);
+        if (_maxEntries > 0) {
+            CHECK_FOR_CUDA_ERROR(
+                cudaMemcpy(entries, _entries, sizeof(Entry) * numEntries, cudaMemcpyDeviceToDevice));
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(freeIds, _freeIds, sizeof(int) * numFreeIds, cudaMemcpyDeviceToDevice));
+            CudaMemoryManager::getInstance().freeMemory(_entries);
+            CudaMemoryManager::getInstance().freeMemory(_freeIds);
+            CudaMemoryManager::getInstance().freeMemory(_slots);
+        }
+        _entries = entries;
+        _freeIds = freeIds;
+        _maxEntries = maxEntries;
+
+        _numSlots = 1;
+        while (_numSlots < maxEntries * 2) {
+            _numSlots *= 2;
+        }
+        CudaMemoryManager::getInstance().acquireMemory<int>(_numSlots, _slots);
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_slots, 0, sizeof(int) * _numSlots));
+    }
+
+    __host__ __inline__ void resizeInternedIds(int maxInternedIds)
+    {
+        CudaMemoryManager::getInstance().freeMemory(_internedIds);
+        CudaMemoryManager::getInstance().acquireMemory<int>(maxInternedIds, _internedIds);
+        _maxInternedIds = maxInternedIds;
+    }
+
+    //the bytes of the buffer for cleanup are not preserved since it is only used during the garbage collection
+    __host__ __inline__ void resizeBytes(uint64_t maxBytes, uint64_t numBytes)
+    {
+        char* bytes;
+        char* bytesForCleanup;
+        CudaMemoryManager::getInstance().acquireMemory<char>(maxBytes, bytes);
+        CudaMemoryManager::getInstance().acquireMemory<char>(maxBytes, bytesForCleanup);
+        if (_maxBytes > 0) {
+            auto origBytes = getBytes_host(_bytes);
+            auto origBytesForCleanup = getBytes_host(_bytesForCleanup);
+            CHECK_FOR_CUDA_ERROR(cudaMemcpy(bytes, origBytes, numBytes, cudaMemcpyDeviceToDevice));
+            CudaMemoryManager::getInstance().freeMemory(origBytes);
+            CudaMemoryManager::getInstance().freeMemory(origBytesForCleanup);
+        }
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(_bytes, &bytes, sizeof(char*), cudaMemcpyHostToDevice));
+        CHECK_FOR_CUDA_ERROR(cudaMemcpy(_bytesForCleanup, &bytesForCleanup, sizeof(char*), cudaMemcpyHostToDevice));
+        _maxBytes = maxBytes;
+    }
+
+    int _maxEntries = 0;
+    int _numSlots = 0;  //power of two
+    int _maxInternedIds = 0;
+    uint64_t _maxBytes = 0;
+
+    Entry* _entries = nullptr;  //entry of id i is at index i - 1
+    int* _numEntries;  //highest id which has been assigned
+    int* _freeIds = nullptr;
+    int* _numFreeIds;
+    int* _slots = nullptr;  //open addressing from the hash of the string to its id, 0 = empty slot
+    int* _internedIds = nullptr;  //ids of the strings of the access data which is added
+
+    //pointers to the buffers such that they can be swapped by the device
+    char** _bytes;
+    char** _bytesForCleanup;
+    unsigned long long int* _numBytes;
+    unsigned long long int* _numBytesForCleanup;
+
+    int* _numUnreferenced;
+};
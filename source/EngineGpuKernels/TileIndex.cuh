@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Array.cuh"
+#include "Base.cuh"
+#include "Map.cuh"
+
+//coarse spatial index for region queries: the entities are sorted into square tiles by a counting sort
+//it is rebuilt at the end of each time step and after data manipulations which move entities
+template <typename Entity>
+class TileIndex : public MapInfo
+{
+public:
+    static int const TileSize = 16;
+
+    __host__ __inline__ void init(int2 const& size)
+    {
+        MapInfo::init(size);
+        _numTiles = {(size.x + TileSize - 1) / TileSize, (size.y + TileSize - 1) / TileSize};
+        CudaMemoryManager::getInstance().acquireMemory<int>(_numTiles.x * _numTiles.y, _tileSizes);
+        CudaMemoryManager::getInstance().acquireMemory<int>(_numTiles.x * _numTiles.y, _tileOffsets);
+        _entityTiles.init();
+        _entries.init();
+        _occupiedTiles.init();
+        _occupiedTiles.resize(_numTiles.x * _numTiles.y);
+        _valid = false;
+
+        CHECK_FOR_CUDA_ERROR(cudaMemset(_tileSizes, 0, sizeof(int) * _numTiles.x * _numTiles.y));
+    }
+
+    __host__ __inline__ void resize(int entityArraySize, int pointerArraySize)
+    {
+        _entityTiles.resize(pointerArraySize);
+        _entries.resize(entityArraySize);
+        _valid = false;
+    }
+
+    __host__ __inline__ void free()
+    {
+        CudaMemoryManager::getInstance().freeMemory(_tileSizes);
+        CudaMemoryManager::getInstance().freeMemory(_tileOffsets);
+        _entityTiles.free();
+        _entries.free();
+        _occupiedTiles.free();
+    }
+
+    __host__ __inline__ void setValid(bool value) { _valid = value; }
+    __host__ __inline__ bool isValid() const { return _valid; }
+
+    //pass 0 of the build: clear the tiles of the previous build
+    __device__ __inline__ void cleanup_system()
+    {
+        auto partition = calcPartition(
+            _occupiedTiles.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            _tileSizes[_occupiedTiles.at(index)] = 0;
+        }
+    }
+
+    __device__ __inline__ void reset()
+    {
+        _entries.reset();
+        _occupiedTiles.reset();
+    }
+
+    //pass 1: determine tile sizes and the rank of each entity within its tile
+    __device__ __inline__ void countEntities_system(Array<Entity*> const& pointers)
+    {
+        auto partition =
+            calcPartition(pointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& entity = pointers.at(index);
+            if (!entity) {
+                _entityTiles.at(index) = {-1, 0};
+                continue;
+            }
+            auto tile = calcTile(entity->absPos);
+            auto rank = atomicAdd(&_tileSizes[tile], 1);
+            if (0 == rank) {
+                *_occupiedTiles.getNewElement() = tile;
+            }
+            _entityTiles.at(index) = {tile, rank};
+        }
+    }
+
+    //pass 2: reserve a contiguous range of entries for each occupied tile
+    __device__ __inline__ void allocateTiles_system()
+    {
+        auto partition = calcPartition(
+            _occupiedTiles.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto tile = _occupiedTiles.at(index);
+            auto tileEntries = _entries.getNewSubarray(_tileSizes[tile]);
+            _tileOffsets[tile] = static_cast<int>(tileEntries - _entries.getArray());
+        }
+    }
+
+    //pass 3: scatter the entities into their ranges
+    __device__ __inline__ void fillTiles_system(Array<Entity*> const& pointers)
+    {
+        auto partition =
+            calcPartition(pointers.getNumEntries(), threadIdx.x + blockIdx.x * blockDim.x, blockDim.x * gridDim.x);
+        for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+            auto const& tileAndRank = _entityTiles.at(index);
+            if (tileAndRank.x >= 0) {
+                _entries.at(_tileOffsets[tileAndRank.x] + tileAndRank.y) = pointers.at(index);
+            }
+        }
+    }
+
+    //calls func for each entity in the tiles intersecting the rectangle (the entities themselves may lie outside)
+    //the tiles are partitioned among the blocks and the entities of a tile among the threads of a block
+    template <typename Func>
+    __device__ __inline__ void
+    executeForEachInRect_system(int2 const& rectUpperLeft, int2 const& rectLowerRight, Func const& func) const
+    {
+        int2 tileUpperLeft{max(rectUpperLeft.x, 0) / TileSize, max(rectUpperLeft.y, 0) / TileSize};
+        int2 tileLowerRight{
+            min(rectLowerRight.x / TileSize, _numTiles.x - 1), min(rectLowerRight.y / TileSize, _numTiles.y - 1)};
+        if (tileUpperLeft.x > tileLowerRight.x || tileUpperLeft.y > tileLowerRight.y) {
+            return;
+        }
+
+        auto numTilesX = tileLowerRight.x - tileUpperLeft.x + 1;
+        auto numTilesInRect = numTilesX * (tileLowerRight.y - tileUpperLeft.y + 1);
+        auto const tilePartition = calcPartition(numTilesInRect, blockIdx.x, gridDim.x);
+        for (int tileIndex = tilePartition.startIndex; tileIndex <= tilePartition.endIndex; ++tileIndex) {
+            auto tileX = tileUpperLeft.x + tileIndex % numTilesX;
+            auto tileY = tileUpperLeft.y + tileIndex / numTilesX;
+            auto tile = tileX + tileY * _numTiles.x;
+            auto tileSize = _tileSizes[tile];
+            if (0 == tileSize) {
+                continue;
+            }
+            auto offset = _tileOffsets[tile];
+            auto const partition = calcPartition(tileSize, threadIdx.x, blockDim.x);
+            for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
+                func(_entries.at(offset + index));
+            }
+        }
+    }
+
+private:
+    __device__ __inline__ int calcTile(float2 pos) const
+    {
+        mapPosCorrection(pos);
+        auto x = min(floorInt(pos.x) / TileSize, _numTiles.x - 1);
+        auto y = min(floorInt(pos.y) / TileSize, _numTiles.y - 1);
+        return x + y * _numTiles.x;
+    }
+
+    int2 _numTiles;
+    bool _valid = false;  //only used on the host
+    int* _tileSizes;  //zero outside of occupied tiles
+    int* _tileOffsets;  //only valid for occupied tiles
+    Array<int2> _entityTiles;  //tile and rank for each entry in the pointer array
+    Array<Entity*> _entries;
+    Array<int> _occupiedTiles;
+};
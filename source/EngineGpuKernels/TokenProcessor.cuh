@@ -39,7 +39,8 @@ __inline__ __device__ void TokenProcessor::movement(SimulationData& data, int nu
     for (int index = partition.startIndex; index <= partition.endIndex; ++index) {
         auto& token = tokens.at(index);
         auto cell = token->cell;
-        atomicAdd(&cell->tokenUsages, 1);
+        atomicAdd(&cell->cold->tokenUsages, 1);
+        data.markChanged(cell);
 
         int numMovedTokens = 0;
         EntityFactory factory;
@@ -73,11 +74,13 @@ __inline__ __device__ void TokenProcessor::movement(SimulationData& data, int nu
                 if (0 == numMovedTokens) {
                     token->sourceCell = token->cell;
                     token->cell = connectedCell;
+                    data.markChanged(connectedCell);
                     ++numMovedTokens;
 
                     
-                    if (data.numberGen.random() < tokenMutationRate) {
-                        token->memory[data.numberGen.random(MAX_TOKEN_MEM_SIZE - 1)] = data.numberGen.random(255);
+                    if (data.numberGen.random(connectedCell) < tokenMutationRate) {
+                        auto memoryIndex = data.numberGen.random(connectedCell, MAX_TOKEN_MEM_SIZE - 1);
+                        token->memory[memoryIndex] = data.numberGen.random(connectedCell, 255);
                     }
                 } else {
                     auto origEnergy = atomicAdd(&connectedCell->energy, -token->energy); 
@@ -109,6 +112,7 @@ __inline__ __device__ void TokenProcessor::executeReadonlyCellFunctions(Simulati
         if (token) {
             auto cellFunctionType = cell->getCellFunctionType();
             if (cell->tryLock()) {
+                data.markChanged(cell);  //token memory may be changed
                 if (Enums::CellFunction::SCANNER == cellFunctionType) {
                     ScannerFunction::processing(token, data);
                 }
@@ -139,6 +143,7 @@ TokenProcessor::executeModifyingCellFunctions(SimulationData& data, SimulationRe
             do {
 */
                 if (cell->tryLock()) {
+                    data.markChanged(cell);
 
                     EnergyGuidance::processing(data, token);
                     if (Enums::CellFunction::COMPUTER == cellFunctionType) {
@@ -0,0 +1,28 @@
+#pragma once
+
+//vector types of the interface between the engines and the host code
+//they are taken from the CUDA toolkit if available, otherwise equivalent definitions are used such that the CPU
+//engine can be built without the toolkit
+#if __has_include(<vector_types.h>)
+#include <vector_types.h>
+#else
+struct alignas(8) float2
+{
+    float x, y;
+};
+
+struct float3
+{
+    float x, y, z;
+};
+
+struct alignas(8) int2
+{
+    int x, y;
+};
+
+struct int3
+{
+    int x, y, z;
+};
+#endif
@@ -28,12 +28,7 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
     auto& tokenMem = token->memory;
     tokenMem[Enums::Weapon::OUTPUT] = Enums::WeaponOut::NO_TARGET;
 
-    Cell* otherCells[18];
-    int numOtherCells;
-    data.cellMap.get(otherCells, 18, numOtherCells, cell->absPos, 1.6f);
-    for (int i = 0; i < numOtherCells; ++i) {
-        Cell* otherCell = otherCells[i];
-
+    data.cellMap.executeForEach(cell->absPos, 1.6f, [&](Cell* otherCell) {
         if (otherCell->tryLock()) {
             if (!isConnectedConnected(cell, otherCell)) {
                 auto energyToTransfer = otherCell->energy * cudaSimulationParameters.cellFunctionWeaponStrength + 1.0f;
@@ -69,7 +64,7 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
                     }
                     return false;
                 };
-                if (homogene && otherHomogene && !isColorSuperior(cell->metadata.color, otherCell->metadata.color)) {
+                if (homogene && otherHomogene && !isColorSuperior(cell->cold->metadata.color, otherCell->cold->metadata.color)) {
                     energyToTransfer = energyToTransfer * (1.0f - cellFunctionWeaponColorPenalty);
                 }
                 if (otherCell->numConnections > cell->numConnections + 1) {
@@ -86,6 +81,7 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
                 }
                 if (otherCell->energy > energyToTransfer) {
                     otherCell->energy -= energyToTransfer;
+                    data.markChanged(otherCell);
                     token->energy += energyToTransfer / 2;
                     cell->energy += energyToTransfer / 2;
                     token->memory[Enums::Weapon::OUTPUT] = Enums::WeaponOut::STRIKE_SUCCESSFUL;
@@ -94,7 +90,7 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
             }
             otherCell->releaseLock();
         }
-    }
+    });
     if (Enums::WeaponOut::NO_TARGET == token->memory[Enums::Weapon::OUTPUT]) {
         result.incFailedAttack();
     }
@@ -105,8 +101,8 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
         auto& pos = cell->absPos;
         float2 particleVel = (cell->vel * cudaSimulationParameters.radiationVelocityMultiplier)
             + float2{
-                (data.numberGen.random() - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation,
-                (data.numberGen.random() - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation};
+                (data.numberGen.random(cell) - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation,
+                (data.numberGen.random(cell) - 0.5f) * cudaSimulationParameters.radiationVelocityPerturbation};
         float2 particlePos = pos + Math::normalized(particleVel) * 1.5f;
         data.cellMap.mapPosCorrection(particlePos);
 
@@ -115,21 +111,21 @@ __inline__ __device__ void WeaponFunction::processing(Token* token, SimulationDa
         cell->energy -= radiationEnergy;
         EntityFactory factory;
         factory.init(&data);
-        auto particle = factory.createParticle(radiationEnergy, particlePos, particleVel, {cell->metadata.color});
+        auto particle = factory.createParticle(radiationEnergy, particlePos, particleVel, {cell->cold->metadata.color});
     }
 }
 
 __inline__ __device__ bool WeaponFunction::isHomogene(Cell* cell)
 {
-    int color = cell->metadata.color;
+    int color = cell->cold->metadata.color;
     for (int i = 0; i < cell->numConnections; ++i) {
         auto otherCell = cell->connections[i].cell;
-        if ((color % 7) != (otherCell->metadata.color % 7)) {
+        if ((color % 7) != (otherCell->cold->metadata.color % 7)) {
             return false;
         }
         for (int j = 0; j < otherCell->numConnections; ++j) {
             auto otherOtherCell = otherCell->connections[j].cell;
-            if ((color % 7) != (otherOtherCell->metadata.color % 7)) {
+            if ((color % 7) != (otherOtherCell->cold->metadata.color % 7)) {
                 return false;
             }
         }
@@ -1,92 +1,168 @@
 #include "AccessDataTOCache.h"
 
-_AccessDataTOCache::_AccessDataTOCache(GpuSettings const& gpuConstants)
-    : _gpuConstants(gpuConstants)
-{}
+#include <algorithm>
+
+#include "Base/Exceptions.h"
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
+#include "EngineInterface/EngineSettings.h"
 
-_AccessDataTOCache::~_AccessDataTOCache()
+namespace
 {
-    for (DataAccessTO const& dataTO : _freeDataTOs) {
-        deleteDataTO(dataTO);
-    }
-    for (DataAccessTO const& dataTO : _usedDataTOs) {
-        deleteDataTO(dataTO);
-    }
+    uint64_t const MinBufferBytes = 1 << 16;
+    int const SizeClassesPerPowerOfTwo = 4;  //=> at most 25% of a buffer remains unused
 }
 
+_AccessDataTOCache::_AccessDataTOCache(EngineSettings const& engineSettings)
+    : _memoryLimit(static_cast<uint64_t>(engineSettings.ACCESS_DATA_CACHE_LIMIT_MB) * 1024 * 1024)
+{}
+
+_AccessDataTOCache::~_AccessDataTOCache() = default;
+
 DataAccessTO _AccessDataTOCache::getDataTO(ArraySizes const& arraySizes)
 {
-    if (!_arraySizes || * _arraySizes != arraySizes) {
-        for (DataAccessTO const& dataTO : _freeDataTOs) {
-            deleteDataTO(dataTO);
-        }
-        for (DataAccessTO const& dataTO : _usedDataTOs) {
-            deleteDataTO(dataTO);
-        }
-        _freeDataTOs.clear();
-        _usedDataTOs.clear();
-        _arraySizes = arraySizes;
-    }
-
-    auto clear = [](auto& result) {
-            *result.numCells = 0;
-            *result.numParticles = 0;
-            *result.numTokens = 0;
-            *result.numStringBytes = 0;
-    };
+    std::lock_guard<std::mutex> lock(_mutex);
 
     DataAccessTO result;
-    if (!_freeDataTOs.empty()) {
-        result = *_freeDataTOs.begin();
-        _freeDataTOs.erase(_freeDataTOs.begin());
-        _usedDataTOs.emplace_back(result);
-
-        clear(result);
-        return result;
+    try {
+        auto counters = new int[5];
+        result.numCells = &counters[0];
+        result.numParticles = &counters[1];
+        result.numTokens = &counters[2];
+        result.numStrings = &counters[3];
+        result.numStringBytes = &counters[4];
+    } catch (std::bad_alloc const&) {
+        throw BugReportException("There is not sufficient CPU memory available.");
     }
-    result = getNewDataTO();
-    _usedDataTOs.emplace_back(result);
-    clear(result);
+    *result.numCells = 0;
+    *result.numParticles = 0;
+    *result.numTokens = 0;
+    *result.numStrings = 0;
+    *result.numStringBytes = 0;
+
+    result.cells = acquireArray<CellAccessTO>(ArrayType::Cells, arraySizes.cellArraySize);
+    result.particles = acquireArray<ParticleAccessTO>(ArrayType::Particles, arraySizes.particleArraySize);
+    result.tokens = acquireArray<TokenAccessTO>(ArrayType::Tokens, arraySizes.tokenArraySize);
+    result.strings = acquireArray<StringAccessTO>(ArrayType::Strings, arraySizes.stringArraySize);
+    result.stringBytes = acquireArray<char>(ArrayType::StringBytes, arraySizes.stringByteArraySize);
     return result;
 }
 
 void _AccessDataTOCache::releaseDataTO(DataAccessTO const& dataTO)
 {
-    auto usedDataTO = std::find_if(_usedDataTOs.begin(), _usedDataTOs.end(), [&dataTO](DataAccessTO const& usedDataTO) {
-        return usedDataTO == dataTO;
-    });
-    if (usedDataTO != _usedDataTOs.end()) {
-        _freeDataTOs.emplace_back(*usedDataTO);
-        _usedDataTOs.erase(usedDataTO);
-    }
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    delete[] dataTO.numCells;
+    releaseArray(dataTO.cells);
+    releaseArray(dataTO.particles);
+    releaseArray(dataTO.tokens);
+    releaseArray(dataTO.strings);
+    releaseArray(dataTO.stringBytes);
+    evictBuffersIfNecessary();
+}
+
+void _AccessDataTOCache::setMemoryLimit(uint64_t numBytes)
+{
+    _memoryLimit.store(numBytes);
+}
+
+auto _AccessDataTOCache::getStatistics() const -> Statistics
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
 }
 
-DataAccessTO _AccessDataTOCache::getNewDataTO()
+template <typename T>
+T* _AccessDataTOCache::acquireArray(ArrayType type, int numElements)
 {
+    auto sizeClass = calcSizeClass(sizeof(T) * static_cast<uint64_t>(std::max(numElements, 1)));
+    auto& bucket = _freeBuffersByBucket[calcBucket(type, sizeClass)];
+    if (!bucket.empty()) {
+        auto freeBuffer = bucket.back();
+        bucket.pop_back();
+
+        auto data = freeBuffer->data.get();
+        _usedBuffers.emplace(data, std::move(*freeBuffer));
+        _freeBuffers.erase(freeBuffer);
+        ++_statistics.numHits;
+        return reinterpret_cast<T*>(data);
+    }
+
+    //free buffers of other sizes may be evicted to stay within the limit
+    Buffer buffer;
+    buffer.numBytes = calcNumBytes(sizeClass);
+    buffer.sizeClass = sizeClass;
+    buffer.type = type;
+    _statistics.allocatedBytes += buffer.numBytes;
+    evictBuffersIfNecessary();
     try {
-        DataAccessTO result;
-        result.numCells = new int;
-        result.numParticles = new int;
-        result.numTokens = new int;
-        result.numStringBytes = new int;
-        result.cells = new CellAccessTO[_arraySizes->cellArraySize];
-        result.particles = new ParticleAccessTO[_arraySizes->particleArraySize];
-        result.tokens = new TokenAccessTO[_arraySizes->tokenArraySize];
-        result.stringBytes = new char[Const::MetadataMemorySize];
-        return result;
+        buffer.data.reset(new char[buffer.numBytes]);
     } catch (std::bad_alloc const&) {
+        _statistics.allocatedBytes -= buffer.numBytes;
         throw BugReportException("There is not sufficient CPU memory available.");
     }
+    ++_statistics.numMisses;
+
+    auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+    loggingService->logMessage(
+        Priority::Unimportant,
+        "access data cache: " + std::to_string(buffer.numBytes / (1024 * 1024)) + " MB allocated, "
+            + std::to_string(_statistics.allocatedBytes / (1024 * 1024)) + " MB in use, "
+            + std::to_string(_statistics.numHits) + " hits, " + std::to_string(_statistics.numMisses) + " misses, "
+            + std::to_string(_statistics.numEvictions) + " evictions");
+
+    auto data = buffer.data.get();
+    _usedBuffers.emplace(data, std::move(buffer));
+    return reinterpret_cast<T*>(data);
+}
+
+void _AccessDataTOCache::releaseArray(void* data)
+{
+    auto usedBuffer = _usedBuffers.find(data);
+    if (usedBuffer == _usedBuffers.end()) {
+        return;
+    }
+    _freeBuffers.emplace_front(std::move(usedBuffer->second));
+    _usedBuffers.erase(usedBuffer);
+
+    auto const& freeBuffer = _freeBuffers.front();
+    _freeBuffersByBucket[calcBucket(freeBuffer.type, freeBuffer.sizeClass)].emplace_back(_freeBuffers.begin());
+}
+
+void _AccessDataTOCache::evictBuffersIfNecessary()
+{
+    auto memoryLimit = _memoryLimit.load();
+    while (_statistics.allocatedBytes > memoryLimit && !_freeBuffers.empty()) {
+
+        //the least recently used buffer is also the least recently used one of its bucket
+        auto const& buffer = _freeBuffers.back();
+        _freeBuffersByBucket[calcBucket(buffer.type, buffer.sizeClass)].pop_front();
+        _statistics.allocatedBytes -= buffer.numBytes;
+        ++_statistics.numEvictions;
+        _freeBuffers.pop_back();
+    }
+}
+
+int _AccessDataTOCache::calcSizeClass(uint64_t numBytes)
+{
+    numBytes = std::max(numBytes, MinBufferBytes);
+    int exponent = 0;
+    while ((2ull << exponent) <= numBytes) {
+        ++exponent;
+    }
+    auto powerOfTwo = 1ull << exponent;
+    auto subClass = static_cast<int>(
+        (numBytes - powerOfTwo + powerOfTwo / SizeClassesPerPowerOfTwo - 1) / (powerOfTwo / SizeClassesPerPowerOfTwo));
+    return exponent * SizeClassesPerPowerOfTwo + subClass;
+}
+
+uint64_t _AccessDataTOCache::calcNumBytes(int sizeClass)
+{
+    auto powerOfTwo = 1ull << (sizeClass / SizeClassesPerPowerOfTwo);
+    return powerOfTwo + powerOfTwo / SizeClassesPerPowerOfTwo * (sizeClass % SizeClassesPerPowerOfTwo);
 }
 
-void _AccessDataTOCache::deleteDataTO(DataAccessTO const& dataTO)
+int _AccessDataTOCache::calcBucket(ArrayType type, int sizeClass)
 {
-    delete dataTO.numCells;
-    delete dataTO.numParticles;
-    delete dataTO.numTokens;
-    delete dataTO.numStringBytes;
-    delete[] dataTO.cells;
-    delete[] dataTO.particles;
-    delete[] dataTO.tokens;
-    delete[] dataTO.stringBytes;
+    return sizeClass * static_cast<int>(ArrayType::_Count) + static_cast<int>(type);
 }
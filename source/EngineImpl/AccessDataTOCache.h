@@ -1,41 +1,83 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "Base/Definitions.h"
 
 #include "EngineGpuKernels/AccessTOs.cuh"
 
 #include "Definitions.h"
 
+//pool for the host buffers of access data: the arrays are allocated in size classes and reused for requests of the
+//same class, unused buffers are freed in least recently used order when the memory limit is exceeded
 class _AccessDataTOCache
 {
 public:
-    _AccessDataTOCache(GpuSettings const& gpuConstants);
+    _AccessDataTOCache(EngineSettings const& engineSettings);
     ~_AccessDataTOCache();
 
+    //number of requested elements for each array
     struct ArraySizes
     {
         int cellArraySize;
         int particleArraySize;
         int tokenArraySize;
-
-        bool operator==(ArraySizes const& other) const
-        {
-            return cellArraySize == other.cellArraySize && particleArraySize == other.particleArraySize
-                && tokenArraySize == other.tokenArraySize;
-        }
-
-        bool operator!=(ArraySizes const& other) const { return !operator==(other); };
+        int stringArraySize;
+        int stringByteArraySize;
     };
     DataAccessTO getDataTO(ArraySizes const& arraySizes);
     void releaseDataTO(DataAccessTO const& dataTO);
 
+    void setMemoryLimit(uint64_t numBytes);
+
+    struct Statistics
+    {
+        uint64_t numHits = 0;
+        uint64_t numMisses = 0;
+        uint64_t numEvictions = 0;
+        uint64_t allocatedBytes = 0;
+    };
+    Statistics getStatistics() const;
+
 private:
-    DataAccessTO getNewDataTO();
-    void deleteDataTO(DataAccessTO const& dataTO);
+    enum class ArrayType
+    {
+        Cells,
+        Particles,
+        Tokens,
+        Strings,
+        StringBytes,
+        _Count
+    };
+    struct Buffer
+    {
+        std::unique_ptr<char[]> data;
+        uint64_t numBytes;
+        int sizeClass;
+        ArrayType type;
+    };
+    using BufferList = std::list<Buffer>;
 
-    GpuSettings _gpuConstants;
-    std::vector<DataAccessTO> _freeDataTOs;
-    std::vector<DataAccessTO> _usedDataTOs;
-    boost::optional<ArraySizes> _arraySizes;
-};
+    template <typename T>
+    T* acquireArray(ArrayType type, int numElements);
+    void releaseArray(void* data);
+    void evictBuffersIfNecessary();
 
+    static int calcSizeClass(uint64_t numBytes);
+    static uint64_t calcNumBytes(int sizeClass);
+    static int calcBucket(ArrayType type, int sizeClass);
+
+    mutable std::mutex _mutex;
+    std::atomic<uint64_t> _memoryLimit;
+
+    BufferList _freeBuffers;  //most recently used first
+    std::unordered_map<int, std::deque<BufferList::iterator>> _freeBuffersByBucket;  //most recently used last
+    std::unordered_map<void*, Buffer> _usedBuffers;
+
+    Statistics _statistics;
+};
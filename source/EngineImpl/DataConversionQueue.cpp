@@ -0,0 +1,35 @@
+#include "DataConversionQueue.h"
+
+_DataConversionQueue::_DataConversionQueue()
+{
+    _thread = std::thread(&_DataConversionQueue::run, this);
+}
+
+_DataConversionQueue::~_DataConversionQueue()
+{
+    {
+        std::unique_lock<std::mutex> uniqueLock(_mutex);
+        _isShutdown = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+}
+
+void _DataConversionQueue::run()
+{
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> uniqueLock(_mutex);
+            _condition.wait(uniqueLock, [this] { return _isShutdown || !_conversions.empty(); });
+            if (_conversions.empty()) {
+                return;
+            }
+            task = std::move(_conversions.front());
+            _conversions.pop_front();
+        }
+
+        //exceptions are passed to the future
+        task();
+    }
+}
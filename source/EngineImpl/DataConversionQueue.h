@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include "EngineInterface/Descriptions.h"
+
+#include "Definitions.h"
+
+//converts extracted access data to descriptions on a background thread such that the simulation is not blocked,
+//conversions are processed in the order of their requests
+class _DataConversionQueue
+{
+public:
+    _DataConversionQueue();
+    ~_DataConversionQueue();  //pending conversions are finished
+
+    template <typename Conversion>
+    auto add(Conversion&& conversion) -> std::future<decltype(conversion())>;
+
+private:
+    void run();
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::packaged_task<void()>> _conversions;
+    bool _isShutdown = false;
+    std::thread _thread;
+};
+
+template <typename Conversion>
+auto _DataConversionQueue::add(Conversion&& conversion) -> std::future<decltype(conversion())>
+{
+    std::packaged_task<decltype(conversion())()> task(std::forward<Conversion>(conversion));
+    auto result = task.get_future();
+    {
+        std::unique_lock<std::mutex> uniqueLock(_mutex);
+        _conversions.emplace_back([task = std::move(task)]() mutable { task(); });
+    }
+    _condition.notify_all();
+    return result;
+}
@@ -1,13 +1,99 @@
 #include "DataConverter.h"
 
 #include <algorithm>
-#include <boost/range/adaptor/map.hpp>
+#include <atomic>
+#include <string_view>
+#include <unordered_map>
 
 #include "Base/NumberGenerator.h"
 #include "Base/Exceptions.h"
+#include "Base/TaskPool.h"
 #include "EngineInterface/Descriptions.h"
 #include "EngineInterface/ChangeDescriptions.h"
+#include "EngineInterface/UnionFind.h"
 
+namespace
+{
+    int const MinEntitiesPerThread = 10000;
+
+    //splits [0, numEntities) into contiguous ranges which are processed by the shared worker threads
+    template <typename Func>
+    void executeInParallel(int numEntities, Func const& func)
+    {
+        TaskPool::getInstance().executeInParallel(numEntities, MinEntitiesPerThread, func);
+    }
+
+    //-1 marks a connected cell which has not been extracted, other indices have to refer to an extracted cell
+    bool isValidCellIndex(DataAccessTO const& dataTO, int cellIndex)
+    {
+        if (-1 == cellIndex) {
+            return false;
+        }
+        if (cellIndex < 0 || cellIndex >= *dataTO.numCells) {
+            throw BugReportException("Connected cell index out of range.");
+        }
+        return true;
+    }
+}
+
+class DataConverter::CellIndexByIdMap
+{
+public:
+    CellIndexByIdMap(int maxEntries)
+    {
+        while ((uint64_t(1) << _capacityBits) < static_cast<uint64_t>(maxEntries) * 2) {
+            ++_capacityBits;
+        }
+        //zero-initialized: id 0 marks an empty slot since all inserted ids are nonzero
+        _slots = std::vector<Slot>(uint64_t(1) << _capacityBits);
+    }
+
+    //the largest index wins if an id is inserted several times (same result as a sequential insert_or_assign)
+    void insert(uint64_t id, int index)
+    {
+        for (auto slotIndex = calcSlotIndex(id);; slotIndex = (slotIndex + 1) & calcMask()) {
+            auto& slot = _slots[slotIndex];
+            uint64_t slotId = 0;
+            if (slot.id.compare_exchange_strong(slotId, id, std::memory_order_relaxed) || slotId == id) {
+                auto cellIndex = slot.cellIndex.load(std::memory_order_relaxed);
+                while (cellIndex < index
+                       && !slot.cellIndex.compare_exchange_weak(cellIndex, index, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+        }
+    }
+
+    //returns -1 if id is not contained
+    int find(uint64_t id) const
+    {
+        for (auto slotIndex = calcSlotIndex(id);; slotIndex = (slotIndex + 1) & calcMask()) {
+            auto const& slot = _slots[slotIndex];
+            auto slotId = slot.id.load(std::memory_order_relaxed);
+            if (slotId == id) {
+                return slot.cellIndex.load(std::memory_order_relaxed);
+            }
+            if (slotId == 0) {
+                return -1;
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> id;
+        std::atomic<int> cellIndex;
+    };
+
+    uint64_t calcMask() const { return (uint64_t(1) << _capacityBits) - 1; }
+
+    //ids are mostly consecutive running numbers => consecutive ids are kept in neighboring slots for cache locality
+    uint64_t calcSlotIndex(uint64_t id) const { return (id ^ (id >> _capacityBits)) & calcMask(); }
+
+    int _capacityBits = 4;
+    std::vector<Slot> _slots;
+};
 
 DataConverter::DataConverter(
     SimulationParameters const& parameters,
@@ -22,28 +108,30 @@ DataDescription DataConverter::convertAccessTOtoDataDescription(DataAccessTO con
 	DataDescription result;
 
     //cells
-    std::vector<ClusterDescription> clusters;
-    std::unordered_set<int> freeCellIndices;
-    for (int i = 0; i < *dataTO.numCells; ++i) {
-        freeCellIndices.insert(i);
+    auto const numCells = *dataTO.numCells;
+    auto cellTOIndicesByCluster = calcClusters(dataTO);
+    auto const numClusters = static_cast<int>(cellTOIndicesByCluster.clusterOffsets.size()) - 1;
+
+    result.clusters.resize(numClusters);
+    for (int clusterIndex = 0; clusterIndex < numClusters; ++clusterIndex) {
+        auto& cluster = result.clusters[clusterIndex];
+        cluster.id = NumberGenerator::getInstance().getId();
+        cluster.cells.resize(cellTOIndicesByCluster.getClusterSize(clusterIndex));
     }
-    std::unordered_map<int, int> cellTOIndexToCellDescIndex;
-    std::unordered_map<int, int> cellTOIndexToClusterDescIndex;
-    int clusterDescIndex = 0;
-    while (!freeCellIndices.empty()) {
-        auto freeCellIndex = *freeCellIndices.begin();
-        auto createClusterData = scanAndCreateClusterDescription(dataTO, freeCellIndex, freeCellIndices);
-        clusters.emplace_back(createClusterData.cluster);
-
-        //update index maps
-        cellTOIndexToCellDescIndex.insert(
-            createClusterData.cellTOIndexToCellDescIndex.begin(), createClusterData.cellTOIndexToCellDescIndex.end());
-        for (auto const& cellTOIndex : createClusterData.cellTOIndexToCellDescIndex | boost::adaptors::map_keys) {
-            cellTOIndexToClusterDescIndex.emplace(cellTOIndex, clusterDescIndex);
+    std::vector<int> cellTOIndexToClusterDescIndex(numCells);
+    std::vector<int> cellTOIndexToCellDescIndex(numCells);
+    executeInParallel(numClusters, [&](int startIndex, int endIndex) {
+        for (int clusterIndex = startIndex; clusterIndex < endIndex; ++clusterIndex) {
+            auto& cells = result.clusters[clusterIndex].cells;
+            auto const cellTOIndices = cellTOIndicesByCluster.getCellTOIndices(clusterIndex);
+            for (int cellDescIndex = 0; cellDescIndex < static_cast<int>(cells.size()); ++cellDescIndex) {
+                auto const cellTOIndex = cellTOIndices[cellDescIndex];
+                cells[cellDescIndex] = createCellDescription(dataTO, cellTOIndex);
+                cellTOIndexToClusterDescIndex[cellTOIndex] = clusterIndex;
+                cellTOIndexToCellDescIndex[cellTOIndex] = cellDescIndex;
+            }
         }
-        ++clusterDescIndex;
-    }
-    result.addClusters(clusters);
+    });
 
     //tokens
     for (int i = 0; i < *dataTO.numTokens; ++i) {
@@ -53,8 +141,11 @@ DataDescription DataConverter::convertAccessTOtoDataDescription(DataAccessTO con
         for (int i = 0; i < _parameters.tokenMemorySize; ++i) {
             data[i] = token.memory[i];
         }
-        auto clusterDescIndex = cellTOIndexToClusterDescIndex.at(token.cellIndex);
-        auto cellDescIndex = cellTOIndexToCellDescIndex.at(token.cellIndex);
+        if (token.cellIndex < 0 || token.cellIndex >= numCells) {
+            throw BugReportException("Token cell index out of range.");
+        }
+        auto clusterDescIndex = cellTOIndexToClusterDescIndex[token.cellIndex];
+        auto cellDescIndex = cellTOIndexToCellDescIndex[token.cellIndex];
         CellDescription& cell = result.clusters.at(clusterDescIndex).cells.at(cellDescIndex);
 
         cell.addToken(TokenDescription().setEnergy(token.energy).setData(data));
@@ -76,15 +167,53 @@ DataDescription DataConverter::convertAccessTOtoDataDescription(DataAccessTO con
     return result;
 }
 
-OverlayDescription DataConverter::convertAccessTOtoOverlayDescription(DataAccessTO const& dataTO)
+DataDeltaDescription
+DataConverter::convertAccessTOtoDataDeltaDescription(DataAccessTO const& dataTO, int numChangedCells)
+{
+    DataDeltaDescription result;
+
+    //cells behind numChangedCells only serve for the resolution of connections
+    result.cells.reserve(numChangedCells);
+    for (int i = 0; i < numChangedCells; ++i) {
+        result.cells.emplace_back(createCellDescription(dataTO, i));
+    }
+
+    for (int i = 0; i < *dataTO.numTokens; ++i) {
+        TokenAccessTO const& token = dataTO.tokens[i];
+
+        std::string data(_parameters.tokenMemorySize, 0);
+        for (int i = 0; i < _parameters.tokenMemorySize; ++i) {
+            data[i] = token.memory[i];
+        }
+        if (token.cellIndex < 0 || token.cellIndex >= numChangedCells) {
+            throw BugReportException("Token cell index out of range.");
+        }
+        result.cells[token.cellIndex].addToken(TokenDescription().setEnergy(token.energy).setData(data));
+    }
+
+    result.particles.reserve(*dataTO.numParticles);
+    for (int i = 0; i < *dataTO.numParticles; ++i) {
+        ParticleAccessTO const& particle = dataTO.particles[i];
+        result.particles.emplace_back(ParticleDescription()
+                                          .setId(particle.id)
+                                          .setPos({particle.pos.x, particle.pos.y})
+                                          .setVel({particle.vel.x, particle.vel.y})
+                                          .setEnergy(particle.energy)
+                                          .setMetadata(ParticleMetadata().setColor(particle.metadata.color)));
+    }
+    return result;
+}
+
+OverlayDescription DataConverter::convertAccessTOtoOverlayDescription(OverlayAccessTO const& overlayTO)
 {
     OverlayDescription result;
-    result.elements.reserve(*dataTO.numCells);
-    for (int i = 0; i < *dataTO.numCells; ++i) {
-        auto const& cellTO = dataTO.cells[i];
+    auto numElements = std::min(*overlayTO.numElements, overlayTO.maxElements);
+    result.elements.reserve(numElements);
+    for (int i = 0; i < numElements; ++i) {
+        auto const& elementTO = overlayTO.elements[i];
         OverlayElementDescription element;
-        element.pos = {cellTO.pos.x, cellTO.pos.y};
-        element.cellType = static_cast<Enums::CellFunction::Type>(cellTO.cellFunctionType);
+        element.pos = {elementTO.pos.x, elementTO.pos.y};
+        element.cellType = static_cast<Enums::CellFunction::Type>(elementTO.cellFunctionType);
         result.elements.emplace_back(element);
     }
     return result;
@@ -92,24 +221,63 @@ OverlayDescription DataConverter::convertAccessTOtoOverlayDescription(DataAccess
 
 void DataConverter::convertDataDescriptionToAccessTO(DataAccessTO& result, DataChangeDescription const& description)
 {
-    unordered_map<uint64_t, int> cellIndexByIds;
-    for (auto const& cell : description.cells) {
-        if (cell.isAdded()) {
-            addCell(result, cell.getValue(), cellIndexByIds);
+    auto const layout = calcUploadLayout(result, description);
+    auto const numCells = static_cast<int>(layout.cells.size());
+    auto const numParticles = static_cast<int>(layout.particles.size());
+    auto const cellStartIndex = *result.numCells;
+    auto const particleStartIndex = *result.numParticles;
+
+    CellIndexByIdMap cellIndexByIds(numCells);
+    executeInParallel(numCells, [&](int startIndex, int endIndex) {
+        for (int i = startIndex; i < endIndex; ++i) {
+            cellIndexByIds.insert(layout.cellIds[i], cellStartIndex + i);
         }
-    }
-    for (auto const& cell : description.cells) {
-        if (cell.isAdded()) {
-            if (cell->id != 0) {
-                setConnections(result, cell.getValue(), cellIndexByIds);
+    });
+
+    std::atomic<bool> missingConnectedCell{false};
+    executeInParallel(numCells, [&](int startIndex, int endIndex) {
+        for (int i = startIndex; i < endIndex; ++i) {
+            auto const& cellDesc = *layout.cells[i];
+            auto const cellIndex = cellStartIndex + i;
+            addCell(
+                result,
+                cellDesc,
+                layout.cellIds[i],
+                cellIndex,
+                layout.tokenIndices[i],
+                &layout.cellStringIndices[i * 3]);
+            if (cellDesc.id != 0 && !setConnections(result, cellDesc, cellIndex, cellIndexByIds)) {
+                missingConnectedCell.store(true, std::memory_order_relaxed);
             }
         }
+    });
+    if (missingConnectedCell.load()) {
+        throw BugReportException("Connected cell not found.");
     }
-    for (auto const& particle : description.particles) {
-        if (particle.isAdded()) {
-            addParticle(result, particle.getValue());
+
+    executeInParallel(numParticles, [&](int startIndex, int endIndex) {
+        for (int i = startIndex; i < endIndex; ++i) {
+            addParticle(result, *layout.particles[i], layout.particleIds[i], particleStartIndex + i);
         }
-    }
+    });
+
+    auto const numStrings = static_cast<int>(layout.strings.size());
+    auto const stringStartIndex = *result.numStrings;
+    executeInParallel(numStrings, [&](int startIndex, int endIndex) {
+        for (int i = startIndex; i < endIndex; ++i) {
+            auto const& string = *layout.strings[i];
+            auto& stringTO = result.strings[stringStartIndex + i];
+            stringTO.numBytes = toInt(string.size());
+            stringTO.byteIndex = layout.stringByteIndices[i];
+            std::copy(string.begin(), string.end(), &result.stringBytes[stringTO.byteIndex]);
+        }
+    });
+
+    *result.numCells += numCells;
+    *result.numParticles += numParticles;
+    *result.numTokens = layout.tokenIndices.back();
+    *result.numStrings += numStrings;
+    *result.numStringBytes = layout.stringByteIndices.back();
 }
 
 namespace
@@ -135,58 +303,173 @@ namespace
     }
 }
 
-namespace
+auto DataConverter::calcUploadLayout(DataAccessTO const& dataTO, DataChangeDescription const& description) const
+    -> UploadLayout
 {
-    template <typename T>
-    void setInplaceDifference(std::unordered_set<T>& a, std::unordered_set<T> const& b)
-    {
-        for (auto const& element : b) {
-            a.erase(element);
+    UploadLayout result;
+    result.cells.reserve(description.cells.size());
+    for (auto const& cell : description.cells) {
+        if (cell.isAdded()) {
+            result.cells.emplace_back(&cell.getValue());
+        }
+    }
+    result.particles.reserve(description.particles.size());
+    for (auto const& particle : description.particles) {
+        if (particle.isAdded()) {
+            result.particles.emplace_back(&particle.getValue());
         }
     }
+
+    //new ids are assigned sequentially in order to keep them independent of the thread scheduling
+    auto const numCells = static_cast<int>(result.cells.size());
+    result.cellIds.resize(numCells);
+    result.tokenIndices.resize(numCells + 1);
+    result.cellStringIndices.resize(numCells * 3, -1);
+    result.tokenIndices[0] = *dataTO.numTokens;
+    result.stringByteIndices.emplace_back(*dataTO.numStringBytes);
+
+    std::unordered_map<std::string_view, int> stringIndexByValue;
+    auto getStringIndex = [&](std::string const& string) {
+        if (string.empty()) {
+            return -1;
+        }
+        auto stringIndex = *dataTO.numStrings + static_cast<int>(result.strings.size());
+        auto insertResult = stringIndexByValue.emplace(std::string_view(string), stringIndex);
+        if (insertResult.second) {
+            result.strings.emplace_back(&string);
+            result.stringByteIndices.emplace_back(result.stringByteIndices.back() + toInt(string.size()));
+        }
+        return insertResult.first->second;
+    };
+    for (int i = 0; i < numCells; ++i) {
+        auto const& cellDesc = *result.cells[i];
+        result.cellIds[i] = cellDesc.id == 0 ? NumberGenerator::getInstance().getId() : cellDesc.id;
+
+        auto numTokens = cellDesc.tokens.getOptionalValue() ? toInt(cellDesc.tokens->size()) : 0;
+        result.tokenIndices[i + 1] = result.tokenIndices[i] + numTokens;
+
+        if (cellDesc.metadata.getOptionalValue()) {
+            result.cellStringIndices[i * 3] = getStringIndex(cellDesc.metadata->name);
+            result.cellStringIndices[i * 3 + 1] = getStringIndex(cellDesc.metadata->description);
+            result.cellStringIndices[i * 3 + 2] = getStringIndex(cellDesc.metadata->computerSourcecode);
+        }
+    }
+
+    auto const numParticles = static_cast<int>(result.particles.size());
+    result.particleIds.resize(numParticles);
+    for (int i = 0; i < numParticles; ++i) {
+        auto const& particleDesc = *result.particles[i];
+        result.particleIds[i] = particleDesc.id == 0 ? NumberGenerator::getInstance().getId() : particleDesc.id;
+    }
+    return result;
 }
 
-auto DataConverter::scanAndCreateClusterDescription(
-    DataAccessTO const& dataTO,
-    int startCellIndex,
-    std::unordered_set<int>& freeCellIndices) const
-    -> CreateClusterReturnData
+auto DataConverter::calcClusters(DataAccessTO const& dataTO) const -> ClusterCells
 {
-    CreateClusterReturnData result; 
-
-    std::unordered_set<int> currentCellIndices;
-    currentCellIndices.insert(startCellIndex);
-    std::unordered_set<int> scannedCellIndices = currentCellIndices;
-
-    std::vector<CellDescription> cells;
-    std::unordered_set<int> nextCellIndices;
-    int cellDescIndex = 0;
-    do {
-        for (auto const& currentCellIndex : currentCellIndices) {
-            cells.emplace_back(createCellDescription(dataTO, currentCellIndex));
-            result.cellTOIndexToCellDescIndex.emplace(currentCellIndex, cellDescIndex);
-            auto const& cellTO = dataTO.cells[currentCellIndex];
+    auto const numCells = *dataTO.numCells;
+
+    //connected cells are united in parallel
+    UnionFind unionFind(numCells);
+    executeInParallel(numCells, [&](int startIndex, int endIndex) {
+        for (int cellTOIndex = startIndex; cellTOIndex < endIndex; ++cellTOIndex) {
+            auto const& cellTO = dataTO.cells[cellTOIndex];
             for (int i = 0; i < cellTO.numConnections; ++i) {
-                auto connectionTO = cellTO.connections[i];
-                if (scannedCellIndices.find(connectionTO.cellIndex) == scannedCellIndices.end()) {
-                    nextCellIndices.insert(connectionTO.cellIndex);
-                    scannedCellIndices.insert(connectionTO.cellIndex);
+                auto const connectedCellTOIndex = cellTO.connections[i].cellIndex;
+                if (isValidCellIndex(dataTO, connectedCellTOIndex)) {
+                    unionFind.unite(cellTOIndex, connectedCellTOIndex);
                 }
             }
-            ++cellDescIndex;
         }
-        currentCellIndices = nextCellIndices;
-        nextCellIndices.clear();
-    } while (!currentCellIndices.empty());
-
-    setInplaceDifference(freeCellIndices, scannedCellIndices);
+    });
+    std::vector<int> roots(numCells);
+    executeInParallel(numCells, [&](int startIndex, int endIndex) {
+        for (int cellTOIndex = startIndex; cellTOIndex < endIndex; ++cellTOIndex) {
+            roots[cellTOIndex] = unionFind.find(cellTOIndex);
+        }
+    });
+
+    //clusters are ordered by their smallest cell index
+    std::vector<int> clusterIndices(numCells, -1);
+    int numClusters = 0;
+    for (int cellTOIndex = 0; cellTOIndex < numCells; ++cellTOIndex) {
+        auto& clusterIndex = clusterIndices[roots[cellTOIndex]];
+        if (-1 == clusterIndex) {
+            clusterIndex = numClusters++;
+        }
+    }
 
-    result.cluster.id = NumberGenerator::getInstance().getId();
-    result.cluster.addCells(cells);
+    //CSR layout with the cells of each cluster in ascending order
+    ClusterCells result;
+    result.clusterOffsets.resize(numClusters + 1, 0);
+    for (int cellTOIndex = 0; cellTOIndex < numCells; ++cellTOIndex) {
+        ++result.clusterOffsets[clusterIndices[roots[cellTOIndex]] + 1];
+    }
+    for (int clusterIndex = 1; clusterIndex <= numClusters; ++clusterIndex) {
+        result.clusterOffsets[clusterIndex] += result.clusterOffsets[clusterIndex - 1];
+    }
+    result.cellTOIndices.resize(numCells);
+    std::vector<int> positionsInCluster(numCells);
+    auto insertPositions = result.clusterOffsets;
+    for (int cellTOIndex = 0; cellTOIndex < numCells; ++cellTOIndex) {
+        auto const clusterIndex = clusterIndices[roots[cellTOIndex]];
+        positionsInCluster[cellTOIndex] = insertPositions[clusterIndex] - result.clusterOffsets[clusterIndex];
+        result.cellTOIndices[insertPositions[clusterIndex]++] = cellTOIndex;
+    }
 
+    //the cells within a cluster are reordered by a breadth-first scan from their smallest cell index
+    executeInParallel(numClusters, [&](int startIndex, int endIndex) {
+        std::vector<int> orderedCellTOIndices;
+        std::vector<bool> visited;
+        for (int clusterIndex = startIndex; clusterIndex < endIndex; ++clusterIndex) {
+            auto const cellTOIndices = &result.cellTOIndices[result.clusterOffsets[clusterIndex]];
+            auto const clusterSize = result.getClusterSize(clusterIndex);
+            if (clusterSize > 1) {
+                orderCellsByScan(dataTO, positionsInCluster, cellTOIndices, clusterSize, orderedCellTOIndices, visited);
+            }
+        }
+    });
     return result;
 }
 
+void DataConverter::orderCellsByScan(
+    DataAccessTO const& dataTO,
+    std::vector<int> const& positionsInCluster,
+    int* cellTOIndices,
+    int clusterSize,
+    std::vector<int>& orderedCellTOIndices,
+    std::vector<bool>& visited) const
+{
+    //the ordered cells serve as queue, visited cells are marked by their position in the cluster
+    orderedCellTOIndices.clear();
+    visited.assign(clusterSize, false);
+    orderedCellTOIndices.emplace_back(cellTOIndices[0]);
+    visited[0] = true;
+    for (int queueIndex = 0; queueIndex < toInt(orderedCellTOIndices.size()); ++queueIndex) {
+        auto const& cellTO = dataTO.cells[orderedCellTOIndices[queueIndex]];
+        for (int i = 0; i < cellTO.numConnections; ++i) {
+            auto const connectedCellIndex = cellTO.connections[i].cellIndex;
+            if (!isValidCellIndex(dataTO, connectedCellIndex)) {
+                continue;
+            }
+            auto const position = positionsInCluster[connectedCellIndex];
+            if (!visited[position]) {
+                visited[position] = true;
+                orderedCellTOIndices.emplace_back(connectedCellIndex);
+            }
+        }
+    }
+
+    //cells which are only reachable against the direction of connections are appended
+    if (toInt(orderedCellTOIndices.size()) < clusterSize) {
+        for (int position = 0; position < clusterSize; ++position) {
+            if (!visited[position]) {
+                orderedCellTOIndices.emplace_back(cellTOIndices[position]);
+            }
+        }
+    }
+    std::copy(orderedCellTOIndices.begin(), orderedCellTOIndices.end(), cellTOIndices);
+}
+
 CellDescription DataConverter::createCellDescription(DataAccessTO const& dataTO, int cellIndex) const
 {
     CellDescription result;
@@ -200,6 +483,9 @@ CellDescription DataConverter::createCellDescription(DataAccessTO const& dataTO,
     std::vector<ConnectionDescription> connections;
     for (int i = 0; i < cellTO.numConnections; ++i) {
         auto const& connectionTO = cellTO.connections[i];
+        if (!isValidCellIndex(dataTO, connectionTO.cellIndex)) {
+            continue;  //connected cell lies outside of the extracted region
+        }
         ConnectionDescription connection;
         connection.cellId = dataTO.cells[connectionTO.cellIndex].id;
         connection.distance = connectionTO.distance;
@@ -211,22 +497,11 @@ CellDescription DataConverter::createCellDescription(DataAccessTO const& dataTO,
     result.tokenBranchNumber = cellTO.branchNumber;
 
     auto const& metadataTO = cellTO.metadata;
-    auto metadata = CellMetadata().setColor(metadataTO.color);
-    if (metadataTO.nameLen > 0) {
-        auto const name = std::string(&dataTO.stringBytes[metadataTO.nameStringIndex], metadataTO.nameLen);
-        metadata.setName(name);
-    }
-    if (metadataTO.descriptionLen > 0) {
-        auto const description =
-            std::string(&dataTO.stringBytes[metadataTO.descriptionStringIndex], metadataTO.descriptionLen);
-        metadata.setDescription(description);
-    }
-    if (metadataTO.sourceCodeLen > 0) {
-        auto const sourceCode =
-            std::string(&dataTO.stringBytes[metadataTO.sourceCodeStringIndex], metadataTO.sourceCodeLen);
-        metadata.setSourceCode(sourceCode);
-    }
-    result.metadata = metadata;
+    result.metadata = CellMetadata()
+                          .setColor(metadataTO.color)
+                          .setName(getString(dataTO, metadataTO.nameStringIndex))
+                          .setDescription(getString(dataTO, metadataTO.descriptionStringIndex))
+                          .setSourceCode(getString(dataTO, metadataTO.sourceCodeStringIndex));
 
     auto feature = CellFeatureDescription()
                        .setType(static_cast<Enums::CellFunction::Type>(cellTO.cellFunctionType))
@@ -238,37 +513,39 @@ CellDescription DataConverter::createCellDescription(DataAccessTO const& dataTO,
     return result;
 }
 
-void DataConverter::addParticle(DataAccessTO const& dataTO, ParticleDescription const& particleDesc)
+void DataConverter::addParticle(
+    DataAccessTO const& dataTO,
+    ParticleChangeDescription const& particleDesc,
+    uint64_t id,
+    int particleIndex) const
 {
-    auto particleIndex = (*dataTO.numParticles)++;
-
 	ParticleAccessTO& particleTO = dataTO.particles[particleIndex];
-	particleTO.id = particleDesc.id == 0 ? NumberGenerator::getInstance().getId() : particleDesc.id;
-	particleTO.pos = { particleDesc.pos.x, particleDesc.pos.y };
-	particleTO.vel = { particleDesc.vel.x, particleDesc.vel.y };
-	particleTO.energy = toFloat(particleDesc.energy);
-    particleTO.metadata.color = particleDesc.metadata.color;
+	particleTO.id = id;
+	particleTO.pos = { particleDesc.pos->x, particleDesc.pos->y };
+	particleTO.vel = { particleDesc.vel->x, particleDesc.vel->y };
+	particleTO.energy = toFloat(*particleDesc.energy);
+    particleTO.metadata.color = particleDesc.metadata->color;
 }
 
-int DataConverter::convertStringAndReturnStringIndex(DataAccessTO const& dataTO, std::string const& s)
+std::string DataConverter::getString(DataAccessTO const& dataTO, int stringIndex) const
 {
-    auto result = *dataTO.numStringBytes;
-    int len = static_cast<int>(s.size());
-    for (int i = 0; i < len; ++i) {
-        dataTO.stringBytes[result + i] = s.at(i);
+    if (stringIndex < 0 || stringIndex >= *dataTO.numStrings) {
+        return std::string();
     }
-    (*dataTO.numStringBytes) += len;
-    return result;
+    auto const& stringTO = dataTO.strings[stringIndex];
+    return std::string(&dataTO.stringBytes[stringTO.byteIndex], stringTO.numBytes);
 }
 
 void DataConverter::addCell(
     DataAccessTO const& dataTO,
     CellChangeDescription const& cellDesc,
-    unordered_map<uint64_t, int>& cellIndexTOByIds)
+    uint64_t id,
+    int cellIndex,
+    int tokenIndex,
+    int const* stringIndices) const
 {
-    int cellIndex = (*dataTO.numCells)++;
     CellAccessTO& cellTO = dataTO.cells[cellIndex];
-    cellTO.id = cellDesc.id == 0 ? NumberGenerator::getInstance().getId() : cellDesc.id;
+    cellTO.id = id;
 	cellTO.pos= { cellDesc.pos->x, cellDesc.pos->y };
     cellTO.vel = {cellDesc.vel->x, cellDesc.vel->y};
     cellTO.energy = toFloat(*cellDesc.energy);
@@ -288,60 +565,44 @@ void DataConverter::addCell(
 	else {
 		cellTO.numConnections = 0;
 	}
-    if (cellDesc.metadata.getOptionalValue()) {
-        auto& metadataTO = cellTO.metadata;
-        metadataTO.color = cellDesc.metadata->color;
-        metadataTO.nameLen = toInt(cellDesc.metadata->name.size());
-        if (metadataTO.nameLen > 0) {
-            metadataTO.nameStringIndex = convertStringAndReturnStringIndex(dataTO, cellDesc.metadata->name);
-        }
-        metadataTO.descriptionLen = toInt(cellDesc.metadata->description.size());
-        if (metadataTO.descriptionLen > 0) {
-            metadataTO.descriptionStringIndex =
-                convertStringAndReturnStringIndex(dataTO, cellDesc.metadata->description);
-        }
-        metadataTO.sourceCodeLen = toInt(cellDesc.metadata->computerSourcecode.size());
-        if (metadataTO.sourceCodeLen > 0) {
-            metadataTO.sourceCodeStringIndex =
-                convertStringAndReturnStringIndex(dataTO, cellDesc.metadata->computerSourcecode);
-        }
-    }
-    else {
-        cellTO.metadata.color = 0;
-        cellTO.metadata.nameLen = 0;
-        cellTO.metadata.descriptionLen = 0;
-        cellTO.metadata.sourceCodeLen= 0;
-    }
+    cellTO.metadata.color = cellDesc.metadata.getOptionalValue() ? cellDesc.metadata->color : 0;
+    cellTO.metadata.nameStringIndex = stringIndices[0];
+    cellTO.metadata.descriptionStringIndex = stringIndices[1];
+    cellTO.metadata.sourceCodeStringIndex = stringIndices[2];
 
     if (cellDesc.tokens.getOptionalValue()) {
         for (int i = 0; i < cellDesc.tokens->size(); ++i) {
             TokenDescription const& tokenDesc = cellDesc.tokens->at(i);
-            int tokenIndex = (*dataTO.numTokens)++;
-            TokenAccessTO& tokenTO = dataTO.tokens[tokenIndex];
+            TokenAccessTO& tokenTO = dataTO.tokens[tokenIndex + i];
             tokenTO.energy = toFloat(tokenDesc.energy);
             tokenTO.cellIndex = cellIndex;
             convertToArray(tokenDesc.data, tokenTO.memory, _parameters.tokenMemorySize);
         }
     }
-	cellIndexTOByIds.insert_or_assign(cellTO.id, cellIndex);
 }
 
-void DataConverter::setConnections(
+bool DataConverter::setConnections(
     DataAccessTO const& dataTO,
-    CellChangeDescription const& cellToAdd,
-    unordered_map<uint64_t, int> const& cellIndexByIds)
+    CellChangeDescription const& cellDesc,
+    int cellIndex,
+    CellIndexByIdMap const& cellIndexByIds) const
 {
-	if (cellToAdd.connectingCells.getOptionalValue()) {
+	if (cellDesc.connectingCells.getOptionalValue()) {
 		int index = 0;
-        auto& cellTO = dataTO.cells[cellIndexByIds.at(cellToAdd.id)];
-        for (ConnectionChangeDescription const& connection : *cellToAdd.connectingCells) {
-            cellTO.connections[index].cellIndex = cellIndexByIds.at(connection.cellId);
+        auto& cellTO = dataTO.cells[cellIndex];
+        for (ConnectionChangeDescription const& connection : *cellDesc.connectingCells) {
+            auto connectedCellIndex = cellIndexByIds.find(connection.cellId);
+            if (connectedCellIndex == -1) {
+                return false;
+            }
+            cellTO.connections[index].cellIndex = connectedCellIndex;
             cellTO.connections[index].distance = toFloat(connection.distance);
             cellTO.connections[index].angleFromPrevious = toFloat(connection.angleFromPrevious);
             ++index;
 		}
         cellTO.numConnections = index;
 	}
+    return true;
 }
 
 namespace
@@ -8,7 +8,7 @@
 #include "EngineGpuKernels/AccessTOs.cuh"
 #include "Definitions.h"
 
-#include <unordered_map>
+#include <vector>
 
 class DataConverter
 {
@@ -16,33 +16,72 @@ public:
     DataConverter(SimulationParameters const& parameters, GpuSettings const& gpuConstants);
 
     DataDescription convertAccessTOtoDataDescription(DataAccessTO const& dataTO);
-    OverlayDescription convertAccessTOtoOverlayDescription(DataAccessTO const& dataTO);
+    DataDeltaDescription convertAccessTOtoDataDeltaDescription(DataAccessTO const& dataTO, int numChangedCells);
+    OverlayDescription convertAccessTOtoOverlayDescription(OverlayAccessTO const& overlayTO);
     void convertDataDescriptionToAccessTO(DataAccessTO& result, DataChangeDescription const& description);
 
 private:
-	struct CreateClusterReturnData
+    //cell indices of each cluster in CSR layout, clusters are ordered by their smallest cell index and the cells by a
+    //breadth-first scan starting at this cell
+    struct ClusterCells
     {
-        ClusterDescription cluster;
-        std::unordered_map<int, int> cellTOIndexToCellDescIndex;
-	};
-    CreateClusterReturnData scanAndCreateClusterDescription(
+        std::vector<int> clusterOffsets;  //number of clusters + 1 entries
+        std::vector<int> cellTOIndices;
+
+        int getClusterSize(int clusterIndex) const
+        {
+            return clusterOffsets[clusterIndex + 1] - clusterOffsets[clusterIndex];
+        }
+        int const* getCellTOIndices(int clusterIndex) const { return &cellTOIndices[clusterOffsets[clusterIndex]]; }
+    };
+    ClusterCells calcClusters(DataAccessTO const& dataTO) const;
+    void orderCellsByScan(
         DataAccessTO const& dataTO,
-        int startCellIndex,
-        std::unordered_set<int>& freeCellIndices) const;
+        std::vector<int> const& positionsInCluster,
+        int* cellTOIndices,
+        int clusterSize,
+        std::vector<int>& orderedCellTOIndices,
+        std::vector<bool>& visited) const;
     CellDescription createCellDescription(DataAccessTO const& dataTO, int cellIndex) const;
 
-	void addCell(
-        DataAccessTO const& dataTO,
-        CellChangeDescription const& cellToAdd,
-        unordered_map<uint64_t, int>& cellIndexTOByIds);
-    void addParticle(DataAccessTO const& dataTO, ParticleDescription const& particleDesc);
+    //flat open-addressing map from cell ids to cell indices which can be filled concurrently
+    class CellIndexByIdMap;
+
+    //positions of the added entities in the access data, computed before the arrays are filled in parallel
+    struct UploadLayout
+    {
+        std::vector<CellChangeDescription const*> cells;
+        std::vector<ParticleChangeDescription const*> particles;
+        std::vector<uint64_t> cellIds;
+        std::vector<uint64_t> particleIds;
+        std::vector<int> tokenIndices;  //number of cells + 1 entries
+        std::vector<int> cellStringIndices;  //name, description and source code per cell, -1 = empty string
 
-	void setConnections(
+        //equal strings are transferred once
+        std::vector<std::string const*> strings;
+        std::vector<int> stringByteIndices;  //number of strings + 1 entries
+    };
+    UploadLayout calcUploadLayout(DataAccessTO const& dataTO, DataChangeDescription const& description) const;
+
+    void addCell(
+        DataAccessTO const& dataTO,
+        CellChangeDescription const& cellDesc,
+        uint64_t id,
+        int cellIndex,
+        int tokenIndex,
+        int const* stringIndices) const;
+    void addParticle(
+        DataAccessTO const& dataTO,
+        ParticleChangeDescription const& particleDesc,
+        uint64_t id,
+        int particleIndex) const;
+    bool setConnections(
         DataAccessTO const& dataTO,
-        CellChangeDescription const& cellToAdd,
-        unordered_map<uint64_t, int> const& cellIndexByIds);
+        CellChangeDescription const& cellDesc,
+        int cellIndex,
+        CellIndexByIdMap const& cellIndexByIds) const;
 
-    int convertStringAndReturnStringIndex(DataAccessTO const& dataTO, std::string const& s);
+    std::string getString(DataAccessTO const& dataTO, int stringIndex) const;
 
 private:
 	SimulationParameters _parameters;
@@ -7,3 +7,12 @@ using SimulationController = boost::shared_ptr<_SimulationController>;
 
 class _AccessDataTOCache;
 using AccessDataTOCache = boost::shared_ptr<_AccessDataTOCache>;
+
+class _OverlayAccessTOBuffer;
+using OverlayAccessTOBuffer = boost::shared_ptr<_OverlayAccessTOBuffer>;
+
+class _DataConversionQueue;
+using DataConversionQueue = boost::shared_ptr<_DataConversionQueue>;
+
+class _SnapshotFile;
+using SnapshotFile = boost::shared_ptr<_SnapshotFile>;
@@ -1,17 +1,60 @@
 #include "EngineWorker.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 
+#include "EngineCpu/CpuSimulation.h"
 #include "EngineGpuKernels/AccessTOs.cuh"
+#include "EngineGpuKernels/CudaSimulation.cuh"
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
 #include "EngineInterface/ChangeDescriptions.h"
+#include "EngineInterface/RecordingFile.h"
 #include "AccessDataTOCache.h"
+#include "DataConversionQueue.h"
 #include "DataConverter.h"
+#include "OverlayAccessTOBuffer.h"
+#include "SnapshotFile.h"
 
 namespace
 {
     std::chrono::milliseconds const FrameTimeout(30);
     std::chrono::milliseconds const MonitorUpdate(30);
 
+    //the pending frames of a recording only hold their deltas => the simulation waits only if the writing falls behind
+    uint64_t const MaxPendingRecordingBytes = 512ull * 1024 * 1024;
+
+    //target has to provide sufficient capacity for the entries of source
+    void copyDataTO(DataAccessTO const& source, DataAccessTO const& target)
+    {
+        *target.numCells = *source.numCells;
+        *target.numParticles = *source.numParticles;
+        *target.numTokens = *source.numTokens;
+        *target.numStrings = *source.numStrings;
+        *target.numStringBytes = *source.numStringBytes;
+        std::copy(source.cells, source.cells + *source.numCells, target.cells);
+        std::copy(source.particles, source.particles + *source.numParticles, target.particles);
+        std::copy(source.tokens, source.tokens + *source.numTokens, target.tokens);
+        std::copy(source.strings, source.strings + *source.numStrings, target.strings);
+        std::copy(source.stringBytes, source.stringBytes + *source.numStringBytes, target.stringBytes);
+    }
+
+    uint64_t calcNumBytes(DataAccessTO const& dataTO)
+    {
+        return sizeof(CellAccessTO) * static_cast<uint64_t>(*dataTO.numCells)
+            + sizeof(ParticleAccessTO) * static_cast<uint64_t>(*dataTO.numParticles)
+            + sizeof(TokenAccessTO) * static_cast<uint64_t>(*dataTO.numTokens)
+            + sizeof(StringAccessTO) * static_cast<uint64_t>(*dataTO.numStrings)
+            + static_cast<uint64_t>(*dataTO.numStringBytes);
+    }
+
+    void logRecordingFailure(std::exception const& e)
+    {
+        auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+        loggingService->logMessage(Priority::Important, std::string("recording failed: ") + e.what());
+    }
+
     class CudaAccess
     {
     public:
@@ -74,15 +117,26 @@ void EngineWorker::initCuda()
     _CudaSimulation::initCuda();
 }
 
-void EngineWorker::newSimulation(uint64_t timestep, Settings const& settings, GpuSettings const& gpuSettings)
+void EngineWorker::newSimulation(
+    uint64_t timestep,
+    Settings const& settings,
+    GpuSettings const& gpuSettings,
+    EngineSettings const& engineSettings,
+    ComputeBackend backend)
 {
     _settings = settings;
     _gpuConstants = gpuSettings;
-    _dataTOCache = boost::make_shared<_AccessDataTOCache>(gpuSettings);
-    _cudaSimulation = boost::make_shared<_CudaSimulation>(timestep, settings, gpuSettings);
+    _dataTOCache = boost::make_shared<_AccessDataTOCache>(engineSettings);
+    _overlayTOBuffer = boost::make_shared<_OverlayAccessTOBuffer>();
+    _conversionQueue = boost::make_shared<_DataConversionQueue>();
+    if (ComputeBackend::Cpu == backend) {
+        _simulation = boost::make_shared<_CpuSimulation>(timestep, settings, gpuSettings, engineSettings);
+    } else {
+        _simulation = boost::make_shared<_CudaSimulation>(timestep, settings, gpuSettings, engineSettings);
+    }
 
     if (_imageResourceToRegister) {
-        _cudaResource = _cudaSimulation->registerImageResource(*_imageResourceToRegister);
+        _imageResource = _simulation->registerImageResource(*_imageResourceToRegister);
         _imageResourceToRegister = boost::none;
     }
 }
@@ -91,21 +145,21 @@ void EngineWorker::clear()
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    return _cudaSimulation->clear();
+    return _simulation->clear();
 }
 
 void EngineWorker::registerImageResource(GLuint image)
 {
-    if (!_cudaSimulation) {
+    if (!_simulation) {
 
-        //cuda is not initialized yet => register image resource later
+        //simulation is not initialized yet => register image resource later
         _imageResourceToRegister = image;
     } else {
 
         CudaAccess access(
             _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
 
-        _cudaResource = _cudaSimulation->registerImageResource(image);
+        _imageResource = _simulation->registerImageResource(image);
     }
 }
 
@@ -124,10 +178,10 @@ void EngineWorker::drawVectorGraphics(
         FrameTimeout);
 
     if (!access.isTimeout()) {
-        _cudaSimulation->drawVectorGraphics(
+        _simulation->drawVectorGraphics(
             {rectUpperLeft.x, rectUpperLeft.y},
             {rectLowerRight.x, rectLowerRight.y},
-            _cudaResource,
+            _imageResource,
             {imageSize.x, imageSize.y},
             zoom);
     }
@@ -139,57 +193,191 @@ boost::optional<OverlayDescription> EngineWorker::drawVectorGraphicsAndReturnOve
     IntVector2D const& imageSize,
     double zoom)
 {
-    CudaAccess access(
-        _conditionForAccess,
-        _conditionForWorkerLoop,
-        _requireAccess,
-        _isSimulationRunning,
-        _exceptionData,
-        FrameTimeout);
-
-    if (!access.isTimeout()) {
-        _cudaSimulation->drawVectorGraphics(
+    {
+        CudaAccess access(
+            _conditionForAccess,
+            _conditionForWorkerLoop,
+            _requireAccess,
+            _isSimulationRunning,
+            _exceptionData,
+            FrameTimeout);
+
+        if (access.isTimeout()) {
+            return boost::none;
+        }
+        _simulation->drawVectorGraphics(
             {rectUpperLeft.x, rectUpperLeft.y},
             {rectLowerRight.x, rectLowerRight.y},
-            _cudaResource,
+            _imageResource,
             {imageSize.x, imageSize.y},
             zoom);
 
-        auto arraySizes = _cudaSimulation->getArraySizes();
-        DataAccessTO dataTO = _dataTOCache->getDataTO(
-            {arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
-
-        _cudaSimulation->getSimulationData(
-            {toInt(rectUpperLeft.x), toInt(rectUpperLeft.y)},
-            int2{toInt(rectLowerRight.x), toInt(rectLowerRight.y)},
-            dataTO);
-
-        DataConverter converter(_settings.simulationParameters, _gpuConstants);
-        auto result = converter.convertAccessTOtoOverlayDescription(dataTO);
-        _dataTOCache->releaseDataTO(dataTO);
+        int2 overlayUpperLeft{toInt(rectUpperLeft.x), toInt(rectUpperLeft.y)};
+        int2 overlayLowerRight{toInt(rectLowerRight.x), toInt(rectLowerRight.y)};
+        auto overlayTO = _overlayTOBuffer->getBackBuffer();
+        _simulation->getOverlayData(overlayUpperLeft, overlayLowerRight, overlayTO);
 
-        return result;
+        //buffer was too small => extract again with sufficient size
+        if (*overlayTO.numElements > overlayTO.maxElements) {
+            overlayTO = _overlayTOBuffer->getBackBuffer(*overlayTO.numElements);
+            _simulation->getOverlayData(overlayUpperLeft, overlayLowerRight, overlayTO);
+        }
+        _overlayTOBuffer->swap();
     }
-    return boost::none;
+
+    //conversion of the front buffer does not block the simulation
+    DataConverter converter(_settings.simulationParameters, _gpuConstants);
+    return converter.convertAccessTOtoOverlayDescription(_overlayTOBuffer->getFrontBuffer());
 }
 
 DataDescription EngineWorker::getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight)
 {
-    CudaAccess access(
-        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+    return getSimulationData_async(rectUpperLeft, rectLowerRight).get();
+}
 
-    auto arraySizes = _cudaSimulation->getArraySizes();
-    DataAccessTO dataTO =
-        _dataTOCache->getDataTO({arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
-    _cudaSimulation->getSimulationData(
-        {rectUpperLeft.x, rectUpperLeft.y}, int2{rectLowerRight.x, rectLowerRight.y}, dataTO);
+std::future<DataDescription> EngineWorker::getSimulationData_async(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight)
+{
+    DataAccessTO dataTO;
+    {
+        CudaAccess access(
+            _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+
+        auto arraySizes = _simulation->getArraySizes();
+        dataTO = _dataTOCache->getDataTO(
+            {arraySizes.cellArraySize,
+             arraySizes.particleArraySize,
+             arraySizes.tokenArraySize,
+             arraySizes.stringArraySize,
+             arraySizes.stringByteArraySize});
+        _simulation->getSimulationData(
+            {rectUpperLeft.x, rectUpperLeft.y}, int2{rectLowerRight.x, rectLowerRight.y}, dataTO);
+    }
 
+    //the conversion keeps the cache alive in case a new simulation is created in the meantime
+    auto dataTOCache = _dataTOCache;
     DataConverter converter(_settings.simulationParameters, _gpuConstants);
+    return _conversionQueue->add([=]() mutable {
+        try {
+            auto result = converter.convertAccessTOtoDataDescription(dataTO);
+            dataTOCache->releaseDataTO(dataTO);
+            return result;
+        } catch (...) {
+            dataTOCache->releaseDataTO(dataTO);
+            throw;
+        }
+    });
+}
 
-    auto result = converter.convertAccessTOtoDataDescription(dataTO);
-    _dataTOCache->releaseDataTO(dataTO);
+void EngineWorker::exportSimulationData(
+    int tileSize,
+    std::function<void(DataDescription const& chunk)> const& sink)
+{
+    //the simulation is paused during the export => the access can be released while the sink processes a chunk
+    auto const wasRunning = _isSimulationRunning.load();
+    std::vector<_SimulationBackend::ArraySizes> tileSizes;
+    {
+        CudaAccess access(
+            _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+        pauseSimulation();
+        tileSizes = _simulation->getExportTileSizes(tileSize);
+    }
 
-    return result;
+    try {
+        //the largest tile determines the size of the access data => the cached buffers are reused for all tiles
+        _AccessDataTOCache::ArraySizes maxTileSizes{0, 0, 0, 0, 0};
+        for (auto const& sizes : tileSizes) {
+            maxTileSizes.cellArraySize = std::max(maxTileSizes.cellArraySize, sizes.cellArraySize);
+            maxTileSizes.particleArraySize = std::max(maxTileSizes.particleArraySize, sizes.particleArraySize);
+            maxTileSizes.tokenArraySize = std::max(maxTileSizes.tokenArraySize, sizes.tokenArraySize);
+            maxTileSizes.stringArraySize = std::max(maxTileSizes.stringArraySize, sizes.stringArraySize);
+            maxTileSizes.stringByteArraySize = std::max(maxTileSizes.stringByteArraySize, sizes.stringByteArraySize);
+        }
+
+        DataConverter converter(_settings.simulationParameters, _gpuConstants);
+        for (int tile = 0; tile < toInt(tileSizes.size()); ++tile) {
+            if (0 == tileSizes[tile].cellArraySize && 0 == tileSizes[tile].particleArraySize) {
+                continue;
+            }
+            DataAccessTO dataTO = _dataTOCache->getDataTO(maxTileSizes);
+            DataDescription chunk;
+            try {
+                {
+                    CudaAccess access(
+                        _conditionForAccess,
+                        _conditionForWorkerLoop,
+                        _requireAccess,
+                        _isSimulationRunning,
+                        _exceptionData);
+                    _simulation->getExportTileData(tileSize, tile, dataTO);
+                }
+                chunk = converter.convertAccessTOtoDataDescription(dataTO);
+            } catch (...) {
+                _dataTOCache->releaseDataTO(dataTO);
+                throw;
+            }
+            _dataTOCache->releaseDataTO(dataTO);
+            sink(chunk);
+        }
+    } catch (...) {
+        if (wasRunning) {
+            runSimulation();
+        }
+        throw;
+    }
+    if (wasRunning) {
+        runSimulation();
+    }
+}
+
+DataDeltaDescription EngineWorker::getSimulationDataDelta(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight,
+    uint64_t sinceVersion)
+{
+    return getSimulationDataDelta_async(rectUpperLeft, rectLowerRight, sinceVersion).get();
+}
+
+std::future<DataDeltaDescription> EngineWorker::getSimulationDataDelta_async(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight,
+    uint64_t sinceVersion)
+{
+    DataAccessTO dataTO;
+    _SimulationBackend::DataDelta delta;
+    {
+        CudaAccess access(
+            _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+
+        auto arraySizes = _simulation->getArraySizes();
+        dataTO = _dataTOCache->getDataTO(
+            {arraySizes.cellArraySize,
+             arraySizes.particleArraySize,
+             arraySizes.tokenArraySize,
+             arraySizes.stringArraySize,
+             arraySizes.stringByteArraySize});
+        delta = _simulation->getSimulationDataDelta(
+            {rectUpperLeft.x, rectUpperLeft.y}, int2{rectLowerRight.x, rectLowerRight.y}, sinceVersion, dataTO);
+    }
+
+    auto dataTOCache = _dataTOCache;
+    DataConverter converter(_settings.simulationParameters, _gpuConstants);
+    return _conversionQueue->add([=]() mutable {
+        try {
+            auto result = converter.convertAccessTOtoDataDeltaDescription(dataTO, delta.numChangedCells);
+            dataTOCache->releaseDataTO(dataTO);
+
+            result.version = delta.version;
+            result.complete = delta.complete;
+            result.removedCellIds = std::move(delta.removedCellIds);
+            result.removedParticleIds = std::move(delta.removedParticleIds);
+            return result;
+        } catch (...) {
+            dataTOCache->releaseDataTO(dataTO);
+            throw;
+        }
+    });
 }
 
 OverallStatistics EngineWorker::getMonitorData() const
@@ -207,19 +395,47 @@ OverallStatistics EngineWorker::getMonitorData() const
     return result;
 }
 
+vector<StageStatistics> EngineWorker::getStageStatistics() const
+{
+    return _simulation ? _simulation->getStageStatistics() : vector<StageStatistics>();
+}
+
 void EngineWorker::setSimulationData(DataChangeDescription const& dataToUpdate)
+{
+    uploadSimulationData(dataToUpdate, false);
+}
+
+void EngineWorker::addSimulationData(DataChangeDescription const& dataToAdd)
+{
+    uploadSimulationData(dataToAdd, true);
+}
+
+void EngineWorker::reserveSimulationData(int numCells, int numParticles)
+{
+    CudaAccess access(
+        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+    _simulation->resizeArraysIfNecessary({numCells, numParticles, 0});
+}
+
+void EngineWorker::uploadSimulationData(DataChangeDescription const& dataToUpdate, bool addToExistingData)
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
     int numCells = 0;
     int numParticles = 0;
     int numTokens = 0;
+    int numStringBytes = 0;  //upper bound since equal strings are stored once
     for (auto const& cell : dataToUpdate.cells) {
         if (cell.isAdded()) {
             ++numCells;
             if (cell->tokens.getOptionalValue()) {
                 numTokens += toInt(cell->tokens.getValue().size());
             }
+            if (cell->metadata.getOptionalValue()) {
+                auto const& metadata = cell->metadata.getValue();
+                numStringBytes +=
+                    toInt(metadata.name.size() + metadata.description.size() + metadata.computerSourcecode.size());
+            }
         }
     }
     for (auto const& particle : dataToUpdate.particles) {
@@ -227,29 +443,209 @@ void EngineWorker::setSimulationData(DataChangeDescription const& dataToUpdate)
             ++numParticles;
         }
     }
-    _cudaSimulation->resizeArraysIfNecessary({numCells, numParticles, numTokens});
+    _simulation->resizeArraysIfNecessary({numCells, numParticles, numTokens, numCells * 3, numStringBytes});
 
-    auto arraySizes = _cudaSimulation->getArraySizes();
-    DataAccessTO dataTO = _dataTOCache->getDataTO(
-        {arraySizes.cellArraySize, arraySizes.particleArraySize, arraySizes.tokenArraySize});
+    //only the added entities are converted
+    DataAccessTO dataTO =
+        _dataTOCache->getDataTO({numCells, numParticles, numTokens, numCells * 3, numStringBytes});
     int2 worldSize{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY};
 
     DataConverter converter(_settings.simulationParameters, _gpuConstants);
     converter.convertDataDescriptionToAccessTO(dataTO, dataToUpdate);
 
+    if (addToExistingData) {
+        _simulation->addSimulationData(dataTO);
+    } else {
+        _simulation->setSimulationData(dataTO);
+    }
     _dataTOCache->releaseDataTO(dataTO);
+    updateMonitorDataIntern();
+}
+
+void EngineWorker::recordFrameIfNecessary()
+{
+    if (!_recording || _simulation->getCurrentTimestep() % _recording->stepInterval != 0) {
+        return;
+    }
+
+    //a failed recording is stopped without affecting the simulation
+    try {
+        recordFrame();
+    } catch (std::exception const& e) {
+        _recording = boost::none;
+        _isRecording.store(false);
+        logRecordingFailure(e);
+    }
+}
+
+void EngineWorker::recordFrame()
+{
+    auto& recording = *_recording;
+    while (!recording.pendingFrames.empty()
+           && (recording.numPendingBytes > MaxPendingRecordingBytes
+               || recording.pendingFrames.front().written.wait_for(std::chrono::seconds(0))
+                   == std::future_status::ready)) {
+        auto frame = std::move(recording.pendingFrames.front());
+        recording.pendingFrames.pop_front();
+        recording.numPendingBytes -= frame.numBytes;
+        frame.written.get();
+    }
 
-    _cudaSimulation->setSimulationData(dataTO);
+    auto sinceVersion = recording.numDeltasSinceKeyframe < recording.keyframeInterval ? recording.lastVersion : 0;
+    auto arraySizes = _simulation->getArraySizes();
+    DataAccessTO dataTO = _dataTOCache->getDataTO(
+        {arraySizes.cellArraySize,
+         arraySizes.particleArraySize,
+         arraySizes.tokenArraySize,
+         arraySizes.stringArraySize,
+         arraySizes.stringByteArraySize});
+    _SimulationBackend::DataDelta delta;
+    DataAccessTO frameTO;
+    try {
+        int2 worldSize{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY};
+        delta = _simulation->getSimulationDataDelta({0, 0}, worldSize, sinceVersion, dataTO);
+
+        //only the changed entities are kept until the frame is written, the world-sized buffers are reused
+        frameTO = _dataTOCache->getDataTO(
+            {*dataTO.numCells, *dataTO.numParticles, *dataTO.numTokens, *dataTO.numStrings, *dataTO.numStringBytes});
+        copyDataTO(dataTO, frameTO);
+    } catch (...) {
+        _dataTOCache->releaseDataTO(dataTO);
+        throw;
+    }
+    _dataTOCache->releaseDataTO(dataTO);
+    recording.lastVersion = delta.version;
+    recording.numDeltasSinceKeyframe = delta.complete ? 0 : recording.numDeltasSinceKeyframe + 1;
+
+    auto timestep = _simulation->getCurrentTimestep();
+    auto writer = recording.writer;
+    auto dataTOCache = _dataTOCache;
+    DataConverter converter(_settings.simulationParameters, _gpuConstants);
+    auto numBytes = calcNumBytes(frameTO);
+    recording.pendingFrames.push_back({_conversionQueue->add([=]() mutable {
+        DataDeltaDescription frame;
+        try {
+            frame = converter.convertAccessTOtoDataDeltaDescription(frameTO, delta.numChangedCells);
+        } catch (...) {
+            dataTOCache->releaseDataTO(frameTO);
+            throw;
+        }
+        dataTOCache->releaseDataTO(frameTO);
+
+        frame.version = delta.version;
+        frame.complete = delta.complete;
+        frame.removedCellIds = std::move(delta.removedCellIds);
+        frame.removedParticleIds = std::move(delta.removedParticleIds);
+        writer->write(timestep, frame);
+    }), numBytes});
+    recording.numPendingBytes += numBytes;
+}
+
+void EngineWorker::finishRecording()
+{
+    if (!_recording) {
+        return;
+    }
+    auto recording = std::move(*_recording);
+    _recording = boost::none;
+    _isRecording.store(false);
+
+    //the frames written so far remain readable after a failure
+    try {
+        for (auto& frame : recording.pendingFrames) {
+            frame.written.get();
+        }
+        recording.writer->close();
+    } catch (std::exception const& e) {
+        logRecordingFailure(e);
+    }
+}
+
+void EngineWorker::saveSnapshot(std::string const& filename)
+{
+    DataAccessTO dataTO;
+    {
+        CudaAccess access(
+            _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+
+        auto arraySizes = _simulation->getArraySizes();
+        dataTO = _dataTOCache->getDataTO(
+            {arraySizes.cellArraySize,
+             arraySizes.particleArraySize,
+             arraySizes.tokenArraySize,
+             arraySizes.stringArraySize,
+             arraySizes.stringByteArraySize});
+        try {
+            _simulation->getSimulationData(
+                {0, 0}, int2{_settings.generalSettings.worldSizeX, _settings.generalSettings.worldSizeY}, dataTO);
+        } catch (...) {
+            _dataTOCache->releaseDataTO(dataTO);
+            throw;
+        }
+    }
+
+    //the simulation continues while the file is written
+    try {
+        _SnapshotFile::write(filename, dataTO);
+    } catch (...) {
+        _dataTOCache->releaseDataTO(dataTO);
+        throw;
+    }
+    _dataTOCache->releaseDataTO(dataTO);
+}
+
+void EngineWorker::loadSnapshot(std::string const& filename)
+{
+    //the pages of the file are read when the arrays are copied by the simulation
+    _SnapshotFile snapshot(filename);
+    auto const& dataTO = snapshot.getDataTO();
+
+    CudaAccess access(
+        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+    _simulation->resizeArraysIfNecessary(
+        {*dataTO.numCells, *dataTO.numParticles, *dataTO.numTokens, *dataTO.numStrings, *dataTO.numStringBytes});
+    _simulation->setSimulationData(dataTO);
     updateMonitorDataIntern();
 }
 
+void EngineWorker::startRecording(std::string const& filename, int stepInterval, int keyframeInterval)
+{
+    CudaAccess access(
+        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+
+    finishRecording();
+    _recording = Recording{boost::make_shared<_RecordingWriter>(filename), stepInterval, keyframeInterval};
+    _isRecording.store(true);
+    try {
+        recordFrame();
+    } catch (...) {
+        _recording = boost::none;
+        _isRecording.store(false);
+        throw;
+    }
+}
+
+void EngineWorker::stopRecording()
+{
+    CudaAccess access(
+        _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
+
+    finishRecording();
+}
+
+bool EngineWorker::isRecording() const
+{
+    return _isRecording.load();
+}
+
 void EngineWorker::calcSingleTimestep()
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
 
-    _cudaSimulation->calcCudaTimestep();
+    _simulation->calcTimestep();
     updateMonitorDataIntern();
+    recordFrameIfNecessary();
 }
 
 void EngineWorker::beginShutdown()
@@ -264,7 +660,9 @@ void EngineWorker::endShutdown()
     _isShutdown = false;
     _requireAccess = false;
 
-    _cudaSimulation.reset();
+    finishRecording();
+    _conversionQueue.reset();
+    _simulation.reset();
 }
 
 int EngineWorker::getTpsRestriction() const
@@ -285,14 +683,14 @@ float EngineWorker::getTps() const
 
 uint64_t EngineWorker::getCurrentTimestep() const
 {
-    return _cudaSimulation->getCurrentTimestep();
+    return _simulation->getCurrentTimestep();
 }
 
 void EngineWorker::setCurrentTimestep(uint64_t value)
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    _cudaSimulation->setCurrentTimestep(value);
+    _simulation->setCurrentTimestep(value);
 }
 
 void EngineWorker::setSimulationParameters_async(SimulationParameters const& parameters)
@@ -322,6 +720,15 @@ void EngineWorker::setGpuSettings_async(GpuSettings const& gpuSettings)
     _conditionForWorkerLoop.notify_all();
 }
 
+void EngineWorker::setEngineSettings_async(EngineSettings const& engineSettings)
+{
+    {
+        std::unique_lock<std::mutex> uniqueLock(_mutexForAsyncJobs);
+        _updateEngineSettingsJob = engineSettings;
+    }
+    _conditionForWorkerLoop.notify_all();
+}
+
 void EngineWorker::setFlowFieldSettings_async(FlowFieldSettings const& flowFieldSettings)
 {
     {
@@ -348,35 +755,35 @@ void EngineWorker::switchSelection(RealVector2D const& pos, float radius)
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    _cudaSimulation->switchSelection(SwitchSelectionData{{pos.x, pos.y}, radius});
+    _simulation->switchSelection(SwitchSelectionData{{pos.x, pos.y}, radius});
 }
 
 SelectionShallowData EngineWorker::getSelectionShallowData()
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    return _cudaSimulation->getSelectionShallowData();
+    return _simulation->getSelectionShallowData();
 }
 
 void EngineWorker::setSelection(RealVector2D const& startPos, RealVector2D const& endPos)
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    _cudaSimulation->setSelection(SetSelectionData{{startPos.x, startPos.y}, {endPos.x, endPos.y}});
+    _simulation->setSelection(SetSelectionData{{startPos.x, startPos.y}, {endPos.x, endPos.y}});
 }
 
 void EngineWorker::shallowUpdateSelection(ShallowUpdateSelectionData const& updateData)
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    _cudaSimulation->shallowUpdateSelection(updateData);
+    _simulation->shallowUpdateSelection(updateData);
 }
 
 void EngineWorker::removeSelection()
 {
     CudaAccess access(
         _conditionForAccess, _conditionForWorkerLoop, _requireAccess, _isSimulationRunning, _exceptionData);
-    _cudaSimulation->removeSelection();
+    _simulation->removeSelection();
 }
 
 void EngineWorker::runThreadLoop()
@@ -431,8 +838,9 @@ void EngineWorker::runThreadLoop()
                 }
 
                 startTimestepTime = std::chrono::steady_clock::now();
-                _cudaSimulation->calcCudaTimestep();
+                _simulation->calcTimestep();
                 updateMonitorDataIntern();
+                recordFrameIfNecessary();
                 ++_timestepsSinceTimepoint;
             }
             processJobs();
@@ -465,7 +873,7 @@ void EngineWorker::updateMonitorDataIntern()
     auto now = std::chrono::steady_clock::now();
     if (!_lastMonitorUpdate || now - *_lastMonitorUpdate > MonitorUpdate) {
 
-        auto data = _cudaSimulation->getMonitorData();
+        auto data = _simulation->getMonitorData();
         _timeStep.store(data.timeStep);
         _numCells.store(data.numCells);
         _numParticles.store(data.numParticles);
@@ -484,24 +892,30 @@ void EngineWorker::processJobs()
 {
     std::unique_lock<std::mutex> asyncJobsLock(_mutexForAsyncJobs);
     if (_updateSimulationParametersJob) {
-        _cudaSimulation->setSimulationParameters(*_updateSimulationParametersJob);
+        _simulation->setSimulationParameters(*_updateSimulationParametersJob);
         _updateSimulationParametersJob = boost::none;
     }
     if (_updateSimulationParametersSpotsJob) {
-        _cudaSimulation->setSimulationParametersSpots(*_updateSimulationParametersSpotsJob);
+        _simulation->setSimulationParametersSpots(*_updateSimulationParametersSpotsJob);
         _updateSimulationParametersSpotsJob = boost::none;
     }
     if (_updateGpuSettingsJob) {
-        _cudaSimulation->setGpuConstants(*_updateGpuSettingsJob);
+        _simulation->setGpuConstants(*_updateGpuSettingsJob);
         _updateGpuSettingsJob = boost::none;
     }
+    if (_updateEngineSettingsJob) {
+        _simulation->setEngineSettings(*_updateEngineSettingsJob);
+        auto cacheLimitMB = static_cast<uint64_t>(_updateEngineSettingsJob->ACCESS_DATA_CACHE_LIMIT_MB);
+        _dataTOCache->setMemoryLimit(cacheLimitMB * 1024 * 1024);
+        _updateEngineSettingsJob = boost::none;
+    }
     if (_flowFieldSettings) {
-        _cudaSimulation->setFlowFieldSettings(*_flowFieldSettings);
+        _simulation->setFlowFieldSettings(*_flowFieldSettings);
         _flowFieldSettings = boost::none;
     }
     if (!_applyForceJobs.empty()) {
         for (auto const& applyForceJob : _applyForceJobs) {
-            _cudaSimulation->applyForce(
+            _simulation->applyForce(
                 {{applyForceJob.start.x, applyForceJob.start.y},
                  {applyForceJob.end.x, applyForceJob.end.y},
                  {applyForceJob.force.x, applyForceJob.force.y},
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
+#include <future>
 
 #if defined(_WIN32)
 #define NOMINMAX
@@ -11,10 +14,13 @@
 #include <GL/gl.h>
 
 #include "Base/Definitions.h"
+#include "Base/StageProfiler.h"
 
 #include "EngineInterface/Definitions.h"
+#include "EngineInterface/ComputeBackend.h"
 #include "EngineInterface/SimulationParameters.h"
 #include "EngineInterface/GpuSettings.h"
+#include "EngineInterface/EngineSettings.h"
 #include "EngineInterface/OverallStatistics.h"
 #include "EngineInterface/OverlayDescriptions.h"
 #include "EngineInterface/FlowFieldSettings.h"
@@ -37,7 +43,12 @@ class EngineWorker
 public:
     ENGINEIMPL_EXPORT void initCuda();
 
-    ENGINEIMPL_EXPORT void newSimulation(uint64_t timestep, Settings const& settings, GpuSettings const& gpuSettings);
+    ENGINEIMPL_EXPORT void newSimulation(
+        uint64_t timestep,
+        Settings const& settings,
+        GpuSettings const& gpuSettings,
+        EngineSettings const& engineSettings,
+        ComputeBackend backend = ComputeBackend::Cuda);
     ENGINEIMPL_EXPORT void clear();
 
     ENGINEIMPL_EXPORT void registerImageResource(GLuint image);
@@ -55,9 +66,40 @@ public:
 
     ENGINEIMPL_EXPORT DataDescription
     getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight);
+
+    //the simulation is only blocked during the extraction, the conversion is done on a background thread
+    ENGINEIMPL_EXPORT std::future<DataDescription>
+    getSimulationData_async(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight);
+    //walks the world in square tiles such that only the data of one tile is held at a time, each cluster and particle
+    //is extracted and passed to the sink in exactly one chunk, the simulation is paused during the export
+    ENGINEIMPL_EXPORT void
+    exportSimulationData(int tileSize, std::function<void(DataDescription const& chunk)> const& sink);
+    ENGINEIMPL_EXPORT DataDeltaDescription getSimulationDataDelta(
+        IntVector2D const& rectUpperLeft,
+        IntVector2D const& rectLowerRight,
+        uint64_t sinceVersion);
+    ENGINEIMPL_EXPORT std::future<DataDeltaDescription> getSimulationDataDelta_async(
+        IntVector2D const& rectUpperLeft,
+        IntVector2D const& rectLowerRight,
+        uint64_t sinceVersion);
     ENGINEIMPL_EXPORT OverallStatistics getMonitorData() const;
+    ENGINEIMPL_EXPORT vector<StageStatistics> getStageStatistics() const;
 
     ENGINEIMPL_EXPORT void setSimulationData(DataChangeDescription const& dataToUpdate);
+    //adds the entities to the existing ones such that a world can be uploaded in batches of whole clusters
+    ENGINEIMPL_EXPORT void addSimulationData(DataChangeDescription const& dataToAdd);
+    //enlarges the arrays once for the given number of entities which are added afterwards
+    ENGINEIMPL_EXPORT void reserveSimulationData(int numCells, int numParticles);
+
+    //the access data of the whole world is written to and uploaded from the file without conversion, see SnapshotFile.h
+    ENGINEIMPL_EXPORT void saveSnapshot(std::string const& filename);
+    ENGINEIMPL_EXPORT void loadSnapshot(std::string const& filename);
+
+    //the changes are extracted every stepInterval time steps and written on the background thread, every
+    //keyframeInterval-th frame is a keyframe, the simulation waits for the writing if it falls behind
+    ENGINEIMPL_EXPORT void startRecording(std::string const& filename, int stepInterval, int keyframeInterval);
+    ENGINEIMPL_EXPORT void stopRecording();
+    ENGINEIMPL_EXPORT bool isRecording() const;
 
     ENGINEIMPL_EXPORT void calcSingleTimestep();
 
@@ -74,6 +116,7 @@ public:
     ENGINEIMPL_EXPORT void setSimulationParameters_async(SimulationParameters const& parameters);
     ENGINEIMPL_EXPORT void setSimulationParametersSpots_async(SimulationParametersSpots const& spots);
     ENGINEIMPL_EXPORT void setGpuSettings_async(GpuSettings const& gpuSettings);
+    ENGINEIMPL_EXPORT void setEngineSettings_async(EngineSettings const& engineSettings);
     ENGINEIMPL_EXPORT void setFlowFieldSettings_async(FlowFieldSettings const& flowFieldSettings);
 
     ENGINEIMPL_EXPORT void
@@ -93,8 +136,12 @@ public:
 private:
     void updateMonitorDataIntern();
     void processJobs();
+    void uploadSimulationData(DataChangeDescription const& data, bool addToExistingData);
+    void recordFrameIfNecessary();
+    void recordFrame();
+    void finishRecording();
 
-    CudaSimulation _cudaSimulation;
+    SimulationBackend _simulation;
 
     //sync
     mutable std::mutex _mutexForLoop;
@@ -111,6 +158,7 @@ private:
     boost::optional<SimulationParameters> _updateSimulationParametersJob;
     boost::optional<SimulationParametersSpots> _updateSimulationParametersSpotsJob;
     boost::optional<GpuSettings> _updateGpuSettingsJob;
+    boost::optional<EngineSettings> _updateEngineSettingsJob;
     boost::optional<FlowFieldSettings> _flowFieldSettings;
     boost::optional<GLuint> _imageResourceToRegister;
 
@@ -123,6 +171,26 @@ private:
     };
     std::vector<ApplyForceJob> _applyForceJobs;
 
+    //recording, only accessed by the thread which has access to the simulation
+    struct Recording
+    {
+        RecordingWriter writer;
+        int stepInterval;
+        int keyframeInterval;
+        uint64_t lastVersion = 0;
+        int numDeltasSinceKeyframe = 0;
+
+        struct PendingFrame
+        {
+            std::future<void> written;
+            uint64_t numBytes;  //of the access data held until the frame is converted
+        };
+        std::deque<PendingFrame> pendingFrames;
+        uint64_t numPendingBytes = 0;
+    };
+    boost::optional<Recording> _recording;
+    std::atomic<bool> _isRecording{false};
+
     //time step measurements
     std::atomic<int> _tpsRestriction{0};  //0 = no restriction
     std::atomic<float> _tps;
@@ -146,6 +214,8 @@ private:
     std::atomic<int> _numMuscleActivities{0};
 
     //internals
-    void* _cudaResource;
+    void* _imageResource;
     AccessDataTOCache _dataTOCache;
+    OverlayAccessTOBuffer _overlayTOBuffer;
+    DataConversionQueue _conversionQueue;
 };
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "OverlayAccessTOBuffer.h"
+
+#include <algorithm>
+
+#include "Base/Exceptions.h"
+
+namespace
+{
+    int const InitialOverlayElements = 10000;
+}
+
+OverlayAccessTO _OverlayAccessTOBuffer::getBackBuffer(int minElements)
+{
+    auto& buffer = _buffers[1 - _frontIndex];
+    auto numElements = std::max(minElements, InitialOverlayElements);
+    if (numElements > static_cast<int>(buffer.elements.size())) {
+        try {
+            buffer.elements.resize(numElements + numElements / 2);
+        } catch (std::bad_alloc const&) {
+            throw BugReportException("There is not sufficient CPU memory available.");
+        }
+    }
+    buffer.numElements = 0;
+    return getAccessTO(buffer);
+}
+
+OverlayAccessTO _OverlayAccessTOBuffer::getFrontBuffer()
+{
+    return getAccessTO(_buffers[_frontIndex]);
+}
+
+void _OverlayAccessTOBuffer::swap()
+{
+    _frontIndex = 1 - _frontIndex;
+}
+
+OverlayAccessTO _OverlayAccessTOBuffer::getAccessTO(Buffer& buffer)
+{
+    OverlayAccessTO result;
+    result.numElements = &buffer.numElements;
+    result.elements = buffer.elements.data();
+    result.maxElements = static_cast<int>(buffer.elements.size());
+    return result;
+}
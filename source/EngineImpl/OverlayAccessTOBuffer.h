@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Definitions.h"
+
+//compact double buffer for the cell function overlay: the back buffer is filled by the simulation backend while the
+//front buffer holds the last complete overlay
+class _OverlayAccessTOBuffer
+{
+public:
+    //the back buffer grows lazily to the requested number of elements
+    OverlayAccessTO getBackBuffer(int minElements = 0);
+    OverlayAccessTO getFrontBuffer();
+
+    void swap();
+
+private:
+    struct Buffer
+    {
+        int numElements = 0;
+        std::vector<OverlayElementAccessTO> elements;
+    };
+    OverlayAccessTO getAccessTO(Buffer& buffer);
+
+    Buffer _buffers[2];
+    int _frontIndex = 0;
+};
@@ -7,13 +7,18 @@ void _SimulationController::initCuda()
     _worker.initCuda();
 }
 
-void _SimulationController::newSimulation(uint64_t timestep, Settings const& settings, SymbolMap const& symbolMap)
+void _SimulationController::newSimulation(
+    uint64_t timestep,
+    Settings const& settings,
+    SymbolMap const& symbolMap,
+    ComputeBackend backend)
 {
     _settings = settings;
     _origSettings = _settings;
     _symbolMap = symbolMap;
-    _worker.newSimulation(timestep, settings, _gpuSettings);
+    _worker.newSimulation(timestep, settings, _gpuSettings, _engineSettings, backend);
     _origGpuSettings = _gpuSettings;
+    _origEngineSettings = _engineSettings;
 
     _thread = new std::thread(&EngineWorker::runThreadLoop, &_worker);
 
@@ -55,12 +60,79 @@ DataDescription _SimulationController::getSimulationData(IntVector2D const& rect
     return _worker.getSimulationData(rectUpperLeft, rectLowerRight);
 }
 
+std::future<DataDescription> _SimulationController::getSimulationData_async(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight)
+{
+    return _worker.getSimulationData_async(rectUpperLeft, rectLowerRight);
+}
+
+void _SimulationController::exportSimulationData(
+    int tileSize,
+    std::function<void(DataDescription const& chunk)> const& sink)
+{
+    _worker.exportSimulationData(tileSize, sink);
+}
+
+DataDeltaDescription _SimulationController::getSimulationDataDelta(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight,
+    uint64_t sinceVersion)
+{
+    return _worker.getSimulationDataDelta(rectUpperLeft, rectLowerRight, sinceVersion);
+}
+
+std::future<DataDeltaDescription> _SimulationController::getSimulationDataDelta_async(
+    IntVector2D const& rectUpperLeft,
+    IntVector2D const& rectLowerRight,
+    uint64_t sinceVersion)
+{
+    return _worker.getSimulationDataDelta_async(rectUpperLeft, rectLowerRight, sinceVersion);
+}
+
 void _SimulationController::setSimulationData(DataChangeDescription const& dataToUpdate)
 {
     _worker.setSimulationData(dataToUpdate);
     _isSelectionInvalid = true;
 }
 
+void _SimulationController::addSimulationData(DataChangeDescription const& dataToAdd)
+{
+    _worker.addSimulationData(dataToAdd);
+    _isSelectionInvalid = true;
+}
+
+void _SimulationController::reserveSimulationData(int numCells, int numParticles)
+{
+    _worker.reserveSimulationData(numCells, numParticles);
+}
+
+void _SimulationController::saveSnapshot(std::string const& filename)
+{
+    _worker.saveSnapshot(filename);
+}
+
+void _SimulationController::loadSnapshot(std::string const& filename)
+{
+    _worker.loadSnapshot(filename);
+    _isSelectionInvalid = true;
+}
+
+void _SimulationController::startRecording(std::string const& filename, int stepInterval, int keyframeInterval)
+{
+    _worker.startRecording(filename, stepInterval, keyframeInterval);
+}
+
+void _SimulationController::stopRecording()
+{
+    _worker.stopRecording();
+}
+
+bool _SimulationController::isRecording() const
+{
+    return _worker.isRecording();
+}
+
 void _SimulationController::calcSingleTimestep()
 {
     _worker.calcSingleTimestep();
@@ -156,6 +228,22 @@ void _SimulationController::setGpuSettings_async(GpuSettings const& gpuSettings)
     _worker.setGpuSettings_async(gpuSettings);
 }
 
+EngineSettings _SimulationController::getEngineSettings() const
+{
+    return _engineSettings;
+}
+
+EngineSettings _SimulationController::getOriginalEngineSettings() const
+{
+    return _origEngineSettings;
+}
+
+void _SimulationController::setEngineSettings_async(EngineSettings const& engineSettings)
+{
+    _engineSettings = engineSettings;
+    _worker.setEngineSettings_async(engineSettings);
+}
+
 FlowFieldSettings _SimulationController::getFlowFieldSettings() const
 {
     return _settings.flowFieldSettings;
@@ -246,6 +334,16 @@ OverallStatistics _SimulationController::getStatistics() const
     return _worker.getMonitorData();
 }
 
+vector<StageStatistics> _SimulationController::getStageStatistics() const
+{
+    return _worker.getStageStatistics();
+}
+
+bool _SimulationController::saveStageStatisticsToCsv(std::string const& filename) const
+{
+    return StageProfiler::saveStatisticsToCsv(_worker.getStageStatistics(), filename);
+}
+
 boost::optional<int> _SimulationController::getTpsRestriction() const
 {
     auto result = _worker.getTpsRestriction();
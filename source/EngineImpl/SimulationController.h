@@ -3,6 +3,7 @@
 #include <thread>
 
 #include "EngineInterface/Definitions.h"
+#include "EngineInterface/ComputeBackend.h"
 #include "EngineInterface/SymbolMap.h"
 #include "EngineInterface/Settings.h"
 #include "EngineInterface/SelectionShallowData.h"
@@ -18,7 +19,11 @@ public:
 
     ENGINEIMPL_EXPORT void initCuda();
 
-    ENGINEIMPL_EXPORT void newSimulation(uint64_t timestep, Settings const& settings, SymbolMap const& symbolMap);
+    ENGINEIMPL_EXPORT void newSimulation(
+        uint64_t timestep,
+        Settings const& settings,
+        SymbolMap const& symbolMap,
+        ComputeBackend backend = ComputeBackend::Cuda);
     ENGINEIMPL_EXPORT void clear();
 
     ENGINEIMPL_EXPORT void registerImageResource(GLuint image);
@@ -37,7 +42,41 @@ public:
     ENGINEIMPL_EXPORT DataDescription
     getSimulationData(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight);
 
+    //returns as soon as the data is extracted, the simulation continues during the conversion
+    ENGINEIMPL_EXPORT std::future<DataDescription>
+    getSimulationData_async(IntVector2D const& rectUpperLeft, IntVector2D const& rectLowerRight);
+
+    //streams the whole world tile by tile to the sink such that the host memory is bounded by the tile size
+    ENGINEIMPL_EXPORT void
+    exportSimulationData(int tileSize, std::function<void(DataDescription const& chunk)> const& sink);
+
+    //returns only the entities which have changed since sinceVersion (0 = all entities)
+    ENGINEIMPL_EXPORT DataDeltaDescription getSimulationDataDelta(
+        IntVector2D const& rectUpperLeft,
+        IntVector2D const& rectLowerRight,
+        uint64_t sinceVersion);
+    //returns as soon as the delta is extracted, the conversion is done on a background thread
+    ENGINEIMPL_EXPORT std::future<DataDeltaDescription> getSimulationDataDelta_async(
+        IntVector2D const& rectUpperLeft,
+        IntVector2D const& rectLowerRight,
+        uint64_t sinceVersion);
+
     ENGINEIMPL_EXPORT void setSimulationData(DataChangeDescription const& dataToUpdate);
+    //adds the entities to the existing ones, e.g. for loading a world in chunks
+    ENGINEIMPL_EXPORT void addSimulationData(DataChangeDescription const& dataToAdd);
+    //avoids repeated array enlargements when a world is added in chunks, see _Serializer::deserializeDataChunksFromFile
+    ENGINEIMPL_EXPORT void reserveSimulationData(int numCells, int numParticles);
+
+    //snapshots contain only the entities, the settings are stored separately via _Serializer::serializeSettingsToFile
+    ENGINEIMPL_EXPORT void saveSnapshot(std::string const& filename);
+    //replaces the entities of the current simulation
+    ENGINEIMPL_EXPORT void loadSnapshot(std::string const& filename);
+
+    //records the entities every stepInterval time steps while the simulation runs, see RecordingFile.h
+    //the settings are stored separately via _Serializer::serializeSettingsToFile
+    ENGINEIMPL_EXPORT void startRecording(std::string const& filename, int stepInterval, int keyframeInterval = 20);
+    ENGINEIMPL_EXPORT void stopRecording();
+    ENGINEIMPL_EXPORT bool isRecording() const;
 
     ENGINEIMPL_EXPORT void calcSingleTimestep();
     ENGINEIMPL_EXPORT void runSimulation();
@@ -63,6 +102,10 @@ public:
     ENGINEIMPL_EXPORT GpuSettings getOriginalGpuSettings() const;
     ENGINEIMPL_EXPORT void setGpuSettings_async(GpuSettings const& gpuSettings);
 
+    ENGINEIMPL_EXPORT EngineSettings getEngineSettings() const;
+    ENGINEIMPL_EXPORT EngineSettings getOriginalEngineSettings() const;
+    ENGINEIMPL_EXPORT void setEngineSettings_async(EngineSettings const& engineSettings);
+
     ENGINEIMPL_EXPORT FlowFieldSettings getFlowFieldSettings() const;
     ENGINEIMPL_EXPORT FlowFieldSettings getOriginalFlowFieldSettings() const;
     ENGINEIMPL_EXPORT void setOriginalFlowFieldCenter(FlowCenter const& value, int index);
@@ -83,6 +126,8 @@ public:
     ENGINEIMPL_EXPORT Settings getSettings() const;
     ENGINEIMPL_EXPORT SymbolMap getSymbolMap() const;
     ENGINEIMPL_EXPORT OverallStatistics getStatistics() const;
+    ENGINEIMPL_EXPORT vector<StageStatistics> getStageStatistics() const;
+    ENGINEIMPL_EXPORT bool saveStageStatisticsToCsv(std::string const& filename) const;
 
     ENGINEIMPL_EXPORT boost::optional<int> getTpsRestriction() const;
     ENGINEIMPL_EXPORT void setTpsRestriction(boost::optional<int> const& value);
@@ -96,6 +141,8 @@ private:
     Settings _settings;
     GpuSettings _gpuSettings; 
     GpuSettings _origGpuSettings;
+    EngineSettings _engineSettings;
+    EngineSettings _origEngineSettings;
     SymbolMap _symbolMap;
 
     EngineWorker _worker;
@@ -0,0 +1,202 @@
+#include "SnapshotFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    char const SnapshotFileMagic[8] = {'A', 'L', 'I', 'E', 'N', 'S', 'N', 'P'};
+    uint32_t const SnapshotFileVersion = 2;
+    uint32_t const ByteOrderMark = 0x01020304;
+    uint64_t const ArrayAlignment = 64;
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrderMark;  //written in the byte order of the writing machine
+
+        //sizes of the access structs of the writing build
+        uint32_t cellSize;
+        uint32_t particleSize;
+        uint32_t tokenSize;
+        uint32_t stringSize;
+
+        int numCells;
+        int numParticles;
+        int numTokens;
+        int numStrings;
+        int numStringBytes;
+
+        //positions of the arrays in the file
+        uint64_t cellsPos;
+        uint64_t particlesPos;
+        uint64_t tokensPos;
+        uint64_t stringsPos;
+        uint64_t stringBytesPos;
+    };
+
+    uint64_t alignArrayPos(uint64_t pos)
+    {
+        return (pos + ArrayAlignment - 1) / ArrayAlignment * ArrayAlignment;
+    }
+
+    void writeArray(std::ofstream& stream, uint64_t pos, void const* data, uint64_t numBytes)
+    {
+        auto currentPos = static_cast<uint64_t>(stream.tellp());
+        char const padding[ArrayAlignment] = {};
+        stream.write(padding, pos - currentPos);
+        stream.write(static_cast<char const*>(data), numBytes);
+    }
+
+    template <typename T>
+    T* getArray(boost::interprocess::mapped_region const& region, uint64_t pos, int numElements)
+    {
+        auto fileSize = static_cast<uint64_t>(region.get_size());
+        auto numBytes = sizeof(T) * static_cast<uint64_t>(numElements);
+        if (numElements < 0 || pos % ArrayAlignment != 0 || pos > fileSize || numBytes > fileSize - pos) {
+            throw std::runtime_error("The snapshot file is corrupted.");
+        }
+        return reinterpret_cast<T*>(static_cast<char*>(region.get_address()) + pos);
+    }
+
+    bool isValidIndex(int index, int numElements)
+    {
+        return index >= 0 && index < numElements;
+    }
+
+    bool isValidStringIndex(int index, int numStrings)
+    {
+        return -1 == index || isValidIndex(index, numStrings);
+    }
+
+    //the uploading kernels rely on valid references => a corrupted file must not reach them
+    void validate(DataAccessTO const& dataTO)
+    {
+        auto numCells = *dataTO.numCells;
+        auto numStrings = *dataTO.numStrings;
+        for (int i = 0; i < numCells; ++i) {
+            auto const& cell = dataTO.cells[i];
+            if (cell.numConnections < 0 || cell.numConnections > MAX_CELL_BONDS
+                || cell.numStaticBytes > MAX_CELL_STATIC_BYTES || cell.numMutableBytes > MAX_CELL_MUTABLE_BYTES
+                || !isValidStringIndex(cell.metadata.nameStringIndex, numStrings)
+                || !isValidStringIndex(cell.metadata.descriptionStringIndex, numStrings)
+                || !isValidStringIndex(cell.metadata.sourceCodeStringIndex, numStrings)) {
+                throw std::runtime_error("The snapshot file is corrupted.");
+            }
+            for (int j = 0; j < cell.numConnections; ++j) {
+                if (!isValidIndex(cell.connections[j].cellIndex, numCells)) {
+                    throw std::runtime_error("The snapshot file is corrupted.");
+                }
+            }
+        }
+        for (int i = 0; i < *dataTO.numTokens; ++i) {
+            if (!isValidIndex(dataTO.tokens[i].cellIndex, numCells)) {
+                throw std::runtime_error("The snapshot file is corrupted.");
+            }
+        }
+        for (int i = 0; i < numStrings; ++i) {
+            auto const& string = dataTO.strings[i];
+            if (string.numBytes < 0 || string.byteIndex < 0
+                || string.byteIndex > *dataTO.numStringBytes - string.numBytes) {
+                throw std::runtime_error("The snapshot file is corrupted.");
+            }
+        }
+    }
+}
+
+_SnapshotFile::_SnapshotFile(std::string const& filename)
+{
+    if (!hasSnapshotFormat(filename)) {
+        throw std::runtime_error("The file " + filename + " is no snapshot.");
+    }
+
+    //private mapping: the pages are read on demand and nothing is written back to the file
+    _file = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+    _region = boost::interprocess::mapped_region(_file, boost::interprocess::copy_on_write);
+    _region.advise(boost::interprocess::mapped_region::advice_sequential);
+
+    if (_region.get_size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error("The snapshot file is corrupted.");
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, _region.get_address(), sizeof(SnapshotHeader));
+    if (header.version != SnapshotFileVersion || header.byteOrderMark != ByteOrderMark
+        || header.cellSize != sizeof(CellAccessTO)
+        || header.particleSize != sizeof(ParticleAccessTO) || header.tokenSize != sizeof(TokenAccessTO)
+        || header.stringSize != sizeof(StringAccessTO)) {
+        throw std::runtime_error("The snapshot " + filename + " was written by an incompatible version.");
+    }
+
+    _numCells = header.numCells;
+    _numParticles = header.numParticles;
+    _numTokens = header.numTokens;
+    _numStrings = header.numStrings;
+    _numStringBytes = header.numStringBytes;
+    _dataTO.numCells = &_numCells;
+    _dataTO.numParticles = &_numParticles;
+    _dataTO.numTokens = &_numTokens;
+    _dataTO.numStrings = &_numStrings;
+    _dataTO.numStringBytes = &_numStringBytes;
+    _dataTO.cells = getArray<CellAccessTO>(_region, header.cellsPos, _numCells);
+    _dataTO.particles = getArray<ParticleAccessTO>(_region, header.particlesPos, _numParticles);
+    _dataTO.tokens = getArray<TokenAccessTO>(_region, header.tokensPos, _numTokens);
+    _dataTO.strings = getArray<StringAccessTO>(_region, header.stringsPos, _numStrings);
+    _dataTO.stringBytes = getArray<char>(_region, header.stringBytesPos, _numStringBytes);
+    validate(_dataTO);
+}
+
+DataAccessTO const& _SnapshotFile::getDataTO() const
+{
+    return _dataTO;
+}
+
+void _SnapshotFile::write(std::string const& filename, DataAccessTO const& dataTO)
+{
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(SnapshotHeader));
+    std::memcpy(header.magic, SnapshotFileMagic, sizeof(SnapshotFileMagic));
+    header.version = SnapshotFileVersion;
+    header.byteOrderMark = ByteOrderMark;
+    header.cellSize = sizeof(CellAccessTO);
+    header.particleSize = sizeof(ParticleAccessTO);
+    header.tokenSize = sizeof(TokenAccessTO);
+    header.stringSize = sizeof(StringAccessTO);
+    header.numCells = *dataTO.numCells;
+    header.numParticles = *dataTO.numParticles;
+    header.numTokens = *dataTO.numTokens;
+    header.numStrings = *dataTO.numStrings;
+    header.numStringBytes = *dataTO.numStringBytes;
+
+    auto cellBytes = sizeof(CellAccessTO) * static_cast<uint64_t>(header.numCells);
+    auto particleBytes = sizeof(ParticleAccessTO) * static_cast<uint64_t>(header.numParticles);
+    auto tokenBytes = sizeof(TokenAccessTO) * static_cast<uint64_t>(header.numTokens);
+    auto stringBytes = sizeof(StringAccessTO) * static_cast<uint64_t>(header.numStrings);
+    header.cellsPos = alignArrayPos(sizeof(SnapshotHeader));
+    header.particlesPos = alignArrayPos(header.cellsPos + cellBytes);
+    header.tokensPos = alignArrayPos(header.particlesPos + particleBytes);
+    header.stringsPos = alignArrayPos(header.tokensPos + tokenBytes);
+    header.stringBytesPos = alignArrayPos(header.stringsPos + stringBytes);
+
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        throw std::runtime_error("The snapshot " + filename + " could not be created.");
+    }
+    stream.write(reinterpret_cast<char const*>(&header), sizeof(SnapshotHeader));
+    writeArray(stream, header.cellsPos, dataTO.cells, cellBytes);
+    writeArray(stream, header.particlesPos, dataTO.particles, particleBytes);
+    writeArray(stream, header.tokensPos, dataTO.tokens, tokenBytes);
+    writeArray(stream, header.stringsPos, dataTO.strings, stringBytes);
+    writeArray(stream, header.stringBytesPos, dataTO.stringBytes, header.numStringBytes);
+    if (!stream.flush()) {
+        throw std::runtime_error("The snapshot " + filename + " could not be written.");
+    }
+}
+
+bool _SnapshotFile::hasSnapshotFormat(std::string const& filename)
+{
+    std::ifstream stream(filename, std::ios::binary);
+    char magic[sizeof(SnapshotFileMagic)];
+    return stream.read(magic, sizeof(magic)) && 0 == std::memcmp(magic, SnapshotFileMagic, sizeof(magic));
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "EngineGpuKernels/AccessTOs.cuh"
+
+#include "Definitions.h"
+
+//snapshot of the entities whose layout matches the access data: a header followed by the raw arrays of DataAccessTO
+//such that a memory-mapped file can be uploaded without any conversion
+//the layout depends on the access structs and the byte order, files of builds with a different layout are rejected
+class _SnapshotFile
+{
+public:
+    //maps the file, throws std::runtime_error if it is no valid snapshot for this build or contains invalid references
+    _SnapshotFile(std::string const& filename);
+
+    //the arrays point into the mapped file and are valid as long as this object exists
+    DataAccessTO const& getDataTO() const;
+
+    static void write(std::string const& filename, DataAccessTO const& dataTO);
+    static bool hasSnapshotFormat(std::string const& filename);
+
+private:
+    boost::interprocess::file_mapping _file;
+    boost::interprocess::mapped_region _region;
+
+    int _numCells = 0;
+    int _numParticles = 0;
+    int _numTokens = 0;
+    int _numStrings = 0;
+    int _numStringBytes = 0;
+    DataAccessTO _dataTO;
+};
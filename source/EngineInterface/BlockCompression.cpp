@@ -0,0 +1,439 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "Base/Definitions.h"
+#include "Base/TaskPool.h"
+
+namespace
+{
+    //layout: magic, version, block size, blocks prefixed by their compressed and uncompressed size, index,
+    //position of the index, magic
+    char const BlockCompressedFileMagic[8] = {'A', 'L', 'I', 'E', 'N', 'B', 'L', 'Z'};
+    uint64_t const BlockCompressedFileVersion = 1;
+    int const CompressionLevel = Z_BEST_SPEED;
+
+    struct BlockIndexEntry
+    {
+        uint64_t uncompressedPosition = 0;
+        uint64_t uncompressedSize = 0;
+        uint64_t filePosition = 0;  //of the compressed bytes
+        uint64_t compressedSize = 0;
+    };
+
+    void writeUint64(std::ostream& stream, uint64_t value)
+    {
+        char bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        stream.write(bytes, 8);
+    }
+
+    uint64_t readUint64(std::istream& stream)
+    {
+        unsigned char bytes[8];
+        if (!stream.read(reinterpret_cast<char*>(bytes), 8)) {
+            throw std::runtime_error("unexpected end of file");
+        }
+        uint64_t result = 0;
+        for (int i = 0; i < 8; ++i) {
+            result |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return result;
+    }
+
+    std::string compressBlock(std::string const& data)
+    {
+        auto numBytes = compressBound(static_cast<uLong>(data.size()));
+        std::string result(numBytes, 0);
+        if (Z_OK
+            != compress2(
+                reinterpret_cast<Bytef*>(&result[0]),
+                &numBytes,
+                reinterpret_cast<Bytef const*>(data.data()),
+                static_cast<uLong>(data.size()),
+                CompressionLevel)) {
+            throw std::runtime_error("block could not be compressed");
+        }
+        result.resize(numBytes);
+        return result;
+    }
+
+    std::string decompressBlock(std::string const& data, uint64_t uncompressedSize)
+    {
+        std::string result(uncompressedSize, 0);
+        auto numBytes = static_cast<uLongf>(uncompressedSize);
+        if (Z_OK
+                != uncompress(
+                    reinterpret_cast<Bytef*>(&result[0]),
+                    &numBytes,
+                    reinterpret_cast<Bytef const*>(data.data()),
+                    static_cast<uLong>(data.size()))
+            || numBytes != uncompressedSize) {
+            throw std::runtime_error("block could not be decompressed");
+        }
+        return result;
+    }
+
+    //a block is processed by a worker of the shared task pool or by the thread waiting for it, whichever comes first
+    //=> the streams do not deadlock when they are used from within tasks of the pool
+    class BlockTask
+    {
+    public:
+        BlockTask(std::function<std::string()> const& function)
+            : _state(std::make_shared<State>(function))
+        {}
+
+        void schedule()
+        {
+            auto state = _state;
+            TaskPool::getInstance().add([state] { state->execute(); });
+        }
+
+        std::string get()
+        {
+            _state->execute();
+            return _state->result.get();
+        }
+
+    private:
+        struct State
+        {
+            State(std::function<std::string()> const& function)
+                : task(function)
+                , result(task.get_future())
+            {}
+
+            void execute()
+            {
+                if (!isClaimed.exchange(true)) {
+                    task();
+                }
+            }
+
+            std::atomic<bool> isClaimed{false};
+            std::packaged_task<std::string()> task;
+            std::future<std::string> result;
+        };
+        std::shared_ptr<State> _state;
+    };
+}
+
+/************************************************************************/
+/* Output                                                               */
+/************************************************************************/
+class BlockCompressedOutputStream::Buffer : public std::streambuf
+{
+public:
+    Buffer(std::ostream& target, int blockSize)
+        : _target(target)
+        , _block(blockSize)
+    {
+        _target.write(BlockCompressedFileMagic, 8);
+        writeUint64(_target, BlockCompressedFileVersion);
+        writeUint64(_target, blockSize);
+        _filePosition = 24;
+        setp(_block.data(), _block.data() + _block.size());
+    }
+
+    void finish()
+    {
+        if (_isFinished) {
+            return;
+        }
+        _isFinished = true;
+
+        //small payloads consisting of a single block are compressed on the calling thread
+        submitBlock(_pendingBlocks.empty());
+        while (!_pendingBlocks.empty()) {
+            writeFrontBlock();
+        }
+
+        auto indexPosition = _filePosition;
+        writeUint64(_target, _index.size());
+        for (auto const& entry : _index) {
+            writeUint64(_target, entry.uncompressedPosition);
+            writeUint64(_target, entry.uncompressedSize);
+            writeUint64(_target, entry.filePosition);
+            writeUint64(_target, entry.compressedSize);
+        }
+        writeUint64(_target, indexPosition);
+        _target.write(BlockCompressedFileMagic, 8);
+        _target.flush();
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        submitBlock();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    //only the current position can be queried, it refers to the uncompressed data
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        if (0 != off || std::ios_base::cur != dir || !(which & std::ios_base::out)) {
+            return pos_type(off_type(-1));
+        }
+        return pos_type(static_cast<off_type>(_numSubmittedBytes + (pptr() - pbase())));
+    }
+
+private:
+    struct PendingBlock
+    {
+        uint64_t uncompressedSize;
+        BlockTask compressedData;
+    };
+
+    void submitBlock(bool isLastBlock = false)
+    {
+        if (pptr() == pbase()) {
+            return;
+        }
+        auto data = std::make_shared<std::string>(pbase(), pptr());
+        BlockTask task([data] { return compressBlock(*data); });
+        if (!isLastBlock) {
+            task.schedule();
+        }
+        _pendingBlocks.push_back({data->size(), task});
+        _numSubmittedBytes += data->size();
+        setp(_block.data(), _block.data() + _block.size());
+
+        //bounds the memory for blocks in flight
+        while (_pendingBlocks.size() > 2 * static_cast<size_t>(TaskPool::getInstance().getNumThreads())) {
+            writeFrontBlock();
+        }
+    }
+
+    void writeFrontBlock()
+    {
+        auto& block = _pendingBlocks.front();
+        auto compressedData = block.compressedData.get();
+
+        BlockIndexEntry entry;
+        entry.uncompressedPosition = _numWrittenBytes;
+        entry.uncompressedSize = block.uncompressedSize;
+        entry.filePosition = _filePosition + 16;
+        entry.compressedSize = compressedData.size();
+        writeUint64(_target, entry.compressedSize);
+        writeUint64(_target, entry.uncompressedSize);
+        _target.write(compressedData.data(), compressedData.size());
+        if (!_target) {
+            throw std::runtime_error("compressed block could not be written");
+        }
+        _index.emplace_back(entry);
+
+        _numWrittenBytes += entry.uncompressedSize;
+        _filePosition += 16 + entry.compressedSize;
+        _pendingBlocks.pop_front();
+    }
+
+    std::ostream& _target;
+    std::vector<char> _block;
+    std::deque<PendingBlock> _pendingBlocks;
+    std::vector<BlockIndexEntry> _index;
+    uint64_t _numSubmittedBytes = 0;
+    uint64_t _numWrittenBytes = 0;
+    uint64_t _filePosition = 0;
+    bool _isFinished = false;
+};
+
+BlockCompressedOutputStream::BlockCompressedOutputStream(std::ostream& target, int blockSize)
+    : std::ostream(nullptr)
+    , _buffer(std::make_unique<Buffer>(target, blockSize))
+{
+    rdbuf(_buffer.get());
+    exceptions(std::ios::badbit);
+}
+
+BlockCompressedOutputStream::~BlockCompressedOutputStream()
+{
+    try {
+        _buffer->finish();
+    } catch (...) {
+    }
+}
+
+void BlockCompressedOutputStream::finish()
+{
+    _buffer->finish();
+}
+
+/************************************************************************/
+/* Input                                                                */
+/************************************************************************/
+class BlockCompressedInputStream::Buffer : public std::streambuf
+{
+public:
+    Buffer(std::istream& source)
+        : _source(source)
+    {
+        char magic[8];
+        if (!_source.read(magic, 8) || !std::equal(magic, magic + 8, BlockCompressedFileMagic)) {
+            throw std::runtime_error("no block compressed data found");
+        }
+        if (readUint64(_source) != BlockCompressedFileVersion) {
+            throw std::runtime_error("unsupported version of the block compressed format");
+        }
+        _source.seekg(-16, std::ios::end);
+        auto indexPosition = readUint64(_source);
+        if (!_source.read(magic, 8) || !std::equal(magic, magic + 8, BlockCompressedFileMagic)) {
+            throw std::runtime_error("index of the block compressed format not found");
+        }
+        _source.seekg(indexPosition);
+        _index.resize(readUint64(_source));
+        for (auto& entry : _index) {
+            entry.uncompressedPosition = readUint64(_source);
+            entry.uncompressedSize = readUint64(_source);
+            entry.filePosition = readUint64(_source);
+            entry.compressedSize = readUint64(_source);
+        }
+        _size = _index.empty() ? 0 : _index.back().uncompressedPosition + _index.back().uncompressedSize;
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        auto nextBlock = _currentBlock + 1;
+        if (nextBlock >= toInt(_index.size())) {
+            return traits_type::eof();
+        }
+        loadBlock(nextBlock, 0);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+    {
+        off_type position = off;
+        if (std::ios_base::cur == dir) {
+            position += getCurrentPosition();
+        } else if (std::ios_base::end == dir) {
+            position += static_cast<off_type>(_size);
+        }
+        return seekpos(pos_type(position), which);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+    {
+        auto position = static_cast<off_type>(pos);
+        if (!(which & std::ios_base::in) || position < 0 || position > static_cast<off_type>(_size)) {
+            return pos_type(off_type(-1));
+        }
+        if (position == static_cast<off_type>(_size)) {
+            _currentBlock = toInt(_index.size());
+            _blockData.clear();
+            setg(nullptr, nullptr, nullptr);
+            return pos;
+        }
+        auto isBefore = [](uint64_t value, BlockIndexEntry const& entry) { return value < entry.uncompressedPosition; };
+        auto nextBlock = std::upper_bound(_index.begin(), _index.end(), static_cast<uint64_t>(position), isBefore);
+        auto block = static_cast<int>(nextBlock - _index.begin()) - 1;
+        auto offset = static_cast<uint64_t>(position) - _index[block].uncompressedPosition;
+        if (block == _currentBlock) {
+            setg(eback(), eback() + offset, egptr());
+        } else {
+            loadBlock(block, offset);
+        }
+        return pos;
+    }
+
+private:
+    off_type getCurrentPosition() const
+    {
+        if (_currentBlock < 0) {
+            return 0;
+        }
+        if (_currentBlock >= toInt(_index.size())) {
+            return static_cast<off_type>(_size);
+        }
+        return static_cast<off_type>(_index[_currentBlock].uncompressedPosition) + (gptr() - eback());
+    }
+
+    //the following blocks are decompressed in advance
+    void loadBlock(int block, uint64_t offset)
+    {
+        auto lastBlock = std::min(block + 2 * TaskPool::getInstance().getNumThreads(), toInt(_index.size()) - 1);
+        for (auto it = _decompressedBlocks.begin(); it != _decompressedBlocks.end();) {
+            if (it->first < block || it->first > lastBlock) {
+                it = _decompressedBlocks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        //the requested block is decompressed on the calling thread if it has not been scheduled before
+        for (int i = block; i <= lastBlock; ++i) {
+            if (_decompressedBlocks.find(i) == _decompressedBlocks.end()) {
+                addBlock(i, i != block);
+            }
+        }
+
+        _blockData = _decompressedBlocks.at(block).get();
+        _decompressedBlocks.erase(block);
+        _currentBlock = block;
+        auto begin = &_blockData[0];
+        setg(begin, begin + offset, begin + _blockData.size());
+    }
+
+    void addBlock(int block, bool schedule)
+    {
+        auto const& entry = _index[block];
+        auto data = std::make_shared<std::string>(entry.compressedSize, 0);
+        _source.clear();
+        _source.seekg(entry.filePosition);
+        if (!_source.read(&(*data)[0], entry.compressedSize)) {
+            throw std::runtime_error("unexpected end of file");
+        }
+        auto uncompressedSize = entry.uncompressedSize;
+        BlockTask task([data, uncompressedSize] { return decompressBlock(*data, uncompressedSize); });
+        if (schedule) {
+            task.schedule();
+        }
+        _decompressedBlocks.emplace(block, task);
+    }
+
+    std::istream& _source;
+    std::vector<BlockIndexEntry> _index;
+    uint64_t _size = 0;
+    int _currentBlock = -1;
+    std::string _blockData;
+    std::map<int, BlockTask> _decompressedBlocks;
+};
+
+BlockCompressedInputStream::BlockCompressedInputStream(std::istream& source)
+    : std::istream(nullptr)
+    , _buffer(std::make_unique<Buffer>(source))
+{
+    rdbuf(_buffer.get());
+    exceptions(std::ios::badbit);
+}
+
+BlockCompressedInputStream::~BlockCompressedInputStream() = default;
+
+bool hasBlockCompressedFormat(std::istream& stream)
+{
+    auto position = stream.tellg();
+    char magic[8];
+    auto result = stream.read(magic, 8) && std::equal(magic, magic + 8, BlockCompressedFileMagic);
+    stream.clear();
+    stream.seekg(position);
+    return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <ostream>
+
+#include "DllExport.h"
+
+//block compressed files: the data is split into blocks of fixed size which are compressed independently (zlib) on the
+//shared task pool, an index footer with the positions of the blocks allows seeking in the uncompressed data
+class BlockCompressedOutputStream : public std::ostream
+{
+public:
+    static int const DefaultBlockSize = 1 << 20;
+
+    ENGINEINTERFACE_EXPORT BlockCompressedOutputStream(std::ostream& target, int blockSize = DefaultBlockSize);
+    ENGINEINTERFACE_EXPORT ~BlockCompressedOutputStream() override;
+
+    //writes the remaining blocks and the index, is called by the destructor if omitted
+    ENGINEINTERFACE_EXPORT void finish();
+
+private:
+    class Buffer;
+    std::unique_ptr<Buffer> _buffer;
+};
+
+class BlockCompressedInputStream : public std::istream
+{
+public:
+    ENGINEINTERFACE_EXPORT BlockCompressedInputStream(std::istream& source);
+    ENGINEINTERFACE_EXPORT ~BlockCompressedInputStream() override;
+
+private:
+    class Buffer;
+    std::unique_ptr<Buffer> _buffer;
+};
+
+ENGINEINTERFACE_EXPORT bool hasBlockCompressedFormat(std::istream& stream);
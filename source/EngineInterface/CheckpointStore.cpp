@@ -0,0 +1,145 @@
+#include "CheckpointStore.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <regex>
+#include <stdexcept>
+
+#include "DataDeltaReplay.h"
+
+namespace
+{
+    std::regex const CheckpointFilenameExpr("(base|delta)-(\\d+)\\.ckpt");
+
+    //latest contains the timestep, settings and symbols of the last checkpoint
+    void replayCheckpoints(
+        std::vector<std::string> const& filenames,
+        DataDeltaReplay& replay,
+        DeserializedCheckpoint& latest)
+    {
+        Serializer serializer = boost::make_shared<_Serializer>();
+        for (auto const& filename : filenames) {
+            if (!serializer->deserializeCheckpointFromFile(filename, latest)) {
+                throw std::runtime_error("The checkpoint " + filename + " could not be read.");
+            }
+            replay.apply(latest.content);
+            latest.content = DataDeltaDescription();
+        }
+    }
+}
+
+_CheckpointStore::_CheckpointStore(std::string const& directory)
+    : _directory(directory)
+{
+    std::filesystem::create_directories(_directory);
+    auto files = getAllFiles();
+    if (!files.empty()) {
+        _nextSequenceNumber = files.back().sequenceNumber + 1;
+    }
+}
+
+void _CheckpointStore::write(DeserializedCheckpoint const& checkpoint)
+{
+    auto sequenceNumber = _nextSequenceNumber++;
+    auto filename = (std::filesystem::path(_directory)
+                     / ((checkpoint.content.complete ? "base-" : "delta-") + std::to_string(sequenceNumber) + ".ckpt"))
+                        .string();
+
+    //the file is renamed after it is written completely
+    auto tempFilename = filename + ".tmp";
+    Serializer serializer = boost::make_shared<_Serializer>();
+    if (!serializer->serializeCheckpointToFile(tempFilename, checkpoint)) {
+        throw std::runtime_error("The checkpoint " + filename + " could not be written.");
+    }
+    std::filesystem::rename(tempFilename, filename);
+
+    if (checkpoint.content.complete) {
+        removeFilesBefore(sequenceNumber);
+    }
+}
+
+bool _CheckpointStore::hasBase() const
+{
+    return !getCurrentFiles().empty();
+}
+
+int _CheckpointStore::getNumDeltas() const
+{
+    auto files = getCurrentFiles();
+    return files.empty() ? 0 : toInt(files.size()) - 1;
+}
+
+bool _CheckpointStore::restore(DeserializedSimulation& result) const
+{
+    auto files = getCurrentFiles();
+    if (files.empty()) {
+        return false;
+    }
+    std::vector<std::string> filenames;
+    for (auto const& file : files) {
+        filenames.emplace_back(file.filename);
+    }
+    DataDeltaReplay replay;
+    DeserializedCheckpoint latest;
+    replayCheckpoints(filenames, replay, latest);
+
+    result.timestep = latest.timestep;
+    result.settings = latest.settings;
+    result.symbolMap = latest.symbolMap;
+    result.content = replay.getDataDescription();
+    return true;
+}
+
+void _CheckpointStore::compact()
+{
+    auto files = getCurrentFiles();
+    if (files.size() < 2) {
+        return;
+    }
+    std::vector<std::string> filenames;
+    for (auto const& file : files) {
+        filenames.emplace_back(file.filename);
+    }
+    DataDeltaReplay replay;
+    DeserializedCheckpoint checkpoint;
+    replayCheckpoints(filenames, replay, checkpoint);
+
+    checkpoint.content = replay.getCompleteDelta();
+    write(checkpoint);
+}
+
+auto _CheckpointStore::getCurrentFiles() const -> std::vector<CheckpointFile>
+{
+    auto files = getAllFiles();
+    auto baseFile = std::find_if(files.rbegin(), files.rend(), [](auto const& file) { return file.isBase; });
+    if (baseFile == files.rend()) {
+        return {};
+    }
+    return std::vector<CheckpointFile>(std::prev(baseFile.base()), files.end());
+}
+
+auto _CheckpointStore::getAllFiles() const -> std::vector<CheckpointFile>
+{
+    std::vector<CheckpointFile> result;
+    for (auto const& entry : std::filesystem::directory_iterator(_directory)) {
+        auto filename = entry.path().filename().string();
+        std::smatch match;
+        if (entry.is_regular_file() && std::regex_match(filename, match, CheckpointFilenameExpr)) {
+            result.emplace_back(CheckpointFile{std::stoull(match[2].str()), match[1] == "base", entry.path().string()});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](auto const& file, auto const& other) {
+        return file.sequenceNumber < other.sequenceNumber;
+    });
+    return result;
+}
+
+void _CheckpointStore::removeFilesBefore(uint64_t sequenceNumber) const
+{
+    for (auto const& file : getAllFiles()) {
+        if (file.sequenceNumber < sequenceNumber) {
+            std::error_code error;
+            std::filesystem::remove(file.filename, error);
+        }
+    }
+}
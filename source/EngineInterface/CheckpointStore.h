@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Definitions.h"
+#include "DllExport.h"
+#include "Serializer.h"
+
+//incremental checkpoints in a directory: a base with all entities followed by deltas with the changes since the
+//preceding checkpoint, the files are named base-<n>.ckpt and delta-<n>.ckpt with increasing sequence numbers n
+//and appear atomically, such that an interrupted write leaves the previous state restorable
+//an instance must not be used by several threads at the same time
+class _CheckpointStore
+{
+public:
+    ENGINEINTERFACE_EXPORT _CheckpointStore(std::string const& directory);
+
+    //a complete checkpoint becomes the new base and the older files are removed
+    ENGINEINTERFACE_EXPORT void write(DeserializedCheckpoint const& checkpoint);
+
+    ENGINEINTERFACE_EXPORT bool hasBase() const;
+    ENGINEINTERFACE_EXPORT int getNumDeltas() const;  //since the current base
+
+    //replays the base and its deltas, the clusters are reconstructed from the connections
+    ENGINEINTERFACE_EXPORT bool restore(DeserializedSimulation& result) const;
+
+    //folds the deltas into a new base
+    ENGINEINTERFACE_EXPORT void compact();
+
+private:
+    struct CheckpointFile
+    {
+        uint64_t sequenceNumber;
+        bool isBase;
+        std::string filename;
+    };
+    //the current base and its deltas in order of their sequence numbers
+    std::vector<CheckpointFile> getCurrentFiles() const;
+    std::vector<CheckpointFile> getAllFiles() const;
+    void removeFilesBefore(uint64_t sequenceNumber) const;
+
+    std::string _directory;
+    uint64_t _nextSequenceNumber = 1;
+};
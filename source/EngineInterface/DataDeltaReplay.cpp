@@ -0,0 +1,95 @@
+#include "DataDeltaReplay.h"
+
+#include <algorithm>
+
+#include "Base/NumberGenerator.h"
+
+#include "UnionFind.h"
+
+void DataDeltaReplay::apply(DataDeltaDescription const& delta)
+{
+    if (delta.complete) {
+        _cells.clear();
+        _particles.clear();
+    }
+    for (auto const& id : delta.removedCellIds) {
+        _cells.erase(id);
+    }
+    for (auto const& id : delta.removedParticleIds) {
+        _particles.erase(id);
+    }
+    for (auto const& cell : delta.cells) {
+        _cells.insert_or_assign(cell.id, cell);
+    }
+    for (auto const& particle : delta.particles) {
+        _particles.insert_or_assign(particle.id, particle);
+    }
+    _version = delta.version;
+}
+
+DataDeltaDescription DataDeltaReplay::getCompleteDelta() const
+{
+    DataDeltaDescription result;
+    result.version = _version;
+    result.complete = true;
+    result.cells.reserve(_cells.size());
+    for (auto const& [id, cell] : _cells) {
+        result.cells.emplace_back(cell);
+    }
+    result.particles.reserve(_particles.size());
+    for (auto const& [id, particle] : _particles) {
+        result.particles.emplace_back(particle);
+    }
+    return result;
+}
+
+DataDescription DataDeltaReplay::getDataDescription() const
+{
+    std::vector<uint64_t> cellIds;
+    cellIds.reserve(_cells.size());
+    for (auto const& [id, cell] : _cells) {
+        cellIds.emplace_back(id);
+    }
+    std::sort(cellIds.begin(), cellIds.end());
+
+    std::unordered_map<uint64_t, int> cellIndicesByIds;
+    for (int i = 0; i < toInt(cellIds.size()); ++i) {
+        cellIndicesByIds.emplace(cellIds[i], i);
+    }
+    UnionFind unionFind(toInt(cellIds.size()));
+    for (int i = 0; i < toInt(cellIds.size()); ++i) {
+        for (auto const& connection : _cells.at(cellIds[i]).connections) {
+            auto findResult = cellIndicesByIds.find(connection.cellId);
+            if (findResult != cellIndicesByIds.end()) {
+                unionFind.unite(i, findResult->second);
+            }
+        }
+    }
+
+    DataDescription result;
+    std::unordered_map<int, int> clusterIndicesByRoots;
+    for (int i = 0; i < toInt(cellIds.size()); ++i) {
+        auto [clusterIndex, isNewCluster] =
+            clusterIndicesByRoots.emplace(unionFind.find(i), toInt(result.clusters.size()));
+        if (isNewCluster) {
+            result.clusters.emplace_back(ClusterDescription().setId(NumberGenerator::getInstance().getId()));
+        }
+        auto cell = _cells.at(cellIds[i]);
+        auto& connections = cell.connections;
+        connections.erase(
+            std::remove_if(
+                connections.begin(),
+                connections.end(),
+                [&](auto const& connection) { return !cellIndicesByIds.count(connection.cellId); }),
+            connections.end());
+        result.clusters[clusterIndex->second].cells.emplace_back(std::move(cell));
+    }
+
+    for (auto const& [id, particle] : _particles) {
+        result.particles.emplace_back(particle);
+    }
+    std::sort(result.particles.begin(), result.particles.end(), [](auto const& particle, auto const& other) {
+        return particle.id < other.id;
+    });
+    return result;
+}
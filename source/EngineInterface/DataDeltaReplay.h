@@ -0,0 +1,24 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "Definitions.h"
+#include "Descriptions.h"
+#include "DllExport.h"
+
+//entities resulting from applying a sequence of deltas, a complete delta replaces all previous entities
+class DataDeltaReplay
+{
+public:
+    ENGINEINTERFACE_EXPORT void apply(DataDeltaDescription const& delta);
+
+    ENGINEINTERFACE_EXPORT DataDeltaDescription getCompleteDelta() const;
+
+    //clusters are the connected components of the cells, connections to missing cells are removed
+    ENGINEINTERFACE_EXPORT DataDescription getDataDescription() const;
+
+private:
+    uint64_t _version = 0;
+    std::unordered_map<uint64_t, CellDescription> _cells;
+    std::unordered_map<uint64_t, ParticleDescription> _particles;
+};
@@ -12,6 +12,7 @@
 struct SimulationParameters;
 
 struct DataDescription;
+struct DataDeltaDescription;
 struct ClusterDescription;
 struct CellDescription;
 struct ParticleDescription;
@@ -21,6 +22,7 @@ struct CellChangeDescription;
 struct ParticleChangeDescription;
 
 struct GpuSettings;
+struct EngineSettings;
 
 struct GeneralSettings;
 struct Settings;
@@ -28,4 +30,13 @@ struct Settings;
 class _Serializer;
 using Serializer = boost::shared_ptr<_Serializer>;
 
+class _CheckpointStore;
+using CheckpointStore = boost::shared_ptr<_CheckpointStore>;
+
+class _RecordingWriter;
+using RecordingWriter = boost::shared_ptr<_RecordingWriter>;
+
+class _RecordingReader;
+using RecordingReader = boost::shared_ptr<_RecordingReader>;
+
 struct OverallStatistics;
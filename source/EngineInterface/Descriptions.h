@@ -264,6 +264,19 @@ struct DataDescription
     void shift(RealVector2D const& delta);
 };
 
+//entities which have been created, modified or removed since a previous data version
+//removals should be applied before the cells and particles since a moved entity may occur in both
+struct DataDeltaDescription
+{
+    uint64_t version = 0;  //has to be passed to the next delta request
+    bool complete = false;  //true = all entities in the rectangle are contained and previous data should be discarded
+
+    vector<CellDescription> cells;  //connections may refer to cells which are not contained
+    vector<ParticleDescription> particles;
+    vector<uint64_t> removedCellIds;  //deleted or moved out of the rectangle
+    vector<uint64_t> removedParticleIds;
+};
+
 
 struct DescriptionNavigator
 {
@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Enums
+{
+    struct SpaceFillingCurve
+    {
+        enum Type
+        {
+            MORTON,
+            HILBERT,
+            _COUNTER
+        };
+    };
+}
+
+//settings which are only evaluated on the host, in contrast to GpuSettings they are not copied to constant memory
+struct EngineSettings
+{
+    //cells and particles are sorted along a space-filling curve in every n-th time step, 0 = no reordering
+    int REORDER_INTERVAL = 0;
+    int REORDER_CURVE = Enums::SpaceFillingCurve::MORTON;
+
+    //random numbers are derived from the seed, the time step and the id of the entity they are drawn for
+    int RANDOM_SEED = 0;
+
+    //arrays are enlarged (and compacted) when they are filled above this level
+    float ARRAY_FILL_LEVEL_FACTOR = 2.0f / 3.0f;
+
+    //unused host buffers for data access are freed when the cached buffers exceed this size
+    int ACCESS_DATA_CACHE_LIMIT_MB = 1024;
+
+    //cells are transferred between host and device as records of variable length without the unused array entries
+    //off by default since the packing passes only pay off when the transfer is limited by the bus bandwidth
+    bool PACKED_CELL_TRANSFER = false;
+
+    //the CUDA engine launches the processing steps one by one from the host to measure them separately
+    //off by default since the additional launches and synchronizations slow down the time step
+    bool STAGE_PROFILING = false;
+
+    bool operator==(EngineSettings const& other) const
+    {
+        return REORDER_INTERVAL == other.REORDER_INTERVAL && REORDER_CURVE == other.REORDER_CURVE
+            && RANDOM_SEED == other.RANDOM_SEED && ARRAY_FILL_LEVEL_FACTOR == other.ARRAY_FILL_LEVEL_FACTOR
+            && ACCESS_DATA_CACHE_LIMIT_MB == other.ACCESS_DATA_CACHE_LIMIT_MB
+            && PACKED_CELL_TRANSFER == other.PACKED_CELL_TRANSFER && STAGE_PROFILING == other.STAGE_PROFILING;
+    }
+
+    bool operator!=(EngineSettings const& other) const { return !operator==(other); }
+};
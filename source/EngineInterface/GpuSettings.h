@@ -14,9 +14,3 @@ struct GpuSettings
 
     bool operator!=(GpuSettings const& other) const { return !operator==(other); }
 };
-
-namespace Const
-{
-    int const MetadataMemorySize = 50000000; //~ 50 MB should sufficent
-}
-
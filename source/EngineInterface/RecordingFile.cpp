@@ -0,0 +1,304 @@
+#include "RecordingFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "Serializer.h"
+
+namespace
+{
+    //all numbers are stored in little-endian byte order independent of the machine
+    //layout: magic, version, frames prefixed by their header, index entries, trailer
+    char const RecordingFileMagic[8] = {'A', 'L', 'I', 'E', 'N', 'R', 'E', 'C'};
+    char const IndexMagic[8] = {'A', 'L', 'I', 'E', 'N', 'I', 'D', 'X'};
+    uint32_t const RecordingFileVersion = 1;
+
+    uint64_t const RecordingHeaderSize = 16;  //magic, version, reserved
+    uint64_t const FrameHeaderSize = 24;  //timestep, size, isKeyframe, reserved
+    uint64_t const IndexEntrySize = 24;  //timestep, pos, isKeyframe, reserved
+    uint64_t const IndexTrailerSize = 24;  //position of the index, number of entries, magic
+
+    struct FrameHeader
+    {
+        uint64_t timestep = 0;
+        uint64_t size = 0;
+        uint32_t isKeyframe = 0;
+    };
+
+    void writeUint(std::ostream& stream, uint64_t value, int numBytes)
+    {
+        char bytes[8];
+        for (int i = 0; i < numBytes; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        stream.write(bytes, numBytes);
+    }
+
+    void writeUint64(std::ostream& stream, uint64_t value)
+    {
+        writeUint(stream, value, 8);
+    }
+
+    void writeUint32(std::ostream& stream, uint32_t value)
+    {
+        writeUint(stream, value, 4);
+    }
+
+    //returns false at the end of the stream
+    bool readUint(std::istream& stream, uint64_t& value, int numBytes)
+    {
+        unsigned char bytes[8];
+        if (!stream.read(reinterpret_cast<char*>(bytes), numBytes)) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < numBytes; ++i) {
+            value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return true;
+    }
+
+    bool readUint64(std::istream& stream, uint64_t& value)
+    {
+        return readUint(stream, value, 8);
+    }
+
+    bool readUint32(std::istream& stream, uint32_t& value)
+    {
+        uint64_t result;
+        if (!readUint(stream, result, 4)) {
+            return false;
+        }
+        value = static_cast<uint32_t>(result);
+        return true;
+    }
+
+    void writeFrameHeader(std::ostream& stream, FrameHeader const& header)
+    {
+        writeUint64(stream, header.timestep);
+        writeUint64(stream, header.size);
+        writeUint32(stream, header.isKeyframe);
+        writeUint32(stream, 0);
+    }
+
+    bool readFrameHeader(std::istream& stream, FrameHeader& header)
+    {
+        uint32_t reserved;
+        return readUint64(stream, header.timestep) && readUint64(stream, header.size)
+            && readUint32(stream, header.isKeyframe) && readUint32(stream, reserved);
+    }
+}
+
+_RecordingWriter::_RecordingWriter(std::string const& filename)
+    : _filename(filename)
+    , _stream(filename, std::ios::binary | std::ios::trunc)
+{
+    if (!_stream) {
+        throw std::runtime_error("The recording " + filename + " could not be created.");
+    }
+    _stream.write(RecordingFileMagic, sizeof(RecordingFileMagic));
+    writeUint32(_stream, RecordingFileVersion);
+    writeUint32(_stream, 0);
+}
+
+_RecordingWriter::~_RecordingWriter()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void _RecordingWriter::write(uint64_t timestep, DataDeltaDescription const& delta)
+{
+    if (!_stream.is_open()) {
+        throw std::runtime_error("The recording " + _filename + " is already closed.");
+    }
+    if (_index.empty() && !delta.complete) {
+        throw std::runtime_error("The first frame of a recording has to be complete.");
+    }
+    if (!_index.empty() && timestep <= _index.back().timestep) {
+        throw std::runtime_error("The frames of a recording have to be written in the order of their time steps.");
+    }
+
+    Serializer serializer = boost::make_shared<_Serializer>();
+    auto data = serializer->serializeDataDeltaToString(delta);
+
+    FrameHeader header;
+    header.timestep = timestep;
+    header.size = data.size();
+    header.isKeyframe = delta.complete ? 1 : 0;
+
+    auto pos = static_cast<uint64_t>(_stream.tellp());
+    writeFrameHeader(_stream, header);
+    _stream.write(data.data(), data.size());
+    if (!_stream.flush()) {
+        throw std::runtime_error("The recording " + _filename + " could not be written.");
+    }
+    _index.emplace_back(RecordingIndexEntry{timestep, pos, header.isKeyframe, 0});
+}
+
+void _RecordingWriter::close()
+{
+    if (!_stream.is_open()) {
+        return;
+    }
+    auto indexPos = static_cast<uint64_t>(_stream.tellp());
+    for (auto const& entry : _index) {
+        writeUint64(_stream, entry.timestep);
+        writeUint64(_stream, entry.pos);
+        writeUint32(_stream, entry.isKeyframe);
+        writeUint32(_stream, 0);
+    }
+    writeUint64(_stream, indexPos);
+    writeUint64(_stream, _index.size());
+    _stream.write(IndexMagic, sizeof(IndexMagic));
+    auto success = static_cast<bool>(_stream.flush());
+    _stream.close();
+    if (!success) {
+        throw std::runtime_error("The index of the recording " + _filename + " could not be written.");
+    }
+}
+
+int _RecordingWriter::getNumFrames() const
+{
+    return toInt(_index.size());
+}
+
+_RecordingReader::_RecordingReader(std::string const& filename)
+    : _filename(filename)
+    , _stream(filename, std::ios::binary)
+{
+    char magic[sizeof(RecordingFileMagic)];
+    uint32_t version;
+    uint32_t reserved;
+    if (!_stream.read(magic, sizeof(magic)) || 0 != std::memcmp(magic, RecordingFileMagic, sizeof(magic))
+        || !readUint32(_stream, version) || !readUint32(_stream, reserved)) {
+        throw std::runtime_error("The file " + filename + " is no recording.");
+    }
+    if (version != RecordingFileVersion) {
+        throw std::runtime_error("The recording " + filename + " was written by an incompatible version.");
+    }
+    readIndex();
+    if (_index.empty()) {
+        scanFrames();
+    }
+    if (_index.empty()) {
+        throw std::runtime_error("The recording " + filename + " contains no frames.");
+    }
+}
+
+std::vector<uint64_t> _RecordingReader::getTimesteps() const
+{
+    std::vector<uint64_t> result;
+    result.reserve(_index.size());
+    for (auto const& entry : _index) {
+        result.emplace_back(entry.timestep);
+    }
+    return result;
+}
+
+uint64_t _RecordingReader::seek(uint64_t timestep)
+{
+    auto frameIter = std::upper_bound(
+        _index.begin(), _index.end(), timestep, [](auto const& timestep, auto const& entry) {
+            return timestep < entry.timestep;
+        });
+    if (frameIter == _index.begin()) {
+        throw std::runtime_error(
+            "The recording " + _filename + " starts after time step " + std::to_string(timestep) + ".");
+    }
+    auto frame = toInt(std::distance(_index.begin(), frameIter)) - 1;
+    auto keyframe = frame;
+    while (!_index[keyframe].isKeyframe) {
+        --keyframe;
+    }
+
+    //continue from the current frame if there is no keyframe in between
+    auto startFrame = _currentFrame >= keyframe && _currentFrame <= frame ? _currentFrame + 1 : keyframe;
+    for (auto i = startFrame; i <= frame; ++i) {
+        _replay.apply(readFrame(_index[i]));
+        _currentFrame = i;
+    }
+    return _index[frame].timestep;
+}
+
+DataDescription _RecordingReader::getData() const
+{
+    if (_currentFrame == -1) {
+        throw std::runtime_error("No frame of the recording " + _filename + " has been read.");
+    }
+    return _replay.getDataDescription();
+}
+
+void _RecordingReader::readIndex()
+{
+    _stream.seekg(0, std::ios::end);
+    auto fileSize = static_cast<uint64_t>(_stream.tellg());
+    if (fileSize < RecordingHeaderSize + IndexTrailerSize) {
+        return;
+    }
+    uint64_t indexPos;
+    uint64_t numEntries;
+    char magic[sizeof(IndexMagic)];
+    _stream.seekg(fileSize - IndexTrailerSize);
+    if (!readUint64(_stream, indexPos) || !readUint64(_stream, numEntries) || !_stream.read(magic, sizeof(magic))
+        || 0 != std::memcmp(magic, IndexMagic, sizeof(magic))) {
+        return;
+    }
+    auto indexEnd = fileSize - IndexTrailerSize;
+    if (indexPos > indexEnd || numEntries > (indexEnd - indexPos) / IndexEntrySize
+        || numEntries * IndexEntrySize != indexEnd - indexPos) {
+        throw std::runtime_error("The index of the recording " + _filename + " is corrupted.");
+    }
+    _index.resize(numEntries);
+    _stream.seekg(indexPos);
+    for (auto& entry : _index) {
+        readUint64(_stream, entry.timestep);
+        readUint64(_stream, entry.pos);
+        readUint32(_stream, entry.isKeyframe);
+        readUint32(_stream, entry.reserved);
+    }
+    if (!_stream || (!_index.empty() && !_index.front().isKeyframe)) {
+        throw std::runtime_error("The index of the recording " + _filename + " is corrupted.");
+    }
+}
+
+void _RecordingReader::scanFrames()
+{
+    _stream.clear();
+    _stream.seekg(0, std::ios::end);
+    auto fileSize = static_cast<uint64_t>(_stream.tellg());
+
+    //a frame at the end which was not written completely is ignored
+    uint64_t pos = RecordingHeaderSize;
+    FrameHeader header;
+    while (pos + FrameHeaderSize <= fileSize) {
+        _stream.seekg(pos);
+        if (!readFrameHeader(_stream, header) || header.size > fileSize - pos - FrameHeaderSize) {
+            break;
+        }
+        if (_index.empty() && !header.isKeyframe) {
+            throw std::runtime_error("The recording " + _filename + " is corrupted.");
+        }
+        _index.emplace_back(RecordingIndexEntry{header.timestep, pos, header.isKeyframe, 0});
+        pos += FrameHeaderSize + header.size;
+    }
+    _stream.clear();
+}
+
+DataDeltaDescription _RecordingReader::readFrame(RecordingIndexEntry const& entry)
+{
+    FrameHeader header;
+    _stream.seekg(entry.pos);
+    if (!readFrameHeader(_stream, header) || header.timestep != entry.timestep) {
+        throw std::runtime_error("The recording " + _filename + " is corrupted.");
+    }
+    std::string data(header.size, '\0');
+    if (!_stream.read(data.data(), header.size)) {
+        throw std::runtime_error("The recording " + _filename + " is corrupted.");
+    }
+    Serializer serializer = boost::make_shared<_Serializer>();
+    return serializer->deserializeDataDeltaFromString(data);
+}
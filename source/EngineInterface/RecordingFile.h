@@ -0,0 +1,70 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Definitions.h"
+#include "Descriptions.h"
+#include "DataDeltaReplay.h"
+#include "DllExport.h"
+
+//recordings of simulation runs in a single file: frames with compressed deltas as obtained by getSimulationDataDelta,
+//a complete delta is a keyframe and the following deltas contain the changes since the preceding frame
+//an index footer with the positions of the frames is written on closing, a recording without index (e.g. after a
+//crash) is read up to the last complete frame
+//the settings and symbols are stored next to the file, see Serializer::serializeSettingsToFile
+struct RecordingIndexEntry
+{
+    uint64_t timestep;
+    uint64_t pos;  //of the frame in the file
+    uint32_t isKeyframe;
+    uint32_t reserved;
+};
+
+class _RecordingWriter
+{
+public:
+    ENGINEINTERFACE_EXPORT _RecordingWriter(std::string const& filename);
+    ENGINEINTERFACE_EXPORT ~_RecordingWriter();
+
+    //the first frame has to be a keyframe, the timesteps have to increase
+    ENGINEINTERFACE_EXPORT void write(uint64_t timestep, DataDeltaDescription const& delta);
+
+    //writes the index, is called by the destructor if omitted
+    ENGINEINTERFACE_EXPORT void close();
+
+    ENGINEINTERFACE_EXPORT int getNumFrames() const;
+
+private:
+    std::string _filename;
+    std::ofstream _stream;
+    std::vector<RecordingIndexEntry> _index;
+};
+
+class _RecordingReader
+{
+public:
+    ENGINEINTERFACE_EXPORT _RecordingReader(std::string const& filename);
+
+    ENGINEINTERFACE_EXPORT std::vector<uint64_t> getTimesteps() const;
+
+    //moves to the last frame recorded at or before the given timestep and returns its timestep, the deltas are
+    //replayed from the nearest keyframe or from the current frame when seeking forward
+    ENGINEINTERFACE_EXPORT uint64_t seek(uint64_t timestep);
+
+    //state of the current frame, the clusters are reconstructed from the connections
+    ENGINEINTERFACE_EXPORT DataDescription getData() const;
+
+private:
+    void readIndex();
+    void scanFrames();
+    DataDeltaDescription readFrame(RecordingIndexEntry const& entry);
+
+    std::string _filename;
+    std::ifstream _stream;
+    std::vector<RecordingIndexEntry> _index;
+
+    int _currentFrame = -1;
+    DataDeltaReplay _replay;
+};
@@ -1,5 +1,7 @@
 #include "Serializer.h"
 
+#include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <regex>
 #include <stdexcept>
@@ -17,6 +19,7 @@
 
 #include "Base/ServiceLocator.h"
 
+#include "BlockCompression.h"
 #include "Descriptions.h"
 #include "ChangeDescriptions.h"
 #include "SimulationParameters.h"
@@ -116,6 +119,80 @@ namespace cereal
     {
         ar(data.clusters, data.particles);
     }
+    template <class Archive>
+    inline void serialize(Archive& ar, DataDeltaDescription& data)
+    {
+        ar(data.version, data.complete, data.cells, data.particles, data.removedCellIds, data.removedParticleIds);
+    }
+}
+
+namespace
+{
+    //chunked format: magic, version, chunks prefixed by their size, index, position of the index, magic
+    char const ChunkedFileMagic[8] = {'A', 'L', 'I', 'E', 'N', 'C', 'H', 'K'};
+    uint64_t const ChunkedFileVersion = 1;
+
+    struct ChunkIndexEntry
+    {
+        uint64_t position = 0;  //of the serialized chunk after its size
+        uint64_t numBytes = 0;
+        uint64_t numCells = 0;
+        uint64_t numParticles = 0;
+    };
+
+    void writeUint64(std::ostream& stream, uint64_t value)
+    {
+        char bytes[8];
+        for (int i = 0; i < 8; ++i) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+        stream.write(bytes, 8);
+    }
+
+    uint64_t readUint64(std::istream& stream)
+    {
+        unsigned char bytes[8];
+        if (!stream.read(reinterpret_cast<char*>(bytes), 8)) {
+            throw std::runtime_error("unexpected end of file");
+        }
+        uint64_t result = 0;
+        for (int i = 0; i < 8; ++i) {
+            result |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return result;
+    }
+
+    bool hasChunkedFormat(std::istream& stream)
+    {
+        char magic[8];
+        auto result = stream.read(magic, 8) && std::equal(magic, magic + 8, ChunkedFileMagic);
+        stream.clear();
+        stream.seekg(0);
+        return result;
+    }
+
+    std::vector<ChunkIndexEntry> readChunkIndex(std::istream& stream)
+    {
+        stream.seekg(8);
+        if (readUint64(stream) != ChunkedFileVersion) {
+            throw std::runtime_error("unsupported version of the chunked format");
+        }
+        stream.seekg(-16, std::ios::end);
+        auto indexPosition = readUint64(stream);
+        char magic[8];
+        if (!stream.read(magic, 8) || !std::equal(magic, magic + 8, ChunkedFileMagic)) {
+            throw std::runtime_error("index of the chunked format not found");
+        }
+        stream.seekg(indexPosition);
+        std::vector<ChunkIndexEntry> result(readUint64(stream));
+        for (auto& entry : result) {
+            entry.position = readUint64(stream);
+            entry.numBytes = readUint64(stream);
+            entry.numCells = readUint64(stream);
+            entry.numParticles = readUint64(stream);
+        }
+        return result;
+    }
 }
 
 bool _Serializer::serializeSimulationToFile(string const& filename, DeserializedSimulation const& data)
@@ -125,9 +202,6 @@ bool _Serializer::serializeSimulationToFile(string const& filename, Deserialized
         if (!std::regex_search(filename, fileEndingExpr)) {
             return false;
         }
-        auto settingsFilename = std::regex_replace(filename, fileEndingExpr, ".settings.json");
-        auto symbolsFilename = std::regex_replace(filename, fileEndingExpr, ".symbols.json");
-
         {
             std::ofstream stream(filename, std::ios::binary);
             if (!stream) {
@@ -136,29 +210,57 @@ bool _Serializer::serializeSimulationToFile(string const& filename, Deserialized
             serializeDataDescription(data.content, stream);
             stream.close();
         }
+        return serializeSettingsToFile(filename, data);
+    } catch (std::exception const& e) {
+        throw std::runtime_error(std::string("An error occurred while serializing simulation data: ") + e.what());
+    }
+}
+
+bool _Serializer::deserializeSimulationFromFile(string const& filename, DeserializedSimulation& data)
+{
+    data.content.clear();
+    auto result = deserializeDataChunksFromFile(filename, [&](DataDescription const& chunk) {
+        data.content.addClusters(chunk.clusters);
+        data.content.addParticles(chunk.particles);
+    });
+    return result && deserializeSettingsFromFile(filename, data);
+}
+
+bool _Serializer::serializeSimulationToChunkedFile(
+    string const& filename,
+    DeserializedSimulation const& data,
+    std::function<void(DataChunkSink const&)> const& exportChunks,
+    bool compress)
+{
+    try {
+        std::regex fileEndingExpr("\\.\\w+$");
+        if (!std::regex_search(filename, fileEndingExpr)) {
+            return false;
+        }
         {
-            std::ofstream stream(settingsFilename, std::ios::binary);
-            if (!stream) {
+            std::ofstream fileStream(filename, std::ios::binary);
+            if (!fileStream) {
                 return false;
             }
-            serializeTimestepAndSettings(data.timestep, data.settings, stream);
-            stream.close();
-        }
-        {
-            std::ofstream stream(symbolsFilename, std::ios::binary);
-            if (!stream) {
+            if (compress) {
+                BlockCompressedOutputStream stream(fileStream);
+                serializeDataChunks(exportChunks, stream);
+                stream.finish();
+            } else {
+                serializeDataChunks(exportChunks, fileStream);
+            }
+            if (!fileStream) {
                 return false;
             }
-            serializeSymbolMap(data.symbolMap, stream);
-            stream.close();
+            fileStream.close();
         }
-        return true;
+        return serializeSettingsToFile(filename, data);
     } catch (std::exception const& e) {
         throw std::runtime_error(std::string("An error occurred while serializing simulation data: ") + e.what());
     }
 }
 
-bool _Serializer::deserializeSimulationFromFile(string const& filename, DeserializedSimulation& data)
+bool _Serializer::deserializeSettingsFromFile(string const& filename, DeserializedSimulation& data)
 {
     try {
         std::regex fileEndingExpr("\\.\\w+$");
@@ -168,15 +270,6 @@ bool _Serializer::deserializeSimulationFromFile(string const& filename, Deserial
         auto settingsFilename = std::regex_replace(filename, fileEndingExpr, ".settings.json");
         auto symbolsFilename = std::regex_replace(filename, fileEndingExpr, ".symbols.json");
 
-        {
-            std::ifstream stream(filename, std::ios::binary);
-            if (!stream) {
-                return false;
-            }
-            deserializeDataDescription(data.content, stream);
-            stream.close();
-
-        }
         {
             std::ifstream stream(settingsFilename, std::ios::binary);
             if (!stream) {
@@ -199,6 +292,211 @@ bool _Serializer::deserializeSimulationFromFile(string const& filename, Deserial
     }
 }
 
+bool _Serializer::deserializeDataChunksFromFile(
+    string const& filename,
+    DataChunkSink const& importChunk,
+    DataChunksReservation const& reserve)
+{
+    try {
+        std::regex fileEndingExpr("\\.\\w+$");
+        if (!std::regex_search(filename, fileEndingExpr)) {
+            return false;
+        }
+        std::ifstream fileStream(filename, std::ios::binary);
+        if (!fileStream) {
+            return false;
+        }
+        if (hasBlockCompressedFormat(fileStream)) {
+            BlockCompressedInputStream stream(fileStream);
+            deserializeDataChunks(importChunk, reserve, stream);
+        } else {
+            deserializeDataChunks(importChunk, reserve, fileStream);
+        }
+        return true;
+    } catch (std::exception const& e) {
+        throw std::runtime_error("An error occurred while loading the file " + filename + ": " + e.what());
+    }
+}
+
+bool _Serializer::serializeCheckpointToFile(string const& filename, DeserializedCheckpoint const& data)
+{
+    try {
+        std::ostringstream settingsStream;
+        serializeTimestepAndSettings(data.timestep, data.settings, settingsStream);
+        auto settings = settingsStream.str();
+        std::ostringstream symbolsStream;
+        serializeSymbolMap(data.symbolMap, symbolsStream);
+        auto symbols = symbolsStream.str();
+
+        std::ofstream fileStream(filename, std::ios::binary);
+        if (!fileStream) {
+            return false;
+        }
+        {
+            BlockCompressedOutputStream stream(fileStream);
+            {
+                cereal::PortableBinaryOutputArchive archive(stream);
+                archive(settings, symbols, data.content);
+            }
+            stream.finish();
+        }
+        return static_cast<bool>(fileStream);
+    } catch (std::exception const& e) {
+        throw std::runtime_error(std::string("An error occurred while serializing a checkpoint: ") + e.what());
+    }
+}
+
+bool _Serializer::deserializeCheckpointFromFile(string const& filename, DeserializedCheckpoint& data)
+{
+    try {
+        std::ifstream fileStream(filename, std::ios::binary);
+        if (!fileStream || !hasBlockCompressedFormat(fileStream)) {
+            return false;
+        }
+        std::string settings;
+        std::string symbols;
+        {
+            BlockCompressedInputStream stream(fileStream);
+            cereal::PortableBinaryInputArchive archive(stream);
+            archive(settings, symbols, data.content);
+        }
+        std::istringstream settingsStream(settings);
+        deserializeTimestepAndSettings(data.timestep, data.settings, settingsStream);
+        std::istringstream symbolsStream(symbols);
+        deserializeSymbolMap(data.symbolMap, symbolsStream);
+        return true;
+    } catch (std::exception const& e) {
+        throw std::runtime_error("An error occurred while loading the checkpoint " + filename + ": " + e.what());
+    }
+}
+
+std::string _Serializer::serializeDataDeltaToString(DataDeltaDescription const& data)
+{
+    std::ostringstream result;
+    {
+        BlockCompressedOutputStream stream(result);
+        {
+            cereal::PortableBinaryOutputArchive archive(stream);
+            archive(data);
+        }
+        stream.finish();
+    }
+    return result.str();
+}
+
+DataDeltaDescription _Serializer::deserializeDataDeltaFromString(std::string const& data)
+{
+    DataDeltaDescription result;
+    std::istringstream sourceStream(data);
+    BlockCompressedInputStream stream(sourceStream);
+    cereal::PortableBinaryInputArchive archive(stream);
+    archive(result);
+    return result;
+}
+
+bool _Serializer::serializeSettingsToFile(string const& filename, DeserializedSimulation const& data)
+{
+    std::regex fileEndingExpr("\\.\\w+$");
+    if (!std::regex_search(filename, fileEndingExpr)) {
+        return false;
+    }
+    auto settingsFilename = std::regex_replace(filename, fileEndingExpr, ".settings.json");
+    auto symbolsFilename = std::regex_replace(filename, fileEndingExpr, ".symbols.json");
+
+    {
+        std::ofstream stream(settingsFilename, std::ios::binary);
+        if (!stream) {
+            return false;
+        }
+        serializeTimestepAndSettings(data.timestep, data.settings, stream);
+        stream.close();
+    }
+    {
+        std::ofstream stream(symbolsFilename, std::ios::binary);
+        if (!stream) {
+            return false;
+        }
+        serializeSymbolMap(data.symbolMap, stream);
+        stream.close();
+    }
+    return true;
+}
+
+void _Serializer::serializeDataChunks(
+    std::function<void(DataChunkSink const&)> const& exportChunks,
+    std::ostream& stream) const
+{
+    stream.write(ChunkedFileMagic, 8);
+    writeUint64(stream, ChunkedFileVersion);
+
+    //only one serialized chunk is held in memory at a time
+    std::vector<ChunkIndexEntry> index;
+    exportChunks([&](DataDescription const& chunk) {
+        std::ostringstream chunkStream(std::ios::binary);
+        serializeDataDescription(chunk, chunkStream);
+        auto chunkBytes = chunkStream.str();
+
+        ChunkIndexEntry entry;
+        writeUint64(stream, chunkBytes.size());
+        entry.position = static_cast<uint64_t>(stream.tellp());
+        entry.numBytes = chunkBytes.size();
+        for (auto const& cluster : chunk.clusters) {
+            entry.numCells += cluster.cells.size();
+        }
+        entry.numParticles = chunk.particles.size();
+        stream.write(chunkBytes.data(), chunkBytes.size());
+        index.emplace_back(entry);
+    });
+
+    auto indexPosition = static_cast<uint64_t>(stream.tellp());
+    writeUint64(stream, index.size());
+    for (auto const& entry : index) {
+        writeUint64(stream, entry.position);
+        writeUint64(stream, entry.numBytes);
+        writeUint64(stream, entry.numCells);
+        writeUint64(stream, entry.numParticles);
+    }
+    writeUint64(stream, indexPosition);
+    stream.write(ChunkedFileMagic, 8);
+}
+
+void _Serializer::deserializeDataChunks(
+    DataChunkSink const& importChunk,
+    DataChunksReservation const& reserve,
+    std::istream& stream) const
+{
+    if (!hasChunkedFormat(stream)) {
+        DataDescription data;
+        deserializeDataDescription(data, stream);
+        if (reserve) {
+            uint64_t numCells = 0;
+            for (auto const& cluster : data.clusters) {
+                numCells += cluster.cells.size();
+            }
+            reserve(numCells, data.particles.size());
+        }
+        importChunk(data);
+        return;
+    }
+    auto index = readChunkIndex(stream);
+    if (reserve) {
+        uint64_t numCells = 0;
+        uint64_t numParticles = 0;
+        for (auto const& entry : index) {
+            numCells += entry.numCells;
+            numParticles += entry.numParticles;
+        }
+        reserve(numCells, numParticles);
+    }
+    for (auto const& entry : index) {
+        stream.seekg(entry.position);
+        DataDescription chunk;
+        cereal::PortableBinaryInputArchive archive(stream);
+        archive(chunk);
+        importChunk(chunk);
+    }
+}
+
 void _Serializer::serializeDataDescription(DataDescription const& data, std::ostream& stream) const
 {
     cereal::PortableBinaryOutputArchive archive(stream);
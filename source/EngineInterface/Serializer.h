@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include "Base/Definitions.h"
 
 #include "Definitions.h"
@@ -17,13 +19,62 @@ struct DeserializedSimulation
     DataDescription content;
 };
 
+//entities changed since the previous checkpoint, see CheckpointStore.h
+struct DeserializedCheckpoint
+{
+    uint64_t timestep;
+    Settings settings;
+    SymbolMap symbolMap;
+    DataDeltaDescription content;
+};
+
+using DataChunkSink = std::function<void(DataDescription const& chunk)>;
+//receives the total number of entities in all chunks before the first chunk is passed
+using DataChunksReservation = std::function<void(uint64_t numCells, uint64_t numParticles)>;
+
 class _Serializer
 {
 public:
     ENGINEINTERFACE_EXPORT bool serializeSimulationToFile(string const& filename, DeserializedSimulation const& data);
+    //reads both file formats
     ENGINEINTERFACE_EXPORT bool deserializeSimulationFromFile(string const& filename, DeserializedSimulation& data);
 
+    //chunked format: independent length-prefixed chunks of clusters and particles followed by an index footer
+    //the content of data is ignored, exportChunks has to pass the chunks to the given sink one after another
+    //compress = the chunked data is stored in zlib compressed blocks, see BlockCompression.h
+    ENGINEINTERFACE_EXPORT bool serializeSimulationToChunkedFile(
+        string const& filename,
+        DeserializedSimulation const& data,
+        std::function<void(DataChunkSink const&)> const& exportChunks,
+        bool compress = true);
+
+    //writes only the timestep, settings and symbols next to the given file, the content is ignored
+    ENGINEINTERFACE_EXPORT bool serializeSettingsToFile(string const& filename, DeserializedSimulation const& data);
+    //reads only the timestep, settings and symbols, the content remains empty
+    ENGINEINTERFACE_EXPORT bool deserializeSettingsFromFile(string const& filename, DeserializedSimulation& data);
+
+    //passes the chunks one after another to importChunk, a file in the former format yields a single chunk
+    //reserve is called beforehand with the totals from the index, e.g. for allocating the engine arrays once
+    ENGINEINTERFACE_EXPORT bool deserializeDataChunksFromFile(
+        string const& filename,
+        DataChunkSink const& importChunk,
+        DataChunksReservation const& reserve = DataChunksReservation());
+
+    //checkpoints contain the timestep, settings and symbols together with the entities in zlib compressed blocks
+    ENGINEINTERFACE_EXPORT bool serializeCheckpointToFile(string const& filename, DeserializedCheckpoint const& data);
+    ENGINEINTERFACE_EXPORT bool deserializeCheckpointFromFile(string const& filename, DeserializedCheckpoint& data);
+
+    //compressed in-memory representation of a delta, e.g. for keeping a history of time steps
+    ENGINEINTERFACE_EXPORT std::string serializeDataDeltaToString(DataDeltaDescription const& data);
+    ENGINEINTERFACE_EXPORT DataDeltaDescription deserializeDataDeltaFromString(std::string const& data);
+
 private:
+    void serializeDataChunks(std::function<void(DataChunkSink const&)> const& exportChunks, std::ostream& stream) const;
+    void deserializeDataChunks(
+        DataChunkSink const& importChunk,
+        DataChunksReservation const& reserve,
+        std::istream& stream) const;
+
     void serializeDataDescription(DataDescription const& data, std::ostream& stream) const;
     void serializeTimestepAndSettings(uint64_t timestep, Settings const& generalSettings, std::ostream& stream) const;
     void serializeSymbolMap(SymbolMap const symbols, std::ostream& stream) const;
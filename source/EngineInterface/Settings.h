@@ -3,6 +3,7 @@
 #include "SimulationParameters.h"
 #include "SimulationParametersSpots.h"
 #include "GpuSettings.h"
+#include "EngineSettings.h"
 #include "GeneralSettings.h"
 #include "FlowFieldSettings.h"
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+//lock-free union-find over the indices [0, numElements) where the root of each set is its smallest element
+//unite() and find() may be called concurrently, the resulting sets do not depend on the order of the calls
+class UnionFind
+{
+public:
+    UnionFind(int numElements)
+        : _parents(numElements)
+    {
+        for (int index = 0; index < numElements; ++index) {
+            _parents[index].store(index, std::memory_order_relaxed);
+        }
+    }
+
+    int find(int index)
+    {
+        while (true) {
+            auto parent = _parents[index].load(std::memory_order_relaxed);
+            if (parent == index) {
+                return index;
+            }
+            auto grandParent = _parents[parent].load(std::memory_order_relaxed);
+            //path halving
+            if (grandParent != parent) {
+                _parents[index].compare_exchange_weak(parent, grandParent, std::memory_order_relaxed);
+            }
+            index = grandParent;
+        }
+    }
+
+    void unite(int index1, int index2)
+    {
+        while (true) {
+            auto root1 = find(index1);
+            auto root2 = find(index2);
+            if (root1 == root2) {
+                return;
+            }
+            if (root1 < root2) {
+                std::swap(root1, root2);
+            }
+            //only roots are linked and always to a smaller index => no cycles
+            if (_parents[root1].compare_exchange_strong(root1, root2, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::vector<std::atomic<int>> _parents;
+};
@@ -2,28 +2,45 @@
 
 #include "imgui.h"
 
+#include "Base/LoggingService.h"
+#include "Base/ServiceLocator.h"
+#include "EngineInterface/CheckpointStore.h"
+#include "EngineInterface/Descriptions.h"
 #include "EngineInterface/Serializer.h"
 #include "Resources.h"
 #include "GlobalSettings.h"
 
+namespace
+{
+    //entities slightly outside of the world are saved as well
+    auto const WorldMargin = 1000;
+}
+
 _AutosaveController::_AutosaveController(SimulationController const& simController)
     : _simController(simController)
+    , _checkpointStore(boost::make_shared<_CheckpointStore>(Const::AutosaveDirectory))
 {
-    _startTimePoint = std::chrono::steady_clock::now();
+    _lastSaveTimePoint = std::chrono::steady_clock::now();
     _on = GlobalSettings::getInstance().getBoolState("controllers.auto save.active", true);
+    _interval = GlobalSettings::getInstance().getIntState("controllers.auto save.interval", _interval);
+    _deltasPerBase = GlobalSettings::getInstance().getIntState("controllers.auto save.deltas per base", _deltasPerBase);
 }
 
 _AutosaveController::~_AutosaveController()
 {
     GlobalSettings::getInstance().setBoolState("controllers.auto save.active", _on);
+    GlobalSettings::getInstance().setIntState("controllers.auto save.interval", _interval);
+    GlobalSettings::getInstance().setIntState("controllers.auto save.deltas per base", _deltasPerBase);
 }
 
 void _AutosaveController::shutdown()
 {
+    finishSave();
     if (!_on) {
         return;
     }
     onSave();
+    finishSave();
 }
 
 bool _AutosaveController::isOn() const
@@ -36,27 +53,82 @@ void _AutosaveController::setOn(bool value)
     _on = value;
 }
 
+int _AutosaveController::getInterval() const
+{
+    return _interval;
+}
+
+void _AutosaveController::setInterval(int value)
+{
+    _interval = value;
+}
+
+int _AutosaveController::getDeltasPerBase() const
+{
+    return _deltasPerBase;
+}
+
+void _AutosaveController::setDeltasPerBase(int value)
+{
+    _deltasPerBase = value;
+}
+
 void _AutosaveController::process()
 {
-    if (!_on) {
+    if (_saveJob.valid() && _saveJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        finishSave();
+    }
+    if (!_on || _saveJob.valid()) {
         return;
     }
 
-    auto durationSinceStart =
-        std::chrono::duration_cast<std::chrono::minutes>(std::chrono::steady_clock::now() - *_startTimePoint).count();
-    if (durationSinceStart > 0 && durationSinceStart % 20 == 0) {
+    auto durationSinceLastSave = std::chrono::duration_cast<std::chrono::minutes>(
+                                     std::chrono::steady_clock::now() - _lastSaveTimePoint)
+                                     .count();
+    if (durationSinceLastSave >= _interval) {
         onSave();
     }
 }
 
 void _AutosaveController::onSave()
 {
-    DeserializedSimulation sim;
-    sim.timestep = static_cast<uint32_t>(_simController->getCurrentTimestep());
-    sim.settings = _simController->getSettings();
-    sim.symbolMap = _simController->getSymbolMap();
-    sim.content = _simController->getSimulationData(
-        {-1000, -1000}, {_simController->getWorldSize().x + 1000, _simController->getWorldSize().y + 1000});
-    Serializer serializer = boost::make_shared<_Serializer>();
-    serializer->serializeSimulationToFile(Const::AutosaveFile, sim);
+    _lastSaveTimePoint = std::chrono::steady_clock::now();
+
+    DeserializedCheckpoint checkpoint;
+    checkpoint.timestep = _simController->getCurrentTimestep();
+    checkpoint.settings = _simController->getSettings();
+    checkpoint.symbolMap = _simController->getSymbolMap();
+
+    //a delta can only be replayed on top of a base
+    auto sinceVersion = _checkpointStore->hasBase() ? _lastVersion : 0;
+    auto worldSize = _simController->getWorldSize();
+    auto delta = _simController->getSimulationDataDelta_async(
+        {-WorldMargin, -WorldMargin}, {worldSize.x + WorldMargin, worldSize.y + WorldMargin}, sinceVersion);
+
+    //the store is not accessed by the GUI thread until the job is finished
+    auto checkpointStore = _checkpointStore;
+    auto deltasPerBase = _deltasPerBase;
+    _saveJob = std::async(std::launch::async, [=, delta = std::move(delta)]() mutable {
+        checkpoint.content = delta.get();
+        checkpointStore->write(checkpoint);
+        if (checkpointStore->getNumDeltas() >= deltasPerBase) {
+            checkpointStore->compact();
+        }
+        return checkpoint.content.version;
+    });
+}
+
+void _AutosaveController::finishSave()
+{
+    if (!_saveJob.valid()) {
+        return;
+    }
+
+    //after a failure the next checkpoint contains the changes since the last successful one
+    try {
+        _lastVersion = _saveJob.get();
+    } catch (std::exception const& e) {
+        auto loggingService = ServiceLocator::getInstance().getService<LoggingService>();
+        loggingService->logMessage(Priority::Important, std::string("autosave failed: ") + e.what());
+    }
 }
@@ -1,28 +1,46 @@
 #pragma once
 
 #include <chrono>
+#include <future>
 
+#include "EngineInterface/Definitions.h"
 #include "EngineImpl/SimulationController.h"
 #include "Definitions.h"
 
+//writes checkpoints in the configured interval: the simulation is only blocked for the extraction of the entities
+//changed since the last checkpoint, the conversion, writing and compaction are done in the background
 class _AutosaveController
 {
 public:
     _AutosaveController(SimulationController const& simController);
     ~_AutosaveController();
 
-    void shutdown();
+    void shutdown();  //writes a last checkpoint
 
     bool isOn() const;
     void setOn(bool value);
 
+    int getInterval() const;  //in minutes
+    void setInterval(int value);
+
+    //the deltas are folded into a new base when this number is reached
+    int getDeltasPerBase() const;
+    void setDeltasPerBase(int value);
+
     void process();
 
 private:
     void onSave();
+    void finishSave();
 
     SimulationController _simController;
+    CheckpointStore _checkpointStore;
 
     bool _on = true;
-    boost::optional<std::chrono::steady_clock::time_point> _startTimePoint;
-};
\ No newline at end of file
+    int _interval = 20;
+    int _deltasPerBase = 10;
+    std::chrono::steady_clock::time_point _lastSaveTimePoint;
+
+    uint64_t _lastVersion = 0;  //of the entities in the last checkpoint, 0 = next checkpoint is a base
+    std::future<uint64_t> _saveJob;
+};
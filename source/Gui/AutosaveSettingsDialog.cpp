@@ -0,0 +1,75 @@
+#include "AutosaveSettingsDialog.h"
+
+#include <algorithm>
+
+#include "imgui.h"
+
+#include "AlienImGui.h"
+#include "AutosaveController.h"
+
+namespace
+{
+    auto const ItemTextWidth = 160.0f;
+}
+
+_AutosaveSettingsDialog::_AutosaveSettingsDialog(AutosaveController const& autosaveController)
+    : _autosaveController(autosaveController)
+{}
+
+void _AutosaveSettingsDialog::process()
+{
+    if (!_show) {
+        return;
+    }
+
+    ImGui::OpenPopup("Auto save settings");
+    if (ImGui::BeginPopupModal("Auto save settings", NULL, ImGuiWindowFlags_None)) {
+
+        auto interval = _autosaveController->getInterval();
+        AlienImGui::InputInt(
+            AlienImGui::InputIntParameters()
+                .name("Interval (minutes)")
+                .textWidth(ItemTextWidth)
+                .defaultValue(_origInterval)
+                .tooltip(std::string("Time between two checkpoints. Only the entities changed since the previous "
+                                     "checkpoint are written.")),
+            interval);
+        _autosaveController->setInterval(std::max(interval, 1));
+
+        auto deltasPerBase = _autosaveController->getDeltasPerBase();
+        AlienImGui::InputInt(
+            AlienImGui::InputIntParameters()
+                .name("Deltas per base")
+                .textWidth(ItemTextWidth)
+                .defaultValue(_origDeltasPerBase)
+                .tooltip(std::string("The changes are folded into a new complete checkpoint when this number of "
+                                     "checkpoints with changes is reached.")),
+            deltasPerBase);
+        _autosaveController->setDeltasPerBase(std::max(deltasPerBase, 1));
+
+        AlienImGui::Separator();
+
+        if (ImGui::Button("OK")) {
+            ImGui::CloseCurrentPopup();
+            _show = false;
+        }
+        ImGui::SetItemDefaultFocus();
+
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel")) {
+            ImGui::CloseCurrentPopup();
+            _show = false;
+            _autosaveController->setInterval(_origInterval);
+            _autosaveController->setDeltasPerBase(_origDeltasPerBase);
+        }
+
+        ImGui::EndPopup();
+    }
+}
+
+void _AutosaveSettingsDialog::show()
+{
+    _show = true;
+    _origInterval = _autosaveController->getInterval();
+    _origDeltasPerBase = _autosaveController->getDeltasPerBase();
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Definitions.h"
+
+class _AutosaveSettingsDialog
+{
+public:
+    _AutosaveSettingsDialog(AutosaveController const& autosaveController);
+
+    void process();
+
+    void show();
+
+private:
+    AutosaveController _autosaveController;
+
+    bool _show = false;
+    int _origInterval = 0;
+    int _origDeltasPerBase = 0;
+};
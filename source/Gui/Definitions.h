@@ -69,6 +69,12 @@ using UiController = boost::shared_ptr<_UiController>;
 class _AutosaveController;
 using AutosaveController = boost::shared_ptr<_AutosaveController>;
 
+class _StepHistory;
+using StepHistory = boost::shared_ptr<_StepHistory>;
+
+class _AutosaveSettingsDialog;
+using AutosaveSettingsDialog = boost::shared_ptr<_AutosaveSettingsDialog>;
+
 class _GettingStartedWindow;
 using GettingStartedWindow = boost::shared_ptr<_GettingStartedWindow>;
 
@@ -31,6 +31,18 @@ void GlobalSettings::setGpuSettings(GpuSettings gpuSettings)
     encodeDecodeGpuSettings(gpuSettings, ParserTask::Encode);
 }
 
+EngineSettings GlobalSettings::getEngineSettings()
+{
+    EngineSettings result;
+    encodeDecodeEngineSettings(result, ParserTask::Decode);
+    return result;
+}
+
+void GlobalSettings::setEngineSettings(EngineSettings engineSettings)
+{
+    encodeDecodeEngineSettings(engineSettings, ParserTask::Encode);
+}
+
 bool GlobalSettings::getBoolState(std::string const& name, bool defaultValue)
 {
     bool result;
@@ -70,6 +82,53 @@ void GlobalSettings::encodeDecodeGpuSettings(GpuSettings& gpuSettings, ParserTas
         task);
 }
 
+void GlobalSettings::encodeDecodeEngineSettings(EngineSettings& engineSettings, ParserTask task)
+{
+    EngineSettings defaultSettings;
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.REORDER_INTERVAL,
+        defaultSettings.REORDER_INTERVAL,
+        "settings.engine.reorder interval",
+        task);
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.REORDER_CURVE,
+        defaultSettings.REORDER_CURVE,
+        "settings.engine.reorder curve",
+        task);
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.RANDOM_SEED,
+        defaultSettings.RANDOM_SEED,
+        "settings.engine.random seed",
+        task);
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.ARRAY_FILL_LEVEL_FACTOR,
+        defaultSettings.ARRAY_FILL_LEVEL_FACTOR,
+        "settings.engine.array fill level factor",
+        task);
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.ACCESS_DATA_CACHE_LIMIT_MB,
+        defaultSettings.ACCESS_DATA_CACHE_LIMIT_MB,
+        "settings.engine.access data cache limit",
+        task);
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.PACKED_CELL_TRANSFER,
+        defaultSettings.PACKED_CELL_TRANSFER,
+        "settings.engine.packed cell transfer",
+        task);
+    JsonParser::encodeDecode(
+        _impl->_tree,
+        engineSettings.STAGE_PROFILING,
+        defaultSettings.STAGE_PROFILING,
+        "settings.engine.stage profiling",
+        task);
+}
+
 GlobalSettings::GlobalSettings()
 {
     try {
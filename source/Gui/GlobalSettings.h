@@ -2,6 +2,7 @@
 
 #include "Base/JsonParser.h"
 #include "EngineInterface/GpuSettings.h"
+#include "EngineInterface/EngineSettings.h"
 
 #include "Definitions.h"
 
@@ -18,6 +19,9 @@ public:
     GpuSettings getGpuSettings();
     void setGpuSettings(GpuSettings gpuSettings);
 
+    EngineSettings getEngineSettings();
+    void setEngineSettings(EngineSettings engineSettings);
+
     bool getBoolState(std::string const& name, bool defaultValue);
     void setBoolState(std::string const& name, bool value);
 
@@ -29,6 +33,7 @@ private:
     ~GlobalSettings();
 
     void encodeDecodeGpuSettings(GpuSettings& gpuSettings, ParserTask task);
+    void encodeDecodeEngineSettings(EngineSettings& engineSettings, ParserTask task);
 
     GlobalSettingsImpl* _impl;
 };
\ No newline at end of file
@@ -21,12 +21,16 @@ _GpuSettingsDialog::_GpuSettingsDialog(
 {
     auto gpuSettings = GlobalSettings::getInstance().getGpuSettings();
     _simController->setGpuSettings_async(gpuSettings);
+    auto engineSettings = GlobalSettings::getInstance().getEngineSettings();
+    _simController->setEngineSettings_async(engineSettings);
 }
 
 _GpuSettingsDialog::~_GpuSettingsDialog()
 {
     auto gpuSettings = _simController->getGpuSettings();
     GlobalSettings::getInstance().setGpuSettings(gpuSettings);
+    auto engineSettings = _simController->getEngineSettings();
+    GlobalSettings::getInstance().setEngineSettings(engineSettings);
 }
 
 void _GpuSettingsDialog::process()
@@ -37,6 +41,9 @@ void _GpuSettingsDialog::process()
     auto gpuSettings = _simController->getGpuSettings();
     auto origGpuSettings = _simController->getOriginalGpuSettings();
     auto lastGpuSettings = gpuSettings;
+    auto engineSettings = _simController->getEngineSettings();
+    auto origEngineSettings = _simController->getOriginalEngineSettings();
+    auto lastEngineSettings = engineSettings;
 
     ImGui::OpenPopup("GPU settings");
     if (ImGui::BeginPopupModal("GPU settings", NULL, ImGuiWindowFlags_None)) {
@@ -57,12 +64,82 @@ void _GpuSettingsDialog::process()
                 .tooltip(std::string("Number of GPU threads per blocks.")),
             gpuSettings.NUM_THREADS_PER_BLOCK);
 
+        AlienImGui::InputInt(
+            AlienImGui::InputIntParameters()
+                .name("Reordering interval")
+                .textWidth(ItemTextWidth)
+                .defaultValue(origEngineSettings.REORDER_INTERVAL)
+                .tooltip(std::string("Cells and particles are sorted in memory along a space-filling curve in every "
+                                     "n-th time step (only CPU engine). 0 disables the reordering.")),
+            engineSettings.REORDER_INTERVAL);
+
+        AlienImGui::Combo(
+            AlienImGui::ComboParameters()
+                .name("Reordering curve")
+                .textWidth(ItemTextWidth)
+                .defaultValue(origEngineSettings.REORDER_CURVE)
+                .values({"Morton", "Hilbert"}),
+            engineSettings.REORDER_CURVE);
+
+        AlienImGui::InputInt(
+            AlienImGui::InputIntParameters()
+                .name("Random seed")
+                .textWidth(ItemTextWidth)
+                .defaultValue(origEngineSettings.RANDOM_SEED)
+                .tooltip(std::string("Runs with the same seed, initial data and number of threads produce the same "
+                                     "random numbers.")),
+            engineSettings.RANDOM_SEED);
+
+        AlienImGui::InputFloat(
+            AlienImGui::InputFloatParameters()
+                .name("Array fill level")
+                .textWidth(ItemTextWidth)
+                .step(0.05f)
+                .format("%.2f")
+                .defaultValue(origEngineSettings.ARRAY_FILL_LEVEL_FACTOR)
+                .tooltip(std::string("Entity arrays are enlarged when they are filled above this level. Smaller "
+                                     "values leave more headroom at the expense of memory.")),
+            engineSettings.ARRAY_FILL_LEVEL_FACTOR);
+
+        AlienImGui::InputInt(
+            AlienImGui::InputIntParameters()
+                .name("Access cache (MB)")
+                .textWidth(ItemTextWidth)
+                .defaultValue(origEngineSettings.ACCESS_DATA_CACHE_LIMIT_MB)
+                .tooltip(std::string("Host memory for reusable data access buffers. Unused buffers are freed in "
+                                     "least recently used order when this limit is exceeded.")),
+            engineSettings.ACCESS_DATA_CACHE_LIMIT_MB);
+
+        auto cellTransfer = engineSettings.PACKED_CELL_TRANSFER ? 1 : 0;
+        AlienImGui::Combo(
+            AlienImGui::ComboParameters()
+                .name("Cell transfer")
+                .textWidth(ItemTextWidth)
+                .defaultValue(origEngineSettings.PACKED_CELL_TRANSFER ? 1 : 0)
+                .values({"Fixed size", "Packed"}),
+            cellTransfer);
+        engineSettings.PACKED_CELL_TRANSFER = 1 == cellTransfer;
+
+        auto stageProfiling = engineSettings.STAGE_PROFILING ? 1 : 0;
+        AlienImGui::Combo(
+            AlienImGui::ComboParameters()
+                .name("Stage profiling")
+                .textWidth(ItemTextWidth)
+                .defaultValue(origEngineSettings.STAGE_PROFILING ? 1 : 0)
+                .values({"Whole time step", "Each processing step"}),
+            stageProfiling);
+        engineSettings.STAGE_PROFILING = 1 == stageProfiling;
+
         ImGui::Spacing();
         ImGui::Separator();
         ImGui::Spacing();
 
         gpuSettings.NUM_BLOCKS = std::max(gpuSettings.NUM_BLOCKS, 1);
         gpuSettings.NUM_THREADS_PER_BLOCK = std::max(gpuSettings.NUM_THREADS_PER_BLOCK, 1);
+        engineSettings.REORDER_INTERVAL = std::max(engineSettings.REORDER_INTERVAL, 0);
+        engineSettings.ARRAY_FILL_LEVEL_FACTOR =
+            std::min(std::max(engineSettings.ARRAY_FILL_LEVEL_FACTOR, 0.1f), 0.95f);
+        engineSettings.ACCESS_DATA_CACHE_LIMIT_MB = std::max(engineSettings.ACCESS_DATA_CACHE_LIMIT_MB, 0);
 
         ImGui::Text("Total threads");
         ImGui::PushFont(_styleRepository->getLargeFont());
@@ -85,6 +162,7 @@ void _GpuSettingsDialog::process()
             ImGui::CloseCurrentPopup();
             _show = false;
             gpuSettings = _gpuSettings;
+            engineSettings = _engineSettings;
         }
 
         ImGui::EndPopup();
@@ -92,10 +170,14 @@ void _GpuSettingsDialog::process()
     if (gpuSettings != lastGpuSettings) {
         _simController->setGpuSettings_async(gpuSettings);
     }
+    if (engineSettings != lastEngineSettings) {
+        _simController->setEngineSettings_async(engineSettings);
+    }
 }
 
 void _GpuSettingsDialog::show()
 {
     _show = true;
     _gpuSettings = _simController->getGpuSettings();
+    _engineSettings = _simController->getEngineSettings();
 }
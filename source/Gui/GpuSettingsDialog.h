@@ -1,6 +1,7 @@
 #pragma once
 
 #include "EngineInterface/GpuSettings.h"
+#include "EngineInterface/EngineSettings.h"
 #include "EngineImpl/Definitions.h"
 #include "Definitions.h"
 
@@ -23,4 +24,5 @@ private:
 
     bool _show = false;
     GpuSettings _gpuSettings;
+    EngineSettings _engineSettings;
 };
\ No newline at end of file
@@ -45,6 +45,7 @@
 #include "UiController.h"
 #include "GlobalSettings.h"
 #include "AutosaveController.h"
+#include "AutosaveSettingsDialog.h"
 #include "GettingStartedWindow.h"
 #include "OpenSimulationDialog.h"
 #include "SaveSimulationDialog.h"
@@ -128,6 +129,7 @@ _MainWindow::_MainWindow(SimulationController const& simController, SimpleLogger
     _openSimulationDialog = boost::make_shared<_OpenSimulationDialog>(_simController, _statisticsWindow, _viewport);
     _saveSimulationDialog = boost::make_shared<_SaveSimulationDialog>(_simController);
     _displaySettingsDialog = boost::make_shared<_DisplaySettingsDialog>(_windowController);
+    _autosaveSettingsDialog = boost::make_shared<_AutosaveSettingsDialog>(_autosaveController);
 
     ifd::FileDialog::Instance().CreateTexture = [](uint8_t* data, int w, int h, char fmt) -> void* {
         GLuint tex;
@@ -414,6 +416,9 @@ void _MainWindow::processMenubar()
             if (ImGui::MenuItem("Auto save", "", _autosaveController->isOn())) {
                 _autosaveController->setOn(!_autosaveController->isOn());
             }
+            if (ImGui::MenuItem("Auto save settings")) {
+                _autosaveSettingsDialog->show();
+            }
             if (ImGui::MenuItem("GPU settings", "ALT+C")) {
                 _gpuSettingsDialog->show();
             }
@@ -528,6 +533,7 @@ void _MainWindow::processDialogs()
     _colorizeDialog->process();
     _gpuSettingsDialog->process();
     _displaySettingsDialog->process(); 
+    _autosaveSettingsDialog->process();
     processExitDialog();
 }
 
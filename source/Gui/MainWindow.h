@@ -57,6 +57,7 @@ private:
     OpenSimulationDialog _openSimulationDialog; 
     SaveSimulationDialog _saveSimulationDialog; 
     DisplaySettingsDialog _displaySettingsDialog;
+    AutosaveSettingsDialog _autosaveSettingsDialog;
     EditorController _editorController; 
 
     StyleRepository _styleRepository;
@@ -9,6 +9,11 @@
 #include "StatisticsWindow.h"
 #include "Viewport.h"
 
+namespace
+{
+    auto const SnapshotFileExtension = ".snapshot";
+}
+
 _OpenSimulationDialog::_OpenSimulationDialog(
     SimulationController const& simController,
     StatisticsWindow const& statisticsWindow,
@@ -32,11 +37,21 @@ void _OpenSimulationDialog::process()
 
         Serializer serializer = boost::make_shared<_Serializer>();
 
+        //the world is uploaded chunk by chunk without holding its whole description
         DeserializedSimulation deserializedData;
-        serializer->deserializeSimulationFromFile(firstFilename.string(), deserializedData);
+        serializer->deserializeSettingsFromFile(firstFilename.string(), deserializedData);
 
         _simController->newSimulation(deserializedData.timestep, deserializedData.settings, deserializedData.symbolMap);
-        _simController->setSimulationData(deserializedData.content);
+        if (firstFilename.extension() == SnapshotFileExtension) {
+            _simController->loadSnapshot(firstFilename.string());
+        } else {
+            serializer->deserializeDataChunksFromFile(
+                firstFilename.string(),
+                [&](DataDescription const& chunk) { _simController->addSimulationData(chunk); },
+                [&](uint64_t numCells, uint64_t numParticles) {
+                    _simController->reserveSimulationData(toInt(numCells), toInt(numParticles));
+                });
+        }
         _viewport->setCenterInWorldPos(
             {toFloat(deserializedData.settings.generalSettings.worldSizeX) / 2,
              toFloat(deserializedData.settings.generalSettings.worldSizeY) / 2});
@@ -57,5 +72,8 @@ void _OpenSimulationDialog::process()
 void _OpenSimulationDialog::show()
 {
     ifd::FileDialog::Instance().Open(
-        "SimulationOpenDialog", "Open simulation", "Simulation file (*.sim){.sim},.*", false);
+        "SimulationOpenDialog",
+        "Open simulation",
+        "Simulation file (*.sim){.sim},Snapshot (*.snapshot){.snapshot},.*",
+        false);
 }
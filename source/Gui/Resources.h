@@ -7,6 +7,7 @@ namespace Const
     std::string const BasePath = "Resources/";
 
     auto const AutosaveFile = BasePath + "autosave.sim";
+    auto const AutosaveDirectory = BasePath + "autosave";
     auto const LogFilename = BasePath + "log.txt";
     auto const SettingsFilename = BasePath + "settings.json";
 
@@ -7,6 +7,15 @@
 #include "EngineInterface/Serializer.h"
 #include "ImFileDialog.h"
 
+namespace
+{
+    //bounds the host memory for the world data during saving
+    auto const ExportTileSize = 500;
+
+    //snapshots are larger but load without conversion
+    auto const SnapshotFileExtension = ".snapshot";
+}
+
 _SaveSimulationDialog::_SaveSimulationDialog(SimulationController const& simController)
     : _simController(simController)
 {}
@@ -24,15 +33,24 @@ void _SaveSimulationDialog::process()
         sim.timestep = static_cast<uint32_t>(_simController->getCurrentTimestep());
         sim.settings = _simController->getSettings();
         sim.symbolMap = _simController->getSymbolMap();
-        sim.content = _simController->getSimulationData({0, 0}, _simController->getWorldSize());
 
         Serializer serializer = boost::make_shared<_Serializer>();
-        serializer->serializeSimulationToFile(firstFilename.string(), sim);
+        if (firstFilename.extension() == SnapshotFileExtension) {
+            _simController->saveSnapshot(firstFilename.string());
+            serializer->serializeSettingsToFile(firstFilename.string(), sim);
+        } else {
+            serializer->serializeSimulationToChunkedFile(firstFilename.string(), sim, [&](DataChunkSink const& sink) {
+                _simController->exportSimulationData(ExportTileSize, sink);
+            });
+        }
     }
     ifd::FileDialog::Instance().Close();
 }
 
 void _SaveSimulationDialog::show()
 {
-    ifd::FileDialog::Instance().Save("SimulationSaveDialog", "Save simulation", "Simulation file (*.sim){.sim},.*");
+    ifd::FileDialog::Instance().Save(
+        "SimulationSaveDialog",
+        "Save simulation",
+        "Simulation file (*.sim){.sim},Snapshot (*.snapshot){.snapshot},.*");
 }
@@ -4,6 +4,7 @@
 
 #include "Base/Definitions.h"
 #include "EngineInterface/ChangeDescriptions.h"
+#include "EngineInterface/CheckpointStore.h"
 #include "EngineInterface/Serializer.h"
 #include "EngineImpl/SimulationController.h"
 #include "OpenGLHelper.h"
@@ -39,10 +40,13 @@ void _StartupWindow::process()
     }
 
     if (_state == State::RequestLoading) {
-        Serializer serializer = boost::make_shared<_Serializer>();
-
+        //the checkpoints of the autosave are preferred to the initial simulation
         DeserializedSimulation deserializedData;
-        serializer->deserializeSimulationFromFile(Const::AutosaveFile, deserializedData);
+        _CheckpointStore checkpointStore(Const::AutosaveDirectory);
+        if (!checkpointStore.restore(deserializedData)) {
+            Serializer serializer = boost::make_shared<_Serializer>();
+            serializer->deserializeSimulationFromFile(Const::AutosaveFile, deserializedData);
+        }
 
         _simController->newSimulation(deserializedData.timestep, deserializedData.settings, deserializedData.symbolMap);
         _simController->setSimulationData(deserializedData.content);
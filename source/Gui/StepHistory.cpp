@@ -0,0 +1,101 @@
+#include "StepHistory.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "EngineInterface/DataDeltaReplay.h"
+#include "EngineInterface/Serializer.h"
+
+_StepHistory::_StepHistory(uint64_t memoryBudget, int keyframeInterval)
+    : _memoryBudget(memoryBudget)
+    , _keyframeInterval(keyframeInterval)
+{}
+
+uint64_t _StepHistory::getMemoryBudget() const
+{
+    return _memoryBudget;
+}
+
+void _StepHistory::setMemoryBudget(uint64_t value)
+{
+    _memoryBudget = value;
+    evict();
+}
+
+uint64_t _StepHistory::getSinceVersion() const
+{
+    if (_entries.empty() || _numDeltasSinceKeyframe >= _keyframeInterval) {
+        return 0;
+    }
+    return _lastVersion;
+}
+
+void _StepHistory::push(uint64_t timestep, DataDeltaDescription const& delta)
+{
+    if (_entries.empty() && !delta.complete) {
+        throw std::runtime_error("The first state of the step history has to be complete.");
+    }
+    Serializer serializer = boost::make_shared<_Serializer>();
+    Entry entry{timestep, delta.complete, serializer->serializeDataDeltaToString(delta)};
+    _memoryUsage += entry.delta.size();
+    _entries.emplace_back(std::move(entry));
+    _lastVersion = delta.version;
+    _numDeltasSinceKeyframe = delta.complete ? 0 : _numDeltasSinceKeyframe + 1;
+
+    evict();
+}
+
+auto _StepHistory::pop() -> State
+{
+    if (_entries.empty()) {
+        throw std::runtime_error("The step history is empty.");
+    }
+    auto keyframe =
+        std::find_if(_entries.rbegin(), _entries.rend(), [](auto const& entry) { return entry.isKeyframe; });
+
+    Serializer serializer = boost::make_shared<_Serializer>();
+    DataDeltaReplay replay;
+    for (auto entry = std::prev(keyframe.base()); entry != _entries.end(); ++entry) {
+        replay.apply(serializer->deserializeDataDeltaFromString(entry->delta));
+    }
+    State result{_entries.back().timestep, replay.getDataDescription()};
+
+    _memoryUsage -= _entries.back().delta.size();
+    _entries.pop_back();
+
+    //the restored state gets new versions in the simulation
+    _lastVersion = 0;
+    return result;
+}
+
+void _StepHistory::clear()
+{
+    _entries.clear();
+    _memoryUsage = 0;
+    _lastVersion = 0;
+    _numDeltasSinceKeyframe = 0;
+}
+
+int _StepHistory::getNumStates() const
+{
+    return toInt(_entries.size());
+}
+
+uint64_t _StepHistory::getMemoryUsage() const
+{
+    return _memoryUsage;
+}
+
+void _StepHistory::evict()
+{
+    //deltas are useless without their keyframe, hence a keyframe is dropped together with its deltas
+    while (_memoryUsage > _memoryBudget && !_entries.empty()) {
+        do {
+            _memoryUsage -= _entries.front().delta.size();
+            _entries.pop_front();
+        } while (!_entries.empty() && !_entries.front().isKeyframe);
+    }
+    if (_entries.empty()) {
+        clear();
+    }
+}
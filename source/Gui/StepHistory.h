@@ -0,0 +1,54 @@
+#pragma once
+
+#include <deque>
+
+#include "EngineInterface/Descriptions.h"
+
+#include "Definitions.h"
+
+//states of the simulation for stepping backward: keyframes with all entities followed by compressed deltas with the
+//changes since the preceding state, the oldest keyframes and their deltas are dropped when the memory budget is
+//exceeded
+class _StepHistory
+{
+public:
+    _StepHistory(uint64_t memoryBudget, int keyframeInterval = 25);
+
+    uint64_t getMemoryBudget() const;  //in bytes
+    void setMemoryBudget(uint64_t value);
+
+    //version to be passed to getSimulationDataDelta for the next state, 0 = a keyframe is needed
+    uint64_t getSinceVersion() const;
+
+    void push(uint64_t timestep, DataDeltaDescription const& delta);
+
+    //restores the latest state from the nearest keyframe and removes it from the history
+    struct State
+    {
+        uint64_t timestep;
+        DataDescription data;
+    };
+    State pop();
+
+    void clear();
+
+    int getNumStates() const;
+    uint64_t getMemoryUsage() const;  //in bytes
+
+private:
+    void evict();
+
+    uint64_t _memoryBudget;
+    int _keyframeInterval;
+
+    struct Entry
+    {
+        uint64_t timestep;
+        bool isKeyframe;
+        std::string delta;
+    };
+    std::deque<Entry> _entries;
+    uint64_t _memoryUsage = 0;
+    uint64_t _lastVersion = 0;
+    int _numDeltasSinceKeyframe = 0;
+};
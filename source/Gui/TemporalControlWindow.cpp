@@ -11,6 +11,7 @@
 #include "OpenGLHelper.h"
 #include "Resources.h"
 #include "StatisticsWindow.h"
+#include "StepHistory.h"
 #include "GlobalSettings.h"
 
 _TemporalControlWindow::_TemporalControlWindow(
@@ -29,11 +30,15 @@ _TemporalControlWindow::_TemporalControlWindow(
     _restoreTexture = OpenGLHelper::loadTexture(Const::RestoreFilname);
 
     _on = GlobalSettings::getInstance().getBoolState("windows.temporal control.active", true);
+    _historyBudget =
+        GlobalSettings::getInstance().getIntState("windows.temporal control.history budget", _historyBudget);
+    _history = boost::make_shared<_StepHistory>(static_cast<uint64_t>(_historyBudget) * 1024 * 1024);
 }
 
 _TemporalControlWindow::~_TemporalControlWindow()
 {
     GlobalSettings::getInstance().setBoolState("windows.temporal control.active", _on);
+    GlobalSettings::getInstance().setIntState("windows.temporal control.history budget", _historyBudget);
 }
 
 void _TemporalControlWindow::process()
@@ -66,10 +71,12 @@ void _TemporalControlWindow::process()
     if (ImGui::BeginChild("##", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar)) {
         processTpsInfo();
         processTotalTimestepsInfo();
+        processHistoryInfo();
 
         ImGui::Spacing();
         ImGui::Spacing();
         processTpsRestriction();
+        processHistoryBudget();
     }
     ImGui::EndChild();
 
@@ -108,6 +115,17 @@ void _TemporalControlWindow::processTotalTimestepsInfo()
     ImGui::PopFont();
 }
 
+void _TemporalControlWindow::processHistoryInfo()
+{
+    ImGui::Text("Retained steps");
+
+    ImGui::PushFont(_styleRepository->getLargeFont());
+    ImGui::PushStyleColor(ImGuiCol_Text, Const::TextDecentColor);
+    ImGui::TextUnformatted(StringFormatter::format(_history->getNumStates()).c_str());
+    ImGui::PopStyleColor();
+    ImGui::PopFont();
+}
+
 void _TemporalControlWindow::processTpsRestriction()
 {
     ImGui::Checkbox("Slow down", &_slowDown);
@@ -124,11 +142,22 @@ void _TemporalControlWindow::processTpsRestriction()
     ImGui::EndDisabled();
 }
 
+void _TemporalControlWindow::processHistoryBudget()
+{
+    auto memoryUsage = toFloat(_history->getMemoryUsage()) / (1024 * 1024);
+    ImGui::Text("History memory: %.1f MB", memoryUsage);
+    ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x);
+    if (ImGui::SliderInt("##historyBudget", &_historyBudget, 16, 4096, "%d MB budget", ImGuiSliderFlags_Logarithmic)) {
+        _history->setMemoryBudget(static_cast<uint64_t>(_historyBudget) * 1024 * 1024);
+    }
+    ImGui::PopItemWidth();
+}
+
 void _TemporalControlWindow::processRunButton()
 {
     ImGui::BeginDisabled(_simController->isSimulationRunning());
     if (ImGui::ImageButton((void*)(intptr_t)_runTexture.textureId, {32.0f, 32.0f}, {0, 0}, {1.0f, 1.0f})) {
-        _history.clear();
+        _history->clear();
         _simController->runSimulation();
     }
     ImGui::EndDisabled();
@@ -145,12 +174,11 @@ void _TemporalControlWindow::processPauseButton()
 
 void _TemporalControlWindow::processStepBackwardButton()
 {
-    ImGui::BeginDisabled(_history.empty() || _simController->isSimulationRunning());
+    ImGui::BeginDisabled(_history->getNumStates() == 0 || _simController->isSimulationRunning());
     if (ImGui::ImageButton((void*)(intptr_t)_stepBackwardTexture.textureId, {32.0f, 32.0f}, {0, 0}, {1.0f, 1.0f})) {
-        auto const& snapshot = _history.back();
-        _simController->setCurrentTimestep(snapshot.timestep);
-        _simController->setSimulationData(snapshot.data);
-        _history.pop_back();
+        auto state = _history->pop();
+        _simController->setCurrentTimestep(state.timestep);
+        _simController->setSimulationData(state.data);
     }
     ImGui::EndDisabled();
 }
@@ -159,11 +187,9 @@ void _TemporalControlWindow::processStepForwardButton()
 {
     ImGui::BeginDisabled(_simController->isSimulationRunning());
     if (ImGui::ImageButton((void*)(intptr_t)_stepForwardTexture.textureId, {32.0f, 32.0f}, {0, 0}, {1.0f, 1.0f})) {
-        Snapshot newSnapshot;
-        newSnapshot.timestep = _simController->getCurrentTimestep();
+        auto timestep = _simController->getCurrentTimestep();
         auto size = _simController->getWorldSize();
-        newSnapshot.data = _simController->getSimulationData({0, 0}, size);
-        _history.emplace_back(newSnapshot);
+        _history->push(timestep, _simController->getSimulationDataDelta({0, 0}, size, _history->getSinceVersion()));
 
         _simController->calcSingleTimestep();
     }
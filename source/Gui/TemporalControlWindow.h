@@ -22,6 +22,8 @@ public:
 private:
     void processTpsInfo();
     void processTotalTimestepsInfo();
+    void processHistoryInfo();
+    void processHistoryBudget();
     void processTpsRestriction();
 
     void processRunButton();
@@ -49,7 +51,8 @@ private:
     };
     boost::optional<Snapshot> _snapshot;
 
-    std::vector<Snapshot> _history;
+    StepHistory _history;
+    int _historyBudget = 256;  //in MB
     bool _on = false;
 
     bool _slowDown = false;